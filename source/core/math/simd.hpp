@@ -0,0 +1,305 @@
+/**************************************************************************/
+/* simd.hpp                                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KN_SIMD_SSE2 1
+#else
+#define KN_SIMD_SSE2 0
+#endif
+
+namespace kn::simd {
+/** Number of lanes of the packed types. */
+constexpr uint32_t WIDTH = 4;
+
+#if KN_SIMD_SSE2
+
+/** Four packed floats. */
+struct vfloat4 {
+  __m128 v;
+};
+
+/** Four packed 32-bit integers. */
+struct vint4 {
+  __m128i v;
+};
+
+/** Per-lane result of a comparison. */
+struct vmask4 {
+  __m128 v;
+};
+
+inline vfloat4 load(const float* p) {
+  return {_mm_loadu_ps(p)};
+}
+
+inline vint4 load(const int32_t* p) {
+  return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+}
+
+inline void store(float* p, vfloat4 a) {
+  _mm_storeu_ps(p, a.v);
+}
+
+inline void store(int32_t* p, vint4 a) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a.v);
+}
+
+inline vfloat4 broadcast(float x) {
+  return {_mm_set1_ps(x)};
+}
+
+inline vint4 broadcast(int32_t x) {
+  return {_mm_set1_epi32(x)};
+}
+
+inline vfloat4 operator+(vfloat4 a, vfloat4 b) {
+  return {_mm_add_ps(a.v, b.v)};
+}
+
+inline vfloat4 operator-(vfloat4 a, vfloat4 b) {
+  return {_mm_sub_ps(a.v, b.v)};
+}
+
+inline vfloat4 operator*(vfloat4 a, vfloat4 b) {
+  return {_mm_mul_ps(a.v, b.v)};
+}
+
+inline vfloat4 operator/(vfloat4 a, vfloat4 b) {
+  return {_mm_div_ps(a.v, b.v)};
+}
+
+inline vint4 operator+(vint4 a, vint4 b) {
+  return {_mm_add_epi32(a.v, b.v)};
+}
+
+inline vint4 operator-(vint4 a, vint4 b) {
+  return {_mm_sub_epi32(a.v, b.v)};
+}
+
+inline vfloat4 min(vfloat4 a, vfloat4 b) {
+  return {_mm_min_ps(a.v, b.v)};
+}
+
+inline vfloat4 max(vfloat4 a, vfloat4 b) {
+  return {_mm_max_ps(a.v, b.v)};
+}
+
+inline vfloat4 abs(vfloat4 a) {
+  return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};
+}
+
+inline vfloat4 sqrt(vfloat4 a) {
+  return {_mm_sqrt_ps(a.v)};
+}
+
+inline vmask4 operator<(vfloat4 a, vfloat4 b) {
+  return {_mm_cmplt_ps(a.v, b.v)};
+}
+
+/** Returns a where mask is set, b elsewhere. */
+inline vfloat4 select(vmask4 mask, vfloat4 a, vfloat4 b) {
+  return {_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))};
+}
+
+/** Converts to integers, rounding toward zero; NaN and values out of range give INT32_MIN. */
+inline vint4 to_int(vfloat4 a) {
+  return {_mm_cvttps_epi32(a.v)};
+}
+
+inline vfloat4 to_float(vint4 a) {
+  return {_mm_cvtepi32_ps(a.v)};
+}
+
+/** Rounds toward negative infinity; valid for magnitudes below 2^31, NaN giving -2^31. */
+inline vfloat4 floor(vfloat4 a) {
+  const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+  return {_mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a.v), _mm_set1_ps(1.0f)))};
+}
+
+#else
+
+struct vfloat4 {
+  float v[4];
+};
+
+struct vint4 {
+  int32_t v[4];
+};
+
+struct vmask4 {
+  bool v[4];
+};
+
+#define KN_SIMD_LANES(EXPR)            \
+  for (uint32_t i = 0; i < WIDTH; ++i) { \
+    EXPR;                              \
+  }
+
+inline vfloat4 load(const float* p) {
+  vfloat4 r;
+  KN_SIMD_LANES(r.v[i] = p[i]);
+  return r;
+}
+
+inline vint4 load(const int32_t* p) {
+  vint4 r;
+  KN_SIMD_LANES(r.v[i] = p[i]);
+  return r;
+}
+
+inline void store(float* p, vfloat4 a) {
+  KN_SIMD_LANES(p[i] = a.v[i]);
+}
+
+inline void store(int32_t* p, vint4 a) {
+  KN_SIMD_LANES(p[i] = a.v[i]);
+}
+
+inline vfloat4 broadcast(float x) {
+  return {{x, x, x, x}};
+}
+
+inline vint4 broadcast(int32_t x) {
+  return {{x, x, x, x}};
+}
+
+inline vfloat4 operator+(vfloat4 a, vfloat4 b) {
+  KN_SIMD_LANES(a.v[i] += b.v[i]);
+  return a;
+}
+
+inline vfloat4 operator-(vfloat4 a, vfloat4 b) {
+  KN_SIMD_LANES(a.v[i] -= b.v[i]);
+  return a;
+}
+
+inline vfloat4 operator*(vfloat4 a, vfloat4 b) {
+  KN_SIMD_LANES(a.v[i] *= b.v[i]);
+  return a;
+}
+
+inline vfloat4 operator/(vfloat4 a, vfloat4 b) {
+  KN_SIMD_LANES(a.v[i] /= b.v[i]);
+  return a;
+}
+
+inline vint4 operator+(vint4 a, vint4 b) {
+  KN_SIMD_LANES(a.v[i] += b.v[i]);
+  return a;
+}
+
+inline vint4 operator-(vint4 a, vint4 b) {
+  KN_SIMD_LANES(a.v[i] -= b.v[i]);
+  return a;
+}
+
+// Like SSE, min and max return b when either lane is NaN, which callers rely on to clamp NaN.
+inline vfloat4 min(vfloat4 a, vfloat4 b) {
+  KN_SIMD_LANES(a.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]);
+  return a;
+}
+
+inline vfloat4 max(vfloat4 a, vfloat4 b) {
+  KN_SIMD_LANES(a.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]);
+  return a;
+}
+
+inline vfloat4 abs(vfloat4 a) {
+  KN_SIMD_LANES(a.v[i] = std::fabs(a.v[i]));
+  return a;
+}
+
+inline vfloat4 sqrt(vfloat4 a) {
+  KN_SIMD_LANES(a.v[i] = std::sqrt(a.v[i]));
+  return a;
+}
+
+inline vmask4 operator<(vfloat4 a, vfloat4 b) {
+  vmask4 r;
+  KN_SIMD_LANES(r.v[i] = a.v[i] < b.v[i]);
+  return r;
+}
+
+inline vfloat4 select(vmask4 mask, vfloat4 a, vfloat4 b) {
+  KN_SIMD_LANES(a.v[i] = mask.v[i] ? a.v[i] : b.v[i]);
+  return a;
+}
+
+// Like SSE, NaN and values out of the range of int32_t convert to INT32_MIN.
+inline vint4 to_int(vfloat4 a) {
+  vint4 r;
+  KN_SIMD_LANES(r.v[i] = a.v[i] >= -2147483648.0f && a.v[i] < 2147483648.0f ? static_cast<int32_t>(a.v[i])
+                                                                            : INT32_MIN);
+  return r;
+}
+
+inline vfloat4 to_float(vint4 a) {
+  vfloat4 r;
+  KN_SIMD_LANES(r.v[i] = static_cast<float>(a.v[i]));
+  return r;
+}
+
+// Same steps as SSE, so that NaN and magnitudes from 2^31 give -2^31.
+inline vfloat4 floor(vfloat4 a) {
+  const vfloat4 truncated = to_float(to_int(a));
+  KN_SIMD_LANES(a.v[i] = truncated.v[i] > a.v[i] ? truncated.v[i] - 1.0f : truncated.v[i]);
+  return a;
+}
+
+#undef KN_SIMD_LANES
+
+#endif
+
+/** Returns a * b + c. */
+inline vfloat4 madd(vfloat4 a, vfloat4 b, vfloat4 c) {
+  return a * b + c;
+}
+
+/** Returns a + t * (b - a). */
+inline vfloat4 lerp(vfloat4 a, vfloat4 b, vfloat4 t) {
+  return madd(t, b - a, a);
+}
+
+/** Hints that the cache line holding p will be read soon, to hide the latency of data-dependent loads. */
+inline void prefetch(const void* p) {
+#if KN_SIMD_SSE2
+  _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
+}  // namespace kn::simd
@@ -29,7 +29,9 @@
 
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
+#include <memory>
 #include "common.hpp"
 #include "core_api.hpp"
 
@@ -75,6 +77,42 @@ class os {
     std::filesystem::path _path;
   };
 
+  /**
+   * Represents a file mapped in memory.
+   */
+  class MappedFile {
+    friend class os;
+
+    MappedFile(void* data, size_t size, void* handle) : _data(data), _size(size), _handle(handle) {}
+
+   public:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() { os::unmap_file_impl(_data, _size, _handle); }
+
+    /** Returns the content of the file, writable if it was mapped for writing. */
+    [[nodiscard]] inline void* get_data() const { return _data; }
+
+    [[nodiscard]] inline size_t get_size() const { return _size; }
+
+   private:
+    void* _data;
+    size_t _size;
+    void* _handle;
+  };
+
+  /**
+   * Maps a file in memory.
+   * @param[in] path The path to the file.
+   * @param[in] size The size of the file to create, or 0 to map an existing file for reading.
+   * @return The mapped file, or null if the file could not be opened, created or mapped.
+   */
+  [[nodiscard]] inline static std::unique_ptr<MappedFile> map_file(const std::filesystem::path& path,
+                                                                   size_t size = 0) {
+    return std::unique_ptr<MappedFile>(map_file_impl(path, size));
+  }
+
   /**
    * Loads a dynamic library.
    * @param[in] path The path to the dynamic library.
@@ -94,5 +132,7 @@ class os {
   static KN_CORE_API Library* load_library_impl(const std::filesystem::path& path);
   static KN_CORE_API bool free_library_impl(void* library);
   static KN_CORE_API void* get_function_impl(void* library, const char* name);
+  static KN_CORE_API MappedFile* map_file_impl(const std::filesystem::path& path, size_t size);
+  static KN_CORE_API void unmap_file_impl(void* data, size_t size, void* handle);
 };
 }  // namespace kn
@@ -28,6 +28,10 @@
 /**************************************************************************/
 
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <cstring>
 #include "os/os.hpp"
 
@@ -44,4 +48,36 @@ bool os::free_library_impl(void* library) {
 void* os::get_function_impl(void* library, const char* name) {
   return ::dlsym(library, name);
 }
+
+os::MappedFile* os::map_file_impl(const std::filesystem::path& path, size_t size) {
+  const bool write = size > 0;
+  const int fd = ::open(path.c_str(), write ? O_RDWR | O_CREAT | O_TRUNC : O_RDONLY, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  struct stat status = {};
+  if (write ? ::ftruncate(fd, static_cast<off_t>(size)) != 0 : ::fstat(fd, &status) != 0) {
+    ::close(fd);
+    return nullptr;
+  }
+  if (!write) {
+    size = static_cast<size_t>(status.st_size);
+  }
+
+  // The mapping keeps the file open; empty files cannot be mapped.
+  void* data = size > 0 ? ::mmap(nullptr, size, write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0)
+                        : nullptr;
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  return new MappedFile(data, size, nullptr);
+}
+
+void os::unmap_file_impl(void* data, size_t size, void*) {
+  if (data != nullptr) {
+    ::munmap(data, size);
+  }
+}
 }  // namespace kn
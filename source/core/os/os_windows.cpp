@@ -45,4 +45,51 @@ bool os::free_library_impl(void* library) {
 void* os::get_function_impl(void* library, const char* name) {
   return ::GetProcAddress(static_cast<HMODULE>(library), name);
 }
+
+os::MappedFile* os::map_file_impl(const std::filesystem::path& path, size_t size) {
+  const bool write = size > 0;
+  const HANDLE file = ::CreateFileW(path.c_str(), write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ,
+                                    nullptr, write ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+
+  if (!write) {
+    LARGE_INTEGER file_size = {};
+    if (!::GetFileSizeEx(file, &file_size)) {
+      ::CloseHandle(file);
+      return nullptr;
+    }
+    // Empty files cannot be mapped.
+    if (file_size.QuadPart == 0) {
+      ::CloseHandle(file);
+      return new MappedFile(nullptr, 0, nullptr);
+    }
+    size = static_cast<size_t>(file_size.QuadPart);
+  }
+
+  // The mapping keeps the file open.
+  const HANDLE mapping =
+      ::CreateFileMappingW(file, nullptr, write ? PAGE_READWRITE : PAGE_READONLY, static_cast<DWORD>(size >> 32),
+                           static_cast<DWORD>(size & 0xffffffff), nullptr);
+  ::CloseHandle(file);
+  if (mapping == nullptr) {
+    return nullptr;
+  }
+  void* data = ::MapViewOfFile(mapping, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+  if (data == nullptr) {
+    ::CloseHandle(mapping);
+    return nullptr;
+  }
+  return new MappedFile(data, size, mapping);
+}
+
+void os::unmap_file_impl(void* data, size_t, void* handle) {
+  if (data != nullptr) {
+    ::UnmapViewOfFile(data);
+  }
+  if (handle != nullptr) {
+    ::CloseHandle(handle);
+  }
+}
 }  // namespace kn
@@ -0,0 +1,93 @@
+/**************************************************************************/
+/* parallel_for.hpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "core_api.hpp"
+#include "threading/task_scheduler.hpp"
+
+namespace kn {
+/** Returns the number of threads parallel algorithms spread their work on. */
+KN_CORE_API uint32_t get_worker_count();
+
+/**
+ * Invokes func(i) for every i in [begin, end) on all worker threads.
+ * Indices are handed out in chunks of grain consecutive values, so neighbouring indices stay on the same thread.
+ * The work runs as tasks of the TaskScheduler, so that loops nested in the tasks of other loops or of a graph
+ * share the same workers instead of starting threads of their own.
+ * The calling thread takes part in the work and the function returns once every index has been processed.
+ * @param begin The first index.
+ * @param end One past the last index.
+ * @param func The callable invoked with each index.
+ * @param grain The number of consecutive indices a thread takes at once.
+ */
+template <typename Func>
+void parallel_for(size_t begin, size_t end, Func&& func, size_t grain = 1) {
+  if (begin >= end) {
+    return;
+  }
+
+  grain = std::max<size_t>(grain, 1);
+  const size_t chunk_count = (end - begin + grain - 1) / grain;
+  const size_t task_count = std::min<size_t>(get_worker_count(), chunk_count);
+
+  std::atomic<size_t> next{begin};
+  auto worker = [&]() {
+    for (;;) {
+      const size_t first = next.fetch_add(grain, std::memory_order_relaxed);
+      if (first >= end) {
+        return;
+      }
+      const size_t last = std::min(first + grain, end);
+      for (size_t i = first; i < last; ++i) {
+        func(i);
+      }
+    }
+  };
+
+  if (task_count <= 1) {
+    worker();
+    return;
+  }
+
+  // Every task takes chunks until there are none left, so a task starting late finds no work rather than delaying
+  // the loop.
+  TaskScheduler* scheduler = TaskScheduler::get_instance();
+  TaskGroup group;
+  for (size_t i = 1; i < task_count; ++i) {
+    scheduler->submit(group, worker);
+  }
+  worker();
+  scheduler->wait(group);
+}
+}  // namespace kn
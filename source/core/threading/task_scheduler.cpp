@@ -0,0 +1,169 @@
+/**************************************************************************/
+/* task_scheduler.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "threading/task_scheduler.hpp"
+#include "kn_assert.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+/** Scheduler whose worker runs on this thread, and the queue of that worker. */
+thread_local const TaskScheduler* t_scheduler = nullptr;
+thread_local uint32_t t_queue = 0;
+
+/** Seed of the victim choice, different on every thread so that thieves spread over the queues. */
+thread_local uint32_t t_seed = 0;
+
+uint32_t next_random() {
+  if (t_seed == 0) {
+    t_seed = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+  }
+  // xorshift32
+  t_seed ^= t_seed << 13;
+  t_seed ^= t_seed >> 17;
+  t_seed ^= t_seed << 5;
+  return t_seed;
+}
+}  // namespace
+
+TaskGroup::~TaskGroup() {
+  ensure(is_done());
+}
+
+TaskScheduler::TaskScheduler(uint32_t thread_count)
+    : _queues(std::make_unique<Queue[]>(thread_count + 1)), _queue_count(thread_count + 1) {
+  _threads.reserve(thread_count);
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    _threads.emplace_back([this, i]() { run_worker(i); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::lock_guard lock(_sleep_mutex);
+    _stop = true;
+  }
+  _wake.notify_all();
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+TaskScheduler* TaskScheduler::get_instance() {
+  static TaskScheduler instance(get_worker_count() - 1);
+  return &instance;
+}
+
+void TaskScheduler::submit(TaskGroup& group, Task task) {
+  group._pending.fetch_add(1, std::memory_order_relaxed);
+
+  // Either the task is counted before a worker checks the count to sleep, or the worker is counted as sleeping
+  // before the task is, and is woken up.
+  _queued.fetch_add(1);
+  const uint32_t queue = t_scheduler == this ? t_queue : _queue_count - 1;
+  {
+    std::lock_guard lock(_queues[queue].mutex);
+    _queues[queue].entries.push_back({std::move(task), &group});
+  }
+  if (_sleeping.load() > 0) {
+    { std::lock_guard lock(_sleep_mutex); }
+    _wake.notify_one();
+  }
+}
+
+void TaskScheduler::wait(TaskGroup& group) {
+  const uint32_t queue = t_scheduler == this ? t_queue : _queue_count - 1;
+  for (;;) {
+    const uint32_t pending = group._pending.load(std::memory_order_acquire);
+    if (pending == 0) {
+      return;
+    }
+    // With nothing left to run, the remaining tasks of the group are running on other threads.
+    if (!run_next(queue)) {
+      group._pending.wait(pending, std::memory_order_acquire);
+    }
+  }
+}
+
+bool TaskScheduler::run_next(uint32_t queue) {
+  Entry entry;
+  bool found = false;
+
+  // Workers take their most recent task; the shared queue is only stolen from, oldest first.
+  if (queue + 1 < _queue_count) {
+    std::lock_guard lock(_queues[queue].mutex);
+    if (!_queues[queue].entries.empty()) {
+      entry = std::move(_queues[queue].entries.back());
+      _queues[queue].entries.pop_back();
+      found = true;
+    }
+  }
+
+  const uint32_t start = next_random() % _queue_count;
+  for (uint32_t i = 0; i < _queue_count && !found; ++i) {
+    Queue& victim = _queues[(start + i) % _queue_count];
+    std::lock_guard lock(victim.mutex);
+    if (!victim.entries.empty()) {
+      entry = std::move(victim.entries.front());
+      victim.entries.pop_front();
+      found = true;
+    }
+  }
+
+  if (!found) {
+    return false;
+  }
+
+  _queued.fetch_sub(1, std::memory_order_relaxed);
+  entry.task();
+  if (entry.group->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    entry.group->_pending.notify_all();
+  }
+  return true;
+}
+
+void TaskScheduler::run_worker(uint32_t queue) {
+  t_scheduler = this;
+  t_queue = queue;
+
+  for (;;) {
+    if (run_next(queue)) {
+      continue;
+    }
+
+    std::unique_lock lock(_sleep_mutex);
+    _sleeping.fetch_add(1);
+    _wake.wait(lock, [this]() { return _stop || _queued.load() > 0; });
+    _sleeping.fetch_sub(1);
+    if (_stop && _queued.load() == 0) {
+      return;
+    }
+  }
+}
+}  // namespace kn
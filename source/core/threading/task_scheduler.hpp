@@ -0,0 +1,123 @@
+/**************************************************************************/
+/* task_scheduler.hpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core_api.hpp"
+
+namespace kn {
+/** Tasks submitted together and waited for together. */
+class KN_CORE_API TaskGroup {
+ public:
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  TaskGroup() = default;
+  /** A group must be waited for before it is destroyed. */
+  ~TaskGroup();
+
+  /** Checks if every task of the group has run. */
+  [[nodiscard]] inline bool is_done() const { return _pending.load(std::memory_order_acquire) == 0; }
+
+ private:
+  friend class TaskScheduler;
+
+  std::atomic<uint32_t> _pending{0};
+};
+
+/**
+ * Work-stealing thread pool. Every worker owns a deque: tasks submitted from a worker go to its own deque, where it
+ * takes the most recent one first to reuse what it just wrote, while idle workers steal the oldest tasks of other
+ * deques, which are usually the largest. Tasks submitted from other threads go to a shared deque every worker
+ * steals from. Threads waiting for a group run tasks in the meantime, so tasks may submit and wait for tasks of
+ * their own, such as a node splitting its evaluation into tiles, without blocking a worker.
+ */
+class KN_CORE_API TaskScheduler {
+ public:
+  using Task = std::function<void()>;
+
+  TaskScheduler(const TaskScheduler&) = delete;
+  TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+  /**
+   * Starts the workers.
+   * @param thread_count The number of worker threads, besides the threads waiting for their tasks.
+   */
+  explicit TaskScheduler(uint32_t thread_count);
+  /** Runs the remaining tasks, then stops the workers. */
+  ~TaskScheduler();
+
+  /** Returns the scheduler parallel algorithms use, with a worker per core but the calling one. */
+  static TaskScheduler* get_instance();
+
+  /** Queues a task in a group. */
+  void submit(TaskGroup& group, Task task);
+
+  /** Runs tasks until every task of the group has run. */
+  void wait(TaskGroup& group);
+
+  [[nodiscard]] inline uint32_t get_thread_count() const { return static_cast<uint32_t>(_threads.size()); }
+
+ private:
+  struct Entry {
+    Task task;
+    TaskGroup* group;
+  };
+
+  struct alignas(64) Queue {
+    std::mutex mutex;
+    std::deque<Entry> entries;
+  };
+
+  /** Runs a task, taken from the back of the given queue or stolen from the front of another one. */
+  bool run_next(uint32_t queue);
+  void run_worker(uint32_t queue);
+
+  /** One queue per worker, then the queue of the other threads. */
+  std::unique_ptr<Queue[]> _queues;
+  uint32_t _queue_count;
+  std::vector<std::thread> _threads;
+
+  /** Number of queued tasks, which workers check before sleeping. */
+  std::atomic<uint32_t> _queued{0};
+  std::atomic<uint32_t> _sleeping{0};
+  std::mutex _sleep_mutex;
+  std::condition_variable _wake;
+  bool _stop = false;
+};
+}  // namespace kn
@@ -0,0 +1,145 @@
+/**************************************************************************/
+/* buffer_plan.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "buffer_plan.hpp"
+#include <algorithm>
+
+namespace kn {
+BufferPlan plan_buffers(const Graph& graph,
+                        std::span<const GraphIndex> outputs,
+                        std::span<const uint8_t> in_place,
+                        std::span<const GraphIndex> groups /*= {}*/) {
+  const GraphIndex node_count = graph.get_node_count();
+  const GraphIndex output_count = graph.get_output_count();
+  // Fused nodes are run by the last node of their group, which reads their inputs.
+  const auto get_reader = [&](GraphIndex node) {
+    return groups.empty() || groups[node] == INVALID_INDEX ? node : groups[node];
+  };
+
+  BufferPlan plan;
+  plan.buffers.assign(output_count, INVALID_INDEX);
+  plan.release_levels.assign(output_count, INVALID_INDEX);
+  plan.in_place.assign(node_count, 0);
+  plan.active.assign(node_count, 0);
+
+  std::vector<uint8_t> kept(output_count, 0);
+  std::vector<GraphIndex> stack;
+  for (const GraphIndex output : outputs) {
+    kept[output] = 1;
+    stack.push_back(graph.get_output_node(output));
+  }
+  std::vector<uint8_t> needed(node_count, 0);
+  while (!stack.empty()) {
+    const GraphIndex node = stack.back();
+    stack.pop_back();
+    if (needed[node] == 0) {
+      needed[node] = 1;
+      stack.push_back(get_reader(node));
+      for (const GraphIndex predecessor : graph.get_predecessors(node)) {
+        stack.push_back(predecessor);
+      }
+    }
+  }
+
+  // Last level reading every output, and how many inputs read it there.
+  std::vector<uint32_t> last_levels(output_count, 0);
+  std::vector<uint32_t> last_reads(output_count, 0);
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    plan.active[node] = needed[node] != 0 && get_reader(node) == node ? 1 : 0;
+    for (const GraphIndex output : graph.get_outputs(node)) {
+      last_levels[output] = graph.get_level(node);
+    }
+  }
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    if (needed[node] == 0) {
+      continue;
+    }
+    const uint32_t level = graph.get_level(get_reader(node));
+    for (const GraphIndex input : graph.get_inputs(node)) {
+      const GraphIndex source = graph.get_source(input);
+      if (source == INVALID_INDEX) {
+        continue;
+      }
+      if (level > last_levels[source]) {
+        last_levels[source] = level;
+        last_reads[source] = 0;
+      }
+      last_reads[source] += level == last_levels[source] ? 1 : 0;
+    }
+  }
+
+  std::vector<std::vector<GraphIndex>> releases(graph.get_level_count());
+  std::vector<uint8_t> taken(output_count, 0);
+  std::vector<GraphIndex> free_buffers;
+  for (uint32_t level = 0; level < graph.get_level_count(); ++level) {
+    for (const GraphIndex node : graph.get_level_nodes(level)) {
+      if (plan.active[node] == 0) {
+        continue;
+      }
+
+      const IndexRange node_outputs = graph.get_outputs(node);
+      const IndexRange inputs = graph.get_inputs(node);
+      const GraphIndex definition = graph.get_definition(node);
+      for (const GraphIndex output : node_outputs) {
+        GraphIndex buffer = INVALID_INDEX;
+        if (output == *node_outputs.begin() && !inputs.empty() && definition < in_place.size() &&
+            in_place[definition] != 0 && get_reader(node) == node) {
+          // The input is overwritten when this node is the last and only one reading it.
+          const GraphIndex source = graph.get_source(*inputs.begin());
+          if (source != INVALID_INDEX && kept[source] == 0 && plan.buffers[source] != INVALID_INDEX &&
+              last_levels[source] == level && last_reads[source] == 1) {
+            buffer = plan.buffers[source];
+            plan.in_place[node] = 1;
+            taken[source] = 1;
+          }
+        }
+        if (buffer == INVALID_INDEX && !free_buffers.empty()) {
+          buffer = free_buffers.back();
+          free_buffers.pop_back();
+        } else if (buffer == INVALID_INDEX) {
+          buffer = plan.buffer_count++;
+        }
+        plan.buffers[output] = buffer;
+        if (kept[output] == 0) {
+          plan.release_levels[output] = last_levels[output];
+          releases[last_levels[output]].push_back(output);
+        }
+      }
+    }
+
+    // Buffers taken over in place stay in use.
+    for (const GraphIndex output : releases[level]) {
+      if (taken[output] == 0) {
+        free_buffers.push_back(plan.buffers[output]);
+      }
+    }
+  }
+  return plan;
+}
+}  // namespace kn
@@ -0,0 +1,70 @@
+/**************************************************************************/
+/* buffer_plan.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "graph.hpp"
+#include "graph_api.hpp"
+
+namespace kn {
+/**
+ * Assignment of the outputs of a graph evaluated level by level to physical buffers. An output lives from the level
+ * of its node to the last level reading it; outputs whose lives do not overlap share a buffer, so the number of
+ * buffers follows the width of the graph rather than its size.
+ */
+struct BufferPlan {
+  /** Buffer every output is written to, INVALID_INDEX for outputs that are not computed. */
+  std::vector<GraphIndex> buffers;
+  /** Level after which every output is not read anymore, INVALID_INDEX for the outputs kept. */
+  std::vector<uint32_t> release_levels;
+  /** Whether the first output of every node is written over its first input. */
+  std::vector<uint8_t> in_place;
+  /** Whether every node runs, being read by the outputs kept and not fused into another node. */
+  std::vector<uint8_t> active;
+  GraphIndex buffer_count = 0;
+};
+
+/**
+ * Plans the buffers of an evaluation, allocating them the way a register allocator does with a linear scan over the
+ * levels: buffers of the outputs read for the last time by a level are free from the next one. A node able to work
+ * in place writes its first output over its first input when it is the only one reading it last.
+ * @param graph The graph to evaluate.
+ * @param outputs The outputs to keep, which give the nodes to run.
+ * @param in_place Whether the nodes of every definition can work in place.
+ * @param groups The fusion group of every node, see find_fusion_groups, or nothing without fusion.
+ * @return The plan.
+ */
+KN_GRAPH_API BufferPlan plan_buffers(const Graph& graph,
+                                     std::span<const GraphIndex> outputs,
+                                     std::span<const uint8_t> in_place,
+                                     std::span<const GraphIndex> groups = {});
+}  // namespace kn
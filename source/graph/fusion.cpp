@@ -0,0 +1,218 @@
+/**************************************************************************/
+/* fusion.cpp                                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "fusion.hpp"
+#include <algorithm>
+#include "kn_assert.hpp"
+#include "log/log.hpp"
+#include "texture_format.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+/** Pixels of a run, whose values for every node of a group fit in the L2 cache. */
+constexpr size_t RUN_SIZE = 1024;
+
+/** Scratch values of the nodes of a group, inputs converted to the format of their port, and inputs of a node. */
+thread_local std::vector<float> t_values;
+thread_local std::vector<float> t_converted;
+thread_local std::vector<const float*> t_inputs;
+}  // namespace
+
+std::vector<GraphIndex> find_fusion_groups(const Graph& graph,
+                                           std::span<const uint8_t> pointwise,
+                                           std::span<const GraphIndex> kept /*= {}*/) {
+  const auto is_pointwise = [&](GraphIndex node) {
+    const GraphIndex definition = graph.get_definition(node);
+    return definition < pointwise.size() && pointwise[definition] != 0 && graph.get_outputs(node).size() == 1;
+  };
+
+  std::vector<uint8_t> kept_nodes(graph.get_node_count(), 0);
+  for (const GraphIndex output : kept) {
+    kept_nodes[graph.get_output_node(output)] = 1;
+  }
+
+  // Readers come after the nodes they read, so walking the order backwards finds the group of the reader first.
+  std::vector<GraphIndex> groups(graph.get_node_count(), INVALID_INDEX);
+  const std::span<const GraphIndex> order = graph.get_topological_order();
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const GraphIndex node = *it;
+    if (!is_pointwise(node)) {
+      continue;
+    }
+    groups[node] = node;
+    const IndexRange edges = graph.get_edges(*graph.get_outputs(node).begin());
+    if (edges.size() == 1 && kept_nodes[node] == 0) {
+      const GraphIndex reader = graph.get_input_node(graph.get_edge_target(*edges.begin()));
+      if (groups[reader] != INVALID_INDEX) {
+        groups[node] = groups[reader];
+      }
+    }
+  }
+  return groups;
+}
+
+TexturePtr run_fused(const Graph& graph,
+                     std::span<const GraphIndex> nodes,
+                     std::span<const PointwiseKernel> kernels,
+                     const Region& region,
+                     const std::function<TexturePtr(GraphIndex input)>& fetch) {
+  if (!ensure(!nodes.empty()) || region.is_empty()) {
+    return nullptr;
+  }
+
+  // Resolves every input of the group once: values of an earlier node, or a texture read from outside, converted
+  // run by run when their format differs from those of the port.
+  const size_t node_count = nodes.size();
+  std::vector<uint32_t> channels(node_count);
+  std::vector<size_t> value_offsets(node_count + 1, 0);
+  std::vector<size_t> first_inputs = {0};
+  std::vector<size_t> input_nodes;
+  std::vector<const float*> input_data;
+  std::vector<uint32_t> input_channels;
+  // Floats from one pixel of an input read from outside to the next, 0 for uniform ones.
+  std::vector<uint32_t> input_steps;
+  // Channels of the values an input is converted from, 0 if it is read as is, and where the converted values go.
+  std::vector<uint32_t> source_channels;
+  std::vector<size_t> converted_offsets;
+  size_t converted_size = 0;
+  std::vector<TexturePtr> textures;
+  for (size_t i = 0; i < node_count; ++i) {
+    const GraphIndex definition = graph.get_definition(nodes[i]);
+    if (!ensure(definition < kernels.size() && kernels[definition].function)) {
+      return nullptr;
+    }
+    uint32_t widest = 0;
+    for (const GraphIndex input : graph.get_inputs(nodes[i])) {
+      const GraphIndex source = graph.get_source(input);
+      const GraphIndex source_node = source == INVALID_INDEX ? INVALID_INDEX : graph.get_output_node(source);
+      const auto member = std::find(nodes.begin(), nodes.begin() + static_cast<ptrdiff_t>(i), source_node);
+      if (source_node != INVALID_INDEX && member != nodes.begin() + static_cast<ptrdiff_t>(i)) {
+        const auto index = static_cast<size_t>(member - nodes.begin());
+        input_nodes.push_back(index);
+        input_data.push_back(nullptr);
+        input_channels.push_back(channels[index]);
+        input_steps.push_back(0);
+      } else {
+        TexturePtr texture = source == INVALID_INDEX ? nullptr : fetch(input);
+        if (texture && (texture->get_width() != region.width || texture->get_height() != region.height)) {
+          KN_LOG(LogGraph, Error, "Input {} of node {} does not cover the region", input, nodes[i]);
+          return nullptr;
+        }
+        // Uniform inputs are converted once.
+        const uint32_t fitted = texture ? fit_channels(texture->get_channels(), graph.get_input_formats(input)) : 0;
+        if (texture && texture->is_uniform() && fitted != texture->get_channels()) {
+          texture = std::make_shared<Texture>(convert_channels(*texture, fitted));
+        }
+        input_nodes.push_back(node_count);
+        input_data.push_back(texture ? texture->get_data() : nullptr);
+        input_channels.push_back(texture ? texture->get_channels() : 0);
+        input_steps.push_back(texture && !texture->is_uniform() ? texture->get_channels() : 0);
+        textures.push_back(std::move(texture));
+      }
+
+      const uint32_t fitted = fit_channels(input_channels.back(), graph.get_input_formats(input));
+      source_channels.push_back(fitted != input_channels.back() ? input_channels.back() : 0);
+      converted_offsets.push_back(converted_size);
+      if (source_channels.back() > 0) {
+        input_channels.back() = fitted;
+        converted_size += RUN_SIZE * fitted;
+      }
+      widest = std::max(widest, input_channels.back());
+    }
+    first_inputs.push_back(input_nodes.size());
+
+    const uint32_t kernel_channels = kernels[definition].channels;
+    channels[i] = kernel_channels > 0 ? kernel_channels : std::max(widest, 1u);
+    // The last node writes to the output directly.
+    value_offsets[i + 1] = value_offsets[i] + (i + 1 < node_count ? RUN_SIZE * channels[i] : 0);
+  }
+
+  const auto run_pixels = [&](size_t first, size_t count, float* output) {
+    t_values.resize(value_offsets.back());
+    t_converted.resize(converted_size);
+    for (size_t i = 0; i < node_count; ++i) {
+      t_inputs.clear();
+      for (size_t input = first_inputs[i]; input < first_inputs[i + 1]; ++input) {
+        const float* data = nullptr;
+        if (input_nodes[input] < node_count) {
+          data = t_values.data() + value_offsets[input_nodes[input]];
+        } else if (input_data[input] != nullptr) {
+          data = input_data[input] + first * input_steps[input];
+        }
+        if (data != nullptr && source_channels[input] > 0) {
+          const uint32_t from = source_channels[input];
+          const uint32_t to = input_channels[input];
+          float* converted = t_converted.data() + converted_offsets[input];
+          convert_pixels(data, from, converted, to, count);
+          data = converted;
+        }
+        t_inputs.push_back(data);
+      }
+      float* values = i + 1 < node_count ? t_values.data() + value_offsets[i] : output;
+      const std::span<const uint32_t> node_channels(input_channels.data() + first_inputs[i],
+                                                    first_inputs[i + 1] - first_inputs[i]);
+      kernels[graph.get_definition(nodes[i])].function(
+          {graph.get_parameters(nodes[i]), t_inputs, node_channels, values, channels[i], count});
+    }
+  };
+
+  // Without varying inputs, the group computes a single pixel standing for all of them.
+  const bool uniform = std::all_of(textures.begin(), textures.end(), [](const TexturePtr& texture) {
+    return !texture || texture->is_uniform();
+  });
+  if (uniform) {
+    std::vector<float> value(channels.back());
+    run_pixels(0, 1, value.data());
+    return std::make_shared<Texture>(Texture::uniform(region.width, region.height, value));
+  }
+
+  // Kernels read runs of pixels, so uniform inputs are repeated over a run, which every run reads.
+  const size_t pixel_count = static_cast<size_t>(region.width) * region.height;
+  std::vector<std::vector<float>> repeated;
+  for (size_t input = 0, texture = 0; input < input_nodes.size(); ++input) {
+    if (input_nodes[input] < node_count || !textures[texture++] || input_steps[input] > 0) {
+      continue;
+    }
+    const uint32_t input_channel_count = input_channels[input];
+    std::vector<float>& values = repeated.emplace_back(std::min(RUN_SIZE, pixel_count) * input_channel_count);
+    for (size_t i = 0; i < values.size(); i += input_channel_count) {
+      std::copy_n(input_data[input], input_channel_count, values.data() + i);
+    }
+    input_data[input] = values.data();
+  }
+
+  auto output = std::make_shared<Texture>(region.width, region.height, channels.back());
+  parallel_for(0, (pixel_count + RUN_SIZE - 1) / RUN_SIZE, [&](size_t run) {
+    const size_t first = run * RUN_SIZE;
+    run_pixels(first, std::min(RUN_SIZE, pixel_count - first), output->get_data() + first * channels.back());
+  });
+  return output;
+}
+}  // namespace kn
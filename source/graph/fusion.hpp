@@ -0,0 +1,101 @@
+/**************************************************************************/
+/* fusion.hpp                                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+#include "graph.hpp"
+#include "graph_api.hpp"
+#include "output_cache.hpp"
+#include "region.hpp"
+
+namespace kn {
+/** What a point-wise kernel reads and writes: a run of consecutive pixels of its inputs and output. */
+struct PixelContext {
+  std::span<const ParameterValue> parameters;
+  /** First pixel of the run in every input, null when the input is not connected. */
+  std::span<const float* const> inputs;
+  /**
+   * Interleaved channels of every input, 0 when the input is not connected. Inputs have a format their port accepts,
+   * so kernels may specialize on it with dispatch_channels.
+   */
+  std::span<const uint32_t> input_channels;
+  float* output;
+  uint32_t channels;
+  /** Pixels of the run, which need not be a multiple of the SIMD width. */
+  size_t count;
+};
+
+/**
+ * Kernel of a node whose output pixels only depend on the input pixels at the same position, like blends, levels or
+ * inversions. Such nodes have a single output and read the region they compute.
+ */
+struct PointwiseKernel {
+  std::function<void(const PixelContext&)> function;
+  /** Channels of the output, 0 for those of the input with the most channels, or 1 without inputs. */
+  uint32_t channels = 0;
+};
+
+/**
+ * Groups point-wise nodes so that each group runs as one kernel. A point-wise node joins the group of the node
+ * reading its output if that node is point-wise too and is the only one reading it, so that its output is never
+ * needed on its own; groups are trees of chains, each computing the output of its last node.
+ * @param graph The graph to compile.
+ * @param pointwise Whether the nodes of every definition are point-wise.
+ * @param kept Output ports that are needed on their own, whose node ends its group.
+ * @return The last node of the group of every node, INVALID_INDEX for nodes that are not point-wise.
+ */
+KN_GRAPH_API std::vector<GraphIndex> find_fusion_groups(const Graph& graph,
+                                                        std::span<const uint8_t> pointwise,
+                                                        std::span<const GraphIndex> kept = {});
+
+/**
+ * Computes the output of a group of point-wise nodes over a region in a single pass. The region is split into runs
+ * small enough for the values of every node of the group to stay in the cache of the core: each run goes through
+ * the kernels of the nodes in order, the output of one feeding the next, and only the last one is written to memory.
+ * Values read by a port that does not accept their format are converted within the run, see fit_channels.
+ * A group whose inputs are all uniform textures, or that has none, computes a single pixel and returns a uniform
+ * texture, so that constant parts of a graph cost the same at any resolution.
+ * @param graph The graph holding the group.
+ * @param nodes The nodes of the group, in topological order.
+ * @param kernels The kernel of every definition.
+ * @param region The region to compute.
+ * @param fetch Returns the texture covering the region connected to an input port read from outside the group.
+ * @return The output of the last node, or null if an input does not cover the region.
+ */
+KN_GRAPH_API TexturePtr run_fused(const Graph& graph,
+                                  std::span<const GraphIndex> nodes,
+                                  std::span<const PointwiseKernel> kernels,
+                                  const Region& region,
+                                  const std::function<TexturePtr(GraphIndex input)>& fetch);
+}  // namespace kn
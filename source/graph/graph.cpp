@@ -0,0 +1,340 @@
+/**************************************************************************/
+/* graph.cpp                                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "graph.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "kn_assert.hpp"
+#include "log/log.hpp"
+#include "schema_reader.hpp"
+
+namespace kn {
+GraphIndex Graph::find_node(std::string_view name) const {
+  const auto it = _node_indices.find(std::string(name));
+  return it == _node_indices.end() ? INVALID_INDEX : it->second;
+}
+
+bool Graph::set_parameter(GraphIndex node, GraphIndex parameter, ParameterValue value) {
+  if (!ensure(node < get_node_count() && parameter < _first_parameters[node + 1] - _first_parameters[node])) {
+    return false;
+  }
+
+  ParameterValue& current = _parameters[_first_parameters[node] + parameter];
+  if (value.index() != current.index()) {
+    return false;
+  }
+  current = std::move(value);
+  return true;
+}
+
+GraphIndex GraphBuilder::add_node(GraphIndex definition, std::string name /*= {}*/) {
+  if (!ensure(definition < _library.get_size())) {
+    return INVALID_INDEX;
+  }
+
+  const NodeDefinition& node_definition = _library.get(definition);
+  std::vector<ParameterValue> parameters;
+  parameters.reserve(node_definition.parameters.size());
+  for (const ParameterDefinition& parameter : node_definition.parameters) {
+    parameters.push_back(parameter.default_value);
+  }
+
+  _definitions.push_back(definition);
+  _names.push_back(std::move(name));
+  _parameters.push_back(std::move(parameters));
+  return get_node_count() - 1;
+}
+
+bool GraphBuilder::set_parameter(GraphIndex node, std::string_view parameter_id, ParameterValue value) {
+  if (!ensure(node < get_node_count())) {
+    return false;
+  }
+
+  const NodeDefinition& definition = _library.get(_definitions[node]);
+  const GraphIndex parameter = definition.find_parameter(parameter_id);
+  if (parameter == INVALID_INDEX) {
+    KN_LOG(LogGraph, Error, "Node type {} has no parameter {}", definition.id, parameter_id);
+    return false;
+  }
+  if (value.index() != _parameters[node][parameter].index()) {
+    KN_LOG(LogGraph, Error, "Invalid value type for parameter {} of node type {}", parameter_id, definition.id);
+    return false;
+  }
+  _parameters[node][parameter] = std::move(value);
+  return true;
+}
+
+bool GraphBuilder::connect(GraphIndex source,
+                           std::string_view output_id,
+                           GraphIndex target,
+                           std::string_view input_id) {
+  if (!ensure(source < get_node_count() && target < get_node_count())) {
+    return false;
+  }
+
+  const NodeDefinition& source_definition = _library.get(_definitions[source]);
+  const NodeDefinition& target_definition = _library.get(_definitions[target]);
+  const GraphIndex output = source_definition.find_output(output_id);
+  const GraphIndex input = target_definition.find_input(input_id);
+  if (output == INVALID_INDEX || input == INVALID_INDEX) {
+    KN_LOG(LogGraph, Error, "Cannot connect {}.{} to {}.{}", source_definition.id, output_id, target_definition.id,
+           input_id);
+    return false;
+  }
+  return connect(source, output, target, input);
+}
+
+bool GraphBuilder::connect(GraphIndex source, GraphIndex output, GraphIndex target, GraphIndex input) {
+  if (!ensure(source < get_node_count() && target < get_node_count())) {
+    return false;
+  }
+
+  if (output >= _library.get(_definitions[source]).outputs.size() ||
+      input >= _library.get(_definitions[target]).inputs.size()) {
+    KN_LOG(LogGraph, Error, "Cannot connect output {} of node {} to input {} of node {}", output, source, input,
+           target);
+    return false;
+  }
+  _connections.push_back({source, output, target, input});
+  return true;
+}
+
+std::optional<Graph> GraphBuilder::build() const {
+  const GraphIndex node_count = get_node_count();
+  Graph graph;
+  graph._node_definitions = _definitions;
+  graph._node_names = _names;
+  graph._definition_ids.reserve(_library.get_size());
+  for (GraphIndex definition = 0; definition < _library.get_size(); ++definition) {
+    graph._definition_ids.push_back(_library.get(definition).id);
+  }
+
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    if (!_names[node].empty() && !graph._node_indices.emplace(_names[node], node).second) {
+      KN_LOG(LogGraph, Error, "Duplicate node name: {}", _names[node]);
+      return std::nullopt;
+    }
+  }
+
+  // Ports and parameters of a node are consecutive, in the order of its definition.
+  graph._first_inputs.resize(node_count + 1, 0);
+  graph._first_outputs.resize(node_count + 1, 0);
+  graph._first_parameters.resize(node_count + 1, 0);
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    const NodeDefinition& definition = _library.get(_definitions[node]);
+    graph._first_inputs[node + 1] = graph._first_inputs[node] + static_cast<GraphIndex>(definition.inputs.size());
+    graph._first_outputs[node + 1] = graph._first_outputs[node] + static_cast<GraphIndex>(definition.outputs.size());
+    graph._first_parameters[node + 1] =
+        graph._first_parameters[node] + static_cast<GraphIndex>(_parameters[node].size());
+  }
+
+  graph._input_nodes.resize(graph._first_inputs[node_count]);
+  graph._output_nodes.resize(graph._first_outputs[node_count]);
+  graph._input_formats.reserve(graph._first_inputs[node_count]);
+  graph._parameters.reserve(graph._first_parameters[node_count]);
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    std::fill(graph._input_nodes.begin() + graph._first_inputs[node],
+              graph._input_nodes.begin() + graph._first_inputs[node + 1], node);
+    for (const InputDefinition& input : _library.get(_definitions[node]).inputs) {
+      graph._input_formats.push_back(input.formats);
+    }
+    std::fill(graph._output_nodes.begin() + graph._first_outputs[node],
+              graph._output_nodes.begin() + graph._first_outputs[node + 1], node);
+    graph._parameters.insert(graph._parameters.end(), _parameters[node].begin(), _parameters[node].end());
+  }
+
+  // Later connections of an input replace the earlier ones.
+  graph._input_sources.assign(graph._input_nodes.size(), INVALID_INDEX);
+  for (const Connection& connection : _connections) {
+    graph._input_sources[graph._first_inputs[connection.target] + connection.input] =
+        graph._first_outputs[connection.source] + connection.output;
+  }
+
+  // Edges are counting sorted by output port, then by input port.
+  const GraphIndex output_count = graph.get_output_count();
+  graph._first_edges.assign(output_count + 1, 0);
+  for (const GraphIndex source : graph._input_sources) {
+    if (source != INVALID_INDEX) {
+      ++graph._first_edges[source + 1];
+    }
+  }
+  for (GraphIndex output = 0; output < output_count; ++output) {
+    graph._first_edges[output + 1] += graph._first_edges[output];
+  }
+  graph._edge_sources.resize(graph._first_edges[output_count]);
+  graph._edge_targets.resize(graph._first_edges[output_count]);
+  std::vector<GraphIndex> cursors(graph._first_edges.begin(), graph._first_edges.end() - 1);
+  for (GraphIndex input = 0; input < graph.get_input_count(); ++input) {
+    const GraphIndex source = graph._input_sources[input];
+    if (source != INVALID_INDEX) {
+      const GraphIndex edge = cursors[source]++;
+      graph._edge_sources[edge] = source;
+      graph._edge_targets[edge] = input;
+    }
+  }
+
+  // Successors of a node are the distinct nodes its edges reach; predecessors are their transpose.
+  graph._successor_offsets.resize(node_count + 1, 0);
+  graph._successors.reserve(graph.get_edge_count());
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    const size_t first = graph._successors.size();
+    for (GraphIndex edge = graph._first_edges[graph._first_outputs[node]];
+         edge < graph._first_edges[graph._first_outputs[node + 1]]; ++edge) {
+      graph._successors.push_back(graph._input_nodes[graph._edge_targets[edge]]);
+    }
+    std::sort(graph._successors.begin() + first, graph._successors.end());
+    graph._successors.erase(std::unique(graph._successors.begin() + first, graph._successors.end()),
+                            graph._successors.end());
+    graph._successor_offsets[node + 1] = static_cast<GraphIndex>(graph._successors.size());
+  }
+
+  graph._predecessor_offsets.assign(node_count + 1, 0);
+  for (const GraphIndex successor : graph._successors) {
+    ++graph._predecessor_offsets[successor + 1];
+  }
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    graph._predecessor_offsets[node + 1] += graph._predecessor_offsets[node];
+  }
+  graph._predecessors.resize(graph._successors.size());
+  cursors.assign(graph._predecessor_offsets.begin(), graph._predecessor_offsets.end() - 1);
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    for (const GraphIndex successor : graph.get_successors(node)) {
+      graph._predecessors[cursors[successor]++] = node;
+    }
+  }
+
+  // Kahn's algorithm, computing the level of every node as the nodes it reads are visited.
+  std::vector<GraphIndex> pending(node_count);
+  std::vector<GraphIndex> queue;
+  queue.reserve(node_count);
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    pending[node] = graph._predecessor_offsets[node + 1] - graph._predecessor_offsets[node];
+    if (pending[node] == 0) {
+      queue.push_back(node);
+    }
+  }
+  graph._levels.assign(node_count, 0);
+  for (size_t head = 0; head < queue.size(); ++head) {
+    const GraphIndex node = queue[head];
+    for (const GraphIndex successor : graph.get_successors(node)) {
+      graph._levels[successor] = std::max(graph._levels[successor], graph._levels[node] + 1);
+      if (--pending[successor] == 0) {
+        queue.push_back(successor);
+      }
+    }
+  }
+  if (queue.size() != node_count) {
+    KN_LOG(LogGraph, Error, "The graph has a cycle through {} nodes", node_count - queue.size());
+    return std::nullopt;
+  }
+
+  // Counting sort by level, keeping nodes of a level in increasing order.
+  const uint32_t level_count = node_count > 0 ? *std::max_element(graph._levels.begin(), graph._levels.end()) + 1 : 0;
+  graph._level_offsets.assign(level_count + 1, 0);
+  for (const uint32_t level : graph._levels) {
+    ++graph._level_offsets[level + 1];
+  }
+  for (uint32_t level = 0; level < level_count; ++level) {
+    graph._level_offsets[level + 1] += graph._level_offsets[level];
+  }
+  graph._order.resize(node_count);
+  cursors.assign(graph._level_offsets.begin(), graph._level_offsets.end() - 1);
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    graph._order[cursors[graph._levels[node]]++] = node;
+  }
+
+  return graph;
+}
+
+std::optional<Graph> parse_graph(std::string_view text, const NodeLibrary& library) {
+  using namespace schema;
+  try {
+    const YAML::Node root = YAML::Load(std::string(text));
+    if (!root.IsMap()) {
+      throw SchemaError("the document is not an object");
+    }
+
+    GraphBuilder builder(library);
+    std::unordered_map<std::string, GraphIndex> nodes;
+    for (const YAML::Node& node : require(root, "nodes")) {
+      const std::string id = require(node, "id").as<std::string>();
+      const std::string type = require(node, "type").as<std::string>();
+      const GraphIndex definition = library.find(type);
+      if (definition == INVALID_INDEX) {
+        throw SchemaError(fmt::format("unknown node type '{}'", type));
+      }
+      const GraphIndex index = builder.add_node(definition, id);
+      if (!nodes.emplace(id, index).second) {
+        throw SchemaError(fmt::format("duplicate node '{}'", id));
+      }
+
+      const NodeDefinition& node_definition = library.get(definition);
+      const YAML::Node parameters = node["parameters"];
+      for (const auto& entry : parameters ? parameters : YAML::Node(YAML::NodeType::Map)) {
+        const std::string parameter_id = entry.first.as<std::string>();
+        const GraphIndex parameter = node_definition.find_parameter(parameter_id);
+        if (parameter == INVALID_INDEX) {
+          throw SchemaError(fmt::format("unknown parameter '{}' of node '{}'", parameter_id, id));
+        }
+        builder.set_parameter(index, parameter_id,
+                              read_parameter_value(entry.second, node_definition.parameters[parameter]));
+      }
+    }
+
+    const YAML::Node edges = root["edges"];
+    for (const YAML::Node& edge : edges ? edges : YAML::Node(YAML::NodeType::Sequence)) {
+      const auto source = nodes.find(require(edge, "from").as<std::string>());
+      const auto target = nodes.find(require(edge, "to").as<std::string>());
+      if (source == nodes.end() || target == nodes.end()) {
+        throw SchemaError("edge between unknown nodes");
+      }
+      if (!builder.connect(source->second, require(edge, "output").as<std::string>(), target->second,
+                           require(edge, "input").as<std::string>())) {
+        throw SchemaError(fmt::format("invalid edge from '{}' to '{}'", source->first, target->first));
+      }
+    }
+    return builder.build();
+  } catch (const std::exception& e) {
+    KN_LOG(LogGraph, Error, "Invalid graph: {}", e.what());
+    return std::nullopt;
+  }
+}
+
+std::optional<Graph> load_graph(const std::filesystem::path& file_path, const NodeLibrary& library) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    KN_LOG(LogGraph, Error, "Failed to open file: {}", file_path.string());
+    return std::nullopt;
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+  return parse_graph(text.str(), library);
+}
+}  // namespace kn
@@ -0,0 +1,236 @@
+/**************************************************************************/
+/* graph.hpp                                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "graph_api.hpp"
+#include "node_definition.hpp"
+#include "node_library.hpp"
+
+namespace kn {
+/** Consecutive indices, such as the ports of a node. */
+using IndexRange = std::ranges::iota_view<GraphIndex, GraphIndex>;
+
+/**
+ * Graph of node instances, stored as structure-of-arrays tables addressed by 32-bit indices. The ports of a node
+ * are consecutive in the input and output tables, the edges of an output port are consecutive in the edge table,
+ * and the adjacency between nodes is kept in compressed sparse rows, so traversals only read contiguous arrays.
+ * GraphBuilder creates the graph; its topology is immutable, only parameter values can change.
+ */
+class KN_GRAPH_API Graph {
+ public:
+  [[nodiscard]] inline GraphIndex get_node_count() const { return static_cast<GraphIndex>(_node_definitions.size()); }
+  [[nodiscard]] inline GraphIndex get_input_count() const { return static_cast<GraphIndex>(_input_nodes.size()); }
+  [[nodiscard]] inline GraphIndex get_output_count() const { return static_cast<GraphIndex>(_output_nodes.size()); }
+  [[nodiscard]] inline GraphIndex get_edge_count() const { return static_cast<GraphIndex>(_edge_targets.size()); }
+
+  /** Returns the index of the definition of a node in the library the graph was built with. */
+  [[nodiscard]] inline GraphIndex get_definition(GraphIndex node) const { return _node_definitions[node]; }
+
+  /** Returns the id of the definition of a node, which unlike its index does not depend on the library. */
+  [[nodiscard]] inline const std::string& get_definition_id(GraphIndex node) const {
+    return _definition_ids[_node_definitions[node]];
+  }
+
+  [[nodiscard]] inline const std::string& get_name(GraphIndex node) const { return _node_names[node]; }
+
+  /** Returns the node with the given name, INVALID_INDEX if there is none. */
+  [[nodiscard]] GraphIndex find_node(std::string_view name) const;
+
+  /** Returns the input ports of a node, in the order of its definition. */
+  [[nodiscard]] inline IndexRange get_inputs(GraphIndex node) const {
+    return IndexRange(_first_inputs[node], _first_inputs[node + 1]);
+  }
+
+  /** Returns the output ports of a node, in the order of its definition. */
+  [[nodiscard]] inline IndexRange get_outputs(GraphIndex node) const {
+    return IndexRange(_first_outputs[node], _first_outputs[node + 1]);
+  }
+
+  [[nodiscard]] inline GraphIndex get_input_node(GraphIndex input) const { return _input_nodes[input]; }
+  [[nodiscard]] inline GraphIndex get_output_node(GraphIndex output) const { return _output_nodes[output]; }
+
+  /** Returns the formats an input port accepts, 0 if it accepts any. */
+  [[nodiscard]] inline PortFormats get_input_formats(GraphIndex input) const { return _input_formats[input]; }
+
+  /** Returns the output port connected to an input port, INVALID_INDEX if it is not connected. */
+  [[nodiscard]] inline GraphIndex get_source(GraphIndex input) const { return _input_sources[input]; }
+
+  /** Returns the edges leaving an output port. */
+  [[nodiscard]] inline IndexRange get_edges(GraphIndex output) const {
+    return IndexRange(_first_edges[output], _first_edges[output + 1]);
+  }
+
+  [[nodiscard]] inline GraphIndex get_edge_source(GraphIndex edge) const { return _edge_sources[edge]; }
+  [[nodiscard]] inline GraphIndex get_edge_target(GraphIndex edge) const { return _edge_targets[edge]; }
+
+  /** Returns the parameter values of a node, in the order of its definition. */
+  [[nodiscard]] inline std::span<const ParameterValue> get_parameters(GraphIndex node) const {
+    return {_parameters.data() + _first_parameters[node], _parameters.data() + _first_parameters[node + 1]};
+  }
+
+  /**
+   * Sets a parameter of a node.
+   * @param node The node.
+   * @param parameter The position of the parameter in the definition of the node.
+   * @param value The value, of the type of the current one.
+   * @return True if the value was set, false if its type does not match.
+   */
+  bool set_parameter(GraphIndex node, GraphIndex parameter, ParameterValue value);
+
+  /** Returns the distinct nodes reading an output of a node, in increasing order. */
+  [[nodiscard]] inline std::span<const GraphIndex> get_successors(GraphIndex node) const {
+    return {_successors.data() + _successor_offsets[node], _successors.data() + _successor_offsets[node + 1]};
+  }
+
+  /** Returns the distinct nodes an input of a node reads, in increasing order. */
+  [[nodiscard]] inline std::span<const GraphIndex> get_predecessors(GraphIndex node) const {
+    return {_predecessors.data() + _predecessor_offsets[node], _predecessors.data() + _predecessor_offsets[node + 1]};
+  }
+
+  /**
+   * Returns every node after the nodes it reads, sorted by level, so that the nodes of a level are consecutive and
+   * independent of each other.
+   */
+  [[nodiscard]] inline std::span<const GraphIndex> get_topological_order() const { return _order; }
+
+  /** Returns the length of the longest path from a node without inputs to a node. */
+  [[nodiscard]] inline uint32_t get_level(GraphIndex node) const { return _levels[node]; }
+
+  [[nodiscard]] inline uint32_t get_level_count() const {
+    return static_cast<uint32_t>(_level_offsets.size()) - 1;
+  }
+
+  /** Returns the nodes of a level, which can be evaluated in parallel once the previous levels are. */
+  [[nodiscard]] inline std::span<const GraphIndex> get_level_nodes(uint32_t level) const {
+    return {_order.data() + _level_offsets[level], _order.data() + _level_offsets[level + 1]};
+  }
+
+ private:
+  friend class GraphBuilder;
+
+  // Nodes; the offset tables hold one more entry than there are nodes.
+  std::vector<GraphIndex> _node_definitions;
+  std::vector<std::string> _node_names;
+  std::vector<GraphIndex> _first_inputs;
+  std::vector<GraphIndex> _first_outputs;
+  std::vector<GraphIndex> _first_parameters;
+  std::unordered_map<std::string, GraphIndex> _node_indices;
+  /** Ids of the definitions of the library, by index. */
+  std::vector<std::string> _definition_ids;
+
+  // Ports.
+  std::vector<GraphIndex> _input_nodes;
+  std::vector<GraphIndex> _input_sources;
+  std::vector<PortFormats> _input_formats;
+  std::vector<GraphIndex> _output_nodes;
+  std::vector<GraphIndex> _first_edges;
+
+  // Edges, sorted by output port.
+  std::vector<GraphIndex> _edge_sources;
+  std::vector<GraphIndex> _edge_targets;
+
+  std::vector<ParameterValue> _parameters;
+
+  // Adjacency, in compressed sparse rows.
+  std::vector<GraphIndex> _successor_offsets;
+  std::vector<GraphIndex> _successors;
+  std::vector<GraphIndex> _predecessor_offsets;
+  std::vector<GraphIndex> _predecessors;
+
+  // Schedule.
+  std::vector<GraphIndex> _order;
+  std::vector<uint32_t> _levels;
+  std::vector<GraphIndex> _level_offsets;
+};
+
+/** Collects nodes, parameters and connections, then lays them out into a Graph. */
+class KN_GRAPH_API GraphBuilder {
+ public:
+  explicit GraphBuilder(const NodeLibrary& library) : _library(library) {}
+
+  /**
+   * Adds an instance of a node definition, its parameters set to their defaults.
+   * @param definition The index of the definition in the library.
+   * @param name A name unique in the graph to look the node up, or empty.
+   * @return The index of the node.
+   */
+  GraphIndex add_node(GraphIndex definition, std::string name = {});
+
+  /** Sets a parameter of a node; the value must have the type of the default value of the parameter. */
+  bool set_parameter(GraphIndex node, std::string_view parameter_id, ParameterValue value);
+
+  /**
+   * Connects an output of a node to an input of another one, replacing the previous connection of the input.
+   * @return True if both nodes have the given ports, false otherwise.
+   */
+  bool connect(GraphIndex source, std::string_view output_id, GraphIndex target, std::string_view input_id);
+
+  /** Connects ports given by their position in the definitions of the nodes. */
+  bool connect(GraphIndex source, GraphIndex output, GraphIndex target, GraphIndex input);
+
+  [[nodiscard]] inline GraphIndex get_node_count() const { return static_cast<GraphIndex>(_definitions.size()); }
+
+  /** Lays out the graph, or returns nothing if its connections form a cycle. */
+  [[nodiscard]] std::optional<Graph> build() const;
+
+ private:
+  struct Connection {
+    GraphIndex source;
+    GraphIndex output;
+    GraphIndex target;
+    GraphIndex input;
+  };
+
+  const NodeLibrary& _library;
+  std::vector<GraphIndex> _definitions;
+  std::vector<std::string> _names;
+  std::vector<std::vector<ParameterValue>> _parameters;
+  std::vector<Connection> _connections;
+};
+
+/**
+ * Parses a graph instance, as described by misc/schema/types/Graph.json, against the definitions of a library.
+ * @param text The JSON document.
+ * @param library The definitions of the nodes, looked up by id.
+ * @return The graph, or nothing if the document is invalid or its connections form a cycle.
+ */
+KN_GRAPH_API std::optional<Graph> parse_graph(std::string_view text, const NodeLibrary& library);
+
+/** Loads a graph instance from a JSON file. */
+KN_GRAPH_API std::optional<Graph> load_graph(const std::filesystem::path& file_path, const NodeLibrary& library);
+}  // namespace kn
@@ -0,0 +1,697 @@
+/**************************************************************************/
+/* graph_evaluator.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "graph_evaluator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <utility>
+#include "graph_scheduler.hpp"
+#include "kn_assert.hpp"
+#include "log/log.hpp"
+#include "texture_format.hpp"
+
+namespace kn {
+namespace {
+/** Copies an area both regions contain from a texture covering one region to a texture covering the other. */
+void copy_area(const Texture& src,
+               const Region& src_region,
+               Texture& dst,
+               const Region& dst_region,
+               const Region& area) {
+  const uint32_t channels = src.get_channels();
+  if (src.is_uniform()) {
+    for (int32_t y = area.y; y < area.get_bottom(); ++y) {
+      float* to = dst.get_data() + (static_cast<size_t>(y - dst_region.y) * dst_region.width +
+                                    static_cast<size_t>(area.x - dst_region.x)) * channels;
+      for (uint32_t x = 0; x < area.width; ++x) {
+        std::copy_n(src.get_data(), channels, to + static_cast<size_t>(x) * channels);
+      }
+    }
+    return;
+  }
+  for (int32_t y = area.y; y < area.get_bottom(); ++y) {
+    const float* from = src.get_data() + (static_cast<size_t>(y - src_region.y) * src_region.width +
+                                          static_cast<size_t>(area.x - src_region.x)) * channels;
+    float* to = dst.get_data() + (static_cast<size_t>(y - dst_region.y) * dst_region.width +
+                                  static_cast<size_t>(area.x - dst_region.x)) * channels;
+    std::copy_n(from, static_cast<size_t>(area.width) * channels, to);
+  }
+}
+
+/** Returns the part of a texture covering src_region that covers dst_region. */
+TexturePtr crop(const TexturePtr& src, const Region& src_region, const Region& dst_region) {
+  if (!src || dst_region.is_empty() || src_region == dst_region) {
+    return dst_region.is_empty() ? nullptr : src;
+  }
+  if (!ensure(src_region.contains(dst_region))) {
+    return nullptr;
+  }
+  if (src->is_uniform()) {
+    return std::make_shared<Texture>(
+        Texture::uniform(dst_region.width, dst_region.height, {src->get_data(), src->get_channels()}));
+  }
+  auto texture = std::make_shared<Texture>(dst_region.width, dst_region.height, src->get_channels());
+  copy_area(*src, src_region, *texture, dst_region, dst_region);
+  return texture;
+}
+
+/** Returns a texture whose pixels can be viewed: a materialized copy of a uniform texture, others as they are. */
+TexturePtr materialized(const TexturePtr& texture) {
+  if (!texture || !texture->is_uniform()) {
+    return texture;
+  }
+  auto copy = std::make_shared<Texture>(*texture);
+  copy->materialize();
+  return copy;
+}
+}  // namespace
+
+GraphEvaluator::GraphEvaluator(Graph& graph, OutputCache& cache /*= *OutputCache::get_instance()*/)
+    : _graph(graph),
+      _cache(cache),
+      _dirty(graph.get_node_count(), 1),
+      _versions(graph.get_node_count(), 0),
+      _keys(graph.get_node_count(), 0),
+      _salts(graph.get_node_count(), 0),
+      _groups(graph.get_node_count(), INVALID_INDEX),
+      _members(graph.get_node_count()),
+      _outputs(graph.get_output_count()) {}
+
+void GraphEvaluator::set_kernel(GraphIndex definition, NodeKernel kernel, std::string_view version /*= {}*/) {
+  if (definition >= _kernels.size()) {
+    _kernels.resize(definition + 1);
+  }
+  _kernels[definition] = std::move(kernel);
+  set_kernel_hash(definition, version);
+  if (definition < _pointwise.size() && _pointwise[definition].function) {
+    _pointwise[definition] = {};
+    update_fusion();
+  }
+
+  for (GraphIndex node = 0; node < _graph.get_node_count(); ++node) {
+    if (_graph.get_definition(node) == definition) {
+      mark_dirty(node);
+    }
+  }
+}
+
+void GraphEvaluator::set_pointwise_kernel(GraphIndex definition,
+                                          PointwiseKernel kernel,
+                                          std::string_view version /*= {}*/) {
+  if (definition >= _pointwise.size()) {
+    _pointwise.resize(definition + 1);
+  }
+  _pointwise[definition] = std::move(kernel);
+  if (definition < _kernels.size()) {
+    _kernels[definition] = nullptr;
+  }
+  set_kernel_hash(definition, version);
+  update_fusion();
+}
+
+void GraphEvaluator::set_fusion(bool enabled) {
+  if (enabled != _fusion) {
+    _fusion = enabled;
+    update_fusion();
+  }
+}
+
+void GraphEvaluator::set_in_place(GraphIndex definition, bool in_place) {
+  if (definition >= _in_place.size()) {
+    _in_place.resize(definition + 1, 0);
+  }
+  _in_place[definition] = in_place ? 1 : 0;
+}
+
+void GraphEvaluator::set_uniform_inputs(GraphIndex definition, bool accepted) {
+  if (definition >= _uniform_inputs.size()) {
+    _uniform_inputs.resize(definition + 1, 0);
+  }
+  _uniform_inputs[definition] = accepted ? 1 : 0;
+}
+
+void GraphEvaluator::set_footprint(GraphIndex definition, NodeFootprint footprint) {
+  if (definition >= _footprints.size()) {
+    _footprints.resize(definition + 1);
+  }
+  _footprints[definition] = std::move(footprint);
+}
+
+void GraphEvaluator::set_resolution(uint32_t width, uint32_t height) {
+  if (width == _width && height == _height) {
+    return;
+  }
+  _width = width;
+  _height = height;
+  for (GraphIndex node = 0; node < _graph.get_node_count(); ++node) {
+    mark_dirty(node);
+  }
+}
+
+bool GraphEvaluator::set_parameter(GraphIndex node, GraphIndex parameter, ParameterValue value) {
+  if (!ensure(node < _graph.get_node_count() && parameter < _graph.get_parameters(node).size())) {
+    return false;
+  }
+  if (_graph.get_parameters(node)[parameter] == value) {
+    return true;
+  }
+  if (!_graph.set_parameter(node, parameter, std::move(value))) {
+    return false;
+  }
+  mark_dirty(node);
+  return true;
+}
+
+void GraphEvaluator::invalidate(GraphIndex node) {
+  if (!ensure(node < _graph.get_node_count())) {
+    return;
+  }
+  _cache.invalidate(hash_state(node, _keys));
+  ++_salts[node];
+  mark_dirty(node);
+}
+
+EvaluationStats GraphEvaluator::evaluate(TaskScheduler& scheduler /*= *TaskScheduler::get_instance()*/) {
+  std::vector<GraphIndex> nodes;
+  for (const GraphIndex node : _graph.get_topological_order()) {
+    if (_dirty[node]) {
+      nodes.push_back(node);
+    }
+  }
+
+  std::atomic<uint32_t> evaluated{0};
+  std::atomic<uint32_t> cached{0};
+  std::atomic<uint32_t> fused{0};
+  run_graph(
+      _graph, nodes,
+      [&](GraphIndex node) {
+        EvaluationStats stats;
+        evaluate_node(node, stats);
+        evaluated.fetch_add(stats.evaluated, std::memory_order_relaxed);
+        cached.fetch_add(stats.cached, std::memory_order_relaxed);
+        fused.fetch_add(stats.fused, std::memory_order_relaxed);
+      },
+      scheduler);
+  return {evaluated.load(), cached.load(), fused.load()};
+}
+
+void GraphEvaluator::mark_dirty(GraphIndex node) {
+  // Nodes downstream of a dirty node are dirty too, so the walk stops at dirty nodes.
+  std::vector<GraphIndex> stack = {node};
+  while (!stack.empty()) {
+    const GraphIndex current = stack.back();
+    stack.pop_back();
+    if (_dirty[current]) {
+      continue;
+    }
+    _dirty[current] = 1;
+    for (const GraphIndex successor : _graph.get_successors(current)) {
+      stack.push_back(successor);
+    }
+  }
+}
+
+void GraphEvaluator::set_kernel_hash(GraphIndex definition, std::string_view version) {
+  static std::atomic<uint64_t> serial{0};
+  if (definition >= _kernel_hashes.size()) {
+    _kernel_hashes.resize(definition + 1, 0);
+  }
+  // Versions and serials hash apart, so that no version stands for a kernel set without one.
+  _kernel_hashes[definition] = version.empty() ? hash_combine(HASH_SEED, serial.fetch_add(1) + 1)
+                                               : hash_combine(std::hash<std::string_view>{}(version), 0);
+}
+
+uint64_t GraphEvaluator::hash_node(GraphIndex node, std::span<const uint64_t> keys) const {
+  // The salt of the evaluator covers every state of an invalidated node, that of the cache the invalidated state in
+  // every evaluator.
+  const uint64_t key = hash_state(node, keys);
+  return hash_combine(hash_combine(key, _salts[node]), _cache.get_salt(key));
+}
+
+uint64_t GraphEvaluator::hash_state(GraphIndex node, std::span<const uint64_t> keys) const {
+  const GraphIndex definition = _graph.get_definition(node);
+  uint64_t key = hash_combine(hash_combine(HASH_SEED, _width), _height);
+  key = hash_combine(key, std::hash<std::string>{}(_graph.get_definition_id(node)));
+  key = hash_combine(key, definition < _kernel_hashes.size() ? _kernel_hashes[definition] : 0);
+  for (const ParameterValue& value : _graph.get_parameters(node)) {
+    key = hash_combine(key, hash_value(value));
+  }
+
+  // The hash of an output stands for its content: the hash of its node and its position.
+  for (const GraphIndex input : _graph.get_inputs(node)) {
+    const GraphIndex source = _graph.get_source(input);
+    if (source == INVALID_INDEX) {
+      key = hash_combine(key, 0);
+    } else {
+      const GraphIndex source_node = _graph.get_output_node(source);
+      key = hash_combine(key, hash_combine(keys[source_node], source - *_graph.get_outputs(source_node).begin()));
+    }
+  }
+  return key;
+}
+
+Region GraphEvaluator::get_footprint(const NodeContext& context, GraphIndex input) const {
+  const GraphIndex definition = _graph.get_definition(context.node);
+  if (definition < _footprints.size() && _footprints[definition]) {
+    return _footprints[definition](context, input);
+  }
+  return context.region;
+}
+
+std::vector<TexturePtr> GraphEvaluator::run_kernel(const NodeContext& context,
+                                                   std::span<const GraphIndex> members,
+                                                   const std::function<TexturePtr(GraphIndex input)>& fetch) const {
+  std::vector<TexturePtr> values(_graph.get_outputs(context.node).size());
+  const GraphIndex definition = _graph.get_definition(context.node);
+  if (!members.empty()) {
+    values[0] = run_fused(_graph, members, _pointwise, context.region, fetch);
+  } else if (definition < _kernels.size() && _kernels[definition]) {
+    // Inputs are converted to a format their port accepts, and uniform ones are materialized for the kernels that
+    // need their pixels. Other inputs are passed as they are, since references to them tell whether a node may work
+    // in place.
+    const IndexRange ports = _graph.get_inputs(context.node);
+    const bool accepted = definition < _uniform_inputs.size() && _uniform_inputs[definition] != 0;
+    std::span<const TexturePtr> inputs = context.inputs;
+    std::vector<TexturePtr> adapted;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      const TexturePtr& input = inputs[i];
+      if (!input) {
+        continue;
+      }
+      const GraphIndex port = *ports.begin() + static_cast<GraphIndex>(i);
+      const uint32_t channels = fit_channels(input->get_channels(), _graph.get_input_formats(port));
+      const bool materialize = !accepted && input->is_uniform();
+      if (channels == input->get_channels() && !materialize) {
+        continue;
+      }
+      if (adapted.empty()) {
+        adapted.assign(inputs.begin(), inputs.end());
+      }
+      auto texture = std::make_shared<Texture>(channels == input->get_channels() ? Texture(*input)
+                                                                                  : convert_channels(*input, channels));
+      if (materialize) {
+        texture->materialize();
+      }
+      adapted[i] = std::move(texture);
+    }
+    if (!adapted.empty()) {
+      inputs = adapted;
+    }
+    _kernels[definition]({context.graph, context.node, context.parameters, inputs, values, context.width,
+                          context.height, context.region, context.input_regions, context.allocator});
+  } else {
+    KN_LOG(LogGraph, Error, "No kernel for node {}", context.node);
+  }
+
+  if (_uniform_detection) {
+    for (TexturePtr& value : values) {
+      if (value && !value->is_uniform() && value->get_stored_size() > value->get_channels() &&
+          value->has_single_value()) {
+        value = std::make_shared<Texture>(
+            Texture::uniform(value->get_width(), value->get_height(), {value->get_data(), value->get_channels()}));
+      }
+    }
+  }
+  return values;
+}
+
+void GraphEvaluator::find_groups(std::span<const GraphIndex> kept,
+                                 std::vector<GraphIndex>& groups,
+                                 std::vector<std::vector<GraphIndex>>& members) const {
+  std::vector<uint8_t> pointwise(_pointwise.size());
+  for (size_t definition = 0; definition < _pointwise.size(); ++definition) {
+    pointwise[definition] = _pointwise[definition].function ? 1 : 0;
+  }
+  groups = find_fusion_groups(_graph, pointwise, kept);
+  for (GraphIndex& group : groups) {
+    if (!_fusion && group != INVALID_INDEX) {
+      group = static_cast<GraphIndex>(&group - groups.data());
+    }
+  }
+  members.assign(_graph.get_node_count(), {});
+  for (const GraphIndex node : _graph.get_topological_order()) {
+    if (groups[node] != INVALID_INDEX) {
+      members[groups[node]].push_back(node);
+    }
+  }
+}
+
+void GraphEvaluator::update_fusion() {
+  find_groups({}, _groups, _members);
+
+  // Fused nodes have no outputs, so nodes changing group may not keep theirs.
+  std::fill(_keys.begin(), _keys.end(), 0);
+  for (GraphIndex node = 0; node < _graph.get_node_count(); ++node) {
+    mark_dirty(node);
+  }
+}
+
+void GraphEvaluator::evaluate_node(GraphIndex node, EvaluationStats& stats) {
+  const uint64_t key = hash_node(node, _keys);
+  const IndexRange output_range = _graph.get_outputs(node);
+  const std::span<TexturePtr> outputs(_outputs.data() + *output_range.begin(), output_range.size());
+  if (is_fused(node)) {
+    std::fill(outputs.begin(), outputs.end(), nullptr);
+    ++stats.fused;
+    _keys[node] = key;
+    _dirty[node] = 0;
+    return;
+  }
+
+  // Every node computes the whole texture.
+  const Region frame{0, 0, _width, _height};
+  std::vector<TexturePtr> inputs;
+  std::vector<Region> input_regions;
+  for (const GraphIndex input : _graph.get_inputs(node)) {
+    const GraphIndex source = _graph.get_source(input);
+    inputs.push_back(source == INVALID_INDEX ? nullptr : _outputs[source]);
+    input_regions.push_back(source == INVALID_INDEX ? Region{} : frame);
+  }
+
+  if (_versions[node] > 0 && key == _keys[node]) {
+    ++stats.cached;
+  } else {
+    std::vector<TexturePtr> values;
+    if (_cache.find(key, values)) {
+      ++stats.cached;
+    } else {
+      const auto start = std::chrono::steady_clock::now();
+      const std::span<const ParameterValue> parameters = _graph.get_parameters(node);
+      values = run_kernel({_graph, node, parameters, inputs, {}, _width, _height, frame, input_regions},
+                          _members[node], [this](GraphIndex input) { return _outputs[_graph.get_source(input)]; });
+      ++stats.evaluated;
+      // The cost lets the cache keep the outputs that take the longest to compute again.
+      _cache.insert(key, values, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::copy(values.begin(), values.end(), outputs.begin());
+    ++_versions[node];
+  }
+
+  _keys[node] = key;
+  _dirty[node] = 0;
+}
+
+std::vector<TexturePtr> GraphEvaluator::evaluate_once(
+    std::span<const GraphIndex> outputs,
+    TaskScheduler& scheduler /*= *TaskScheduler::get_instance()*/) {
+  // Requested outputs end their group, so that they are computed rather than fused into a node downstream.
+  std::vector<GraphIndex> groups;
+  std::vector<std::vector<GraphIndex>> members;
+  find_groups(outputs, groups, members);
+  const BufferPlan plan = plan_buffers(_graph, outputs, _in_place, groups);
+  std::vector<std::vector<float>> buffers(plan.buffer_count);
+  std::vector<TexturePtr> values(_graph.get_output_count());
+  // Outputs allocated from the buffers, whose storage goes back to them once nothing reads the outputs.
+  std::vector<std::shared_ptr<Texture>> allocated(_graph.get_output_count());
+  std::vector<std::vector<GraphIndex>> releases(_graph.get_level_count());
+  for (GraphIndex output = 0; output < _graph.get_output_count(); ++output) {
+    if (plan.release_levels[output] != INVALID_INDEX) {
+      releases[plan.release_levels[output]].push_back(output);
+    }
+  }
+
+  const Region frame{0, 0, _width, _height};
+  for (uint32_t level = 0; level < _graph.get_level_count(); ++level) {
+    // Nodes of a level only read outputs of previous levels, and write buffers no other node of the level uses.
+    TaskGroup group;
+    for (const GraphIndex node : _graph.get_level_nodes(level)) {
+      if (plan.active[node] == 0) {
+        continue;
+      }
+      scheduler.submit(group, [&, node]() {
+        std::vector<TexturePtr> inputs;
+        std::vector<Region> input_regions;
+        for (const GraphIndex input : _graph.get_inputs(node)) {
+          const GraphIndex source = _graph.get_source(input);
+          inputs.push_back(source == INVALID_INDEX ? nullptr : values[source]);
+          input_regions.push_back(source == INVALID_INDEX ? Region{} : frame);
+        }
+
+        const GraphIndex first_output = *_graph.get_outputs(node).begin();
+        const OutputAllocator allocator = [&](GraphIndex slot, uint32_t width, uint32_t height, uint32_t channels) {
+          const GraphIndex output = first_output + slot;
+          if (plan.in_place[node] != 0 && slot == 0) {
+            // The input is held by the outputs, the allocated outputs and the inputs of the node, unless a kernel
+            // passed it through to another output.
+            const std::shared_ptr<Texture>& input = allocated[_graph.get_source(*_graph.get_inputs(node).begin())];
+            if (input && input.use_count() == 3 && input->get_width() == width && input->get_height() == height &&
+                input->get_channels() == channels) {
+              allocated[output] = input;
+              return input;
+            }
+          }
+          auto texture = std::make_shared<Texture>(width, height, channels, std::move(buffers[plan.buffers[output]]));
+          allocated[output] = texture;
+          return texture;
+        };
+
+        const std::vector<TexturePtr> node_values =
+            run_kernel({_graph, node, _graph.get_parameters(node), inputs, {}, _width, _height, frame, input_regions,
+                        &allocator},
+                       members[node], [&](GraphIndex input) { return values[_graph.get_source(input)]; });
+        std::copy(node_values.begin(), node_values.end(), values.begin() + first_output);
+      });
+    }
+    scheduler.wait(group);
+
+    for (const GraphIndex output : releases[level]) {
+      values[output] = nullptr;
+      std::shared_ptr<Texture>& texture = allocated[output];
+      if (texture && texture.use_count() == 1) {
+        buffers[plan.buffers[output]] = texture->take_storage();
+      }
+      texture = nullptr;
+    }
+  }
+
+  std::vector<TexturePtr> results;
+  results.reserve(outputs.size());
+  for (const GraphIndex output : outputs) {
+    results.push_back(materialized(values[output]));
+  }
+  return results;
+}
+
+void GraphEvaluator::evaluate_resolutions(std::span<const GraphIndex> outputs,
+                                          const std::vector<Resolution>& resolutions,
+                                          const ResampleOptions& options,
+                                          const ExportEncoder& encode,
+                                          TaskScheduler& scheduler /*= *TaskScheduler::get_instance()*/) {
+  if (resolutions.empty()) {
+    return;
+  }
+  uint32_t width = 0;
+  uint32_t height = 0;
+  for (const Resolution& resolution : resolutions) {
+    width = std::max(width, resolution.width);
+    height = std::max(height, resolution.height);
+  }
+
+  // evaluate_once does not touch the state of incremental evaluations, which keep their resolution.
+  const uint32_t previous_width = std::exchange(_width, width);
+  const uint32_t previous_height = std::exchange(_height, height);
+  const std::vector<TexturePtr> textures = evaluate_once(outputs, scheduler);
+  _width = previous_width;
+  _height = previous_height;
+
+  TaskGroup group;
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (!textures[i]) {
+      continue;
+    }
+    scheduler.submit(group, [&, i]() {
+      derive_resolutions(
+          textures[i]->view(), resolutions, options,
+          [&, output = outputs[i]](size_t index, const TextureView& texture) { encode(output, index, texture); },
+          scheduler);
+    });
+  }
+  scheduler.wait(group);
+}
+
+TexturePtr GraphEvaluator::evaluate_region(GraphIndex output,
+                                           const Region& region,
+                                           TaskScheduler& scheduler /*= *TaskScheduler::get_instance()*/) {
+  if (!ensure(output < _graph.get_output_count()) || region.is_empty()) {
+    return nullptr;
+  }
+
+  // Consumers come after their sources, so walking the order backwards gives every node the union of the regions
+  // its consumers read before its own footprint is asked for.
+  const std::span<const GraphIndex> order = _graph.get_topological_order();
+  const GraphIndex target = _graph.get_output_node(output);
+  std::vector<Region> regions(_graph.get_node_count());
+  regions[target] = region;
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const GraphIndex node = *it;
+    if (regions[node].is_empty()) {
+      continue;
+    }
+    const NodeContext context{_graph, node, _graph.get_parameters(node), {}, {}, _width, _height, regions[node], {}};
+    const IndexRange inputs = _graph.get_inputs(node);
+    for (const GraphIndex input : inputs) {
+      const GraphIndex source = _graph.get_source(input);
+      if (source != INVALID_INDEX) {
+        Region& source_region = regions[_graph.get_output_node(source)];
+        source_region = source_region.united(get_footprint(context, input - *inputs.begin()));
+      }
+    }
+  }
+
+  // The requested output ends its group, as in evaluate_once.
+  std::vector<GraphIndex> groups;
+  std::vector<std::vector<GraphIndex>> members;
+  find_groups({&output, 1}, groups, members);
+  std::vector<GraphIndex> nodes;
+  std::vector<uint64_t> keys(_graph.get_node_count(), 0);
+  for (const GraphIndex node : order) {
+    if (!regions[node].is_empty()) {
+      keys[node] = hash_node(node, keys);
+      nodes.push_back(node);
+    }
+  }
+
+  std::vector<TexturePtr> outputs(_graph.get_output_count());
+  run_graph(
+      _graph, nodes,
+      [&](GraphIndex node) { evaluate_tiles(node, regions, keys, groups, members, outputs, scheduler); }, scheduler);
+  return materialized(crop(outputs[output], regions[target], region));
+}
+
+TexturePtr GraphEvaluator::get_output(GraphIndex output) const {
+  return materialized(_outputs[output]);
+}
+
+void GraphEvaluator::evaluate_tiles(GraphIndex node,
+                                    std::span<const Region> regions,
+                                    std::span<const uint64_t> keys,
+                                    std::span<const GraphIndex> groups,
+                                    std::span<const std::vector<GraphIndex>> members,
+                                    std::span<TexturePtr> outputs,
+                                    TaskScheduler& scheduler) {
+  if (groups[node] != INVALID_INDEX && groups[node] != node) {
+    return;
+  }
+
+  // Tiles are the cells of the grid the region overlaps, clipped to it.
+  const Region& region = regions[node];
+  const Region grid = region.aligned(REGION_TILE_SIZE);
+  const uint32_t columns = grid.width / REGION_TILE_SIZE;
+  std::vector<Region> tiles;
+  for (uint32_t row = 0; row < grid.height / REGION_TILE_SIZE; ++row) {
+    for (uint32_t column = 0; column < columns; ++column) {
+      const Region cell{grid.x + static_cast<int32_t>(column * REGION_TILE_SIZE),
+                        grid.y + static_cast<int32_t>(row * REGION_TILE_SIZE), REGION_TILE_SIZE, REGION_TILE_SIZE};
+      tiles.push_back(cell.intersected(region));
+    }
+  }
+
+  const std::span<const ParameterValue> parameters = _graph.get_parameters(node);
+  const IndexRange inputs = _graph.get_inputs(node);
+  const IndexRange output_range = _graph.get_outputs(node);
+  std::vector<std::vector<TexturePtr>> values(tiles.size());
+  TaskGroup group;
+  for (size_t i = 0; i < tiles.size(); ++i) {
+    const uint64_t key = hash_combine(hash_combine(hash_combine(hash_combine(keys[node], tiles[i].x), tiles[i].y),
+                                                   tiles[i].width),
+                                      tiles[i].height);
+    if (_cache.find(key, values[i])) {
+      continue;
+    }
+
+    scheduler.submit(group, [&, i, key]() {
+      const Region& tile = tiles[i];
+      const NodeContext context{_graph, node, parameters, {}, {}, _width, _height, tile, {}};
+      std::vector<TexturePtr> tile_inputs;
+      std::vector<Region> input_regions;
+      // Point-wise nodes fetch their inputs themselves.
+      for (const GraphIndex input : members[node].empty() ? inputs : IndexRange()) {
+        const GraphIndex source = _graph.get_source(input);
+        if (source == INVALID_INDEX) {
+          tile_inputs.emplace_back();
+          input_regions.emplace_back();
+          continue;
+        }
+        const Region footprint = get_footprint(context, input - *inputs.begin());
+        tile_inputs.push_back(crop(outputs[source], regions[_graph.get_output_node(source)], footprint));
+        input_regions.push_back(footprint);
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      // Nodes of a fused group all compute the tile.
+      const auto fetch = [&](GraphIndex input) {
+        const GraphIndex source = _graph.get_source(input);
+        return crop(outputs[source], regions[_graph.get_output_node(source)], tile);
+      };
+      values[i] = run_kernel({_graph, node, parameters, tile_inputs, {}, _width, _height, tile, input_regions},
+                             members[node], fetch);
+      for (TexturePtr& value : values[i]) {
+        if (value && (value->get_width() != tile.width || value->get_height() != tile.height)) {
+          KN_LOG(LogGraph, Error, "Output of node {} does not match the size of its region", node);
+          value = nullptr;
+        }
+      }
+      _cache.insert(key, values[i], std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    });
+  }
+  scheduler.wait(group);
+
+  for (size_t slot = 0; slot < output_range.size(); ++slot) {
+    TexturePtr& output = outputs[*output_range.begin() + slot];
+    if (tiles.size() == 1) {
+      output = values[0][slot];
+      continue;
+    }
+    // Tiles without the output, or with another layout, leave it unset.
+    const TexturePtr& first = values[0][slot];
+    const bool complete = first && std::all_of(values.begin(), values.end(), [&](const auto& tile_values) {
+      return tile_values[slot] && tile_values[slot]->get_channels() == first->get_channels();
+    });
+    if (!complete) {
+      continue;
+    }
+    const uint32_t channels = first->get_channels();
+    const bool uniform = std::all_of(values.begin(), values.end(), [&](const auto& tile_values) {
+      const TexturePtr& value = tile_values[slot];
+      return value->is_uniform() && std::equal(first->get_data(), first->get_data() + channels, value->get_data());
+    });
+    if (uniform) {
+      output = std::make_shared<Texture>(Texture::uniform(region.width, region.height, {first->get_data(), channels}));
+      continue;
+    }
+    auto texture = std::make_shared<Texture>(region.width, region.height, first->get_channels());
+    for (size_t i = 0; i < tiles.size(); ++i) {
+      copy_area(*values[i][slot], tiles[i], *texture, region, tiles[i]);
+    }
+    output = texture;
+  }
+}
+}  // namespace kn
@@ -0,0 +1,339 @@
+/**************************************************************************/
+/* graph_evaluator.hpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "buffer_plan.hpp"
+#include "fusion.hpp"
+#include "graph.hpp"
+#include "graph_api.hpp"
+#include "multi_resolution.hpp"
+#include "output_cache.hpp"
+#include "region.hpp"
+#include "threading/task_scheduler.hpp"
+
+namespace kn {
+/** Size of the tiles regions are computed and cached in. */
+constexpr uint32_t REGION_TILE_SIZE = 256;
+
+/** Returns the texture an output slot of a node is written to. */
+using OutputAllocator =
+    std::function<std::shared_ptr<Texture>(GraphIndex slot, uint32_t width, uint32_t height, uint32_t channels)>;
+
+/** What a node kernel reads and writes. */
+struct NodeContext {
+  const Graph& graph;
+  GraphIndex node;
+  std::span<const ParameterValue> parameters;
+  /**
+   * Output connected to every input of the node, null when the input is not connected, converted to a format the
+   * input accepts, see fit_channels. Inputs are only uniform textures for definitions accepting them, see
+   * GraphEvaluator::set_uniform_inputs.
+   */
+  std::span<const TexturePtr> inputs;
+  /** Outputs of the node, in the order of its definition, which the kernel sets. */
+  std::span<TexturePtr> outputs;
+  /** Size of the whole textures of the graph. */
+  uint32_t width;
+  uint32_t height;
+  /** Region of the whole texture the outputs cover, which gives their size. */
+  Region region;
+  /** Region every input covers, as asked by the footprint of the node. */
+  std::span<const Region> input_regions;
+  /** Provides the storage of the outputs, null when they are allocated on their own. */
+  const OutputAllocator* allocator = nullptr;
+
+  /**
+   * Returns a texture for an output of the node, whose pixels are unspecified: a buffer no other output uses
+   * anymore, or the first input itself for nodes working in place. Kernels may also create their outputs.
+   */
+  [[nodiscard]] inline std::shared_ptr<Texture> allocate(GraphIndex slot,
+                                                         uint32_t width,
+                                                         uint32_t height,
+                                                         uint32_t channels = 1) const {
+    return allocator != nullptr ? (*allocator)(slot, width, height, channels)
+                                : std::make_shared<Texture>(width, height, channels);
+  }
+};
+
+/**
+ * Computes the outputs of a node; kernels of different nodes, and of different tiles of a node, run concurrently.
+ * Kernels index their inputs by pixel of the whole texture, less the origin of the input region, wrapping around
+ * their borders: a full evaluation gives every node the whole texture, which repeats.
+ */
+using NodeKernel = std::function<void(const NodeContext&)>;
+
+/**
+ * Returns the region of an input a node reads to compute the region of the context, whose inputs and outputs are
+ * empty: a filter adds its halo, a transform maps the bounds of the region.
+ */
+using NodeFootprint = std::function<Region(const NodeContext& context, GraphIndex input)>;
+
+/**
+ * Called once per exported output and resolution, possibly from several threads at once.
+ * @param output The output port.
+ * @param index The index of the resolution in the requested resolutions.
+ * @param texture The output at that resolution, valid until the callback returns.
+ */
+using ExportEncoder = std::function<void(GraphIndex output, size_t index, const TextureView& texture)>;
+
+struct EvaluationStats {
+  /** Nodes whose kernel ran. */
+  uint32_t evaluated = 0;
+  /** Nodes served from their previous outputs or from the cache. */
+  uint32_t cached = 0;
+  /** Nodes run within the fused kernel of a node downstream. */
+  uint32_t fused = 0;
+};
+
+/**
+ * Evaluates a graph incrementally. Editing a parameter marks its node and every node downstream of it dirty, and
+ * only dirty nodes are visited by the next evaluation. A visited node hashes its type, parameter values and the
+ * hashes of the outputs it reads, which stand for their content; the node keeps its outputs if the hash did not
+ * change and reads them from the cache if it was seen before, so an edit costs time proportional to the part of the
+ * graph it affects. Regions of an output can also be computed alone, for previews of a part of the texture. Outputs
+ * whose pixels all have the same value are kept as uniform textures, which point-wise nodes compute as a single pixel
+ * and other kernels see materialized unless they handle them; outputs returned by the evaluator are materialized.
+ * Hashes do not depend on the evaluator but on the ids of the definitions and the versions of their kernels, so
+ * evaluators sharing a cache, like those of a graph closed and opened again, share the outputs of kernels set with
+ * the same version; kernels set without a version share their outputs with no other kernel.
+ */
+class KN_GRAPH_API GraphEvaluator {
+ public:
+  GraphEvaluator(const GraphEvaluator&) = delete;
+  GraphEvaluator& operator=(const GraphEvaluator&) = delete;
+
+  /**
+   * Evaluates a graph, whose parameters are edited through the evaluator.
+   * @param graph The graph to evaluate.
+   * @param cache The cache holding the outputs of previous evaluations.
+   */
+  explicit GraphEvaluator(Graph& graph, OutputCache& cache = *OutputCache::get_instance());
+  ~GraphEvaluator() = default;
+
+  /**
+   * Sets the kernel of every node of a definition, marking them dirty.
+   * @param definition The index of the definition in the library of the graph.
+   * @param kernel The kernel.
+   * @param version Names the kernel in the hash of the nodes, so that evaluators sharing the cache reuse the outputs
+   * of kernels of the same definition and version. Without a version, outputs are only reused by this kernel.
+   */
+  void set_kernel(GraphIndex definition, NodeKernel kernel, std::string_view version = {});
+
+  /**
+   * Sets the point-wise kernel of every node of a definition instead of its kernel, marking them dirty. Point-wise
+   * nodes reading each other run fused into one pass, see find_fusion_groups. The version is that of set_kernel.
+   */
+  void set_pointwise_kernel(GraphIndex definition, PointwiseKernel kernel, std::string_view version = {});
+
+  /**
+   * Enables fusing point-wise nodes, which is the default, marking every node dirty. Outputs of nodes fused into a
+   * node downstream are not kept, so inspecting them requires disabling fusion.
+   */
+  void set_fusion(bool enabled);
+
+  /**
+   * Declares whether kernels of a definition can write their first output over their first input, reading every
+   * input pixel before writing the output pixel at the same position; allocate then returns the input when no other
+   * node reads it anymore.
+   */
+  void set_in_place(GraphIndex definition, bool in_place);
+
+  /**
+   * Declares whether kernels of a definition handle uniform inputs, reading their single pixel or passing them to
+   * the Texture overloads of the texture functions, which filter them as one pixel, see filter_texture. Inputs of
+   * other kernels are materialized first.
+   */
+  void set_uniform_inputs(GraphIndex definition, bool accepted);
+
+  /**
+   * Enables checking the outputs of kernels for a single value, which is the default, keeping those that have one as
+   * uniform textures. The check usually ends within the first pixels of other outputs.
+   */
+  inline void set_uniform_detection(bool enabled) { _uniform_detection = enabled; }
+
+  /** Sets the footprint of every node of a definition; nodes without one read the region they compute. */
+  void set_footprint(GraphIndex definition, NodeFootprint footprint);
+
+  /** Sets the size of the textures of the graph, marking every node dirty. */
+  void set_resolution(uint32_t width, uint32_t height);
+
+  /**
+   * Sets a parameter of a node, marking it and the nodes downstream of it dirty if the value changed.
+   * @return True if the value has the type of the parameter, false otherwise.
+   */
+  bool set_parameter(GraphIndex node, GraphIndex parameter, ParameterValue value);
+
+  /**
+   * Marks a node dirty and stops using its cached outputs, for content the parameters do not describe, like files.
+   * The cache salts the current hash of the node, so that evaluators sharing it, like that of a graph opened again,
+   * do not use them either.
+   */
+  void invalidate(GraphIndex node);
+
+  /** Evaluates the dirty nodes. */
+  EvaluationStats evaluate(TaskScheduler& scheduler = *TaskScheduler::get_instance());
+
+  /**
+   * Evaluates the nodes some outputs depend on once, without the cache nor the outputs of previous evaluations,
+   * releasing every other output after the last node reading it. Levels run one after the other on buffers planned
+   * by plan_buffers, which outputs allocated through NodeContext::allocate reuse, so that memory follows the width of
+   * the graph rather than its size. Requested outputs end their fusion group, so that every one is computed.
+   * @param outputs The output ports to compute.
+   * @param scheduler The scheduler running the nodes of every level.
+   * @return The texture of every requested output.
+   */
+  std::vector<TexturePtr> evaluate_once(std::span<const GraphIndex> outputs,
+                                        TaskScheduler& scheduler = *TaskScheduler::get_instance());
+
+  /**
+   * Exports outputs at several resolutions from a single evaluate_once at the largest width and height requested,
+   * the other resolutions being derived by derive_resolutions, instead of evaluating the graph at every size.
+   * Outputs are derived and encoded concurrently. The resolution of the evaluator is left as it is.
+   * @param outputs The output ports to export; outputs the kernels did not set are skipped.
+   * @param resolutions The export resolutions.
+   * @param options The filter deriving the lower resolutions.
+   * @param encode The encoder invoked for every output and resolution.
+   * @param scheduler The scheduler running the nodes, resampling and encoders.
+   */
+  void evaluate_resolutions(std::span<const GraphIndex> outputs,
+                            const std::vector<Resolution>& resolutions,
+                            const ResampleOptions& options,
+                            const ExportEncoder& encode,
+                            TaskScheduler& scheduler = *TaskScheduler::get_instance());
+
+  /**
+   * Computes a region of an output. The footprints of the nodes carry the region up to the nodes it depends on,
+   * which compute only the regions read downstream, split along a grid of REGION_TILE_SIZE tiles. Tiles are cached
+   * on their own, so that moving the region computes only the tiles it uncovers. Does not change the outputs of
+   * full evaluations.
+   * @param output The output port.
+   * @param region The region to compute, which may cross the borders of the texture.
+   * @param scheduler The scheduler running nodes and tiles.
+   * @return The pixels of the region, null if the kernel of the node did not set the output.
+   */
+  TexturePtr evaluate_region(GraphIndex output,
+                             const Region& region,
+                             TaskScheduler& scheduler = *TaskScheduler::get_instance());
+
+  [[nodiscard]] inline bool is_dirty(GraphIndex node) const { return _dirty[node] != 0; }
+
+  /** Returns how many times the outputs of a node changed, 0 before its first evaluation. */
+  [[nodiscard]] inline uint64_t get_version(GraphIndex node) const { return _versions[node]; }
+
+  /**
+   * Returns the content of an output port, as of the last evaluation. Uniform outputs are materialized into a new
+   * texture at every call, see is_uniform_output.
+   */
+  [[nodiscard]] TexturePtr get_output(GraphIndex output) const;
+
+  /** Checks if an output port holds a uniform texture, which get_output materializes. */
+  [[nodiscard]] inline bool is_uniform_output(GraphIndex output) const {
+    return _outputs[output] && _outputs[output]->is_uniform();
+  }
+
+  [[nodiscard]] inline OutputCache& get_cache() { return _cache; }
+
+ private:
+  void mark_dirty(GraphIndex node);
+  void set_kernel_hash(GraphIndex definition, std::string_view version);
+  /**
+   * Hashes a node from its definition id, kernel version, parameters and the hashes of the nodes it reads, then its
+   * salts.
+   */
+  [[nodiscard]] uint64_t hash_node(GraphIndex node, std::span<const uint64_t> keys) const;
+  /** Returns the hash of a node without its salts. */
+  [[nodiscard]] uint64_t hash_state(GraphIndex node, std::span<const uint64_t> keys) const;
+  [[nodiscard]] Region get_footprint(const NodeContext& context, GraphIndex input) const;
+  /**
+   * Runs the kernel of a node, or the fused kernel of the group it ends, whose nodes are members, returning its
+   * outputs, null if it has no kernel. Fused kernels read the inputs of the group through fetch.
+   */
+  std::vector<TexturePtr> run_kernel(const NodeContext& context,
+                                     std::span<const GraphIndex> members,
+                                     const std::function<TexturePtr(GraphIndex input)>& fetch) const;
+  /**
+   * Groups point-wise nodes, see find_fusion_groups, each node alone without fusion.
+   * @param kept Output ports ending their group.
+   * @param[out] groups The last node of the group of every node.
+   * @param[out] members The nodes of the group every last node computes, in topological order.
+   */
+  void find_groups(std::span<const GraphIndex> kept,
+                   std::vector<GraphIndex>& groups,
+                   std::vector<std::vector<GraphIndex>>& members) const;
+  /** Groups point-wise nodes again, after their kernels changed. */
+  void update_fusion();
+  /** Checks if a node runs within the fused kernel of a node downstream. */
+  [[nodiscard]] inline bool is_fused(GraphIndex node) const {
+    return _groups[node] != INVALID_INDEX && _groups[node] != node;
+  }
+  void evaluate_node(GraphIndex node, EvaluationStats& stats);
+  /** Computes the region of a node tile by tile, from the regions of its inputs and the given fusion groups. */
+  void evaluate_tiles(GraphIndex node,
+                      std::span<const Region> regions,
+                      std::span<const uint64_t> keys,
+                      std::span<const GraphIndex> groups,
+                      std::span<const std::vector<GraphIndex>> members,
+                      std::span<TexturePtr> outputs,
+                      TaskScheduler& scheduler);
+
+  Graph& _graph;
+  std::vector<NodeKernel> _kernels;
+  std::vector<NodeFootprint> _footprints;
+  std::vector<PointwiseKernel> _pointwise;
+  std::vector<uint8_t> _in_place;
+  std::vector<uint8_t> _uniform_inputs;
+  /** Hash of the version of the kernel of every definition, or of a serial unique to the process without one. */
+  std::vector<uint64_t> _kernel_hashes;
+  bool _fusion = true;
+  bool _uniform_detection = true;
+  uint32_t _width = 1024;
+  uint32_t _height = 1024;
+  OutputCache& _cache;
+
+  // Per node.
+  std::vector<uint8_t> _dirty;
+  std::vector<uint64_t> _versions;
+  std::vector<uint64_t> _keys;
+  /** Bumped by invalidate, so that the hash of the node changes. */
+  std::vector<uint64_t> _salts;
+  /** Last node of the fusion group of the node, INVALID_INDEX if it is not point-wise. */
+  std::vector<GraphIndex> _groups;
+  /** Nodes of the fusion group every last node computes, in topological order. */
+  std::vector<std::vector<GraphIndex>> _members;
+
+  // Per output port.
+  std::vector<TexturePtr> _outputs;
+};
+}  // namespace kn
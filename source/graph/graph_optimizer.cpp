@@ -0,0 +1,273 @@
+/**************************************************************************/
+/* graph_optimizer.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "graph_optimizer.hpp"
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include "kn_assert.hpp"
+#include "texture_format.hpp"
+
+namespace kn {
+namespace {
+/** A uniform color and its channels. */
+struct Constant {
+  std::array<float, 4> value = {};
+  uint32_t channels = 4;
+};
+
+/** What a node computes: its definition, parameters, and the node and output slot every input reads. */
+using Signature =
+    std::tuple<GraphIndex, std::vector<ParameterValue>, std::vector<std::pair<GraphIndex, GraphIndex>>>;
+
+/** Hashes the bits of parameter values, as the evaluator does, so that NaN parameters can be compared. */
+struct SignatureHash {
+  size_t operator()(const Signature& signature) const {
+    const auto& [definition, parameters, inputs] = signature;
+    uint64_t hash = hash_combine(HASH_SEED, definition);
+    for (const ParameterValue& value : parameters) {
+      hash = hash_combine(hash, hash_value(value));
+    }
+    for (const auto& [source, slot] : inputs) {
+      hash = hash_combine(hash_combine(hash, source), slot);
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+struct SignatureEqual {
+  bool operator()(const Signature& a, const Signature& b) const {
+    return std::get<0>(a) == std::get<0>(b) && std::get<2>(a) == std::get<2>(b) &&
+           std::ranges::equal(std::get<1>(a), std::get<1>(b), is_same_value);
+  }
+};
+
+GraphIndex find_parameter(const NodeDefinition& definition, ParameterType type) {
+  const auto it = std::find_if(definition.parameters.begin(), definition.parameters.end(),
+                               [type](const ParameterDefinition& parameter) { return parameter.type == type; });
+  return it == definition.parameters.end() ? INVALID_INDEX
+                                           : static_cast<GraphIndex>(it - definition.parameters.begin());
+}
+}  // namespace
+
+OptimizedGraph optimize_graph(const Graph& graph,
+                              const NodeLibrary& library,
+                              std::span<const GraphIndex> outputs,
+                              const OptimizerOptions& options /*= {}*/) {
+  const GraphIndex node_count = graph.get_node_count();
+  OptimizedGraph result;
+  OptimizationReport& report = result.report;
+
+  // Nodes the outputs depend on.
+  std::vector<uint8_t> needed(node_count, 0);
+  std::vector<GraphIndex> stack;
+  for (const GraphIndex output : outputs) {
+    stack.push_back(graph.get_output_node(output));
+  }
+  while (!stack.empty()) {
+    const GraphIndex node = stack.back();
+    stack.pop_back();
+    if (needed[node] == 0) {
+      needed[node] = 1;
+      stack.insert(stack.end(), graph.get_predecessors(node).begin(), graph.get_predecessors(node).end());
+    }
+  }
+
+  GraphIndex color_parameter = INVALID_INDEX;
+  GraphIndex channels_parameter = INVALID_INDEX;
+  if (options.uniform_definition != INVALID_INDEX && ensure(options.uniform_definition < library.get_size())) {
+    const NodeDefinition& uniform = library.get(options.uniform_definition);
+    color_parameter = find_parameter(uniform, ParameterType::Color);
+    channels_parameter = find_parameter(uniform, ParameterType::Number);
+    if (!ensure(color_parameter != INVALID_INDEX && uniform.outputs.size() == 1)) {
+      color_parameter = INVALID_INDEX;
+    }
+  }
+  const auto make_uniform = [&](const Constant& constant) {
+    std::vector<ParameterValue> parameters;
+    for (const ParameterDefinition& parameter : library.get(options.uniform_definition).parameters) {
+      parameters.push_back(parameter.default_value);
+    }
+    parameters[color_parameter] = constant.value;
+    if (channels_parameter != INVALID_INDEX) {
+      parameters[channels_parameter] = static_cast<double>(constant.channels);
+    }
+    return parameters;
+  };
+
+  // Nodes are visited after the nodes they read, so their inputs are already folded and merged.
+  std::vector<std::optional<Constant>> constants(node_count);
+  std::vector<GraphIndex> representatives(node_count, INVALID_INDEX);
+  std::vector<Signature> signatures(node_count);
+  std::unordered_map<Signature, GraphIndex, SignatureHash, SignatureEqual> unique;
+  for (const GraphIndex node : graph.get_topological_order()) {
+    if (needed[node] == 0) {
+      continue;
+    }
+    const GraphIndex definition = graph.get_definition(node);
+    const std::span<const ParameterValue> parameters = graph.get_parameters(node);
+
+    bool folded = false;
+    if (color_parameter != INVALID_INDEX && definition == options.uniform_definition) {
+      Constant constant;
+      constant.value = std::get<std::array<float, 4>>(parameters[color_parameter]);
+      if (channels_parameter != INVALID_INDEX) {
+        const double channels = std::get<double>(parameters[channels_parameter]);
+        constant.channels = static_cast<uint32_t>(std::clamp(channels, 1.0, 4.0));
+      }
+      constants[node] = constant;
+    } else if (color_parameter != INVALID_INDEX && definition < options.pointwise.size() &&
+               options.pointwise[definition].function) {
+      // Inputs are converted to a format their port accepts, as the evaluator does.
+      const IndexRange ports = graph.get_inputs(node);
+      std::vector<Constant> converted(ports.size());
+      std::vector<const float*> inputs;
+      std::vector<uint32_t> input_channels;
+      bool constant_inputs = true;
+      uint32_t widest = 0;
+      for (const GraphIndex input : ports) {
+        const GraphIndex source = graph.get_source(input);
+        const std::optional<Constant>* constant =
+            source == INVALID_INDEX ? nullptr : &constants[graph.get_output_node(source)];
+        const bool known = constant != nullptr && constant->has_value();
+        constant_inputs = constant_inputs && (source == INVALID_INDEX || known);
+        if (known) {
+          Constant& value = converted[input - *ports.begin()];
+          value.channels = fit_channels((*constant)->channels, graph.get_input_formats(input));
+          convert_channels(TextureView{const_cast<float*>((*constant)->value.data()), 1, 1, (*constant)->channels, 4},
+                           TextureView{value.value.data(), 1, 1, value.channels, 4});
+          inputs.push_back(value.value.data());
+          input_channels.push_back(value.channels);
+        } else {
+          inputs.push_back(nullptr);
+          input_channels.push_back(0);
+        }
+        widest = std::max(widest, input_channels.back());
+      }
+
+      const PointwiseKernel& kernel = options.pointwise[definition];
+      Constant constant;
+      constant.channels = kernel.channels > 0 ? kernel.channels : std::max(widest, 1u);
+      if (constant_inputs && constant.channels <= 4) {
+        kernel.function({parameters, inputs, input_channels, constant.value.data(), constant.channels, 1});
+        constants[node] = constant;
+        folded = true;
+        report.folded_nodes.push_back(node);
+      }
+    }
+
+    Signature signature;
+    if (folded) {
+      signature = {options.uniform_definition, make_uniform(*constants[node]), {}};
+    } else {
+      std::vector<std::pair<GraphIndex, GraphIndex>> inputs;
+      for (const GraphIndex input : graph.get_inputs(node)) {
+        const GraphIndex source = graph.get_source(input);
+        if (source == INVALID_INDEX) {
+          inputs.emplace_back(INVALID_INDEX, 0);
+        } else {
+          const GraphIndex source_node = graph.get_output_node(source);
+          inputs.emplace_back(representatives[source_node], source - *graph.get_outputs(source_node).begin());
+        }
+      }
+      signature = {definition, std::vector<ParameterValue>(parameters.begin(), parameters.end()), std::move(inputs)};
+    }
+
+    const auto [it, inserted] = unique.emplace(signature, node);
+    representatives[node] = it->second;
+    if (inserted) {
+      signatures[node] = std::move(signature);
+    } else {
+      report.merged_nodes.emplace_back(node, it->second);
+    }
+  }
+
+  // Folding leaves the nodes only folded nodes read without readers.
+  std::vector<uint8_t> live(node_count, 0);
+  for (const GraphIndex output : outputs) {
+    stack.push_back(representatives[graph.get_output_node(output)]);
+  }
+  while (!stack.empty()) {
+    const GraphIndex node = stack.back();
+    stack.pop_back();
+    if (live[node] == 0) {
+      live[node] = 1;
+      for (const auto& [source, slot] : std::get<2>(signatures[node])) {
+        if (source != INVALID_INDEX) {
+          stack.push_back(source);
+        }
+      }
+    }
+  }
+
+  GraphBuilder builder(library);
+  std::vector<GraphIndex> new_nodes(node_count, INVALID_INDEX);
+  for (const GraphIndex node : graph.get_topological_order()) {
+    if (representatives[node] != node || live[node] == 0) {
+      continue;
+    }
+    const auto& [definition, parameters, inputs] = signatures[node];
+    const GraphIndex new_node = builder.add_node(definition, graph.get_name(node));
+    const NodeDefinition& node_definition = library.get(definition);
+    for (size_t i = 0; i < parameters.size(); ++i) {
+      builder.set_parameter(new_node, node_definition.parameters[i].id, parameters[i]);
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (inputs[i].first != INVALID_INDEX) {
+        builder.connect(new_nodes[inputs[i].first], inputs[i].second, new_node, static_cast<GraphIndex>(i));
+      }
+    }
+    new_nodes[node] = new_node;
+  }
+  std::optional<Graph> optimized = builder.build();
+  if (!ensure(optimized.has_value())) {
+    return {};
+  }
+  result.graph = std::move(*optimized);
+
+  result.nodes.assign(node_count, INVALID_INDEX);
+  result.outputs.assign(graph.get_output_count(), INVALID_INDEX);
+  for (GraphIndex node = 0; node < node_count; ++node) {
+    const GraphIndex representative = representatives[node];
+    if (representative == INVALID_INDEX || live[representative] == 0) {
+      report.dead_nodes.push_back(node);
+      continue;
+    }
+    result.nodes[node] = new_nodes[representative];
+    const IndexRange ports = result.graph.get_outputs(new_nodes[representative]);
+    for (const GraphIndex output : graph.get_outputs(node)) {
+      const GraphIndex slot = output - *graph.get_outputs(node).begin();
+      result.outputs[output] = slot < ports.size() ? *ports.begin() + slot : INVALID_INDEX;
+    }
+  }
+  return result;
+}
+}  // namespace kn
@@ -0,0 +1,86 @@
+/**************************************************************************/
+/* graph_optimizer.hpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <span>
+#include <utility>
+#include <vector>
+#include "fusion.hpp"
+#include "graph.hpp"
+#include "graph_api.hpp"
+#include "node_library.hpp"
+
+namespace kn {
+struct OptimizerOptions {
+  /**
+   * Definition of the nodes producing a uniform color, whose first color parameter gives the color and first number
+   * parameter its channels; INVALID_INDEX disables constant folding.
+   */
+  GraphIndex uniform_definition = INVALID_INDEX;
+  /** Point-wise kernel of every definition, which folding runs on a single pixel. */
+  std::span<const PointwiseKernel> pointwise;
+};
+
+/** What optimize_graph removed, as nodes of the original graph. */
+struct OptimizationReport {
+  /** Nodes no output kept depends on, including those only read by folded nodes. */
+  std::vector<GraphIndex> dead_nodes;
+  /** Nodes whose output was constant, replaced by uniform nodes. */
+  std::vector<GraphIndex> folded_nodes;
+  /** Nodes identical to a node computed instead, each with that node. */
+  std::vector<std::pair<GraphIndex, GraphIndex>> merged_nodes;
+};
+
+struct OptimizedGraph {
+  Graph graph;
+  /** Node of the optimized graph computing every node of the original one, INVALID_INDEX for dead nodes. */
+  std::vector<GraphIndex> nodes;
+  /** Output port of the optimized graph holding every output port of the original one, INVALID_INDEX if none. */
+  std::vector<GraphIndex> outputs;
+  OptimizationReport report;
+};
+
+/**
+ * Builds a graph computing the same outputs with less work. Nodes the outputs do not depend on are dropped.
+ * Point-wise nodes whose inputs are all uniform are evaluated once and replaced by uniform nodes, so that constant
+ * subgraphs fold to a single value. Nodes of the same definition with the same parameters and the same inputs, like
+ * two noises with the same seed, are hash-consed in topological order, so that identical subgraphs are computed
+ * once. Node names are kept, merged nodes taking the name of the node computing them.
+ * @param graph The graph to optimize.
+ * @param library The library of the graph.
+ * @param outputs The output ports the optimized graph must compute.
+ * @param options How constants are folded.
+ * @return The optimized graph, how it maps to the original one, and what was removed.
+ */
+KN_GRAPH_API OptimizedGraph optimize_graph(const Graph& graph,
+                                           const NodeLibrary& library,
+                                           std::span<const GraphIndex> outputs,
+                                           const OptimizerOptions& options = {});
+}  // namespace kn
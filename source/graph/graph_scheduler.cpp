@@ -0,0 +1,113 @@
+/**************************************************************************/
+/* graph_scheduler.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "graph_scheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace kn {
+namespace {
+class GraphRun {
+ public:
+  GraphRun(const Graph& graph, const std::function<void(GraphIndex)>& func, TaskScheduler& scheduler)
+      : _graph(graph),
+        _func(func),
+        _scheduler(scheduler),
+        _pending(std::make_unique<std::atomic<uint32_t>[]>(graph.get_node_count())),
+        _selected(graph.get_node_count(), 1) {}
+
+  /** Restricts the run to the given nodes. */
+  void select(std::span<const GraphIndex> nodes) {
+    std::fill(_selected.begin(), _selected.end(), 0);
+    for (const GraphIndex node : nodes) {
+      _selected[node] = 1;
+    }
+  }
+
+  void run() {
+    // Counters are all set before the first task runs, since any of them may complete one.
+    std::vector<GraphIndex> roots;
+    for (GraphIndex node = 0; node < _graph.get_node_count(); ++node) {
+      if (!_selected[node]) {
+        continue;
+      }
+      uint32_t count = 0;
+      for (const GraphIndex predecessor : _graph.get_predecessors(node)) {
+        count += _selected[predecessor];
+      }
+      _pending[node].store(count, std::memory_order_relaxed);
+      if (count == 0) {
+        roots.push_back(node);
+      }
+    }
+    for (const GraphIndex node : roots) {
+      submit(node);
+    }
+    _scheduler.wait(_group);
+  }
+
+ private:
+  void submit(GraphIndex node) {
+    _scheduler.submit(_group, [this, node]() {
+      _func(node);
+      for (const GraphIndex successor : _graph.get_successors(node)) {
+        if (_selected[successor] && _pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          submit(successor);
+        }
+      }
+    });
+  }
+
+  const Graph& _graph;
+  const std::function<void(GraphIndex)>& _func;
+  TaskScheduler& _scheduler;
+  TaskGroup _group;
+  std::unique_ptr<std::atomic<uint32_t>[]> _pending;
+  std::vector<uint8_t> _selected;
+};
+}  // namespace
+
+void run_graph(const Graph& graph,
+               const std::function<void(GraphIndex)>& func,
+               TaskScheduler& scheduler /*= *TaskScheduler::get_instance()*/) {
+  GraphRun run(graph, func, scheduler);
+  run.run();
+}
+
+void run_graph(const Graph& graph,
+               std::span<const GraphIndex> nodes,
+               const std::function<void(GraphIndex)>& func,
+               TaskScheduler& scheduler /*= *TaskScheduler::get_instance()*/) {
+  GraphRun run(graph, func, scheduler);
+  run.select(nodes);
+  run.run();
+}
+}  // namespace kn
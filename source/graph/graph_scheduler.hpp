@@ -0,0 +1,61 @@
+/**************************************************************************/
+/* graph_scheduler.hpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <span>
+#include "graph.hpp"
+#include "graph_api.hpp"
+#include "threading/task_scheduler.hpp"
+
+namespace kn {
+/**
+ * Runs func(node) for every node of a graph as tasks of a scheduler, each node once every node it reads has run.
+ * Every node holds an atomic count of its predecessors left to run; the node completing the count queues the
+ * successor on its own worker, next to the data it just wrote, and idle workers steal from there, so independent
+ * branches run on different cores. func may split its work into tile tasks with parallel_for or the scheduler,
+ * which then share the workers with the nodes. Returns once every node has run.
+ * @param graph The graph to run.
+ * @param func The callable invoked with each node, from any thread.
+ * @param scheduler The scheduler running the tasks.
+ */
+KN_GRAPH_API void run_graph(const Graph& graph,
+                            const std::function<void(GraphIndex)>& func,
+                            TaskScheduler& scheduler = *TaskScheduler::get_instance());
+
+/**
+ * Runs func(node) for a subset of the nodes of a graph, such as the nodes affected by an edit; nodes outside of it
+ * are considered to have run already.
+ */
+KN_GRAPH_API void run_graph(const Graph& graph,
+                            std::span<const GraphIndex> nodes,
+                            const std::function<void(GraphIndex)>& func,
+                            TaskScheduler& scheduler = *TaskScheduler::get_instance());
+}  // namespace kn
@@ -0,0 +1,196 @@
+/**************************************************************************/
+/* node_definition.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "node_definition.hpp"
+#include <yaml-cpp/yaml.h>
+#include <bit>
+#include <fstream>
+#include <sstream>
+#include "log/log.hpp"
+#include "schema_reader.hpp"
+
+namespace kn {
+namespace {
+using namespace schema;
+
+constexpr std::array<std::string_view, 7> PARAMETER_TYPES = {"File",    "Color",  "Number", "Radial",
+                                                             "Boolean", "Slider", "Enum"};
+constexpr std::array<std::string_view, 4> FORMATS = {"float", "float2", "float3", "float4"};
+constexpr std::array<std::string_view, 5> EVALUATION_TYPES = {"compute_shader", "cuda", "lua", "pixel_shader",
+                                                              "python"};
+
+ParameterDefinition read_parameter(const YAML::Node& node) {
+  ParameterDefinition parameter;
+  parameter.name = require(node, "name").as<std::string>();
+  parameter.id = require(node, "id").as<std::string>();
+  parameter.type = static_cast<ParameterType>(read_enum(require(node, "type"), PARAMETER_TYPES));
+  parameter.values = read_sequence(node, "values", [](const YAML::Node& value) { return value.as<std::string>(); });
+  if (node["min"]) {
+    parameter.min = node["min"].as<double>();
+  }
+  if (node["max"]) {
+    parameter.max = node["max"].as<double>();
+  }
+  parameter.default_value = read_parameter_value(node["default"], parameter);
+  return parameter;
+}
+
+InputDefinition read_input(const YAML::Node& node) {
+  InputDefinition input;
+  input.name = require(node, "name").as<std::string>();
+  input.id = require(node, "id").as<std::string>();
+  input.required = node["required"] && node["required"].as<bool>();
+  const YAML::Node formats = require(node, "formats");
+  for (const YAML::Node& format : formats) {
+    input.formats |= static_cast<PortFormats>(1 << read_enum(format, FORMATS));
+  }
+  return input;
+}
+
+std::map<std::string, std::string> read_bind(const YAML::Node& node) {
+  std::map<std::string, std::string> bind;
+  for (const auto& entry : node) {
+    bind.emplace(entry.first.as<std::string>(),
+                 entry.second.IsScalar() ? entry.second.as<std::string>() : YAML::Dump(entry.second));
+  }
+  return bind;
+}
+
+PermutationDefinition read_permutation(const YAML::Node& node) {
+  PermutationDefinition permutation;
+  permutation.id = require(node, "id").as<std::string>();
+  permutation.condition = read_string(node, "if");
+  require(node, "definitions");
+  permutation.definitions =
+      read_sequence(node, "definitions", [](const YAML::Node& definition) { return definition.as<std::string>(); });
+  return permutation;
+}
+
+OutputDefinition read_output(const YAML::Node& node) {
+  OutputDefinition output;
+  output.name = require(node, "name").as<std::string>();
+  output.id = require(node, "id").as<std::string>();
+  const YAML::Node evaluation = require(node, "evaluation");
+  output.evaluation.type = static_cast<EvaluationType>(read_enum(require(evaluation, "type"), EVALUATION_TYPES));
+  output.evaluation.filename = read_string(evaluation, "filename");
+  output.evaluation.binds = read_sequence(evaluation, "binds", read_bind);
+  output.evaluation.permutations = read_sequence(evaluation, "permutations", read_permutation);
+  return output;
+}
+
+template <typename Item>
+GraphIndex find_by_id(const std::vector<Item>& items, std::string_view id) {
+  for (size_t i = 0; i < items.size(); ++i) {
+    if (items[i].id == id) {
+      return static_cast<GraphIndex>(i);
+    }
+  }
+  return INVALID_INDEX;
+}
+}  // namespace
+
+uint64_t hash_value(const ParameterValue& value) {
+  uint64_t hash = hash_combine(HASH_SEED, value.index());
+  if (const bool* boolean = std::get_if<bool>(&value)) {
+    return hash_combine(hash, *boolean ? 1 : 0);
+  }
+  if (const double* number = std::get_if<double>(&value)) {
+    return hash_combine(hash, std::bit_cast<uint64_t>(*number));
+  }
+  if (const auto* color = std::get_if<std::array<float, 4>>(&value)) {
+    for (const float channel : *color) {
+      hash = hash_combine(hash, std::bit_cast<uint32_t>(channel));
+    }
+    return hash;
+  }
+  return hash_combine(hash, std::hash<std::string_view>()(std::get<std::string>(value)));
+}
+
+bool is_same_value(const ParameterValue& a, const ParameterValue& b) {
+  if (a.index() != b.index()) {
+    return false;
+  }
+  if (const double* number = std::get_if<double>(&a)) {
+    return std::bit_cast<uint64_t>(*number) == std::bit_cast<uint64_t>(std::get<double>(b));
+  }
+  if (const auto* color = std::get_if<std::array<float, 4>>(&a)) {
+    return std::bit_cast<std::array<uint32_t, 4>>(*color) ==
+           std::bit_cast<std::array<uint32_t, 4>>(std::get<std::array<float, 4>>(b));
+  }
+  return a == b;
+}
+
+GraphIndex NodeDefinition::find_parameter(std::string_view parameter_id) const {
+  return find_by_id(parameters, parameter_id);
+}
+
+GraphIndex NodeDefinition::find_input(std::string_view input_id) const {
+  return find_by_id(inputs, input_id);
+}
+
+GraphIndex NodeDefinition::find_output(std::string_view output_id) const {
+  return find_by_id(outputs, output_id);
+}
+
+std::optional<NodeDefinition> parse_node_definition(std::string_view text) {
+  try {
+    // JSON documents are valid YAML.
+    const YAML::Node node = YAML::Load(std::string(text));
+    if (!node.IsMap()) {
+      throw SchemaError("the document is not an object");
+    }
+
+    NodeDefinition definition;
+    definition.name = require(node, "name").as<std::string>();
+    definition.id = require(node, "id").as<std::string>();
+    definition.description = read_string(node, "description");
+    definition.author = read_string(node, "author");
+    definition.category = read_string(node, "category");
+    definition.parameters = read_sequence(node, "parameters", read_parameter);
+    definition.inputs = read_sequence(node, "inputs", read_input);
+    require(node, "outputs");
+    definition.outputs = read_sequence(node, "outputs", read_output);
+    return definition;
+  } catch (const std::exception& e) {
+    KN_LOG(LogGraph, Error, "Invalid node definition: {}", e.what());
+    return std::nullopt;
+  }
+}
+
+std::optional<NodeDefinition> load_node_definition(const std::filesystem::path& file_path) {
+  std::ifstream file(file_path);
+  if (!file.is_open()) {
+    KN_LOG(LogGraph, Error, "Failed to open file: {}", file_path.string());
+    return std::nullopt;
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+  return parse_node_definition(text.str());
+}
+}  // namespace kn
@@ -0,0 +1,182 @@
+/**************************************************************************/
+/* node_definition.hpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "graph_api.hpp"
+
+namespace kn {
+/** Index of an entry in one of the tables of the graph runtime. */
+using GraphIndex = uint32_t;
+constexpr GraphIndex INVALID_INDEX = std::numeric_limits<GraphIndex>::max();
+
+enum class ParameterType : uint8_t {
+  File,
+  Color,
+  Number,
+  Radial,
+  Boolean,
+  Slider,
+  Enum,
+};
+
+/** Value of a parameter: booleans, numbers, colors, and strings for files and enum entries. */
+using ParameterValue = std::variant<bool, double, std::array<float, 4>, std::string>;
+
+constexpr uint64_t HASH_SEED = 0x9e3779b97f4a7c15ull;
+
+/** Mixes a value into a hash, with the finalizer of MurmurHash3 spreading every input bit. */
+inline uint64_t hash_combine(uint64_t hash, uint64_t value) {
+  hash ^= value + HASH_SEED + (hash << 6) + (hash >> 2);
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/** Hashes the bits of a parameter value, see is_same_value. */
+KN_GRAPH_API uint64_t hash_value(const ParameterValue& value);
+
+/** Compares the bits of parameter values: unlike ==, a NaN equals itself, and -0 differs from 0. */
+KN_GRAPH_API bool is_same_value(const ParameterValue& a, const ParameterValue& b);
+
+struct ParameterDefinition {
+  std::string name;
+  std::string id;
+  ParameterType type = ParameterType::Number;
+  ParameterValue default_value;
+  /** Entries of an enum parameter. */
+  std::vector<std::string> values;
+  std::optional<double> min;
+  std::optional<double> max;
+};
+
+/** Formats accepted by an input, as a mask of FORMAT_FLOAT to FORMAT_FLOAT4. */
+using PortFormats = uint8_t;
+constexpr PortFormats FORMAT_FLOAT = 1 << 0;
+constexpr PortFormats FORMAT_FLOAT2 = 1 << 1;
+constexpr PortFormats FORMAT_FLOAT3 = 1 << 2;
+constexpr PortFormats FORMAT_FLOAT4 = 1 << 3;
+constexpr PortFormats FORMAT_ANY = FORMAT_FLOAT | FORMAT_FLOAT2 | FORMAT_FLOAT3 | FORMAT_FLOAT4;
+
+/**
+ * Returns the channel count an input accepting some formats reads from an output with the given channel count: the
+ * same one if the input accepts it or any format, else the narrowest wider format, else the widest format.
+ */
+constexpr uint32_t fit_channels(uint32_t channels, PortFormats formats) {
+  if (formats == 0 || channels == 0 || channels > 4 || (formats & (1u << (channels - 1))) != 0) {
+    return channels;
+  }
+  for (uint32_t wider = channels + 1; wider <= 4; ++wider) {
+    if ((formats & (1u << (wider - 1))) != 0) {
+      return wider;
+    }
+  }
+  uint32_t widest = channels - 1;
+  while ((formats & (1u << (widest - 1))) == 0) {
+    --widest;
+  }
+  return widest;
+}
+
+struct InputDefinition {
+  std::string name;
+  std::string id;
+  bool required = false;
+  PortFormats formats = 0;
+};
+
+enum class EvaluationType : uint8_t {
+  ComputeShader,
+  Cuda,
+  Lua,
+  PixelShader,
+  Python,
+};
+
+struct PermutationDefinition {
+  std::string id;
+  /** Condition enabling the permutation, empty when it always applies. */
+  std::string condition;
+  std::vector<std::string> definitions;
+};
+
+struct EvaluationDefinition {
+  EvaluationType type = EvaluationType::ComputeShader;
+  std::string filename;
+  /** Bindings of the evaluation, their values kept as written, nested ones serialized. */
+  std::vector<std::map<std::string, std::string>> binds;
+  std::vector<PermutationDefinition> permutations;
+};
+
+struct OutputDefinition {
+  std::string name;
+  std::string id;
+  EvaluationDefinition evaluation;
+};
+
+/** Type of node, as described by misc/schema/types/Node.json. */
+struct KN_GRAPH_API NodeDefinition {
+  std::string name;
+  std::string id;
+  std::string description;
+  std::string author;
+  std::string category;
+  std::vector<ParameterDefinition> parameters;
+  std::vector<InputDefinition> inputs;
+  std::vector<OutputDefinition> outputs;
+
+  /** Returns the position of the parameter, input or output with the given id, INVALID_INDEX if there is none. */
+  [[nodiscard]] GraphIndex find_parameter(std::string_view parameter_id) const;
+  [[nodiscard]] GraphIndex find_input(std::string_view input_id) const;
+  [[nodiscard]] GraphIndex find_output(std::string_view output_id) const;
+};
+
+/**
+ * Parses a node definition from its JSON description.
+ * @param text The JSON document.
+ * @return The definition, or nothing if the document does not follow the schema.
+ */
+KN_GRAPH_API std::optional<NodeDefinition> parse_node_definition(std::string_view text);
+
+/** Loads a node definition from a JSON file. */
+KN_GRAPH_API std::optional<NodeDefinition> load_node_definition(const std::filesystem::path& file_path);
+}  // namespace kn
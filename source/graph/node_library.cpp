@@ -0,0 +1,76 @@
+/**************************************************************************/
+/* node_library.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "node_library.hpp"
+#include <algorithm>
+#include "log/log.hpp"
+
+namespace kn {
+GraphIndex NodeLibrary::add(NodeDefinition definition) {
+  const auto [it, inserted] = _indices.emplace(definition.id, static_cast<GraphIndex>(_definitions.size()));
+  if (inserted) {
+    _definitions.push_back(std::move(definition));
+  } else {
+    _definitions[it->second] = std::move(definition);
+  }
+  return it->second;
+}
+
+bool NodeLibrary::load_directory(const std::filesystem::path& directory) {
+  std::error_code ec;
+  std::vector<std::filesystem::path> files;
+  for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".json") {
+      files.push_back(entry.path());
+    }
+  }
+  if (ec) {
+    KN_LOG(LogGraph, Error, "Failed to read directory: {} -- {}", directory.string(), ec.message());
+    return false;
+  }
+
+  // Directory order is unspecified; sorting keeps indices the same from one run to the next.
+  std::sort(files.begin(), files.end());
+  bool loaded = true;
+  for (const auto& file : files) {
+    std::optional<NodeDefinition> definition = load_node_definition(file);
+    if (definition.has_value()) {
+      add(std::move(*definition));
+    } else {
+      loaded = false;
+    }
+  }
+  return loaded;
+}
+
+GraphIndex NodeLibrary::find(std::string_view id) const {
+  const auto it = _indices.find(std::string(id));
+  return it == _indices.end() ? INVALID_INDEX : it->second;
+}
+}  // namespace kn
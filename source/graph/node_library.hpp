@@ -0,0 +1,65 @@
+/**************************************************************************/
+/* node_library.hpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "graph_api.hpp"
+#include "node_definition.hpp"
+
+namespace kn {
+/** Node definitions available to graphs, addressed by a 32-bit index that stays valid as definitions are added. */
+class KN_GRAPH_API NodeLibrary {
+ public:
+  /** Adds a definition, replacing the one with the same id in place, and returns its index. */
+  GraphIndex add(NodeDefinition definition);
+
+  /**
+   * Loads every JSON node definition of a directory.
+   * @param directory The directory holding the definitions.
+   * @return True if all the definitions were loaded, false otherwise.
+   */
+  bool load_directory(const std::filesystem::path& directory);
+
+  /** Returns the index of the definition with the given id, INVALID_INDEX if there is none. */
+  [[nodiscard]] GraphIndex find(std::string_view id) const;
+
+  [[nodiscard]] inline const NodeDefinition& get(GraphIndex index) const { return _definitions[index]; }
+
+  [[nodiscard]] inline GraphIndex get_size() const { return static_cast<GraphIndex>(_definitions.size()); }
+
+ private:
+  std::vector<NodeDefinition> _definitions;
+  std::unordered_map<std::string, GraphIndex> _indices;
+};
+}  // namespace kn
@@ -0,0 +1,312 @@
+/**************************************************************************/
+/* output_cache.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "output_cache.hpp"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <fmt/format.h>
+#include "log/log.hpp"
+#include "os/os.hpp"
+
+namespace kn {
+namespace {
+/** Bytes an entry takes besides its pixels, so that entries without pixels still count. */
+constexpr size_t ENTRY_OVERHEAD = 256;
+
+size_t get_pixel_bytes(const std::vector<TexturePtr>& outputs) {
+  size_t bytes = 0;
+  for (const TexturePtr& output : outputs) {
+    if (output) {
+      bytes += output->get_stored_size() * sizeof(float);
+    }
+  }
+  return bytes;
+}
+}  // namespace
+
+OutputCache::OutputCache() {
+  std::error_code ec;
+  const std::filesystem::path temp = std::filesystem::temp_directory_path(ec);
+  // Several caches and processes may spill at once.
+  std::random_device random;
+  const uint64_t id = (static_cast<uint64_t>(random()) << 32) | random();
+  _directory = (ec ? std::filesystem::path(".") : temp) / "knoodle" / "cache" / fmt::format("{:016x}", id);
+}
+
+OutputCache::~OutputCache() {
+  clear();
+  std::error_code ec;
+  std::filesystem::remove(_directory, ec);
+}
+
+OutputCache* OutputCache::get_instance() {
+  static OutputCache instance;
+  return &instance;
+}
+
+bool OutputCache::find(uint64_t key, std::vector<TexturePtr>& outputs) {
+  std::unique_lock lock(_mutex);
+  if (const auto it = _entries.find(key); it != _entries.end()) {
+    // A hit restores the priority of the entry.
+    Entry& entry = it->second;
+    _queue.erase({entry.priority, entry.order, key});
+    entry.priority = _inflation + entry.cost / static_cast<double>(entry.bytes);
+    entry.order = _order++;
+    _queue.emplace(entry.priority, entry.order, key);
+    outputs = entry.outputs;
+    ++_stats.hits;
+    return true;
+  }
+  if (const auto it = _spilling.find(key); it != _spilling.end()) {
+    outputs = it->second;
+    ++_stats.hits;
+    return true;
+  }
+  const auto it = _spilled.find(key);
+  if (it == _spilled.end()) {
+    ++_stats.misses;
+    return false;
+  }
+
+  SpilledEntry spilled = std::move(it->second);
+  _spilled.erase(it);
+  _spill_ages.erase(spilled.age);
+  _stats.disk_bytes -= spilled.bytes;
+  lock.unlock();
+
+  std::vector<TexturePtr> reloaded;
+  std::unique_ptr<os::MappedFile> file = os::map_file(spilled.path);
+  if (file && file->get_size() == spilled.bytes) {
+    const auto* data = static_cast<const std::byte*>(file->get_data());
+    for (const auto& [width, height, channels, uniform] : spilled.layouts) {
+      if (channels == 0) {
+        reloaded.emplace_back();
+        continue;
+      }
+      const auto* values = reinterpret_cast<const float*>(data);
+      auto texture = uniform != 0 ? std::make_shared<Texture>(Texture::uniform(width, height, {values, channels}))
+                                  : std::make_shared<Texture>(width, height, channels);
+      const size_t bytes = texture->get_stored_size() * sizeof(float);
+      std::memcpy(texture->get_data(), data, bytes);
+      data += bytes;
+      reloaded.push_back(std::move(texture));
+    }
+  } else {
+    KN_LOG(LogGraph, Error, "Failed to read scratch file: {}", spilled.path.string());
+  }
+  // Windows does not remove files that are still mapped.
+  file.reset();
+  std::error_code ec;
+  std::filesystem::remove(spilled.path, ec);
+
+  lock.lock();
+  if (reloaded.size() != spilled.layouts.size()) {
+    ++_stats.misses;
+    ++_stats.discards;
+    return false;
+  }
+  ++_stats.hits;
+  ++_stats.reloads;
+  outputs = reloaded;
+  std::vector<Victim> victims = emplace(key, std::move(reloaded), spilled.cost);
+  lock.unlock();
+  spill(std::move(victims));
+  return true;
+}
+
+void OutputCache::insert(uint64_t key, std::vector<TexturePtr> outputs, double cost /*= 0.0*/) {
+  std::unique_lock lock(_mutex);
+  std::vector<Victim> victims = emplace(key, std::move(outputs), cost);
+  lock.unlock();
+  spill(std::move(victims));
+}
+
+void OutputCache::invalidate(uint64_t key) {
+  std::lock_guard lock(_mutex);
+  _salts[key] = ++_last_salt;
+}
+
+uint64_t OutputCache::get_salt(uint64_t key) const {
+  std::lock_guard lock(_mutex);
+  const auto it = _salts.find(key);
+  return it != _salts.end() ? it->second : 0;
+}
+
+void OutputCache::clear() {
+  std::lock_guard lock(_mutex);
+  _entries.clear();
+  _queue.clear();
+  _inflation = 0.0;
+  _spilling.clear();
+  while (!_spill_ages.empty()) {
+    drop_spilled(_spill_ages.front());
+  }
+  ++_generation;
+  _stats.memory_bytes = 0;
+}
+
+void OutputCache::set_memory_budget(size_t bytes) {
+  std::unique_lock lock(_mutex);
+  _memory_budget = bytes;
+  std::vector<Victim> victims = trim();
+  lock.unlock();
+  spill(std::move(victims));
+}
+
+void OutputCache::set_disk_budget(size_t bytes) {
+  std::lock_guard lock(_mutex);
+  _disk_budget = bytes;
+  while (_stats.disk_bytes > _disk_budget) {
+    drop_spilled(_spill_ages.front());
+    ++_stats.discards;
+  }
+}
+
+void OutputCache::set_scratch_directory(const std::filesystem::path& directory) {
+  std::lock_guard lock(_mutex);
+  _directory = directory;
+}
+
+size_t OutputCache::get_size() const {
+  std::lock_guard lock(_mutex);
+  return _entries.size();
+}
+
+OutputCacheStats OutputCache::get_stats() const {
+  std::lock_guard lock(_mutex);
+  return _stats;
+}
+
+std::vector<OutputCache::Victim> OutputCache::emplace(uint64_t key, std::vector<TexturePtr> outputs, double cost) {
+  if (const auto it = _entries.find(key); it != _entries.end()) {
+    _queue.erase({it->second.priority, it->second.order, key});
+    _stats.memory_bytes -= it->second.bytes;
+    _entries.erase(it);
+  }
+  if (_spilled.contains(key)) {
+    drop_spilled(key);
+  }
+
+  Entry entry;
+  entry.bytes = get_pixel_bytes(outputs) + ENTRY_OVERHEAD;
+  entry.outputs = std::move(outputs);
+  entry.cost = cost;
+  entry.priority = _inflation + cost / static_cast<double>(entry.bytes);
+  entry.order = _order++;
+  _queue.emplace(entry.priority, entry.order, key);
+  _stats.memory_bytes += entry.bytes;
+  _entries.emplace(key, std::move(entry));
+  return trim();
+}
+
+std::vector<OutputCache::Victim> OutputCache::trim() {
+  std::vector<Victim> victims;
+  while (_stats.memory_bytes > _memory_budget && !_queue.empty()) {
+    const auto [priority, order, key] = *_queue.begin();
+    _queue.erase(_queue.begin());
+    _inflation = priority;
+
+    auto node = _entries.extract(key);
+    _stats.memory_bytes -= node.mapped().bytes;
+    ++_stats.evictions;
+    if (_disk_budget > 0 && get_pixel_bytes(node.mapped().outputs) > 0) {
+      _spilling[key] = node.mapped().outputs;
+      victims.push_back({key, std::move(node.mapped()), _generation});
+    } else {
+      ++_stats.discards;
+    }
+  }
+  return victims;
+}
+
+void OutputCache::drop_spilled(uint64_t key) {
+  const auto it = _spilled.find(key);
+  std::error_code ec;
+  std::filesystem::remove(it->second.path, ec);
+  _stats.disk_bytes -= it->second.bytes;
+  _spill_ages.erase(it->second.age);
+  _spilled.erase(it);
+}
+
+void OutputCache::spill(std::vector<Victim> victims) {
+  for (Victim& victim : victims) {
+    std::unique_lock lock(_mutex);
+    const std::filesystem::path path = _directory / fmt::format("{:016x}-{}.knc", victim.key, victim.entry.order);
+    lock.unlock();
+
+    SpilledEntry spilled;
+    spilled.path = path;
+    spilled.bytes = get_pixel_bytes(victim.entry.outputs);
+    spilled.cost = victim.entry.cost;
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    std::unique_ptr<os::MappedFile> file = os::map_file(path, spilled.bytes);
+    const bool written = file != nullptr;
+    if (written) {
+      auto* data = static_cast<std::byte*>(file->get_data());
+      for (const TexturePtr& output : victim.entry.outputs) {
+        if (!output) {
+          spilled.layouts.push_back({0, 0, 0, 0});
+          continue;
+        }
+        spilled.layouts.push_back(
+            {output->get_width(), output->get_height(), output->get_channels(), output->is_uniform() ? 1u : 0u});
+        const size_t bytes = output->get_stored_size() * sizeof(float);
+        std::memcpy(data, output->get_data(), bytes);
+        data += bytes;
+      }
+      file.reset();
+    } else {
+      KN_LOG(LogGraph, Error, "Failed to write scratch file: {}", path.string());
+    }
+
+    lock.lock();
+    // The entry may have been computed again or cleared while it was written.
+    const bool current = victim.generation == _generation && _spilling.erase(victim.key) > 0 &&
+                         !_entries.contains(victim.key) && !_spilled.contains(victim.key);
+    if (!current) {
+      std::filesystem::remove(path, ec);
+      continue;
+    }
+    if (!written) {
+      ++_stats.discards;
+      continue;
+    }
+    spilled.age = _spill_ages.insert(_spill_ages.end(), victim.key);
+    _stats.disk_bytes += spilled.bytes;
+    ++_stats.spills;
+    _spilled.emplace(victim.key, std::move(spilled));
+    while (_stats.disk_bytes > _disk_budget && !_spill_ages.empty()) {
+      drop_spilled(_spill_ages.front());
+      ++_stats.discards;
+    }
+  }
+}
+}  // namespace kn
@@ -0,0 +1,187 @@
+/**************************************************************************/
+/* output_cache.hpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "graph_api.hpp"
+#include "texture.hpp"
+
+namespace kn {
+using TexturePtr = std::shared_ptr<const Texture>;
+
+struct OutputCacheStats {
+  /** Lookups served from memory or from a scratch file. */
+  uint64_t hits = 0;
+  /** Lookups served from a scratch file. */
+  uint64_t reloads = 0;
+  uint64_t misses = 0;
+  /** Entries moved out of memory to fit the memory budget. */
+  uint64_t evictions = 0;
+  /** Evicted entries written to a scratch file. */
+  uint64_t spills = 0;
+  /** Entries dropped for good, evicted without spilling or spilled beyond the disk budget. */
+  uint64_t discards = 0;
+  size_t memory_bytes = 0;
+  size_t disk_bytes = 0;
+};
+
+/**
+ * Outputs of evaluated nodes, keyed by a hash of everything they depend on, so that a node whose type, parameters
+ * and inputs come back to a previous state is served without running again. Thread-safe.
+ *
+ * Entries fit a memory budget. When it is exceeded, the cache evicts the entries that are cheapest to recompute per
+ * byte they hold, aging the others so that entries not used for a while go too (GreedyDual-Size). Evicted entries
+ * spill to memory-mapped scratch files within a disk budget, which a later lookup reads back, as reading a texture
+ * is cheaper than computing it again.
+ */
+class KN_GRAPH_API OutputCache {
+ public:
+  OutputCache(const OutputCache&) = delete;
+  OutputCache& operator=(const OutputCache&) = delete;
+
+  OutputCache();
+  /** Deletes the scratch files. */
+  ~OutputCache();
+
+  /** Returns the cache evaluators share by default, so that a graph opened again finds its outputs. */
+  static OutputCache* get_instance();
+
+  /**
+   * Looks the outputs of a node up, reading them back if they were spilled.
+   * @param key The hash of the node.
+   * @param[out] outputs The outputs of the node, when found.
+   * @return True if the key was found, false otherwise.
+   */
+  bool find(uint64_t key, std::vector<TexturePtr>& outputs);
+
+  /**
+   * Keeps the outputs of a node, evicting other entries beyond the memory budget.
+   * @param key The hash of the node.
+   * @param outputs The outputs of the node.
+   * @param cost The time it took to compute the outputs, in seconds.
+   */
+  void insert(uint64_t key, std::vector<TexturePtr> outputs, double cost = 0.0);
+
+  /**
+   * Stops serving the outputs of a node whose content changed without its hash, like that of a node reading a file:
+   * evaluators combine the hash of every node with its salt, which this gives a new value.
+   * @param key The hash of the node, without its salt.
+   */
+  void invalidate(uint64_t key);
+
+  /** Returns the salt of a node hash, 0 until it is invalidated. Salts outlive clear. */
+  [[nodiscard]] uint64_t get_salt(uint64_t key) const;
+
+  /** Drops every entry and deletes the scratch files. */
+  void clear();
+
+  /** Sets the number of bytes the entries kept in memory may take. */
+  void set_memory_budget(size_t bytes);
+
+  /** Sets the number of bytes the scratch files may take; 0 disables spilling. */
+  void set_disk_budget(size_t bytes);
+
+  /** Sets the directory new scratch files are written to. */
+  void set_scratch_directory(const std::filesystem::path& directory);
+
+  /** Returns the number of entries kept in memory. */
+  [[nodiscard]] size_t get_size() const;
+
+  [[nodiscard]] OutputCacheStats get_stats() const;
+
+ private:
+  struct Entry {
+    std::vector<TexturePtr> outputs;
+    size_t bytes;
+    double cost;
+    double priority;
+    uint64_t order;
+  };
+
+  struct SpilledEntry {
+    std::filesystem::path path;
+    /** Width, height, channels and uniformity of every output, 0 channels for null outputs. */
+    std::vector<std::array<uint32_t, 4>> layouts;
+    size_t bytes;
+    double cost;
+    std::list<uint64_t>::iterator age;
+  };
+
+  struct Victim {
+    uint64_t key;
+    Entry entry;
+    uint64_t generation;
+  };
+
+  /** Adds an entry and returns the ones evicted to fit the budget. Requires the mutex. */
+  std::vector<Victim> emplace(uint64_t key, std::vector<TexturePtr> outputs, double cost);
+  /** Evicts entries until the budget is met. Requires the mutex. */
+  std::vector<Victim> trim();
+  /** Drops a spilled entry and its file. Requires the mutex. */
+  void drop_spilled(uint64_t key);
+  /** Writes evicted entries to scratch files, without the mutex so that lookups go on meanwhile. */
+  void spill(std::vector<Victim> victims);
+
+  mutable std::mutex _mutex;
+  std::unordered_map<uint64_t, Entry> _entries;
+  /** Priority, order of use and key of the entries in memory, the next to evict first. */
+  std::set<std::tuple<double, uint64_t, uint64_t>> _queue;
+  /** Priority of the last evicted entry, added to new priorities so that old entries age. */
+  double _inflation = 0.0;
+  uint64_t _order = 0;
+
+  /** Evicted entries being written, still served from memory. */
+  std::unordered_map<uint64_t, std::vector<TexturePtr>> _spilling;
+  std::unordered_map<uint64_t, SpilledEntry> _spilled;
+  /** Keys of the spilled entries, oldest first. */
+  std::list<uint64_t> _spill_ages;
+  /** Bumped by clear, so that spills started before it are dropped. */
+  uint64_t _generation = 0;
+  /** Salts of the invalidated node hashes. */
+  std::unordered_map<uint64_t, uint64_t> _salts;
+  uint64_t _last_salt = 0;
+  std::filesystem::path _directory;
+
+  size_t _memory_budget = size_t{2} << 30;
+  size_t _disk_budget = size_t{8} << 30;
+  OutputCacheStats _stats;
+};
+}  // namespace kn
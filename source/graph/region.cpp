@@ -0,0 +1,61 @@
+/**************************************************************************/
+/* region.cpp                                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "region.hpp"
+#include <cmath>
+#include <limits>
+
+namespace kn {
+Region map_bounds(const Region& region, const std::array<float, 6>& matrix) {
+  if (region.is_empty()) {
+    return region;
+  }
+
+  // An affine map sends the rectangle to a parallelogram, bounded by its corners.
+  float min_x = std::numeric_limits<float>::max();
+  float min_y = std::numeric_limits<float>::max();
+  float max_x = std::numeric_limits<float>::lowest();
+  float max_y = std::numeric_limits<float>::lowest();
+  for (const auto [px, py] : {std::array<int32_t, 2>{region.x, region.y}, {region.get_right() - 1, region.y},
+                              {region.x, region.get_bottom() - 1}, {region.get_right() - 1, region.get_bottom() - 1}}) {
+    const float cx = static_cast<float>(px) + 0.5f;
+    const float cy = static_cast<float>(py) + 0.5f;
+    const float sx = matrix[0] * cx + matrix[1] * cy + matrix[2];
+    const float sy = matrix[3] * cx + matrix[4] * cy + matrix[5];
+    min_x = std::min(min_x, sx);
+    min_y = std::min(min_y, sy);
+    max_x = std::max(max_x, sx);
+    max_y = std::max(max_y, sy);
+  }
+
+  // Bilinear filtering reads the pixels whose centers surround the sample.
+  const auto first = [](float v) { return static_cast<int32_t>(std::floor(v - 0.5f)); };
+  return Region::from_bounds(first(min_x), first(min_y), first(max_x) + 2, first(max_y) + 2);
+}
+}  // namespace kn
@@ -0,0 +1,104 @@
+/**************************************************************************/
+/* region.hpp                                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include "graph_api.hpp"
+
+namespace kn {
+/**
+ * Rectangle of pixels of a texture. Textures repeat, so regions may extend beyond their borders, where coordinates
+ * wrap around.
+ */
+struct Region {
+  int32_t x = 0;
+  int32_t y = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+
+  bool operator==(const Region&) const = default;
+
+  [[nodiscard]] inline bool is_empty() const { return width == 0 || height == 0; }
+
+  [[nodiscard]] inline int32_t get_right() const { return x + static_cast<int32_t>(width); }
+  [[nodiscard]] inline int32_t get_bottom() const { return y + static_cast<int32_t>(height); }
+
+  [[nodiscard]] inline bool contains(const Region& other) const {
+    return other.is_empty() || (other.x >= x && other.y >= y && other.get_right() <= get_right() &&
+                                other.get_bottom() <= get_bottom());
+  }
+
+  /** Returns the smallest region containing both regions. */
+  [[nodiscard]] inline Region united(const Region& other) const {
+    if (other.is_empty()) {
+      return *this;
+    }
+    if (is_empty()) {
+      return other;
+    }
+    return from_bounds(std::min(x, other.x), std::min(y, other.y), std::max(get_right(), other.get_right()),
+                       std::max(get_bottom(), other.get_bottom()));
+  }
+
+  /** Returns the pixels both regions contain. */
+  [[nodiscard]] inline Region intersected(const Region& other) const {
+    return from_bounds(std::max(x, other.x), std::max(y, other.y), std::min(get_right(), other.get_right()),
+                       std::min(get_bottom(), other.get_bottom()));
+  }
+
+  /** Returns the region grown by a margin on every side, such as the halo of a filter. */
+  [[nodiscard]] inline Region expanded(uint32_t margin) const {
+    const auto m = static_cast<int32_t>(margin);
+    return is_empty() ? *this : from_bounds(x - m, y - m, get_right() + m, get_bottom() + m);
+  }
+
+  /** Returns the smallest region made of whole tiles of a grid of the given size containing the region. */
+  [[nodiscard]] inline Region aligned(uint32_t tile_size) const {
+    const auto size = static_cast<int32_t>(tile_size);
+    const auto floor = [size](int32_t v) { return (v >= 0 ? v : v - size + 1) / size * size; };
+    return is_empty() ? *this : from_bounds(floor(x), floor(y), floor(get_right() + size - 1),
+                                            floor(get_bottom() + size - 1));
+  }
+
+  [[nodiscard]] static inline Region from_bounds(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    return {x0, y0, static_cast<uint32_t>(std::max(x1 - x0, 0)), static_cast<uint32_t>(std::max(y1 - y0, 0))};
+  }
+};
+
+/**
+ * Returns the region of a source a transform reads to produce a region, the bounds of the region mapped by the
+ * transform from output to source pixels, grown by a pixel for bilinear filtering.
+ * @param region The region to produce.
+ * @param matrix The row-major 2x3 matrix mapping output pixel centers to source pixel coordinates.
+ */
+KN_GRAPH_API Region map_bounds(const Region& region, const std::array<float, 6>& matrix);
+}  // namespace kn
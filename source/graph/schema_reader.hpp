@@ -0,0 +1,116 @@
+/**************************************************************************/
+/* schema_reader.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <yaml-cpp/yaml.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "node_definition.hpp"
+
+/** Helpers shared by the readers of node definitions and graphs, private to the graph module. */
+namespace kn::schema {
+/** Thrown when a document does not follow the schema, caught where parsing starts. */
+class SchemaError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+inline YAML::Node require(const YAML::Node& node, const char* key) {
+  const YAML::Node value = node[key];
+  if (!value) {
+    throw SchemaError(fmt::format("missing '{}'", key));
+  }
+  return value;
+}
+
+inline std::string read_string(const YAML::Node& node, const char* key) {
+  const YAML::Node value = node[key];
+  return value ? value.as<std::string>() : std::string();
+}
+
+template <size_t Size>
+inline size_t read_enum(const YAML::Node& node, const std::array<std::string_view, Size>& names) {
+  const std::string name = node.as<std::string>();
+  for (size_t i = 0; i < Size; ++i) {
+    if (names[i] == name) {
+      return i;
+    }
+  }
+  throw SchemaError(fmt::format("unknown value '{}'", name));
+}
+
+template <typename Read>
+inline auto read_sequence(const YAML::Node& node, const char* key, Read read) {
+  std::vector<decltype(read(node))> items;
+  const YAML::Node sequence = node[key];
+  if (!sequence) {
+    return items;
+  }
+  if (!sequence.IsSequence()) {
+    throw SchemaError(fmt::format("'{}' is not an array", key));
+  }
+  items.reserve(sequence.size());
+  for (const YAML::Node& item : sequence) {
+    items.push_back(read(item));
+  }
+  return items;
+}
+
+/** Reads a value of the type of a parameter, falling back to a neutral value when the node is missing. */
+inline ParameterValue read_parameter_value(const YAML::Node& node, const ParameterDefinition& parameter) {
+  switch (parameter.type) {
+    case ParameterType::Boolean:
+      return node ? node.as<bool>() : false;
+    case ParameterType::Color: {
+      std::array<float, 4> color = {0.0f, 0.0f, 0.0f, 1.0f};
+      if (node) {
+        for (size_t i = 0; i < std::min<size_t>(node.size(), color.size()); ++i) {
+          color[i] = node[i].as<float>();
+        }
+      }
+      return color;
+    }
+    case ParameterType::File:
+      return node ? node.as<std::string>() : std::string();
+    case ParameterType::Enum:
+      if (node) {
+        return node.as<std::string>();
+      }
+      return parameter.values.empty() ? std::string() : parameter.values.front();
+    default:
+      return node ? node.as<double>() : parameter.min.value_or(0.0);
+  }
+}
+}  // namespace kn::schema
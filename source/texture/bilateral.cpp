@@ -0,0 +1,288 @@
+/**************************************************************************/
+/* bilateral.cpp                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "bilateral.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <vector>
+#include "texture_pool.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+/** Most cells along the guide axis; wider guide ranges raise the range sigma to fit. */
+constexpr uint32_t MAX_RANGE_CELLS = 256;
+
+/** Size of a grid cell in sigmas, the [1 2 1] / 4 blur having a standard deviation of 1 / sqrt(2) cells. */
+constexpr double CELL_SIGMAS = std::numbers::sqrt2;
+
+/** Position of a pixel between two grid nodes along one axis. */
+struct Lerp {
+  uint32_t i0;
+  uint32_t i1;
+  float t;
+};
+
+/** Positions of the pixels along a wrapped spatial axis, nodes being evenly spread over the pixels. */
+std::vector<Lerp> make_axis(uint32_t size, uint32_t cells) {
+  std::vector<Lerp> axis(size);
+  const double scale = static_cast<double>(cells) / size;
+  for (uint32_t p = 0; p < size; ++p) {
+    const double g = (p + 0.5) * scale - 0.5;
+    const double f = std::floor(g);
+    const auto i = static_cast<int64_t>(f);
+    axis[p] = {wrap_coord(i, cells), wrap_coord(i + 1, cells), static_cast<float>(g - f)};
+  }
+  return axis;
+}
+
+/**
+ * Homogeneous bilateral grid: every cell holds the weighted sum of the splatted values followed by the sum of
+ * the weights. Cells are stored along z first, then x, then y, in a pooled texture.
+ */
+struct Grid {
+  uint32_t cells_x;
+  uint32_t cells_y;
+  uint32_t cells_z;
+  /** Floats per cell. */
+  uint32_t stride;
+
+  [[nodiscard]] inline size_t index(uint32_t x, uint32_t y, uint32_t z) const {
+    return ((static_cast<size_t>(y) * cells_x + x) * cells_z + z) * stride;
+  }
+
+  [[nodiscard]] inline size_t get_row_size() const { return static_cast<size_t>(cells_x) * cells_z * stride; }
+};
+
+/** Blurs the grid by [1 2 1] / 4 along one axis; x and y wrap around, z is zero outside. */
+void blur(const Grid& grid, const float* in, float* out, uint32_t axis) {
+  parallel_for(0, grid.cells_y, [&](size_t y) {
+    const auto gy = static_cast<uint32_t>(y);
+    for (uint32_t x = 0; x < grid.cells_x; ++x) {
+      for (uint32_t z = 0; z < grid.cells_z; ++z) {
+        const float* center = in + grid.index(x, gy, z);
+        const float* previous = nullptr;
+        const float* next = nullptr;
+        if (axis == 0) {
+          previous = in + grid.index(wrap_coord(static_cast<int64_t>(x) - 1, grid.cells_x), gy, z);
+          next = in + grid.index(wrap_coord(static_cast<int64_t>(x) + 1, grid.cells_x), gy, z);
+        } else if (axis == 1) {
+          previous = in + grid.index(x, wrap_coord(static_cast<int64_t>(y) - 1, grid.cells_y), z);
+          next = in + grid.index(x, wrap_coord(static_cast<int64_t>(y) + 1, grid.cells_y), z);
+        } else {
+          previous = z > 0 ? center - grid.stride : nullptr;
+          next = z + 1 < grid.cells_z ? center + grid.stride : nullptr;
+        }
+
+        float* result = out + grid.index(x, gy, z);
+        for (uint32_t c = 0; c < grid.stride; ++c) {
+          const float sides = (previous ? previous[c] : 0.0f) + (next ? next[c] : 0.0f);
+          result[c] = 0.5f * center[c] + 0.25f * sides;
+        }
+      }
+    }
+  });
+}
+}  // namespace
+
+void bilateral_filter(const TextureView& src,
+                      const TextureView& guide,
+                      uint32_t guide_channel,
+                      const TextureView& dst,
+                      const BilateralOptions& options /*= {}*/) {
+  if (!ensure(src.is_valid() && dst.has_same_layout(src)) ||
+      !ensure(guide.width == src.width && guide.height == src.height && guide_channel < guide.channels) ||
+      !ensure(options.spatial_sigma > 0.0f && options.range_sigma > 0.0f)) {
+    return;
+  }
+
+  const uint32_t width = src.width;
+  const uint32_t height = src.height;
+  const uint32_t channels = src.channels;
+
+  // Range of the guide.
+  std::vector<float> row_min(height);
+  std::vector<float> row_max(height);
+  std::vector<uint8_t> row_finite(height);
+  parallel_for(0, height, [&](size_t y) {
+    float low = std::numeric_limits<float>::max();
+    float high = std::numeric_limits<float>::lowest();
+    bool finite = true;
+    for (uint32_t x = 0; x < width; ++x) {
+      const float g = guide.at(x, static_cast<uint32_t>(y), guide_channel);
+      finite = finite && std::isfinite(g);
+      low = std::min(low, g);
+      high = std::max(high, g);
+    }
+    row_min[y] = low;
+    row_max[y] = high;
+    row_finite[y] = finite;
+  });
+
+  // Guide values out of the grid have no cell: the source goes through unfiltered.
+  if (std::find(row_finite.begin(), row_finite.end(), 0) != row_finite.end()) {
+    if (dst.data != src.data) {
+      for (uint32_t y = 0; y < height; ++y) {
+        std::copy_n(src.row(y), static_cast<size_t>(width) * channels, dst.row(y));
+      }
+    }
+    return;
+  }
+  const float guide_min = *std::min_element(row_min.begin(), row_min.end());
+  const float guide_max = *std::max_element(row_max.begin(), row_max.end());
+
+  // The range is computed in double since it may overflow a float.
+  const double guide_range = static_cast<double>(guide_max) - static_cast<double>(guide_min);
+  const double range_cell = std::max<double>(options.range_sigma * CELL_SIGMAS, guide_range / (MAX_RANGE_CELLS - 2));
+
+  const auto spatial_cells = [&](uint32_t size) {
+    const auto cells = static_cast<uint32_t>(std::lround(size / (options.spatial_sigma * CELL_SIGMAS)));
+    return std::clamp<uint32_t>(cells, 1, size);
+  };
+
+  Grid grid;
+  grid.cells_x = spatial_cells(width);
+  grid.cells_y = spatial_cells(height);
+  grid.cells_z = std::min(static_cast<uint32_t>(guide_range / range_cell) + 2, MAX_RANGE_CELLS);
+  grid.stride = channels + 1;
+
+  const std::vector<Lerp> columns = make_axis(width, grid.cells_x);
+  const std::vector<Lerp> rows = make_axis(height, grid.cells_y);
+  const auto inv_range_cell = static_cast<float>(1.0 / range_cell);
+  const auto max_depth = static_cast<float>(grid.cells_z - 1);
+  const auto depth = [&](uint32_t x, uint32_t y) {
+    const float t = std::clamp((guide.at(x, y, guide_channel) - guide_min) * inv_range_cell, 0.0f, max_depth);
+    const uint32_t z0 = std::min(static_cast<uint32_t>(t), grid.cells_z - 2);
+    return Lerp{z0, z0 + 1, t - static_cast<float>(z0)};
+  };
+
+  // Pixel rows splatted into each grid row, with their weight: every task owns one grid row, so splatting needs
+  // no synchronization and sums in a deterministic order.
+  std::vector<std::vector<std::pair<uint32_t, float>>> splat_rows(grid.cells_y);
+  for (uint32_t y = 0; y < height; ++y) {
+    splat_rows[rows[y].i0].emplace_back(y, 1.0f - rows[y].t);
+    splat_rows[rows[y].i1].emplace_back(y, rows[y].t);
+  }
+
+  TexturePool* pool = TexturePool::get_instance();
+  Texture grid_texture = pool->acquire(grid.cells_x * grid.cells_z, grid.cells_y, grid.stride);
+  Texture blurred_texture = pool->acquire(grid.cells_x * grid.cells_z, grid.cells_y, grid.stride);
+  float* cells = grid_texture.get_data();
+  float* blurred = blurred_texture.get_data();
+
+  parallel_for(0, grid.cells_y, [&](size_t gy) {
+    float* grid_row = cells + grid.index(0, static_cast<uint32_t>(gy), 0);
+    std::fill_n(grid_row, grid.get_row_size(), 0.0f);
+
+    for (const auto& [y, weight_y] : splat_rows[gy]) {
+      for (uint32_t x = 0; x < width; ++x) {
+        const Lerp& column = columns[x];
+        const Lerp z = depth(x, y);
+        const float* value = &src.at(x, y);
+
+        const float weights_x[2] = {weight_y * (1.0f - column.t), weight_y * column.t};
+        const uint32_t xs[2] = {column.i0, column.i1};
+        for (uint32_t i = 0; i < 2; ++i) {
+          float* cell = grid_row + (static_cast<size_t>(xs[i]) * grid.cells_z + z.i0) * grid.stride;
+          const float w0 = weights_x[i] * (1.0f - z.t);
+          const float w1 = weights_x[i] * z.t;
+          for (uint32_t c = 0; c < channels; ++c) {
+            cell[c] += w0 * value[c];
+            cell[grid.stride + c] += w1 * value[c];
+          }
+          cell[channels] += w0;
+          cell[grid.stride + channels] += w1;
+        }
+      }
+    }
+  });
+
+  // A [1 2 1] / 4 blur along every axis approximates the Gaussian of the bilateral filter, see CELL_SIGMAS.
+  blur(grid, cells, blurred, 0);
+  blur(grid, blurred, cells, 1);
+  blur(grid, cells, blurred, 2);
+
+  parallel_for(0, height, [&](size_t py) {
+    const auto y = static_cast<uint32_t>(py);
+    const Lerp& row = rows[y];
+    std::vector<float> sum(grid.stride);
+
+    for (uint32_t x = 0; x < width; ++x) {
+      const Lerp& column = columns[x];
+      const Lerp z = depth(x, y);
+      std::fill(sum.begin(), sum.end(), 0.0f);
+
+      for (uint32_t j = 0; j < 2; ++j) {
+        const uint32_t gy = j == 0 ? row.i0 : row.i1;
+        const float weight_y = j == 0 ? 1.0f - row.t : row.t;
+        for (uint32_t i = 0; i < 2; ++i) {
+          const uint32_t gx = i == 0 ? column.i0 : column.i1;
+          const float weight_xy = weight_y * (i == 0 ? 1.0f - column.t : column.t);
+          const float* cell = blurred + grid.index(gx, gy, z.i0);
+          const float w0 = weight_xy * (1.0f - z.t);
+          const float w1 = weight_xy * z.t;
+          for (uint32_t c = 0; c < grid.stride; ++c) {
+            sum[c] += w0 * cell[c] + w1 * cell[grid.stride + c];
+          }
+        }
+      }
+
+      // Homogeneous division; cells no pixel reached keep the source value.
+      const float weight = sum[channels];
+      for (uint32_t c = 0; c < channels; ++c) {
+        dst.at(x, y, c) = weight > 1e-6f ? sum[c] / weight : src.at(x, y, c);
+      }
+    }
+  });
+
+  pool->release(std::move(grid_texture));
+  pool->release(std::move(blurred_texture));
+}
+
+Texture bilateral_filter(const Texture& src,
+                         const Texture& guide,
+                         uint32_t guide_channel,
+                         const BilateralOptions& options /*= {}*/) {
+  // Smoothing a constant gives the constant, whatever the guide.
+  if (src.is_uniform()) {
+    return src;
+  }
+  Texture materialized_guide;
+  if (guide.is_uniform()) {
+    materialized_guide = guide;
+    materialized_guide.materialize();
+  }
+  Texture dst(src.get_width(), src.get_height(), src.get_channels());
+  bilateral_filter(src.view(), guide.is_uniform() ? materialized_guide.view() : guide.view(), guide_channel,
+                   dst.view(), options);
+  return dst;
+}
+}  // namespace kn
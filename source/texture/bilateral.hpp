@@ -0,0 +1,68 @@
+/**************************************************************************/
+/* bilateral.hpp                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+struct BilateralOptions {
+  /** Spatial standard deviation, in pixels. */
+  float spatial_sigma = 16.0f;
+  /** Range standard deviation, in guide values. */
+  float range_sigma = 0.1f;
+};
+
+/**
+ * Edge-preserving smoothing with a bilateral grid (Chen, Paris and Durand): pixels are splatted into a 3D grid
+ * of homogeneous values, with cells of sqrt(2) sigmas along x, y and the guide value, the grid is blurred, then
+ * sliced back at every pixel. The cost is linear in the pixel count, whatever the sigmas, and the spatial axes of
+ * the grid wrap around so the result stays tileable. Grids are borrowed from the TexturePool. The guide axis has
+ * at most 256 cells: wider guide ranges smooth with a larger range sigma. A guide with non-finite values leaves
+ * src unfiltered.
+ * @param[in] src The texture to smooth.
+ * @param[in] guide The texture whose edges are preserved, of the size of src; it may be src itself.
+ * @param[in] guide_channel The channel of guide to read.
+ * @param[out] dst The smoothed texture, with the layout of src.
+ * @param[in] options The spatial and range sigmas.
+ */
+KN_TEXTURE_API void bilateral_filter(const TextureView& src,
+                                     const TextureView& guide,
+                                     uint32_t guide_channel,
+                                     const TextureView& dst,
+                                     const BilateralOptions& options = {});
+
+/** Smooths a texture into a new one; a uniform src is returned as it is, see filter_texture. */
+KN_TEXTURE_API Texture bilateral_filter(const Texture& src,
+                                        const Texture& guide,
+                                        uint32_t guide_channel,
+                                        const BilateralOptions& options = {});
+}  // namespace kn
@@ -0,0 +1,74 @@
+/**************************************************************************/
+/* color.hpp                                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace kn {
+/** Decodes an sRGB encoded value to linear light, following IEC 61966-2-1. */
+[[nodiscard]] inline float srgb_to_linear(float value) {
+  return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+/** Encodes a linear light value to sRGB, following IEC 61966-2-1. */
+[[nodiscard]] inline float linear_to_srgb(float value) {
+  return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+/**
+ * Converts RGB to hue, saturation and lightness, all in [0, 1] for inputs in [0, 1]. Branchless like the kshader
+ * RGBtoHSL: two conditional swaps sort the channels while tracking the hue offset of the largest one.
+ */
+[[nodiscard]] inline std::array<float, 3> rgb_to_hsl(float r, float g, float b) {
+  const bool gb = g < b;
+  const float px = gb ? b : g;
+  const float py = gb ? g : b;
+  const float pz = gb ? -1.0f : 0.0f;
+  const float pw = gb ? 2.0f / 3.0f : -1.0f / 3.0f;
+  const bool rp = r < px;
+  const float qx = rp ? px : r;
+  const float qz = rp ? pw : pz;
+  const float qw = rp ? r : px;
+  const float chroma = qx - std::min(qw, py);
+  const float lightness = qx - 0.5f * chroma;
+  const float hue = std::abs((qw - py) / (6.0f * chroma + 1e-10f) + qz);
+  return {hue, chroma / (1.0f - std::abs(2.0f * lightness - 1.0f) + 1e-10f), lightness};
+}
+
+/** Converts hue, saturation and lightness back to RGB, like the kshader HSLtoRGB. */
+[[nodiscard]] inline std::array<float, 3> hsl_to_rgb(float h, float s, float l) {
+  const float chroma = (1.0f - std::abs(2.0f * l - 1.0f)) * s;
+  const auto channel = [&](float value) { return (std::clamp(value, 0.0f, 1.0f) - 0.5f) * chroma + l; };
+  return {channel(std::abs(h * 6.0f - 3.0f) - 1.0f), channel(2.0f - std::abs(h * 6.0f - 2.0f)),
+          channel(2.0f - std::abs(h * 6.0f - 4.0f))};
+}
+}  // namespace kn
@@ -0,0 +1,414 @@
+/**************************************************************************/
+/* color_grading.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "color_grading.hpp"
+#include <algorithm>
+#include <cmath>
+#include "color.hpp"
+#include "math/simd.hpp"
+#include "texture_format.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+constexpr uint32_t CURVE_SIZE = ColorGrading::CURVE_SIZE;
+constexpr uint32_t CUBE_SIZE = ColorGrading::CUBE_SIZE;
+
+/**
+ * Position of a value clamped to [0, 1], NaN reading as 0, in a table of size entries: the entry before it and the
+ * offset past it. Positions are not negative, so truncation floors them without a call to floor.
+ */
+inline void locate(float value, uint32_t size, uint32_t& index, float& t) {
+  const float position = std::max(0.0f, std::min(value, 1.0f)) * static_cast<float>(size - 1);
+  index = std::min(static_cast<uint32_t>(position), size - 2);
+  t = position - static_cast<float>(index);
+}
+
+inline float lookup(const float* table, float value) {
+  uint32_t index;
+  float t;
+  locate(value, CURVE_SIZE, index, t);
+  return table[index] + t * (table[index + 1] - table[index]);
+}
+
+/** Looks up four values, each lane in the table starting at its own offset of base. */
+inline simd::vfloat4 lookup(const float* tables, simd::vint4 base, simd::vfloat4 value) {
+  using namespace simd;
+  const vfloat4 position = min(max(value, broadcast(0.0f)), broadcast(1.0f)) * broadcast(float{CURVE_SIZE - 1});
+  const vfloat4 entry = min(floor(position), broadcast(float{CURVE_SIZE - 2}));
+  int32_t offsets[WIDTH];
+  store(offsets, base + to_int(entry));
+  float lo[WIDTH];
+  float hi[WIDTH];
+  for (uint32_t i = 0; i < WIDTH; ++i) {
+    lo[i] = tables[offsets[i]];
+    hi[i] = tables[offsets[i] + 1];
+  }
+  return lerp(load(lo), load(hi), position - entry);
+}
+
+/** Moves a value of [0, 1] toward 0 or 1 by amount, in [-1, 1]. */
+inline float push(float value, float amount) {
+  return amount >= 0.0f ? value + (1.0f - value) * amount : value * (1.0f + amount);
+}
+
+void adjust_hsl(const HslAdjustment& adjustment, float* rgb) {
+  auto [h, s, l] = rgb_to_hsl(rgb[0], rgb[1], rgb[2]);
+  h += adjustment.hue;
+  h -= std::floor(h);
+  const auto out = hsl_to_rgb(h, std::min(1.0f, s * (1.0f + adjustment.saturation)), push(l, adjustment.lightness));
+  std::copy(out.begin(), out.end(), rgb);
+}
+
+/**
+ * Tetrahedral lookup of the RGB table: the cell is split into six tetrahedra along its gray diagonal, by the order
+ * of the offsets. Only four nodes are read, and the faces of the tetrahedra, where two channels are equal, match
+ * the creases of HSL adjustments, which trilinear interpolation would blur.
+ */
+inline simd::vfloat4 sample_cube(const float* cube, float r, float g, float b) {
+  using namespace simd;
+  uint32_t ir, ig, ib;
+  float tr, tg, tb;
+  locate(r, CUBE_SIZE, ir, tr);
+  locate(g, CUBE_SIZE, ig, tg);
+  locate(b, CUBE_SIZE, ib, tb);
+
+  constexpr size_t STEP_R = 4;
+  constexpr size_t STEP_G = size_t{CUBE_SIZE} * 4;
+  constexpr size_t STEP_B = size_t{CUBE_SIZE} * CUBE_SIZE * 4;
+  const float* c = cube + ib * STEP_B + ig * STEP_G + ir * STEP_R;
+
+  // Walks from the lowest node to the highest one, one axis at a time, by decreasing offset.
+  size_t first, second;
+  float t0, t1, t2;
+  if (tr >= tg) {
+    if (tg >= tb) {
+      first = STEP_R, second = STEP_R + STEP_G, t0 = tr, t1 = tg, t2 = tb;
+    } else if (tr >= tb) {
+      first = STEP_R, second = STEP_R + STEP_B, t0 = tr, t1 = tb, t2 = tg;
+    } else {
+      first = STEP_B, second = STEP_B + STEP_R, t0 = tb, t1 = tr, t2 = tg;
+    }
+  } else if (tr >= tb) {
+    first = STEP_G, second = STEP_G + STEP_R, t0 = tg, t1 = tr, t2 = tb;
+  } else if (tg >= tb) {
+    first = STEP_G, second = STEP_G + STEP_B, t0 = tg, t1 = tb, t2 = tr;
+  } else {
+    first = STEP_B, second = STEP_B + STEP_G, t0 = tb, t1 = tg, t2 = tr;
+  }
+
+  const vfloat4 c0 = load(c);
+  const vfloat4 c1 = load(c + first);
+  const vfloat4 c2 = load(c + second);
+  const vfloat4 c3 = load(c + STEP_R + STEP_G + STEP_B);
+  return madd(broadcast(t2), c3 - c2, madd(broadcast(t1), c2 - c1, madd(broadcast(t0), c1 - c0, c0)));
+}
+}  // namespace
+
+float Levels::evaluate(float value) const {
+  const float range = in_white - in_black;
+  float t = range > 0.0f ? (value - in_black) / range : (value >= in_black ? 1.0f : 0.0f);
+  t = std::clamp(t, 0.0f, 1.0f);
+  if (gamma > 0.0f && gamma != 1.0f) {
+    t = std::pow(t, 1.0f / gamma);
+  }
+  return out_black + t * (out_white - out_black);
+}
+
+ToneCurve::ToneCurve(std::vector<CurvePoint> points) : _points(std::move(points)) {
+  std::stable_sort(_points.begin(), _points.end(), [](const CurvePoint& a, const CurvePoint& b) { return a.x < b.x; });
+  // Of points sharing an abscissa, the last one given wins.
+  auto last = std::unique(_points.rbegin(), _points.rend(),
+                          [](const CurvePoint& a, const CurvePoint& b) { return a.x == b.x; });
+  _points.erase(_points.begin(), last.base());
+
+  const size_t count = _points.size();
+  _tangents.assign(count, 0.0f);
+  if (count < 2) {
+    return;
+  }
+
+  std::vector<float> slopes(count - 1);
+  for (size_t i = 0; i + 1 < count; ++i) {
+    slopes[i] = (_points[i + 1].y - _points[i].y) / (_points[i + 1].x - _points[i].x);
+  }
+  _tangents[0] = slopes[0];
+  _tangents[count - 1] = slopes[count - 2];
+  for (size_t i = 1; i + 1 < count; ++i) {
+    _tangents[i] = slopes[i - 1] * slopes[i] <= 0.0f ? 0.0f : 0.5f * (slopes[i - 1] + slopes[i]);
+  }
+
+  // Limits the tangents so that every segment stays monotone.
+  for (size_t i = 0; i + 1 < count; ++i) {
+    if (slopes[i] == 0.0f) {
+      _tangents[i] = 0.0f;
+      _tangents[i + 1] = 0.0f;
+      continue;
+    }
+    const float a = _tangents[i] / slopes[i];
+    const float b = _tangents[i + 1] / slopes[i];
+    const float length = a * a + b * b;
+    if (length > 9.0f) {
+      const float scale = 3.0f / std::sqrt(length);
+      _tangents[i] = scale * a * slopes[i];
+      _tangents[i + 1] = scale * b * slopes[i];
+    }
+  }
+}
+
+float ToneCurve::evaluate(float value) const {
+  if (_points.empty()) {
+    return value;
+  }
+  if (value <= _points.front().x) {
+    return _points.front().y;
+  }
+  if (value >= _points.back().x) {
+    return _points.back().y;
+  }
+
+  const auto next = std::upper_bound(_points.begin(), _points.end(), value,
+                                     [](float v, const CurvePoint& point) { return v < point.x; });
+  const auto i = static_cast<size_t>(next - _points.begin()) - 1;
+  const CurvePoint& p0 = _points[i];
+  const CurvePoint& p1 = _points[i + 1];
+  const float h = p1.x - p0.x;
+  const float t = (value - p0.x) / h;
+  const float t2 = t * t;
+  const float t3 = t2 * t;
+  return (2.0f * t3 - 3.0f * t2 + 1.0f) * p0.y + (t3 - 2.0f * t2 + t) * h * _tangents[i] +
+         (-2.0f * t3 + 3.0f * t2) * p1.y + (t3 - t2) * h * _tangents[i + 1];
+}
+
+void ColorGrading::add_levels(const Levels& levels, uint32_t channel_mask /*= RGB_CHANNELS*/) {
+  _steps.push_back({levels, channel_mask});
+  _baked = false;
+}
+
+void ColorGrading::add_curve(const ToneCurve& curve, uint32_t channel_mask /*= RGB_CHANNELS*/) {
+  _steps.push_back({curve, channel_mask});
+  _baked = false;
+}
+
+void ColorGrading::add_hsl(const HslAdjustment& adjustment) {
+  _steps.push_back({adjustment, RGB_CHANNELS});
+  _baked = false;
+}
+
+void ColorGrading::clear() {
+  _steps.clear();
+  _baked = false;
+}
+
+void ColorGrading::evaluate(float* values, uint32_t count) const {
+  evaluate(values, count, 0, _steps.size());
+}
+
+void ColorGrading::evaluate(float* values, uint32_t count, size_t first, size_t last) const {
+  count = std::min(count, 4u);
+  for (size_t s = first; s < last; ++s) {
+    const Step& step = _steps[s];
+    if (const auto* hsl = std::get_if<HslAdjustment>(&step.adjustment)) {
+      if (count >= 3) {
+        adjust_hsl(*hsl, values);
+      }
+      continue;
+    }
+    const auto* levels = std::get_if<Levels>(&step.adjustment);
+    const auto* curve = std::get_if<ToneCurve>(&step.adjustment);
+    for (uint32_t c = 0; c < count; ++c) {
+      if ((step.channel_mask >> c) & 1) {
+        values[c] = levels != nullptr ? levels->evaluate(values[c]) : curve->evaluate(values[c]);
+      }
+    }
+  }
+}
+
+void ColorGrading::bake() {
+  _shaper_steps = static_cast<size_t>(
+      std::find_if(_steps.begin(), _steps.end(),
+                   [](const Step& step) { return std::holds_alternative<HslAdjustment>(step.adjustment); }) -
+      _steps.begin());
+  _modified_mask = 0;
+  for (const Step& step : _steps) {
+    _modified_mask |= step.channel_mask;
+  }
+
+  // Per-channel steps never mix channels, so one evaluation fills the entry of all four tables: the color ones
+  // after the steps preceding the first HSL adjustment, alpha after all of them.
+  _curves.resize(static_cast<size_t>(CURVE_SIZE) * 4);
+  for (uint32_t i = 0; i < CURVE_SIZE; ++i) {
+    const float x = static_cast<float>(i) / (CURVE_SIZE - 1);
+    float values[4] = {x, x, x, x};
+    evaluate(values, 4, 0, _shaper_steps);
+    for (uint32_t c = 0; c < 3; ++c) {
+      _curves[c * CURVE_SIZE + i] = values[c];
+    }
+    evaluate(values, 4, _shaper_steps, _steps.size());
+    _curves[3 * CURVE_SIZE + i] = values[3];
+  }
+
+  _cube.clear();
+  if (_shaper_steps < _steps.size()) {
+    _cube.resize(static_cast<size_t>(CUBE_SIZE) * CUBE_SIZE * CUBE_SIZE * 4);
+    parallel_for(0, CUBE_SIZE, [&](size_t b) {
+      for (uint32_t g = 0; g < CUBE_SIZE; ++g) {
+        for (uint32_t r = 0; r < CUBE_SIZE; ++r) {
+          float* entry = _cube.data() + ((b * CUBE_SIZE + g) * CUBE_SIZE + r) * 4;
+          entry[0] = static_cast<float>(r) / (CUBE_SIZE - 1);
+          entry[1] = static_cast<float>(g) / (CUBE_SIZE - 1);
+          entry[2] = static_cast<float>(b) / (CUBE_SIZE - 1);
+          entry[3] = 0.0f;
+          evaluate(entry, 3, _shaper_steps, _steps.size());
+        }
+      }
+    });
+  }
+  _baked = true;
+}
+
+void ColorGrading::apply(const TextureView& src, const TextureView& dst) {
+  if (!ensure(src.is_valid() && src.channels <= 4 && dst.has_same_layout(src))) {
+    return;
+  }
+  if (!_baked) {
+    bake();
+  }
+  if (!_cube.empty() && !ensure(src.channels >= 3)) {
+    return;
+  }
+  // Loops over the channels of a pixel and the phases of the interleaved values unroll for every format.
+  dispatch_channels(src.channels, [&](auto format) {
+    constexpr uint32_t channels = format();
+    if constexpr (channels >= 3) {
+      if (!_cube.empty()) {
+        const bool alpha = channels == 4 && ((_modified_mask >> 3) & 1);
+        parallel_for(0, src.height, [&](size_t y) {
+          const float* in = src.row(static_cast<uint32_t>(y));
+          float* out = dst.row(static_cast<uint32_t>(y));
+          for (uint32_t x = 0; x < src.width; ++x, in += channels, out += channels) {
+            float rgb[simd::WIDTH];
+            simd::store(rgb, sample_cube(_cube.data(), lookup(_curves.data(), in[0]),
+                                         lookup(_curves.data() + CURVE_SIZE, in[1]),
+                                         lookup(_curves.data() + 2 * CURVE_SIZE, in[2])));
+            if constexpr (channels == 4) {
+              out[3] = alpha ? lookup(_curves.data() + 3 * CURVE_SIZE, in[3]) : in[3];
+            }
+            std::copy(rgb, rgb + 3, out);
+          }
+        });
+        return;
+      }
+    }
+
+    // Interleaved values cycle through the channels with a period of lcm(channels, 4) floats, at most 3 vectors.
+    constexpr uint32_t phases = channels == 3 ? 3 : 1;
+    simd::vint4 bases[phases];
+    simd::vmask4 keep[phases];
+    for (uint32_t p = 0; p < phases; ++p) {
+      int32_t base[simd::WIDTH];
+      float unmodified[simd::WIDTH];
+      for (uint32_t i = 0; i < simd::WIDTH; ++i) {
+        const uint32_t c = (p * simd::WIDTH + i) % channels;
+        base[i] = static_cast<int32_t>(c * CURVE_SIZE);
+        unmodified[i] = ((_modified_mask >> c) & 1) ? 0.0f : 1.0f;
+      }
+      bases[p] = simd::load(base);
+      keep[p] = simd::broadcast(0.0f) < simd::load(unmodified);
+    }
+
+    parallel_for(0, src.height, [&](size_t y) {
+      const float* in = src.row(static_cast<uint32_t>(y));
+      float* out = dst.row(static_cast<uint32_t>(y));
+      const size_t count = static_cast<size_t>(src.width) * channels;
+      size_t i = 0;
+      for (uint32_t p = 0; i + simd::WIDTH <= count; i += simd::WIDTH, p = p + 1 == phases ? 0 : p + 1) {
+        const simd::vfloat4 value = simd::load(in + i);
+        simd::store(out + i, simd::select(keep[p], value, lookup(_curves.data(), bases[p], value)));
+      }
+      for (; i < count; ++i) {
+        const uint32_t c = static_cast<uint32_t>(i % channels);
+        out[i] = ((_modified_mask >> c) & 1) ? lookup(_curves.data() + c * CURVE_SIZE, in[i]) : in[i];
+      }
+    });
+  });
+}
+
+GradientMap::GradientMap(std::vector<GradientStop> stops) : _table(static_cast<size_t>(SIZE) * 4, 0.0f) {
+  if (stops.empty()) {
+    return;
+  }
+  std::stable_sort(stops.begin(), stops.end(),
+                   [](const GradientStop& a, const GradientStop& b) { return a.position < b.position; });
+
+  size_t next = 0;
+  for (uint32_t i = 0; i < SIZE; ++i) {
+    const float x = static_cast<float>(i) / (SIZE - 1);
+    while (next < stops.size() && stops[next].position <= x) {
+      ++next;
+    }
+    float* entry = _table.data() + static_cast<size_t>(i) * 4;
+    if (next == 0 || next == stops.size()) {
+      const GradientStop& stop = stops[next == 0 ? 0 : stops.size() - 1];
+      std::copy(stop.color.begin(), stop.color.end(), entry);
+      continue;
+    }
+    const GradientStop& a = stops[next - 1];
+    const GradientStop& b = stops[next];
+    const float t = (x - a.position) / (b.position - a.position);
+    for (uint32_t c = 0; c < 4; ++c) {
+      entry[c] = a.color[c] + t * (b.color[c] - a.color[c]);
+    }
+  }
+}
+
+Texture ColorGrading::apply(const Texture& src) {
+  return filter_texture(src, src.get_width(), src.get_height(), src.get_channels(),
+                        [&](const TextureView& from, const TextureView& to) { apply(from, to); });
+}
+
+void GradientMap::apply(const TextureView& src, uint32_t channel, const TextureView& dst) const {
+  if (!ensure(src.is_valid() && channel < src.channels) ||
+      !ensure(dst.width == src.width && dst.height == src.height && dst.channels <= 4)) {
+    return;
+  }
+
+  parallel_for(0, src.height, [&](size_t y) {
+    for (uint32_t x = 0; x < src.width; ++x) {
+      uint32_t index;
+      float t;
+      locate(src.at(x, static_cast<uint32_t>(y), channel), SIZE, index, t);
+      const float* entry = _table.data() + static_cast<size_t>(index) * 4;
+      float color[simd::WIDTH];
+      simd::store(color, simd::lerp(simd::load(entry), simd::load(entry + 4), simd::broadcast(t)));
+      std::copy(color, color + dst.channels, &dst.at(x, static_cast<uint32_t>(y)));
+    }
+  });
+}
+}  // namespace kn
@@ -0,0 +1,176 @@
+/**************************************************************************/
+/* color_grading.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/** Bit mask of the first three channels, the default target of per-channel adjustments. */
+constexpr uint32_t RGB_CHANNELS = 0b0111;
+
+/** Remaps [in_black, in_white] to [out_black, out_white], with a gamma correction in between. */
+struct KN_TEXTURE_API Levels {
+  float in_black = 0.0f;
+  float in_white = 1.0f;
+  /** Values above 1 brighten the midtones. */
+  float gamma = 1.0f;
+  float out_black = 0.0f;
+  float out_white = 1.0f;
+
+  [[nodiscard]] float evaluate(float value) const;
+};
+
+struct CurvePoint {
+  float x = 0.0f;
+  float y = 0.0f;
+};
+
+/** Monotone cubic interpolation of control points (Fritsch-Carlson), flat beyond the first and last ones. */
+class KN_TEXTURE_API ToneCurve {
+ public:
+  ToneCurve() = default;
+
+  /** Builds the curve through the given points, in any order; no point is the identity. */
+  explicit ToneCurve(std::vector<CurvePoint> points);
+
+  [[nodiscard]] float evaluate(float value) const;
+
+ private:
+  std::vector<CurvePoint> _points;
+  /** Slope of the curve at every point. */
+  std::vector<float> _tangents;
+};
+
+/** Shifts the hue and scales the saturation and lightness toward their extremes. */
+struct HslAdjustment {
+  /** Hue rotation, in turns. */
+  float hue = 0.0f;
+  /** In [-1, 1], scales the saturation by 1 + saturation, so -1 removes it and grays stay gray. */
+  float saturation = 0.0f;
+  /** In [-1, 1]: -1 turns black, 1 turns white. */
+  float lightness = 0.0f;
+};
+
+/**
+ * Chain of color adjustments, applied in the order they were added. The chain is baked into lookup tables on the
+ * first apply after a change, then every apply runs the whole chain in a single pass over the pixels:
+ * per-channel adjustments compose into one 1D table per channel, and adjustments mixing the color channels
+ * compose, with the ones following them, into a 3D table over RGB sampled with tetrahedral interpolation.
+ * Table inputs are clamped to [0, 1].
+ */
+class KN_TEXTURE_API ColorGrading {
+ public:
+  /** Entries of the per-channel tables. */
+  static constexpr uint32_t CURVE_SIZE = 4096;
+  /** Nodes along each axis of the RGB table. */
+  static constexpr uint32_t CUBE_SIZE = 33;
+
+  /** Adds levels applied to the channels set in channel_mask. */
+  void add_levels(const Levels& levels, uint32_t channel_mask = RGB_CHANNELS);
+
+  /** Adds a tone curve applied to the channels set in channel_mask. */
+  void add_curve(const ToneCurve& curve, uint32_t channel_mask = RGB_CHANNELS);
+
+  /** Adds an HSL adjustment of the first three channels, which requires textures with at least 3 channels. */
+  void add_hsl(const HslAdjustment& adjustment);
+
+  /** Removes every adjustment. */
+  void clear();
+
+  /**
+   * Applies the chain, baking its tables first if it changed.
+   * @param[in] src The texture to adjust, with at most 4 channels.
+   * @param[out] dst The adjusted texture, with the layout of src; it may be src itself.
+   */
+  void apply(const TextureView& src, const TextureView& dst);
+
+  /** Applies the chain to a new texture; a uniform src gives a uniform texture, see filter_texture. */
+  [[nodiscard]] Texture apply(const Texture& src);
+
+  /** Applies the chain to the first min(4, count) values, without tables; used to bake them. */
+  void evaluate(float* values, uint32_t count) const;
+
+ private:
+  struct Step {
+    std::variant<Levels, ToneCurve, HslAdjustment> adjustment;
+    uint32_t channel_mask;
+  };
+
+  /** Applies the steps in [first, last). */
+  void evaluate(float* values, uint32_t count, size_t first, size_t last) const;
+
+  void bake();
+
+  std::vector<Step> _steps;
+  bool _baked = false;
+  /** Steps before the first HSL adjustment, which the per-channel tables of the color channels hold. */
+  size_t _shaper_steps = 0;
+  /** Channels modified by any step. */
+  uint32_t _modified_mask = 0;
+  /** CURVE_SIZE entries per channel. */
+  std::vector<float> _curves;
+  /** CUBE_SIZE^3 RGB entries padded to 4 floats, red varying fastest; empty without HSL adjustment. */
+  std::vector<float> _cube;
+};
+
+struct GradientStop {
+  float position = 0.0f;
+  std::array<float, 4> color = {0.0f, 0.0f, 0.0f, 1.0f};
+};
+
+/** Maps a channel to colors interpolated between gradient stops, baked into a table when constructed. */
+class KN_TEXTURE_API GradientMap {
+ public:
+  /** Entries of the table. */
+  static constexpr uint32_t SIZE = 1024;
+
+  /** Builds the table from stops in any order; colors are constant beyond the first and last stop. */
+  explicit GradientMap(std::vector<GradientStop> stops);
+
+  /**
+   * Maps every pixel of a channel of src, clamped to [0, 1], to the color of the gradient at that value.
+   * @param[in] src The texture to map.
+   * @param[in] channel The channel of src to read.
+   * @param[out] dst The mapped texture, of the size of src, with at most 4 channels which receive the first
+   * channels of the gradient colors.
+   */
+  void apply(const TextureView& src, uint32_t channel, const TextureView& dst) const;
+
+ private:
+  /** SIZE RGBA entries. */
+  std::vector<float> _table;
+};
+}  // namespace kn
@@ -0,0 +1,423 @@
+/**************************************************************************/
+/* connected_components.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "connected_components.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+constexpr uint32_t TILE_SIZE = 64;
+constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+/** Component found inside a single tile. */
+struct LocalComponent {
+  /** Raster index of its first pixel, which orders labels. */
+  uint64_t first_pixel;
+  uint32_t pixel_count;
+  int32_t min_x;
+  int32_t min_y;
+  int32_t max_x;
+  int32_t max_y;
+  double sum_x;
+  double sum_y;
+  double sum_value;
+};
+
+struct Tile {
+  uint32_t x0;
+  uint32_t y0;
+  uint32_t width;
+  uint32_t height;
+  /** Index of its first component among all tile components. */
+  uint32_t first_node;
+  std::vector<LocalComponent> components;
+};
+
+/** Shift of a component, in whole texture periods. */
+struct Shift {
+  int32_t x;
+  int32_t y;
+
+  Shift operator+(const Shift& other) const { return {x + other.x, y + other.y}; }
+  Shift operator-(const Shift& other) const { return {x - other.x, y - other.y}; }
+  bool operator==(const Shift&) const = default;
+};
+
+/**
+ * Union-find over tile components, keeping for every node the shift that brings its pixels next to its parent's.
+ * A merge that closes a loop with a non-zero shift means the component winds around the texture.
+ * The root of a set is always its node with the first pixel in raster order, so the result is deterministic.
+ */
+class ShiftedUnionFind {
+ public:
+  explicit ShiftedUnionFind(const std::vector<uint64_t>& first_pixels)
+      : _first_pixels(first_pixels),
+        _parents(first_pixels.size()),
+        _shifts(first_pixels.size(), Shift{0, 0}),
+        _wraps(first_pixels.size(), 0) {
+    for (uint32_t i = 0; i < _parents.size(); ++i) {
+      _parents[i] = i;
+    }
+  }
+
+  /** Returns the root of node and the shift from node to it. */
+  std::pair<uint32_t, Shift> find(uint32_t node) {
+    Shift total{0, 0};
+    uint32_t root = node;
+    while (_parents[root] != root) {
+      total = total + _shifts[root];
+      root = _parents[root];
+    }
+
+    // Path compression, each node on the path now points at the root with its full shift.
+    Shift remaining = total;
+    while (node != root) {
+      const uint32_t parent = _parents[node];
+      const Shift step = _shifts[node];
+      _parents[node] = root;
+      _shifts[node] = remaining;
+      remaining = remaining - step;
+      node = parent;
+    }
+
+    return {root, total};
+  }
+
+  /** Connects a and b, pixels of b being next to pixels of a once shifted by shift. */
+  void unite(uint32_t a, uint32_t b, Shift shift) {
+    const auto [root_a, shift_a] = find(a);
+    const auto [root_b, shift_b] = find(b);
+    const Shift b_to_a = shift_a + shift - shift_b;
+
+    if (root_a == root_b) {
+      _wraps[root_a] |= b_to_a.x != 0 ? ComponentTable::WRAPS_X : 0;
+      _wraps[root_a] |= b_to_a.y != 0 ? ComponentTable::WRAPS_Y : 0;
+      return;
+    }
+
+    if (_first_pixels[root_a] < _first_pixels[root_b]) {
+      _parents[root_b] = root_a;
+      _shifts[root_b] = b_to_a;
+      _wraps[root_a] |= _wraps[root_b];
+    } else {
+      _parents[root_a] = root_b;
+      _shifts[root_a] = Shift{0, 0} - b_to_a;
+      _wraps[root_b] |= _wraps[root_a];
+    }
+  }
+
+  [[nodiscard]] uint8_t get_wraps(uint32_t root) const { return _wraps[root]; }
+
+ private:
+  const std::vector<uint64_t>& _first_pixels;
+  std::vector<uint32_t> _parents;
+  std::vector<Shift> _shifts;
+  std::vector<uint8_t> _wraps;
+};
+
+uint32_t find_local(std::vector<uint32_t>& parents, uint32_t i) {
+  while (parents[i] != i) {
+    parents[i] = parents[parents[i]];
+    i = parents[i];
+  }
+  return i;
+}
+
+void unite_local(std::vector<uint32_t>& parents, uint32_t a, uint32_t b) {
+  a = find_local(parents, a);
+  b = find_local(parents, b);
+  if (a < b) {
+    parents[b] = a;
+  } else if (b < a) {
+    parents[a] = b;
+  }
+}
+
+/** Labels the components of one tile, without wrapping, and writes tile-local ids to labels. */
+void label_tile(const TextureView& mask,
+                uint32_t channel,
+                float threshold,
+                Connectivity connectivity,
+                Tile& tile,
+                std::vector<uint32_t>& labels) {
+  thread_local std::vector<uint32_t> parents;
+  parents.assign(static_cast<size_t>(tile.width) * tile.height, NONE);
+
+  const auto local = [&](uint32_t x, uint32_t y) { return y * tile.width + x; };
+
+  for (uint32_t y = 0; y < tile.height; ++y) {
+    for (uint32_t x = 0; x < tile.width; ++x) {
+      if (mask.at(tile.x0 + x, tile.y0 + y, channel) < threshold) {
+        continue;
+      }
+      const uint32_t i = local(x, y);
+      parents[i] = i;
+
+      const auto link = [&](int64_t nx, int64_t ny) {
+        if (nx < 0 || ny < 0 || nx >= tile.width) {
+          return;
+        }
+        const uint32_t neighbour = local(static_cast<uint32_t>(nx), static_cast<uint32_t>(ny));
+        if (parents[neighbour] != NONE) {
+          unite_local(parents, i, neighbour);
+        }
+      };
+      link(static_cast<int64_t>(x) - 1, y);
+      link(x, static_cast<int64_t>(y) - 1);
+      if (connectivity == Connectivity::Eight) {
+        link(static_cast<int64_t>(x) - 1, static_cast<int64_t>(y) - 1);
+        link(static_cast<int64_t>(x) + 1, static_cast<int64_t>(y) - 1);
+      }
+    }
+  }
+
+  // Roots are the first pixel of their component, so numbering them in raster order numbers components in order.
+  tile.components.clear();
+  for (uint32_t y = 0; y < tile.height; ++y) {
+    for (uint32_t x = 0; x < tile.width; ++x) {
+      const uint32_t i = local(x, y);
+      const size_t pixel = static_cast<size_t>(tile.y0 + y) * mask.width + tile.x0 + x;
+      if (parents[i] == NONE) {
+        labels[pixel] = NONE;
+        continue;
+      }
+
+      const uint32_t root = find_local(parents, i);
+      const auto gx = static_cast<int32_t>(tile.x0 + x);
+      const auto gy = static_cast<int32_t>(tile.y0 + y);
+      const float value = mask.at(tile.x0 + x, tile.y0 + y, channel);
+
+      if (root == i) {
+        labels[pixel] = static_cast<uint32_t>(tile.components.size());
+        tile.components.push_back({pixel, 0, gx, gy, gx, gy, 0.0, 0.0, 0.0});
+      } else {
+        const size_t root_pixel = static_cast<size_t>(tile.y0 + root / tile.width) * mask.width + tile.x0 +
+                                  root % tile.width;
+        labels[pixel] = labels[root_pixel];
+      }
+
+      LocalComponent& component = tile.components[labels[pixel]];
+      component.pixel_count++;
+      component.min_x = std::min(component.min_x, gx);
+      component.max_x = std::max(component.max_x, gx);
+      component.min_y = std::min(component.min_y, gy);
+      component.max_y = std::max(component.max_y, gy);
+      component.sum_x += gx;
+      component.sum_y += gy;
+      component.sum_value += value;
+    }
+  }
+}
+
+/** Accumulates the node statistics into its final component, in the frame of the component root. */
+struct Accumulator {
+  uint32_t pixel_count = 0;
+  int64_t min_x = std::numeric_limits<int64_t>::max();
+  int64_t min_y = std::numeric_limits<int64_t>::max();
+  int64_t max_x = std::numeric_limits<int64_t>::min();
+  int64_t max_y = std::numeric_limits<int64_t>::min();
+  double sum_x = 0.0;
+  double sum_y = 0.0;
+  double sum_value = 0.0;
+};
+
+/** Writes the bounds along one axis, moved so that min lies in [0, size). */
+void finalize_axis(bool wraps,
+                   uint32_t size,
+                   uint32_t count,
+                   int64_t min,
+                   int64_t max,
+                   double sum,
+                   int32_t& out_min,
+                   int32_t& out_max,
+                   float& out_centroid) {
+  if (wraps) {
+    out_min = 0;
+    out_max = static_cast<int32_t>(size) - 1;
+    out_centroid = static_cast<float>(size) * 0.5f;
+    return;
+  }
+  const int64_t periods = min >= 0 ? min / size : -((-min + size - 1) / size);
+  const int64_t offset = periods * size;
+  out_min = static_cast<int32_t>(min - offset);
+  out_max = static_cast<int32_t>(max - offset);
+  out_centroid = static_cast<float>(sum / count - static_cast<double>(offset));
+}
+}  // namespace
+
+void label_components(const TextureView& mask,
+                      uint32_t channel,
+                      float threshold,
+                      Connectivity connectivity,
+                      ComponentLabels& out) {
+  if (!ensure(mask.is_valid() && channel < mask.channels)) {
+    return;
+  }
+
+  const uint32_t width = mask.width;
+  const uint32_t height = mask.height;
+  out.width = width;
+  out.height = height;
+  out.labels.resize(mask.get_pixel_count());
+
+  const uint32_t tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+  const uint32_t tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+  std::vector<Tile> tiles(static_cast<size_t>(tiles_x) * tiles_y);
+  for (uint32_t ty = 0; ty < tiles_y; ++ty) {
+    for (uint32_t tx = 0; tx < tiles_x; ++tx) {
+      Tile& tile = tiles[ty * tiles_x + tx];
+      tile.x0 = tx * TILE_SIZE;
+      tile.y0 = ty * TILE_SIZE;
+      tile.width = std::min(TILE_SIZE, width - tile.x0);
+      tile.height = std::min(TILE_SIZE, height - tile.y0);
+    }
+  }
+
+  parallel_for(0, tiles.size(),
+               [&](size_t t) { label_tile(mask, channel, threshold, connectivity, tiles[t], out.labels); });
+
+  std::vector<uint64_t> first_pixels;
+  for (Tile& tile : tiles) {
+    tile.first_node = static_cast<uint32_t>(first_pixels.size());
+    for (const LocalComponent& component : tile.components) {
+      first_pixels.push_back(component.first_pixel);
+    }
+  }
+
+  // Merge components across tile borders, including the wrapping ones. Only pixels on the last row or column of
+  // a tile, or the first column for the anti-diagonal, can have a neighbour in another tile.
+  ShiftedUnionFind nodes(first_pixels);
+  const auto node_at = [&](uint32_t x, uint32_t y) {
+    const uint32_t local = out.labels[static_cast<size_t>(y) * width + x];
+    return local == NONE ? NONE : tiles[(y / TILE_SIZE) * tiles_x + x / TILE_SIZE].first_node + local;
+  };
+
+  const auto link = [&](uint32_t x, uint32_t y, uint32_t node, int64_t nx, int64_t ny) {
+    const bool crosses_x = nx < 0 || nx >= width;
+    const bool crosses_y = ny >= height;
+    const uint32_t qx = wrap_coord(nx, width);
+    const uint32_t qy = wrap_coord(ny, height);
+    if (!crosses_x && !crosses_y && qx / TILE_SIZE == x / TILE_SIZE && qy / TILE_SIZE == y / TILE_SIZE) {
+      return;
+    }
+    const uint32_t neighbour = node_at(qx, qy);
+    if (neighbour != NONE) {
+      const Shift shift{nx < 0 ? -1 : (nx >= width ? 1 : 0), crosses_y ? 1 : 0};
+      nodes.unite(node, neighbour, shift);
+    }
+  };
+
+  for (uint32_t y = 0; y < height; ++y) {
+    const bool last_row = (y + 1) % TILE_SIZE == 0 || y + 1 == height;
+    for (uint32_t x = 0; x < width; ++x) {
+      const bool last_column = (x + 1) % TILE_SIZE == 0 || x + 1 == width;
+      const bool first_column = x % TILE_SIZE == 0;
+      if (!last_row && !last_column && !first_column) {
+        continue;
+      }
+      const uint32_t node = node_at(x, y);
+      if (node == NONE) {
+        continue;
+      }
+      link(x, y, node, static_cast<int64_t>(x) + 1, y);
+      link(x, y, node, x, static_cast<int64_t>(y) + 1);
+      if (connectivity == Connectivity::Eight) {
+        link(x, y, node, static_cast<int64_t>(x) + 1, static_cast<int64_t>(y) + 1);
+        link(x, y, node, static_cast<int64_t>(x) - 1, static_cast<int64_t>(y) + 1);
+      }
+    }
+  }
+
+  // Roots are numbered in raster order of their first pixel.
+  std::vector<uint32_t> roots;
+  for (uint32_t node = 0; node < first_pixels.size(); ++node) {
+    if (nodes.find(node).first == node) {
+      roots.push_back(node);
+    }
+  }
+  std::sort(roots.begin(), roots.end(),
+            [&](uint32_t a, uint32_t b) { return first_pixels[a] < first_pixels[b]; });
+
+  std::vector<uint32_t> root_labels(first_pixels.size(), 0);
+  for (uint32_t i = 0; i < roots.size(); ++i) {
+    root_labels[roots[i]] = i + 1;
+  }
+
+  std::vector<uint32_t> node_labels(first_pixels.size());
+  std::vector<Accumulator> accumulators(roots.size());
+  for (const Tile& tile : tiles) {
+    for (uint32_t local = 0; local < tile.components.size(); ++local) {
+      const uint32_t node = tile.first_node + local;
+      const auto [root, shift] = nodes.find(node);
+      const uint32_t label = root_labels[root];
+      node_labels[node] = label;
+
+      const LocalComponent& component = tile.components[local];
+      const int64_t dx = static_cast<int64_t>(shift.x) * width;
+      const int64_t dy = static_cast<int64_t>(shift.y) * height;
+      Accumulator& acc = accumulators[label - 1];
+      acc.pixel_count += component.pixel_count;
+      acc.min_x = std::min(acc.min_x, component.min_x + dx);
+      acc.max_x = std::max(acc.max_x, component.max_x + dx);
+      acc.min_y = std::min(acc.min_y, component.min_y + dy);
+      acc.max_y = std::max(acc.max_y, component.max_y + dy);
+      acc.sum_x += component.sum_x + static_cast<double>(dx) * component.pixel_count;
+      acc.sum_y += component.sum_y + static_cast<double>(dy) * component.pixel_count;
+      acc.sum_value += component.sum_value;
+    }
+  }
+
+  ComponentTable& table = out.components;
+  table.resize(roots.size());
+  for (uint32_t i = 0; i < roots.size(); ++i) {
+    const Accumulator& acc = accumulators[i];
+    const uint8_t wraps = nodes.get_wraps(roots[i]);
+    table.pixel_count[i] = acc.pixel_count;
+    table.wraps[i] = wraps;
+    table.mean_value[i] = static_cast<float>(acc.sum_value / acc.pixel_count);
+    finalize_axis((wraps & ComponentTable::WRAPS_X) != 0, width, acc.pixel_count, acc.min_x, acc.max_x, acc.sum_x,
+                  table.min_x[i], table.max_x[i], table.centroid_x[i]);
+    finalize_axis((wraps & ComponentTable::WRAPS_Y) != 0, height, acc.pixel_count, acc.min_y, acc.max_y, acc.sum_y,
+                  table.min_y[i], table.max_y[i], table.centroid_y[i]);
+  }
+
+  parallel_for(0, tiles.size(), [&](size_t t) {
+    const Tile& tile = tiles[t];
+    for (uint32_t y = tile.y0; y < tile.y0 + tile.height; ++y) {
+      uint32_t* row = out.labels.data() + static_cast<size_t>(y) * width;
+      for (uint32_t x = tile.x0; x < tile.x0 + tile.width; ++x) {
+        row[x] = row[x] == NONE ? 0 : node_labels[tile.first_node + row[x]];
+      }
+    }
+  });
+}
+}  // namespace kn
@@ -0,0 +1,111 @@
+/**************************************************************************/
+/* connected_components.hpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+enum class Connectivity : uint8_t {
+  /** Pixels sharing an edge are connected. */
+  Four,
+  /** Pixels sharing an edge or a corner are connected. */
+  Eight,
+};
+
+/**
+ * Statistics of labeled components, stored as one array per field and indexed by label - 1.
+ * Coordinates are unwrapped: a component crossing a border keeps contiguous bounds, with min_x in [0, width) and
+ * max_x possibly past the texture, and likewise for y. Along an axis a component winds all the way around, its
+ * bounds cover the whole texture and the matching wraps bit is set.
+ */
+struct ComponentTable {
+  static constexpr uint8_t WRAPS_X = 1;
+  static constexpr uint8_t WRAPS_Y = 2;
+
+  std::vector<uint32_t> pixel_count;
+  std::vector<int32_t> min_x;
+  std::vector<int32_t> min_y;
+  std::vector<int32_t> max_x;
+  std::vector<int32_t> max_y;
+  /** Mean position of the pixels, in the frame of the bounds. */
+  std::vector<float> centroid_x;
+  std::vector<float> centroid_y;
+  /** Mean value of the labeled channel over the pixels. */
+  std::vector<float> mean_value;
+  std::vector<uint8_t> wraps;
+
+  [[nodiscard]] inline size_t size() const { return pixel_count.size(); }
+
+  void resize(size_t count) {
+    pixel_count.resize(count);
+    min_x.resize(count);
+    min_y.resize(count);
+    max_x.resize(count);
+    max_y.resize(count);
+    centroid_x.resize(count);
+    centroid_y.resize(count);
+    mean_value.resize(count);
+    wraps.resize(count);
+  }
+};
+
+/** Label image and component table produced by label_components. */
+struct ComponentLabels {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  /** One label per pixel, 0 for the background and 1 to components.size() otherwise. */
+  std::vector<uint32_t> labels;
+  ComponentTable components;
+
+  [[nodiscard]] inline uint32_t at(uint32_t x, uint32_t y) const {
+    return labels[static_cast<size_t>(y) * width + x];
+  }
+};
+
+/**
+ * Labels the connected components of a mask, with connectivity wrapping around the borders.
+ * Tiles are labeled in parallel with a local union-find, then components touching across tile borders are merged.
+ * Labels are numbered in raster order of the first pixel of each component, so the output does not depend on the
+ * number of threads.
+ * @param[in] mask The mask to label.
+ * @param[in] channel The channel of mask to read.
+ * @param[in] threshold Pixels whose value is at least threshold are foreground.
+ * @param[in] connectivity The neighbourhood connecting two pixels.
+ * @param[out] out The labels and the component table.
+ */
+KN_TEXTURE_API void label_components(const TextureView& mask,
+                                     uint32_t channel,
+                                     float threshold,
+                                     Connectivity connectivity,
+                                     ComponentLabels& out);
+}  // namespace kn
@@ -0,0 +1,146 @@
+/**************************************************************************/
+/* convolution.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "convolution.hpp"
+#include <bit>
+#include "fft.hpp"
+#include "texture_format.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+/**
+ * Taps per log2(pixel count) above which the FFT path wins.
+ * A forward and an inverse 2D transform cost a few log2(pixels) complex operations per pixel, plus the spectrum
+ * product and the passes over memory.
+ */
+constexpr float FFT_TAPS_PER_LOG2_PIXEL = 4.0f;
+
+/** Direct convolution, compiled per channel count, accumulating the interleaved channels of a row together. */
+template <uint32_t Channels>
+void convolve_direct(const TextureView& src, const TextureView& dst, const ConvolutionKernel& kernel) {
+  const uint32_t width = src.width;
+  const size_t row_size = static_cast<size_t>(width) * Channels;
+  const size_t padded_width = static_cast<size_t>(width) + kernel.width - 1;
+
+  parallel_for(0, src.height, [&](size_t y) {
+    thread_local std::vector<float> padded;
+    thread_local std::vector<float> accum;
+    padded.resize(padded_width * Channels);
+    accum.assign(row_size, 0.0f);
+
+    for (uint32_t j = 0; j < kernel.height; ++j) {
+      const int64_t sy = static_cast<int64_t>(y) + j - kernel.origin_y;
+      const float* row = src.row(wrap_coord(sy, src.height));
+
+      // Unroll the wrapped source row once, so every tap below is a contiguous multiply-add over the row.
+      for (size_t t = 0; t < padded_width; ++t) {
+        const uint32_t x = wrap_coord(static_cast<int64_t>(t) - kernel.origin_x, width);
+        std::copy_n(row + static_cast<size_t>(x) * Channels, Channels, padded.data() + t * Channels);
+      }
+
+      for (uint32_t i = 0; i < kernel.width; ++i) {
+        const float w = kernel.weight(i, j);
+        if (w == 0.0f) {
+          continue;
+        }
+        const float* taps = padded.data() + static_cast<size_t>(i) * Channels;
+        for (size_t x = 0; x < row_size; ++x) {
+          accum[x] += w * taps[x];
+        }
+      }
+    }
+
+    std::copy(accum.begin(), accum.end(), dst.row(static_cast<uint32_t>(y)));
+  });
+}
+
+void convolve_fft(const TextureView& src, const TextureView& dst, const ConvolutionKernel& kernel) {
+  const RealFFT2D fft(src.width, src.height);
+
+  // Wrap the flipped kernel into one texture period; taps larger than the texture fold onto each other,
+  // which is exactly what a periodic direct convolution does.
+  Texture periodic_kernel(src.width, src.height);
+  TextureView kernel_view = periodic_kernel.view();
+  for (uint32_t j = 0; j < kernel.height; ++j) {
+    for (uint32_t i = 0; i < kernel.width; ++i) {
+      const uint32_t x = wrap_coord(static_cast<int64_t>(kernel.origin_x) - i, src.width);
+      const uint32_t y = wrap_coord(static_cast<int64_t>(kernel.origin_y) - j, src.height);
+      kernel_view.at(x, y) += kernel.weight(i, j);
+    }
+  }
+
+  Spectrum kernel_spectrum;
+  fft.forward(kernel_view, 0, kernel_spectrum);
+
+  Spectrum spectrum;
+  for (uint32_t c = 0; c < src.channels; ++c) {
+    fft.forward(src, c, spectrum);
+
+    parallel_for(
+        0, spectrum.bins.size(), [&](size_t i) { spectrum.bins[i] *= kernel_spectrum.bins[i]; }, 4096);
+
+    fft.inverse(spectrum, dst, c);
+  }
+}
+}  // namespace
+
+ConvolutionMethod select_convolution_method(const TextureView& src, const ConvolutionKernel& kernel) {
+  const auto log2_pixels = static_cast<float>(std::bit_width(src.get_pixel_count()));
+  const auto taps = static_cast<float>(kernel.get_tap_count());
+  return taps > FFT_TAPS_PER_LOG2_PIXEL * log2_pixels ? ConvolutionMethod::FFT : ConvolutionMethod::Direct;
+}
+
+void convolve(const TextureView& src,
+              const TextureView& dst,
+              const ConvolutionKernel& kernel,
+              ConvolutionMethod method /*= ConvolutionMethod::Auto*/) {
+  if (!ensure(src.is_valid() && src.channels <= 4 && src.has_same_layout(dst)) || !ensure(src.data != dst.data) ||
+      !ensure(kernel.get_tap_count() > 0 && kernel.weights.size() == kernel.get_tap_count())) {
+    return;
+  }
+
+  if (method == ConvolutionMethod::Auto) {
+    method = select_convolution_method(src, kernel);
+  }
+
+  if (method == ConvolutionMethod::FFT) {
+    convolve_fft(src, dst, kernel);
+  } else {
+    dispatch_channels(src.channels, [&](auto channels) { convolve_direct<channels()>(src, dst, kernel); });
+  }
+}
+
+Texture convolve(const Texture& src,
+                 const ConvolutionKernel& kernel,
+                 ConvolutionMethod method /*= ConvolutionMethod::Auto*/) {
+  return filter_texture(src, src.get_width(), src.get_height(), src.get_channels(),
+                        [&](const TextureView& from, const TextureView& to) { convolve(from, to, kernel, method); });
+}
+}  // namespace kn
@@ -0,0 +1,95 @@
+/**************************************************************************/
+/* convolution.hpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/**
+ * Dense 2D convolution kernel.
+ * The tap at (origin_x, origin_y) lands on the destination pixel: dst(x, y) accumulates
+ * weight(i, j) * src(x + i - origin_x, y + j - origin_y).
+ */
+struct ConvolutionKernel {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t origin_x = 0;
+  uint32_t origin_y = 0;
+  std::vector<float> weights;
+
+  /** Creates a kernel whose origin is its center tap. */
+  static ConvolutionKernel centered(uint32_t width, uint32_t height, std::vector<float> weights) {
+    return {width, height, width / 2, height / 2, std::move(weights)};
+  }
+
+  [[nodiscard]] inline float weight(uint32_t i, uint32_t j) const {
+    return weights[static_cast<size_t>(j) * width + i];
+  }
+
+  [[nodiscard]] inline size_t get_tap_count() const { return static_cast<size_t>(width) * height; }
+};
+
+enum class ConvolutionMethod : uint8_t {
+  /** Picks the cheapest of Direct and FFT for the kernel and texture sizes. */
+  Auto,
+  /** Accumulates every tap, O(taps) per pixel. */
+  Direct,
+  /** Multiplies spectra, O(log(pixels)) per pixel regardless of the kernel size. */
+  FFT,
+};
+
+/**
+ * Returns the method Auto resolves to for a texture and a kernel.
+ * @param src The texture to convolve.
+ * @param kernel The kernel to apply.
+ */
+KN_TEXTURE_API ConvolutionMethod select_convolution_method(const TextureView& src, const ConvolutionKernel& kernel);
+
+/**
+ * Convolves every channel of a texture with a kernel.
+ * Borders wrap around so tileable inputs stay tileable, and both methods produce the same result.
+ * @param[in] src The texture to convolve, with 1 to 4 channels.
+ * @param[out] dst The destination, with the same layout as src. It must not alias src.
+ * @param[in] kernel The kernel to apply.
+ * @param[in] method The evaluation strategy.
+ */
+KN_TEXTURE_API void convolve(const TextureView& src,
+                             const TextureView& dst,
+                             const ConvolutionKernel& kernel,
+                             ConvolutionMethod method = ConvolutionMethod::Auto);
+
+/** Convolves a texture into a new one; a uniform src gives a uniform texture, see filter_texture. */
+KN_TEXTURE_API Texture convolve(const Texture& src,
+                                const ConvolutionKernel& kernel,
+                                ConvolutionMethod method = ConvolutionMethod::Auto);
+}  // namespace kn
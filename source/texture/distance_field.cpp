@@ -0,0 +1,299 @@
+/**************************************************************************/
+/* distance_field.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "distance_field.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+constexpr float INF = std::numeric_limits<float>::infinity();
+
+/** Number of columns gathered together by the vertical pass of the exact transform. */
+constexpr uint32_t COLUMN_BLOCK = 16;
+
+/**
+ * 1D squared distance transform of a periodic line of size values (Felzenszwalb-Huttenlocher).
+ * The nearest copy of any sample lies within size / 2 of an output, so the lower envelope is built over the line
+ * extended by half a period on both sides.
+ */
+class PeriodicEnvelope {
+ public:
+  void transform(float* values, uint32_t size) {
+    const int64_t margin = (size + 1) / 2;
+    const int64_t first = -margin;
+    const int64_t last = static_cast<int64_t>(size) + margin;
+
+    _sites.clear();
+    _bounds.clear();
+    _heights.clear();
+
+    for (int64_t q = first; q < last; ++q) {
+      const float f = values[wrap_coord(q, size)];
+      if (f == INF) {
+        continue;
+      }
+      const double fq = f;
+      while (!_sites.empty()) {
+        const double s = intersection(_sites.back(), _heights.back(), q, fq);
+        if (s > _bounds.back()) {
+          _bounds.push_back(s);
+          break;
+        }
+        _sites.pop_back();
+        _heights.pop_back();
+        _bounds.pop_back();
+      }
+      if (_sites.empty()) {
+        _bounds.push_back(-std::numeric_limits<double>::infinity());
+      }
+      _sites.push_back(q);
+      _heights.push_back(fq);
+    }
+
+    if (_sites.empty()) {
+      return;
+    }
+
+    size_t k = 0;
+    for (uint32_t x = 0; x < size; ++x) {
+      while (k + 1 < _sites.size() && _bounds[k + 1] < x) {
+        ++k;
+      }
+      const double d = static_cast<double>(x) - static_cast<double>(_sites[k]);
+      values[x] = static_cast<float>(d * d + _heights[k]);
+    }
+  }
+
+ private:
+  static double intersection(int64_t p, double fp, int64_t q, double fq) {
+    const auto pd = static_cast<double>(p);
+    const auto qd = static_cast<double>(q);
+    return ((fq + qd * qd) - (fp + pd * pd)) / (2.0 * qd - 2.0 * pd);
+  }
+
+  std::vector<int64_t> _sites;
+  std::vector<double> _heights;
+  /** _bounds[i] is where parabola i starts to be the lowest one. */
+  std::vector<double> _bounds;
+};
+
+/** Writes the distance to the nearest pixel for which is_seed is true into dst, which must be single channel. */
+template <typename Predicate>
+void exact_distance(const TextureView& mask, uint32_t channel, Predicate&& is_seed, const TextureView& dst) {
+  const uint32_t width = mask.width;
+  const uint32_t height = mask.height;
+  const uint32_t block_count = (width + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+
+  // Squared distances along columns; dst doubles as intermediate storage.
+  parallel_for(0, block_count, [&](size_t block) {
+    thread_local PeriodicEnvelope envelope;
+    thread_local std::vector<float> columns;
+    columns.resize(static_cast<size_t>(COLUMN_BLOCK) * height);
+
+    const uint32_t x0 = static_cast<uint32_t>(block) * COLUMN_BLOCK;
+    const uint32_t count = std::min(COLUMN_BLOCK, width - x0);
+
+    for (uint32_t y = 0; y < height; ++y) {
+      for (uint32_t i = 0; i < count; ++i) {
+        columns[static_cast<size_t>(i) * height + y] = is_seed(mask.at(x0 + i, y, channel)) ? 0.0f : INF;
+      }
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+      envelope.transform(columns.data() + static_cast<size_t>(i) * height, height);
+    }
+
+    for (uint32_t y = 0; y < height; ++y) {
+      for (uint32_t i = 0; i < count; ++i) {
+        dst.at(x0 + i, y) = columns[static_cast<size_t>(i) * height + y];
+      }
+    }
+  });
+
+  parallel_for(0, height, [&](size_t y) {
+    thread_local PeriodicEnvelope envelope;
+    thread_local std::vector<float> row;
+    row.resize(width);
+
+    for (uint32_t x = 0; x < width; ++x) {
+      row[x] = dst.at(x, static_cast<uint32_t>(y));
+    }
+    envelope.transform(row.data(), width);
+    for (uint32_t x = 0; x < width; ++x) {
+      dst.at(x, static_cast<uint32_t>(y)) = std::sqrt(row[x]);
+    }
+  });
+}
+
+/** Nearest seed found so far by jump flooding, or a negative x when none was seen. */
+struct Site {
+  int32_t x;
+  int32_t y;
+};
+
+/**
+ * Jump flooding on the torus: at every pass, each pixel adopts the closest seed known by its 8 neighbours at the
+ * current step. Steps halve from half the texture size down to 1, followed by one more pass at step 1.
+ */
+template <typename Predicate>
+void jump_flooding(const TextureView& mask, uint32_t channel, Predicate&& is_seed, const TextureView& dst) {
+  const uint32_t width = mask.width;
+  const uint32_t height = mask.height;
+
+  std::vector<Site> current(mask.get_pixel_count());
+  std::vector<Site> next(mask.get_pixel_count());
+
+  parallel_for(0, height, [&](size_t y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      const bool seed = is_seed(mask.at(x, static_cast<uint32_t>(y), channel));
+      current[y * width + x] = seed ? Site{static_cast<int32_t>(x), static_cast<int32_t>(y)} : Site{-1, -1};
+    }
+  });
+
+  const auto squared_distance = [&](uint32_t x, uint32_t y, Site site) {
+    int64_t dx = std::abs(static_cast<int64_t>(x) - site.x);
+    int64_t dy = std::abs(static_cast<int64_t>(y) - site.y);
+    dx = std::min<int64_t>(dx, width - dx);
+    dy = std::min<int64_t>(dy, height - dy);
+    return dx * dx + dy * dy;
+  };
+
+  std::vector<uint32_t> steps;
+  for (uint32_t step = std::bit_ceil(std::max(width, height)) / 2; step > 0; step /= 2) {
+    steps.push_back(step);
+  }
+  steps.push_back(1);
+
+  // Wrapped neighbour columns of the current step, shared by every row.
+  std::vector<uint32_t> neighbours(static_cast<size_t>(width) * 3);
+
+  for (const uint32_t step : steps) {
+    for (uint32_t x = 0; x < width; ++x) {
+      for (int32_t i = -1; i <= 1; ++i) {
+        neighbours[x * 3 + (i + 1)] = wrap_coord(static_cast<int64_t>(x) + i * static_cast<int64_t>(step), width);
+      }
+    }
+
+    parallel_for(0, height, [&](size_t y) {
+      std::array<const Site*, 3> rows;
+      for (int32_t j = -1; j <= 1; ++j) {
+        const uint32_t ny = wrap_coord(static_cast<int64_t>(y) + j * static_cast<int64_t>(step), height);
+        rows[j + 1] = current.data() + static_cast<size_t>(ny) * width;
+      }
+
+      for (uint32_t x = 0; x < width; ++x) {
+        Site best = current[y * width + x];
+        int64_t best_distance = best.x < 0 ? std::numeric_limits<int64_t>::max() : squared_distance(x, y, best);
+
+        for (const Site* row : rows) {
+          for (uint32_t i = 0; i < 3; ++i) {
+            const Site candidate = row[neighbours[x * 3 + i]];
+            if (candidate.x < 0) {
+              continue;
+            }
+            const int64_t distance = squared_distance(x, static_cast<uint32_t>(y), candidate);
+            if (distance < best_distance) {
+              best = candidate;
+              best_distance = distance;
+            }
+          }
+        }
+        next[y * width + x] = best;
+      }
+    });
+    current.swap(next);
+  }
+
+  parallel_for(0, height, [&](size_t y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      const Site site = current[y * width + x];
+      dst.at(x, static_cast<uint32_t>(y)) =
+          site.x < 0 ? INF : std::sqrt(static_cast<float>(squared_distance(x, static_cast<uint32_t>(y), site)));
+    }
+  });
+}
+
+template <typename Predicate>
+void compute_distance(const TextureView& mask,
+                      uint32_t channel,
+                      Predicate&& is_seed,
+                      const TextureView& dst,
+                      DistanceFieldMethod method) {
+  if (method == DistanceFieldMethod::JumpFlooding) {
+    jump_flooding(mask, channel, is_seed, dst);
+  } else {
+    exact_distance(mask, channel, is_seed, dst);
+  }
+}
+
+bool check_views(const TextureView& mask, uint32_t channel, const TextureView& dst) {
+  return ensure(mask.is_valid() && channel < mask.channels) &&
+         ensure(dst.width == mask.width && dst.height == mask.height && dst.channels == 1);
+}
+}  // namespace
+
+void distance_field(const TextureView& mask,
+                    uint32_t channel,
+                    float threshold,
+                    const TextureView& dst,
+                    DistanceFieldMethod method /*= DistanceFieldMethod::Exact*/) {
+  if (!check_views(mask, channel, dst)) {
+    return;
+  }
+  compute_distance(mask, channel, [threshold](float v) { return v >= threshold; }, dst, method);
+}
+
+void signed_distance_field(const TextureView& mask,
+                           uint32_t channel,
+                           float threshold,
+                           const TextureView& dst,
+                           DistanceFieldMethod method /*= DistanceFieldMethod::Exact*/) {
+  if (!check_views(mask, channel, dst)) {
+    return;
+  }
+
+  Texture inside_texture(mask.width, mask.height);
+  const TextureView inside = inside_texture.view();
+  compute_distance(mask, channel, [threshold](float v) { return v >= threshold; }, dst, method);
+  compute_distance(mask, channel, [threshold](float v) { return v < threshold; }, inside, method);
+
+  parallel_for(0, mask.height, [&](size_t y) {
+    for (uint32_t x = 0; x < mask.width; ++x) {
+      float& outside = dst.at(x, static_cast<uint32_t>(y));
+      outside = outside > 0.0f ? outside - 0.5f : 0.5f - inside.at(x, static_cast<uint32_t>(y));
+    }
+  });
+}
+}  // namespace kn
@@ -0,0 +1,74 @@
+/**************************************************************************/
+/* distance_field.hpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+enum class DistanceFieldMethod : uint8_t {
+  /** Separable Felzenszwalb-Huttenlocher transform, exact in O(pixels). */
+  Exact,
+  /** Jump flooding, approximate in O(pixels * log2(size)) but with a fixed amount of work per pass. */
+  JumpFlooding,
+};
+
+/**
+ * Computes the euclidean distance, in pixels, from every pixel to the nearest seed.
+ * The texture is treated as one period of a tiling, so the field is seamless across borders.
+ * Pixels of a mask without any seed are set to infinity.
+ * @param[in] mask The mask to read.
+ * @param[in] channel The channel of mask holding the seeds.
+ * @param[in] threshold Pixels whose value is at least threshold are seeds.
+ * @param[out] dst A single channel texture with the dimensions of mask.
+ * @param[in] method The algorithm used.
+ */
+KN_TEXTURE_API void distance_field(const TextureView& mask,
+                                   uint32_t channel,
+                                   float threshold,
+                                   const TextureView& dst,
+                                   DistanceFieldMethod method = DistanceFieldMethod::Exact);
+
+/**
+ * Computes the signed distance, in pixels, to the border of a mask: positive outside, negative inside, and zero
+ * halfway between an inside pixel and its outside neighbour.
+ * @param[in] mask The mask to read.
+ * @param[in] channel The channel of mask holding the shape.
+ * @param[in] threshold Pixels whose value is at least threshold are inside the shape.
+ * @param[out] dst A single channel texture with the dimensions of mask.
+ * @param[in] method The algorithm used.
+ */
+KN_TEXTURE_API void signed_distance_field(const TextureView& mask,
+                                          uint32_t channel,
+                                          float threshold,
+                                          const TextureView& dst,
+                                          DistanceFieldMethod method = DistanceFieldMethod::Exact);
+}  // namespace kn
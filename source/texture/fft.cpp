@@ -0,0 +1,281 @@
+/**************************************************************************/
+/* fft.cpp                                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "fft.hpp"
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+/** Number of spectrum columns gathered together so column passes read whole cache lines. */
+constexpr uint32_t COLUMN_BLOCK = 16;
+
+complex_t make_twiddle(uint64_t numerator, uint64_t denominator) {
+  const double angle = -2.0 * std::numbers::pi * static_cast<double>(numerator) / static_cast<double>(denominator);
+  return {static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle))};
+}
+}  // namespace
+
+FFTPlan::FFTPlan(uint32_t size) : _size(size), _radix2_size(size) {
+  ensure(size > 0);
+
+  if (!std::has_single_bit(size)) {
+    _radix2_size = std::bit_ceil(2 * size - 1);
+  }
+
+  const uint32_t bits = std::countr_zero(_radix2_size);
+  _bit_reverse.resize(_radix2_size);
+  for (uint32_t i = 0; i < _radix2_size; ++i) {
+    uint32_t reversed = 0;
+    for (uint32_t b = 0; b < bits; ++b) {
+      reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+    }
+    _bit_reverse[i] = reversed;
+  }
+
+  _twiddles.resize(_radix2_size / 2);
+  for (uint32_t i = 0; i < _radix2_size / 2; ++i) {
+    _twiddles[i] = make_twiddle(i, _radix2_size);
+  }
+
+  if (_radix2_size == _size) {
+    return;
+  }
+
+  // Bluestein: X[k] = w[k] * sum(x[n] * w[n] * conj(w[k - n])) with w[n] = exp(-i * pi * n^2 / size).
+  // n^2 is reduced modulo 2 * size to keep the chirp accurate for large sizes.
+  _chirp.resize(_size);
+  for (uint32_t n = 0; n < _size; ++n) {
+    const uint64_t n2 = (static_cast<uint64_t>(n) * n) % (2ull * _size);
+    _chirp[n] = make_twiddle(n2, 2ull * _size);
+  }
+
+  _chirp_spectrum.assign(_radix2_size, complex_t{});
+  _chirp_spectrum[0] = std::conj(_chirp[0]);
+  for (uint32_t n = 1; n < _size; ++n) {
+    _chirp_spectrum[n] = std::conj(_chirp[n]);
+    _chirp_spectrum[_radix2_size - n] = std::conj(_chirp[n]);
+  }
+  transform_radix2(_chirp_spectrum.data(), false);
+}
+
+void FFTPlan::forward(complex_t* data) const {
+  if (_radix2_size == _size) {
+    transform_radix2(data, false);
+  } else {
+    transform_bluestein(data);
+  }
+}
+
+void FFTPlan::inverse(complex_t* data) const {
+  if (_radix2_size == _size) {
+    transform_radix2(data, true);
+    return;
+  }
+
+  // ifft(x) = conj(fft(conj(x))), so a single chirp table serves both directions.
+  for (uint32_t i = 0; i < _size; ++i) {
+    data[i] = std::conj(data[i]);
+  }
+  transform_bluestein(data);
+  for (uint32_t i = 0; i < _size; ++i) {
+    data[i] = std::conj(data[i]);
+  }
+}
+
+void FFTPlan::transform_radix2(complex_t* data, bool inverse) const {
+  const uint32_t n = _radix2_size;
+
+  for (uint32_t i = 0; i < n; ++i) {
+    const uint32_t j = _bit_reverse[i];
+    if (i < j) {
+      std::swap(data[i], data[j]);
+    }
+  }
+
+  for (uint32_t half = 1; half < n; half *= 2) {
+    const uint32_t step = n / (2 * half);
+    for (uint32_t start = 0; start < n; start += 2 * half) {
+      for (uint32_t k = 0; k < half; ++k) {
+        const complex_t twiddle = inverse ? std::conj(_twiddles[k * step]) : _twiddles[k * step];
+        const complex_t even = data[start + k];
+        const complex_t odd = data[start + k + half] * twiddle;
+        data[start + k] = even + odd;
+        data[start + k + half] = even - odd;
+      }
+    }
+  }
+}
+
+void FFTPlan::transform_bluestein(complex_t* data) const {
+  thread_local std::vector<complex_t> scratch;
+  scratch.assign(_radix2_size, complex_t{});
+
+  for (uint32_t n = 0; n < _size; ++n) {
+    scratch[n] = data[n] * _chirp[n];
+  }
+
+  transform_radix2(scratch.data(), false);
+  for (uint32_t i = 0; i < _radix2_size; ++i) {
+    scratch[i] *= _chirp_spectrum[i];
+  }
+  transform_radix2(scratch.data(), true);
+
+  const float scale = 1.0f / static_cast<float>(_radix2_size);
+  for (uint32_t k = 0; k < _size; ++k) {
+    data[k] = scratch[k] * _chirp[k] * scale;
+  }
+}
+
+RealFFT2D::RealFFT2D(uint32_t width, uint32_t height) : _row_plan(width), _column_plan(height) {}
+
+void RealFFT2D::forward(const TextureView& src, uint32_t channel, Spectrum& out) const {
+  const uint32_t width = get_width();
+  const uint32_t height = get_height();
+  ensure(src.width == width && src.height == height && channel < src.channels);
+
+  out.width = width;
+  out.height = height;
+  out.bins.resize(static_cast<size_t>(out.get_row_size()) * height);
+
+  // Two real rows are packed into one complex row: z = a + i * b, then split using the hermitian symmetry of
+  // real spectra: A[k] = (Z[k] + conj(Z[-k])) / 2 and B[k] = (Z[k] - conj(Z[-k])) / 2i.
+  const uint32_t pair_count = (height + 1) / 2;
+  parallel_for(0, pair_count, [&](size_t pair) {
+    thread_local std::vector<complex_t> packed;
+    packed.resize(width);
+
+    const uint32_t y0 = static_cast<uint32_t>(pair * 2);
+    const uint32_t y1 = y0 + 1;
+    const bool has_second = y1 < height;
+
+    for (uint32_t x = 0; x < width; ++x) {
+      packed[x] = {src.at(x, y0, channel), has_second ? src.at(x, y1, channel) : 0.0f};
+    }
+
+    _row_plan.forward(packed.data());
+
+    complex_t* row0 = out.row(y0);
+    complex_t* row1 = has_second ? out.row(y1) : nullptr;
+    for (uint32_t k = 0; k < out.get_row_size(); ++k) {
+      const complex_t z = packed[k];
+      const complex_t z_mirror = std::conj(packed[(width - k) % width]);
+      row0[k] = (z + z_mirror) * 0.5f;
+      if (row1) {
+        row1[k] = (z - z_mirror) * complex_t{0.0f, -0.5f};
+      }
+    }
+  });
+
+  transform_columns(out, false);
+}
+
+void RealFFT2D::inverse(Spectrum& spectrum, const TextureView& dst, uint32_t channel) const {
+  const uint32_t width = get_width();
+  const uint32_t height = get_height();
+  ensure(spectrum.width == width && spectrum.height == height);
+  ensure(dst.width == width && dst.height == height && channel < dst.channels);
+
+  transform_columns(spectrum, true);
+
+  // Every row now holds the half spectrum of a real row; two of them are rebuilt at once as Z = A + i * B.
+  const float scale = 1.0f / (static_cast<float>(width) * static_cast<float>(height));
+  const uint32_t row_size = spectrum.get_row_size();
+  const uint32_t pair_count = (height + 1) / 2;
+  parallel_for(0, pair_count, [&](size_t pair) {
+    thread_local std::vector<complex_t> packed;
+    packed.resize(width);
+
+    const uint32_t y0 = static_cast<uint32_t>(pair * 2);
+    const uint32_t y1 = y0 + 1;
+    const bool has_second = y1 < height;
+
+    const complex_t* row0 = spectrum.row(y0);
+    const complex_t* row1 = has_second ? spectrum.row(y1) : nullptr;
+    const complex_t i_unit{0.0f, 1.0f};
+
+    for (uint32_t k = 0; k < width; ++k) {
+      const bool mirrored = k >= row_size;
+      const uint32_t index = mirrored ? width - k : k;
+      const complex_t a = mirrored ? std::conj(row0[index]) : row0[index];
+      const complex_t b = row1 ? (mirrored ? std::conj(row1[index]) : row1[index]) : complex_t{};
+      packed[k] = a + i_unit * b;
+    }
+
+    _row_plan.inverse(packed.data());
+
+    for (uint32_t x = 0; x < width; ++x) {
+      dst.at(x, y0, channel) = packed[x].real() * scale;
+      if (has_second) {
+        dst.at(x, y1, channel) = packed[x].imag() * scale;
+      }
+    }
+  });
+}
+
+void RealFFT2D::transform_columns(Spectrum& spectrum, bool inverse) const {
+  const uint32_t height = get_height();
+  const uint32_t row_size = spectrum.get_row_size();
+  const uint32_t block_count = (row_size + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+
+  parallel_for(0, block_count, [&](size_t block) {
+    thread_local std::vector<complex_t> columns;
+    columns.resize(static_cast<size_t>(COLUMN_BLOCK) * height);
+
+    const uint32_t first = static_cast<uint32_t>(block) * COLUMN_BLOCK;
+    const uint32_t count = std::min(COLUMN_BLOCK, row_size - first);
+
+    // Gather a block of columns row by row so reads stay sequential, transform, then scatter back.
+    for (uint32_t y = 0; y < height; ++y) {
+      const complex_t* row = spectrum.row(y) + first;
+      for (uint32_t c = 0; c < count; ++c) {
+        columns[static_cast<size_t>(c) * height + y] = row[c];
+      }
+    }
+
+    for (uint32_t c = 0; c < count; ++c) {
+      complex_t* column = columns.data() + static_cast<size_t>(c) * height;
+      if (inverse) {
+        _column_plan.inverse(column);
+      } else {
+        _column_plan.forward(column);
+      }
+    }
+
+    for (uint32_t y = 0; y < height; ++y) {
+      complex_t* row = spectrum.row(y) + first;
+      for (uint32_t c = 0; c < count; ++c) {
+        row[c] = columns[static_cast<size_t>(c) * height + y];
+      }
+    }
+  });
+}
+}  // namespace kn
@@ -0,0 +1,125 @@
+/**************************************************************************/
+/* fft.hpp                                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+using complex_t = std::complex<float>;
+
+/**
+ * Precomputed plan for in-place complex FFTs of a fixed length.
+ * Power-of-two lengths use an iterative radix-2 transform, any other length goes through Bluestein's algorithm,
+ * so textures of every size keep an exactly periodic spectrum.
+ * A plan is immutable once built and can be shared between threads.
+ */
+class KN_TEXTURE_API FFTPlan {
+ public:
+  explicit FFTPlan(uint32_t size);
+
+  [[nodiscard]] inline uint32_t get_size() const { return _size; }
+
+  /** Computes the forward transform of size values in place. */
+  void forward(complex_t* data) const;
+
+  /** Computes the unnormalized inverse transform of size values in place. */
+  void inverse(complex_t* data) const;
+
+ private:
+  void transform_radix2(complex_t* data, bool inverse) const;
+  void transform_bluestein(complex_t* data) const;
+
+  uint32_t _size;
+  /** Length of the radix-2 transform: size itself, or the padded convolution length for Bluestein. */
+  uint32_t _radix2_size;
+  std::vector<uint32_t> _bit_reverse;
+  std::vector<complex_t> _twiddles;
+  std::vector<complex_t> _chirp;
+  std::vector<complex_t> _chirp_spectrum;
+};
+
+/**
+ * Half spectrum of a real image.
+ * Real inputs have a hermitian spectrum, so only the (width / 2 + 1) first bins of every row are stored.
+ */
+struct Spectrum {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<complex_t> bins;
+
+  /** Returns the number of bins stored per row. */
+  [[nodiscard]] inline uint32_t get_row_size() const { return width / 2 + 1; }
+
+  /** Returns the first bin of row y. */
+  [[nodiscard]] inline complex_t* row(uint32_t y) { return bins.data() + static_cast<size_t>(y) * get_row_size(); }
+  [[nodiscard]] inline const complex_t* row(uint32_t y) const {
+    return bins.data() + static_cast<size_t>(y) * get_row_size();
+  }
+};
+
+/**
+ * Multithreaded real-to-complex 2D FFT.
+ * The transform treats the image as one period of an infinite tiling, which matches the seamless textures the
+ * graph produces: convolutions computed in the frequency domain wrap around the borders.
+ */
+class KN_TEXTURE_API RealFFT2D {
+ public:
+  RealFFT2D(uint32_t width, uint32_t height);
+
+  [[nodiscard]] inline uint32_t get_width() const { return _row_plan.get_size(); }
+  [[nodiscard]] inline uint32_t get_height() const { return _column_plan.get_size(); }
+
+  /**
+   * Transforms one channel of a texture.
+   * @param[in] src The texture to transform, its dimensions must match the plan.
+   * @param[in] channel The channel of src to transform.
+   * @param[out] out The half spectrum of the channel.
+   */
+  void forward(const TextureView& src, uint32_t channel, Spectrum& out) const;
+
+  /**
+   * Transforms a half spectrum back to one channel of a texture; the result is normalized.
+   * @param[in,out] spectrum The spectrum to transform, it is used as scratch memory and left undefined.
+   * @param[out] dst The texture to write, its dimensions must match the plan.
+   * @param[in] channel The channel of dst to write.
+   */
+  void inverse(Spectrum& spectrum, const TextureView& dst, uint32_t channel) const;
+
+ private:
+  void transform_columns(Spectrum& spectrum, bool inverse) const;
+
+  FFTPlan _row_plan;
+  FFTPlan _column_plan;
+};
+}  // namespace kn
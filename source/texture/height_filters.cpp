@@ -0,0 +1,301 @@
+/**************************************************************************/
+/* height_filters.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "height_filters.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "math/simd.hpp"
+#include "summed_area_table.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+using simd::vfloat4;
+
+constexpr uint32_t LANES = simd::WIDTH;
+
+/** 4x4 ordered dither, in sixteenths. */
+constexpr std::array<uint32_t, 16> BAYER_4X4 = {0, 8, 2, 10, 12, 4, 14, 6, 3, 11, 1, 9, 15, 7, 13, 5};
+
+/** Copies one channel of a texture into a tightly packed single channel texture. */
+Texture extract_channel(const TextureView& src, uint32_t channel) {
+  Texture plane(src.width, src.height);
+  const TextureView view = plane.view();
+  parallel_for(0, src.height, [&](size_t y) {
+    float* out = view.row(static_cast<uint32_t>(y));
+    for (uint32_t x = 0; x < src.width; ++x) {
+      out[x] = src.at(x, static_cast<uint32_t>(y), channel);
+    }
+  });
+  return plane;
+}
+
+bool check_views(const TextureView& height, uint32_t channel, const TextureView& dst) {
+  return ensure(height.is_valid() && channel < height.channels) &&
+         ensure(dst.width == height.width && dst.height == height.height);
+}
+
+/** Wraps a coordinate at most one period away from [0, size). */
+inline uint32_t wrap_once(int64_t coord, uint32_t size) {
+  if (coord < 0) {
+    return static_cast<uint32_t>(coord + size);
+  }
+  return static_cast<uint32_t>(coord >= size ? coord - size : coord);
+}
+}  // namespace
+
+void height_to_normal(const TextureView& height,
+                      uint32_t channel,
+                      const TextureView& dst,
+                      const NormalOptions& options /*= {}*/) {
+  if (!check_views(height, channel, dst) || !ensure(dst.channels == 3 || dst.channels == 4)) {
+    return;
+  }
+
+  const Texture plane = extract_channel(height, channel);
+  const TextureView heights = plane.view();
+  const uint32_t width = heights.width;
+
+  // Central differences, smoothed across by [side center side], normalized to height units per pixel.
+  const float side = options.filter == NormalFilter::Sobel ? 1.0f : 3.0f;
+  const float center = options.filter == NormalFilter::Sobel ? 2.0f : 10.0f;
+  const float scale = options.intensity / (2.0f * (2.0f * side + center));
+  const vfloat4 side_weight = simd::broadcast(side * scale);
+  const vfloat4 center_weight = simd::broadcast(center * scale);
+
+  // The image Y axis points down: OpenGL green follows -Y, so an increasing height towards +Y tilts it up.
+  const vfloat4 y_sign = simd::broadcast(options.format == NormalFormat::OpenGL ? 1.0f : -1.0f);
+
+  parallel_for(0, heights.height, [&](size_t y) {
+    // Rows y - 1, y and y + 1 padded by one wrapped pixel on both sides, and up to the next vector.
+    thread_local std::array<std::vector<float>, 3> rows;
+    const size_t padded_width = static_cast<size_t>(width) + 2 + LANES;
+    for (int32_t j = 0; j < 3; ++j) {
+      std::vector<float>& row = rows[j];
+      row.assign(padded_width, 0.0f);
+      const float* src = heights.row(wrap_coord(static_cast<int64_t>(y) + j - 1, heights.height));
+      row[0] = src[width - 1];
+      std::copy_n(src, width, row.data() + 1);
+      row[width + 1] = src[0];
+    }
+
+    float* out = dst.row(static_cast<uint32_t>(y));
+    for (uint32_t x = 0; x < width; x += LANES) {
+      const auto load = [&](uint32_t j, uint32_t i) { return simd::load(rows[j].data() + x + i); };
+      const vfloat4 gx = side_weight * (load(0, 2) - load(0, 0)) + center_weight * (load(1, 2) - load(1, 0)) +
+                         side_weight * (load(2, 2) - load(2, 0));
+      const vfloat4 gy = side_weight * (load(2, 0) - load(0, 0)) + center_weight * (load(2, 1) - load(0, 1)) +
+                         side_weight * (load(2, 2) - load(0, 2));
+
+      const vfloat4 one = simd::broadcast(1.0f);
+      const vfloat4 half = simd::broadcast(0.5f);
+      const vfloat4 inv_length = one / simd::sqrt(simd::madd(gx, gx, simd::madd(gy, gy, one)));
+      const vfloat4 half_length = half * inv_length;
+
+      alignas(16) float normal[3][LANES];
+      simd::store(normal[0], half - gx * half_length);
+      simd::store(normal[1], simd::madd(y_sign * gy, half_length, half));
+      simd::store(normal[2], simd::madd(one, half_length, half));
+
+      const uint32_t count = std::min(LANES, width - x);
+      for (uint32_t l = 0; l < count; ++l) {
+        float* pixel = out + static_cast<size_t>(x + l) * dst.channels;
+        pixel[0] = normal[0][l];
+        pixel[1] = normal[1][l];
+        pixel[2] = normal[2][l];
+        if (dst.channels == 4) {
+          pixel[3] = 1.0f;
+        }
+      }
+    }
+  });
+}
+
+void height_to_curvature(const TextureView& height,
+                         uint32_t channel,
+                         const TextureView& dst,
+                         const CurvatureOptions& options /*= {}*/) {
+  if (!check_views(height, channel, dst) || !ensure(dst.channels == 1 && options.scales > 0)) {
+    return;
+  }
+
+  const Texture plane = extract_channel(height, channel);
+  const TextureView heights = plane.view();
+  const SummedAreaTable sat(heights);
+  Texture mean_texture(heights.width, heights.height);
+  const TextureView mean = mean_texture.view();
+
+  // Boxes wider than the texture average all of it, like the box of the texture size.
+  const uint32_t scales = std::min<uint32_t>(options.scales, std::bit_width(std::max(heights.width, heights.height)));
+  for (uint32_t scale = 0; scale < scales; ++scale) {
+    const uint32_t radius = 1u << scale;
+    box_filter(sat, mean, radius, radius);
+
+    const float weight = 1.0f / static_cast<float>(radius);
+    parallel_for(0, heights.height, [&](size_t y) {
+      const float* h = heights.row(static_cast<uint32_t>(y));
+      const float* m = mean.row(static_cast<uint32_t>(y));
+      float* out = dst.row(static_cast<uint32_t>(y));
+      for (uint32_t x = 0; x < heights.width; ++x) {
+        const float curvature = (h[x] - m[x]) * weight;
+        out[x] = scale == 0 ? curvature : out[x] + curvature;
+      }
+    });
+  }
+
+  const float gain = options.intensity / static_cast<float>(scales);
+  parallel_for(0, heights.height, [&](size_t y) {
+    float* out = dst.row(static_cast<uint32_t>(y));
+    for (uint32_t x = 0; x < heights.width; ++x) {
+      out[x] = 0.5f + out[x] * gain;
+    }
+  });
+}
+
+void height_to_ambient_occlusion(const TextureView& height,
+                                 uint32_t channel,
+                                 const TextureView& dst,
+                                 const AmbientOcclusionOptions& options /*= {}*/) {
+  if (!check_views(height, channel, dst) || !ensure(dst.channels == 1 && options.sample_budget > 0)) {
+    return;
+  }
+
+  const Texture plane = extract_channel(height, channel);
+  const TextureView heights = plane.view();
+  const uint32_t width = heights.width;
+  const uint32_t rows = heights.height;
+
+  const auto directions = std::max<uint32_t>(
+      1, static_cast<uint32_t>(std::lround(std::sqrt(static_cast<double>(options.sample_budget)))));
+  const uint32_t steps = std::max<uint32_t>(1, options.sample_budget / directions);
+  const uint32_t samples = directions * steps;
+
+  /**
+   * Horizon samples of the four pixels of a vector, for one row of the rotation pattern. They are interleaved by
+   * lane, lane l of sample i being at i * LANES + l, as vectors start on multiples of 4.
+   */
+  struct PatternRow {
+    /** Offsets reduced to less than one period, for pixels close to the borders. */
+    std::vector<int32_t> dx;
+    std::vector<int32_t> dy;
+    /** Offsets in the height map, for pixels whose samples do not wrap. */
+    std::vector<ptrdiff_t> offsets;
+    /** height_scale / distance, or 0 when the offset rounds to the pixel itself. */
+    std::vector<float> slope_scales;
+  };
+
+  std::array<PatternRow, 4> pattern;
+  int64_t reach = 0;
+  for (uint32_t py = 0; py < 4; ++py) {
+    PatternRow& row = pattern[py];
+    row.dx.resize(static_cast<size_t>(samples) * LANES);
+    row.dy.resize(row.dx.size());
+    row.offsets.resize(row.dx.size());
+    row.slope_scales.resize(row.dx.size());
+
+    for (uint32_t l = 0; l < LANES; ++l) {
+      const double rotation = (BAYER_4X4[py * 4 + l] + 0.5) / static_cast<double>(BAYER_4X4.size());
+      for (uint32_t d = 0; d < directions; ++d) {
+        const double angle = 2.0 * std::numbers::pi * (d + rotation) / directions;
+        for (uint32_t s = 0; s < steps; ++s) {
+          const double distance = options.radius * (s + 1.0) / steps;
+          const auto dx = static_cast<int64_t>(std::lround(distance * std::cos(angle)));
+          const auto dy = static_cast<int64_t>(std::lround(distance * std::sin(angle)));
+          const double length = std::hypot(static_cast<double>(dx), static_cast<double>(dy));
+          reach = std::max({reach, std::abs(dx), std::abs(dy)});
+
+          const size_t i = static_cast<size_t>(d * steps + s) * LANES + l;
+          row.dx[i] = static_cast<int32_t>(dx % static_cast<int64_t>(width));
+          row.dy[i] = static_cast<int32_t>(dy % static_cast<int64_t>(rows));
+          row.offsets[i] = static_cast<ptrdiff_t>(dy * static_cast<int64_t>(width) + dx);
+          row.slope_scales[i] = length > 0.0 ? static_cast<float>(options.height_scale / length) : 0.0f;
+        }
+      }
+    }
+  }
+
+  parallel_for(0, rows, [&](size_t y) {
+    const PatternRow& row = pattern[y & 3];
+    const float* center_row = heights.row(static_cast<uint32_t>(y));
+    const bool inner_row = static_cast<int64_t>(y) >= reach && static_cast<int64_t>(y) + reach < rows;
+    float* out = dst.row(static_cast<uint32_t>(y));
+    const vfloat4 zero = simd::broadcast(0.0f);
+    const vfloat4 one = simd::broadcast(1.0f);
+
+    for (uint32_t x = 0; x < width; x += LANES) {
+      // Lanes past the end of the row duplicate the last pixel and are discarded.
+      std::array<uint32_t, LANES> xs;
+      alignas(16) float centers[LANES];
+      for (uint32_t l = 0; l < LANES; ++l) {
+        xs[l] = std::min(x + l, width - 1);
+        centers[l] = center_row[xs[l]];
+      }
+      const vfloat4 center = simd::load(centers);
+
+      const auto occlusion = [&](auto&& fetch) {
+        vfloat4 sum = zero;
+        for (uint32_t d = 0; d < directions; ++d) {
+          vfloat4 horizon = zero;
+          for (uint32_t s = 0; s < steps; ++s) {
+            const size_t base = static_cast<size_t>(d * steps + s) * LANES;
+            alignas(16) float values[LANES];
+            for (uint32_t l = 0; l < LANES; ++l) {
+              values[l] = fetch(base + l, l);
+            }
+            horizon = simd::max(horizon, (simd::load(values) - center) * simd::load(row.slope_scales.data() + base));
+          }
+          // Sine of the horizon elevation, from its tangent.
+          sum = sum + horizon / simd::sqrt(simd::madd(horizon, horizon, one));
+        }
+        return sum;
+      };
+
+      // Away from the borders, samples are plain offsets from the pixel.
+      vfloat4 sum;
+      if (inner_row && static_cast<int64_t>(x) >= reach && x + LANES + reach <= width) {
+        sum = occlusion([&](size_t i, uint32_t l) { return center_row[x + l + row.offsets[i]]; });
+      } else {
+        sum = occlusion([&](size_t i, uint32_t l) {
+          const uint32_t sx = wrap_once(static_cast<int64_t>(xs[l]) + row.dx[i], width);
+          const uint32_t sy = wrap_once(static_cast<int64_t>(y) + row.dy[i], rows);
+          return heights.row(sy)[sx];
+        });
+      }
+
+      alignas(16) float result[LANES];
+      simd::store(result, one - sum * simd::broadcast(1.0f / static_cast<float>(directions)));
+      std::copy_n(result, std::min(LANES, width - x), out + x);
+    }
+  });
+}
+}  // namespace kn
@@ -0,0 +1,121 @@
+/**************************************************************************/
+/* height_filters.hpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/** Derivative filter of normal maps. */
+enum class NormalFilter : uint8_t {
+  /** 3x3 Sobel, [1 2 1] smoothing across the derivative. */
+  Sobel,
+  /** 3x3 Scharr, [3 10 3] smoothing, closer to rotation invariant. */
+  Scharr,
+};
+
+/** Orientation of the green channel of normal maps. */
+enum class NormalFormat : uint8_t {
+  /** Green points up the texture (Y+). */
+  OpenGL,
+  /** Green points down the texture (Y-). */
+  DirectX,
+};
+
+struct NormalOptions {
+  NormalFilter filter = NormalFilter::Sobel;
+  NormalFormat format = NormalFormat::OpenGL;
+  /** Scale of the slopes, a height difference of 1 over one pixel being a 45 degrees slope at intensity 1. */
+  float intensity = 1.0f;
+};
+
+/**
+ * Converts a height map to a tangent space normal map, encoded to [0, 1] as n * 0.5 + 0.5.
+ * @param[in] height The height map.
+ * @param[in] channel The channel of height to read.
+ * @param[out] dst The normal map, with 3 channels, or 4 with alpha set to 1.
+ * @param[in] options The filter, format and intensity.
+ */
+KN_TEXTURE_API void height_to_normal(const TextureView& height,
+                                     uint32_t channel,
+                                     const TextureView& dst,
+                                     const NormalOptions& options = {});
+
+struct CurvatureOptions {
+  /**
+   * Number of scales, of radius 1, 2, 4 and so on, averaged together; scales past the one covering the texture
+   * are ignored.
+   */
+  uint32_t scales = 3;
+  /** Scale of the curvature around the 0.5 flat value. */
+  float intensity = 1.0f;
+};
+
+/**
+ * Computes the multi-scale curvature of a height map: convex areas are above 0.5 and concave areas below.
+ * Each scale contributes the difference between the height and its mean over a box of the scale radius, divided
+ * by the radius; box means come from a summed-area table, so large scales cost as little as small ones.
+ * @param[in] height The height map.
+ * @param[in] channel The channel of height to read.
+ * @param[out] dst The single channel curvature.
+ * @param[in] options The scales and intensity.
+ */
+KN_TEXTURE_API void height_to_curvature(const TextureView& height,
+                                        uint32_t channel,
+                                        const TextureView& dst,
+                                        const CurvatureOptions& options = {});
+
+struct AmbientOcclusionOptions {
+  /** Search distance of the horizons, in pixels. */
+  float radius = 16.0f;
+  /** Height of a value of 1, in pixels. */
+  float height_scale = 16.0f;
+  /**
+   * Height samples read per pixel, split between directions and steps along them; higher budgets trade time for
+   * less noise and better small-scale detail.
+   */
+  uint32_t sample_budget = 64;
+};
+
+/**
+ * Computes horizon-based ambient occlusion from a height map, 1 being unoccluded.
+ * Every pixel searches the highest horizon along evenly spaced directions, rotated per pixel by a 4x4 ordered
+ * pattern to turn banding into fine noise, and is occluded by the sine of the horizon elevation.
+ * @param[in] height The height map.
+ * @param[in] channel The channel of height to read.
+ * @param[out] dst The single channel occlusion.
+ * @param[in] options The radius, height scale and sample budget.
+ */
+KN_TEXTURE_API void height_to_ambient_occlusion(const TextureView& height,
+                                                uint32_t channel,
+                                                const TextureView& dst,
+                                                const AmbientOcclusionOptions& options = {});
+}  // namespace kn
@@ -0,0 +1,287 @@
+/**************************************************************************/
+/* morphology.cpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "morphology.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+/** Width of the column strips processed by the vertical and diagonal passes, in pixels. */
+constexpr uint32_t STRIP_WIDTH = 64;
+
+// Written as a < b ? a : b so compilers map them to packed min/max instructions.
+struct MinOp {
+  float operator()(float a, float b) const { return b < a ? b : a; }
+};
+
+struct MaxOp {
+  float operator()(float a, float b) const { return a < b ? b : a; }
+};
+
+/** Running min/max over the 2 * radius + 1 pixels of every row. */
+template <typename Op>
+void filter_rows(const TextureView& src, const TextureView& dst, uint32_t radius) {
+  const Op op;
+  const uint32_t channels = src.channels;
+  // Past a full period, the window already covers the whole row.
+  radius = std::min(radius, src.width);
+  const size_t window = 2 * static_cast<size_t>(radius) + 1;
+  const size_t extended = static_cast<size_t>(src.width) + 2 * radius;
+
+  parallel_for(0, src.height, [&](size_t y) {
+    thread_local std::vector<float> prefix;
+    thread_local std::vector<float> suffix;
+    prefix.resize(extended * channels);
+    suffix.resize(extended * channels);
+
+    const float* row = src.row(static_cast<uint32_t>(y));
+    for (size_t e = 0; e < extended; ++e) {
+      const uint32_t x = wrap_coord(static_cast<int64_t>(e) - radius, src.width);
+      const float* pixel = row + static_cast<size_t>(x) * channels;
+      std::copy(pixel, pixel + channels, prefix.data() + e * channels);
+    }
+    std::copy(prefix.begin(), prefix.end(), suffix.begin());
+
+    // van Herk/Gil-Werman: running extremes restarting every window pixels, forward and backward. Any window
+    // straddles at most two blocks, so it is the suffix of one block combined with the prefix of the next.
+    for (size_t e = 1; e < extended; ++e) {
+      if (e % window != 0) {
+        for (uint32_t c = 0; c < channels; ++c) {
+          prefix[e * channels + c] = op(prefix[(e - 1) * channels + c], prefix[e * channels + c]);
+        }
+      }
+    }
+    for (size_t e = extended - 1; e-- > 0;) {
+      if ((e + 1) % window != 0) {
+        for (uint32_t c = 0; c < channels; ++c) {
+          suffix[e * channels + c] = op(suffix[(e + 1) * channels + c], suffix[e * channels + c]);
+        }
+      }
+    }
+
+    float* out = dst.row(static_cast<uint32_t>(y));
+    for (uint32_t x = 0; x < src.width; ++x) {
+      for (uint32_t c = 0; c < channels; ++c) {
+        const float head = suffix[static_cast<size_t>(x) * channels + c];
+        out[static_cast<size_t>(x) * channels + c] =
+            x % window == 0 ? head : op(head, prefix[(x + window - 1) * channels + c]);
+      }
+    }
+  });
+}
+
+/**
+ * Running min/max over the 2 * radius + 1 pixels of the lines of direction (dx, 1), with dx in {-1, 0, 1}.
+ * Work is split in tasks covering a strip of columns and a block of window rows. Each task reads its strip with
+ * a halo of radius * |dx| columns, so diagonal lines never leave the task, and keeps only two blocks of rows in
+ * memory. The inner loops run along rows and vectorize.
+ */
+template <typename Op>
+void filter_lines(const TextureView& src, const TextureView& dst, uint32_t radius, int32_t dx) {
+  const Op op;
+  const uint32_t channels = src.channels;
+  const uint64_t period = dx == 0 ? src.height : std::lcm<uint64_t>(src.width, src.height);
+  radius = static_cast<uint32_t>(std::min<uint64_t>(radius, period));
+
+  const uint32_t window = 2 * radius + 1;
+  const uint32_t halo = dx == 0 ? 0 : radius;
+  // Wider strips keep the halo overhead of diagonal passes under 50%.
+  const uint32_t strip_width_max = std::max(STRIP_WIDTH, 4 * halo);
+  const uint32_t strip_count = (src.width + strip_width_max - 1) / strip_width_max;
+  const uint32_t block_count = (src.height + window - 1) / window;
+
+  parallel_for(0, static_cast<size_t>(strip_count) * block_count, [&](size_t task) {
+    const uint32_t strip = static_cast<uint32_t>(task % strip_count);
+    const uint32_t block = static_cast<uint32_t>(task / strip_count);
+    const uint32_t x0 = strip * strip_width_max;
+    const uint32_t strip_width = std::min(strip_width_max, src.width - x0);
+    const size_t buffer_width = static_cast<size_t>(strip_width) + 2 * halo;
+    const size_t row_size = buffer_width * channels;
+
+    thread_local std::vector<uint32_t> columns;
+    thread_local std::vector<float> suffix;
+    thread_local std::vector<float> prefix;
+    columns.resize(buffer_width);
+    suffix.resize(row_size * window);
+    prefix.resize(row_size * window);
+
+    for (size_t j = 0; j < buffer_width; ++j) {
+      columns[j] = wrap_coord(static_cast<int64_t>(x0) - halo + static_cast<int64_t>(j), src.width);
+    }
+
+    // Extended row e holds image row e - radius, so the window of output row y spans [y, y + 2 * radius].
+    const auto load = [&](float* out, int64_t extended_row) {
+      const float* row = src.row(wrap_coord(extended_row - radius, src.height));
+      for (size_t j = 0; j < buffer_width; ++j) {
+        std::copy(row + static_cast<size_t>(columns[j]) * channels,
+                  row + static_cast<size_t>(columns[j] + 1) * channels, out + j * channels);
+      }
+    };
+
+    // Along a line, the previous row is read dx pixels behind; columns whose neighbour falls outside the buffer
+    // start a new run, their results are never read.
+    const size_t shift = static_cast<size_t>(std::abs(dx)) * channels;
+    const auto accumulate = [&](float* out, const float* previous, int32_t direction) {
+      if (direction > 0) {
+        for (size_t i = shift; i < row_size; ++i) {
+          out[i] = op(previous[i - shift], out[i]);
+        }
+      } else {
+        for (size_t i = 0; i + shift < row_size; ++i) {
+          out[i] = op(previous[i + shift], out[i]);
+        }
+      }
+    };
+
+    // Backward extremes over the block the output rows belong to...
+    const int64_t first_row = static_cast<int64_t>(block) * window;
+    for (uint32_t i = window; i-- > 0;) {
+      float* row = suffix.data() + i * row_size;
+      load(row, first_row + i);
+      if (i + 1 < window) {
+        accumulate(row, row + row_size, -dx);
+      }
+    }
+
+    // ...and forward extremes over the next one.
+    for (uint32_t i = 0; i < window; ++i) {
+      float* row = prefix.data() + i * row_size;
+      load(row, first_row + window + i);
+      if (i > 0) {
+        accumulate(row, row - row_size, dx);
+      }
+    }
+
+    const uint32_t row_count = std::min<uint32_t>(window, src.height - block * window);
+    const int64_t head_offset = static_cast<int64_t>(halo) - static_cast<int64_t>(radius) * dx;
+    const int64_t tail_offset = static_cast<int64_t>(halo) + static_cast<int64_t>(radius) * dx;
+    for (uint32_t i = 0; i < row_count; ++i) {
+      const float* head = suffix.data() + i * row_size + head_offset * channels;
+      const float* tail = prefix.data() + (i > 0 ? i - 1 : 0) * row_size + tail_offset * channels;
+      float* out = dst.row(block * window + i) + static_cast<size_t>(x0) * channels;
+      const size_t count = static_cast<size_t>(strip_width) * channels;
+      if (i == 0) {
+        std::copy(head, head + count, out);
+      } else {
+        for (size_t k = 0; k < count; ++k) {
+          out[k] = op(head[k], tail[k]);
+        }
+      }
+    }
+  });
+}
+
+void copy_texture(const TextureView& src, const TextureView& dst) {
+  if (src.data == dst.data) {
+    return;
+  }
+  parallel_for(0, src.height, [&](size_t y) {
+    const float* row = src.row(static_cast<uint32_t>(y));
+    std::copy(row, row + static_cast<size_t>(src.width) * src.channels, dst.row(static_cast<uint32_t>(y)));
+  });
+}
+
+/**
+ * Filters src into dst through scratch; dst may alias src.
+ * The disc is the octagon square(a) + diagonal(b) + anti-diagonal(b): its extent is a + 2 * b along the axes and
+ * (2 * a + 2 * b) / sqrt(2) along the diagonals, both equal to the radius for a regular octagon.
+ */
+template <typename Op>
+void filter(const TextureView& src,
+            const TextureView& dst,
+            const TextureView& scratch,
+            StructuringElement element,
+            uint32_t radius) {
+  uint32_t square_radius = radius;
+  uint32_t diagonal_radius = 0;
+  if (element == StructuringElement::Disc) {
+    diagonal_radius = static_cast<uint32_t>(std::lround(radius * (1.0 - 1.0 / std::sqrt(2.0))));
+    // Diagonal segments only reach every other pixel, the square fills the gaps between them.
+    if (diagonal_radius > 0 && radius - 2 * diagonal_radius < 1) {
+      --diagonal_radius;
+    }
+    square_radius = radius - 2 * diagonal_radius;
+  }
+
+  filter_rows<Op>(src, scratch, square_radius);
+  filter_lines<Op>(scratch, dst, square_radius, 0);
+
+  if (diagonal_radius > 0) {
+    filter_lines<Op>(dst, scratch, diagonal_radius, 1);
+    filter_lines<Op>(scratch, dst, diagonal_radius, -1);
+  }
+}
+}  // namespace
+
+void morphology(const TextureView& src,
+                const TextureView& dst,
+                MorphologyOp op,
+                StructuringElement element,
+                uint32_t radius) {
+  if (!ensure(src.is_valid() && src.has_same_layout(dst))) {
+    return;
+  }
+
+  if (radius == 0) {
+    copy_texture(src, dst);
+    return;
+  }
+
+  Texture scratch_texture(src.width, src.height, src.channels);
+  const TextureView scratch = scratch_texture.view();
+
+  switch (op) {
+    case MorphologyOp::Erode:
+      filter<MinOp>(src, dst, scratch, element, radius);
+      break;
+    case MorphologyOp::Dilate:
+      filter<MaxOp>(src, dst, scratch, element, radius);
+      break;
+    case MorphologyOp::Open:
+      filter<MinOp>(src, dst, scratch, element, radius);
+      filter<MaxOp>(dst, dst, scratch, element, radius);
+      break;
+    case MorphologyOp::Close:
+      filter<MaxOp>(src, dst, scratch, element, radius);
+      filter<MinOp>(dst, dst, scratch, element, radius);
+      break;
+  }
+}
+
+Texture morphology(const Texture& src, MorphologyOp op, StructuringElement element, uint32_t radius) {
+  return filter_texture(src, src.get_width(), src.get_height(), src.get_channels(),
+                        [&](const TextureView& from, const TextureView& to) {
+                          morphology(from, to, op, element, radius);
+                        });
+}
+}  // namespace kn
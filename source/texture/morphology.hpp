@@ -0,0 +1,76 @@
+/**************************************************************************/
+/* morphology.hpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+enum class MorphologyOp : uint8_t {
+  /** Minimum over the structuring element. */
+  Erode,
+  /** Maximum over the structuring element. */
+  Dilate,
+  /** Erosion followed by a dilation, removes bright details smaller than the element. */
+  Open,
+  /** Dilation followed by an erosion, fills dark details smaller than the element. */
+  Close,
+};
+
+enum class StructuringElement : uint8_t {
+  /** (2 * radius + 1) pixels wide square. */
+  Square,
+  /** Octagon approximating a disc: a square dilated by the two diagonal segments. */
+  Disc,
+};
+
+/**
+ * Applies a morphological operator to every channel of a texture.
+ * Every structuring element is decomposed into 1D segments filtered with the van Herk/Gil-Werman algorithm,
+ * so the cost per pixel is constant from radius 1 to radius 256. Borders wrap around.
+ * @param[in] src The texture to filter.
+ * @param[out] dst The destination, with the same layout as src. It may alias src.
+ * @param[in] op The operator to apply.
+ * @param[in] element The shape of the structuring element.
+ * @param[in] radius The radius of the structuring element, 0 copies the texture.
+ */
+KN_TEXTURE_API void morphology(const TextureView& src,
+                               const TextureView& dst,
+                               MorphologyOp op,
+                               StructuringElement element,
+                               uint32_t radius);
+
+/** Filters a texture into a new one; a uniform src gives a uniform texture, see filter_texture. */
+KN_TEXTURE_API Texture morphology(const Texture& src,
+                                  MorphologyOp op,
+                                  StructuringElement element,
+                                  uint32_t radius);
+}  // namespace kn
@@ -0,0 +1,86 @@
+/**************************************************************************/
+/* multi_resolution.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "multi_resolution.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace kn {
+void derive_resolutions(const TextureView& source,
+                        const std::vector<Resolution>& resolutions,
+                        const ResampleOptions& options,
+                        const ResolutionEncoder& encode,
+                        TaskScheduler& scheduler /*= *TaskScheduler::get_instance()*/) {
+  if (!ensure(source.is_valid())) {
+    return;
+  }
+  for (const Resolution& resolution : resolutions) {
+    if (!ensure(resolution.width > 0 && resolution.height > 0)) {
+      return;
+    }
+  }
+
+  std::vector<size_t> order(resolutions.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return static_cast<uint64_t>(resolutions[a].width) * resolutions[a].height >
+           static_cast<uint64_t>(resolutions[b].width) * resolutions[b].height;
+  });
+
+  std::vector<Texture> textures(resolutions.size());
+  std::vector<TextureView> views(resolutions.size());
+  TaskGroup encoders;
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    const size_t index = order[i];
+    const Resolution& resolution = resolutions[index];
+
+    // Smallest texture derived so far that covers the resolution, the source if none does.
+    TextureView parent = source;
+    for (size_t j = 0; j < i; ++j) {
+      const TextureView& candidate = views[order[j]];
+      if (candidate.width >= resolution.width && candidate.height >= resolution.height &&
+          candidate.get_pixel_count() < parent.get_pixel_count()) {
+        parent = candidate;
+      }
+    }
+
+    if (parent.width == resolution.width && parent.height == resolution.height) {
+      views[index] = parent;
+    } else {
+      textures[index] = Texture(resolution.width, resolution.height, source.channels);
+      views[index] = textures[index].view();
+      resample(parent, views[index], options);
+    }
+
+    scheduler.submit(encoders, [&encode, index, view = views[index]]() { encode(index, view); });
+  }
+  scheduler.wait(encoders);
+}
+}  // namespace kn
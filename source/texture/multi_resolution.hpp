@@ -0,0 +1,70 @@
+/**************************************************************************/
+/* multi_resolution.hpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "resample.hpp"
+#include "texture.hpp"
+#include "texture_api.hpp"
+#include "threading/task_scheduler.hpp"
+
+namespace kn {
+struct Resolution {
+  uint32_t width = 0;
+  uint32_t height = 0;
+};
+
+/**
+ * Called once per output of derive_resolutions, possibly from several threads at once.
+ * @param index The index of the output in the requested resolutions.
+ * @param texture The texture at that resolution, valid until the callback returns.
+ */
+using ResolutionEncoder = std::function<void(size_t index, const TextureView& texture)>;
+
+/**
+ * Derives outputs at several resolutions from a single evaluation at the largest one, instead of evaluating the
+ * graph again at every size. Resolutions are derived from largest to smallest, each one from the smallest
+ * already derived texture covering it, so a 4K, 2K, 1K, 512 export resamples a mip chain rather than the 4K
+ * texture four times. Every encoder is submitted as a task as soon as its texture is ready, so encoding overlaps
+ * with both the other encoders and the remaining resampling.
+ * @param source The evaluated texture, at least as large as every requested resolution for best quality.
+ * @param resolutions The output resolutions, in any order; one matching the source encodes the source itself.
+ * @param options The filter used by every resampling step.
+ * @param encode The encoder invoked for every output.
+ * @param scheduler The scheduler running the encoders.
+ */
+KN_TEXTURE_API void derive_resolutions(const TextureView& source,
+                                       const std::vector<Resolution>& resolutions,
+                                       const ResampleOptions& options,
+                                       const ResolutionEncoder& encode,
+                                       TaskScheduler& scheduler = *TaskScheduler::get_instance());
+}  // namespace kn
@@ -0,0 +1,289 @@
+/**************************************************************************/
+/* patterns.cpp                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "patterns.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "math/simd.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+using simd::vfloat4;
+
+/** Largest number of polygon sides. */
+constexpr uint32_t MAX_SIDES = 32;
+
+inline vfloat4 fract(vfloat4 x) {
+  return x - simd::floor(x);
+}
+
+inline vfloat4 clamp01(vfloat4 x) {
+  return simd::min(simd::max(x, simd::broadcast(0.0f)), simd::broadcast(1.0f));
+}
+
+/** Maps a signed distance, negative inside, to 1 inside, 0 outside and a ramp of the bevel width in between. */
+class Profile {
+ public:
+  explicit Profile(float bevel) : _scale(simd::broadcast(bevel > 0.0f ? -1.0f / bevel : -1e20f)) {}
+
+  [[nodiscard]] inline vfloat4 operator()(vfloat4 distance) const { return clamp01(distance * _scale); }
+
+ private:
+  vfloat4 _scale;
+};
+
+/** Periodic coordinate of every pixel of a period, the integer repetitions keeping it tileable. */
+class Phase {
+ public:
+  Phase(int32_t repeat_x, int32_t repeat_y)
+      : _x(simd::broadcast(static_cast<float>(repeat_x))), _y(simd::broadcast(static_cast<float>(repeat_y))) {}
+
+  [[nodiscard]] inline vfloat4 operator()(vfloat4 u, vfloat4 v) const { return fract(simd::madd(u, _x, v * _y)); }
+
+ private:
+  vfloat4 _x;
+  vfloat4 _y;
+};
+
+class LinearGradient {
+ public:
+  explicit LinearGradient(const LinearGradientPattern& pattern)
+      : _phase(pattern.repeat_x, pattern.repeat_y), _mirror(pattern.mirror) {}
+
+  [[nodiscard]] inline vfloat4 operator()(vfloat4 u, vfloat4 v) const {
+    const vfloat4 phase = _phase(u, v);
+    if (!_mirror) {
+      return phase;
+    }
+    return simd::broadcast(1.0f) - simd::abs(simd::madd(phase, simd::broadcast(2.0f), simd::broadcast(-1.0f)));
+  }
+
+ private:
+  Phase _phase;
+  bool _mirror;
+};
+
+class Stripes {
+ public:
+  explicit Stripes(const StripesPattern& pattern)
+      : _phase(pattern.repeat_x, pattern.repeat_y),
+        _half_width(simd::broadcast(0.5f * std::clamp(pattern.width, 0.0f, 1.0f))),
+        _profile(pattern.bevel) {
+    // Phases are measured along the direction of the repetitions, whose periods span 1 / |repeat| in UV units.
+    const float length = std::hypot(static_cast<float>(pattern.repeat_x), static_cast<float>(pattern.repeat_y));
+    _period = simd::broadcast(length > 0.0f ? 1.0f / length : 1.0f);
+  }
+
+  [[nodiscard]] inline vfloat4 operator()(vfloat4 u, vfloat4 v) const {
+    const vfloat4 offset = simd::abs(_phase(u, v) - simd::broadcast(0.5f));
+    return _profile((offset - _half_width) * _period);
+  }
+
+ private:
+  Phase _phase;
+  vfloat4 _half_width;
+  vfloat4 _period;
+  Profile _profile;
+};
+
+/** Signed distance to a box of half extents (hx, hy) with rounded corners, centered on the origin. */
+inline vfloat4 rounded_box(vfloat4 x, vfloat4 y, vfloat4 hx, vfloat4 hy, vfloat4 radius) {
+  using namespace simd;
+  const vfloat4 qx = abs(x) - hx + radius;
+  const vfloat4 qy = abs(y) - hy + radius;
+  const vfloat4 zero = broadcast(0.0f);
+  const vfloat4 ox = max(qx, zero);
+  const vfloat4 oy = max(qy, zero);
+  return sqrt(madd(ox, ox, oy * oy)) + min(max(qx, qy), zero) - radius;
+}
+
+class Bricks {
+ public:
+  explicit Bricks(const BricksPattern& pattern)
+      : _columns(simd::broadcast(static_cast<float>(std::max(pattern.columns, 1u)))),
+        _rows(simd::broadcast(static_cast<float>(std::max(pattern.rows, 1u)))),
+        _offset(simd::broadcast(pattern.offset)),
+        _profile(pattern.bevel) {
+    const float cell_x = 1.0f / static_cast<float>(std::max(pattern.columns, 1u));
+    const float cell_y = 1.0f / static_cast<float>(std::max(pattern.rows, 1u));
+    const float half_x = std::max(0.5f * (cell_x - pattern.gap), 0.0f);
+    const float half_y = std::max(0.5f * (cell_y - pattern.gap), 0.0f);
+    _cell_x = simd::broadcast(cell_x);
+    _cell_y = simd::broadcast(cell_y);
+    _half_x = simd::broadcast(half_x);
+    _half_y = simd::broadcast(half_y);
+    _radius = simd::broadcast(std::clamp(pattern.roundness, 0.0f, 1.0f) * std::min(half_x, half_y));
+  }
+
+  [[nodiscard]] inline vfloat4 operator()(vfloat4 u, vfloat4 v) const {
+    using namespace simd;
+    const vfloat4 half = broadcast(0.5f);
+    const vfloat4 row = floor(v * _rows);
+    const vfloat4 odd = row - broadcast(2.0f) * floor(row * half);
+    const vfloat4 x = (fract(madd(u, _columns, odd * _offset)) - half) * _cell_x;
+    const vfloat4 y = (fract(v * _rows) - half) * _cell_y;
+    return _profile(rounded_box(x, y, _half_x, _half_y, _radius));
+  }
+
+ private:
+  vfloat4 _columns;
+  vfloat4 _rows;
+  vfloat4 _offset;
+  vfloat4 _cell_x;
+  vfloat4 _cell_y;
+  vfloat4 _half_x;
+  vfloat4 _half_y;
+  vfloat4 _radius;
+  Profile _profile;
+};
+
+class Shape {
+ public:
+  explicit Shape(const ShapePattern& pattern)
+      : _tiles_x(simd::broadcast(static_cast<float>(std::max(pattern.tiles_x, 1u)))),
+        _tiles_y(simd::broadcast(static_cast<float>(std::max(pattern.tiles_y, 1u)))),
+        _polygon(pattern.kind == ShapeKind::Polygon),
+        _sides(std::clamp(pattern.sides, 3u, MAX_SIDES)),
+        _profile(pattern.bevel) {
+    const float cell_x = 1.0f / static_cast<float>(std::max(pattern.tiles_x, 1u));
+    const float cell_y = 1.0f / static_cast<float>(std::max(pattern.tiles_y, 1u));
+    const float radius = 0.5f * pattern.size * std::min(cell_x, cell_y);
+    _cell_x = simd::broadcast(cell_x);
+    _cell_y = simd::broadcast(cell_y);
+    _radius = simd::broadcast(radius);
+
+    // A regular polygon is the intersection of the half planes bounded by its sides, at the apothem from the center.
+    const double step = 2.0 * std::numbers::pi / _sides;
+    for (uint32_t i = 0; i < _sides; ++i) {
+      const double angle = pattern.rotation + (i + 0.5) * step;
+      _normal_x[i] = simd::broadcast(static_cast<float>(std::cos(angle)));
+      _normal_y[i] = simd::broadcast(static_cast<float>(std::sin(angle)));
+    }
+    _apothem = simd::broadcast(radius * static_cast<float>(std::cos(std::numbers::pi / _sides)));
+  }
+
+  [[nodiscard]] inline vfloat4 operator()(vfloat4 u, vfloat4 v) const {
+    using namespace simd;
+    const vfloat4 half = broadcast(0.5f);
+    const vfloat4 x = (fract(u * _tiles_x) - half) * _cell_x;
+    const vfloat4 y = (fract(v * _tiles_y) - half) * _cell_y;
+    if (!_polygon) {
+      return _profile(sqrt(madd(x, x, y * y)) - _radius);
+    }
+    vfloat4 distance = madd(x, _normal_x[0], y * _normal_y[0]);
+    for (uint32_t i = 1; i < _sides; ++i) {
+      distance = max(distance, madd(x, _normal_x[i], y * _normal_y[i]));
+    }
+    return _profile(distance - _apothem);
+  }
+
+ private:
+  vfloat4 _tiles_x;
+  vfloat4 _tiles_y;
+  vfloat4 _cell_x;
+  vfloat4 _cell_y;
+  vfloat4 _radius;
+  vfloat4 _apothem;
+  bool _polygon;
+  uint32_t _sides;
+  vfloat4 _normal_x[MAX_SIDES];
+  vfloat4 _normal_y[MAX_SIDES];
+  Profile _profile;
+};
+
+/** Averages the pattern over a grid of subsamples in every pixel of dst. */
+template <typename Generator>
+void render(const Generator& generator, const TextureView& dst, const PatternOptions& options) {
+  const uint32_t width = options.width > 0 ? options.width : dst.width;
+  const uint32_t height = options.height > 0 ? options.height : dst.height;
+  const uint32_t samples = std::max(options.supersampling, 1u);
+
+  // U of the left edge of every column, padded to whole vectors; subsamples add their offset.
+  const uint32_t padded = (dst.width + simd::WIDTH - 1) / simd::WIDTH * simd::WIDTH;
+  std::vector<float> columns(padded);
+  for (uint32_t i = 0; i < padded; ++i) {
+    const uint32_t x = wrap_coord(static_cast<int64_t>(options.x) + std::min(i, dst.width - 1), width);
+    columns[i] = static_cast<float>(x) / static_cast<float>(width);
+  }
+
+  std::vector<float> offsets_u(samples);
+  std::vector<float> offsets_v(samples);
+  for (uint32_t s = 0; s < samples; ++s) {
+    offsets_u[s] = (static_cast<float>(s) + 0.5f) / static_cast<float>(samples * width);
+    offsets_v[s] = (static_cast<float>(s) + 0.5f) / static_cast<float>(samples * height);
+  }
+  const vfloat4 weight = simd::broadcast(1.0f / static_cast<float>(samples * samples));
+
+  parallel_for(0, dst.height, [&](size_t row) {
+    const uint32_t y = wrap_coord(static_cast<int64_t>(options.y) + static_cast<int64_t>(row), height);
+    const float v0 = static_cast<float>(y) / static_cast<float>(height);
+    float* out = dst.row(static_cast<uint32_t>(row));
+
+    for (uint32_t i = 0; i < dst.width; i += simd::WIDTH) {
+      const vfloat4 u0 = simd::load(columns.data() + i);
+      vfloat4 sum = simd::broadcast(0.0f);
+      for (uint32_t sy = 0; sy < samples; ++sy) {
+        const vfloat4 v = simd::broadcast(v0 + offsets_v[sy]);
+        for (uint32_t sx = 0; sx < samples; ++sx) {
+          sum = sum + generator(u0 + simd::broadcast(offsets_u[sx]), v);
+        }
+      }
+
+      float values[simd::WIDTH];
+      simd::store(values, sum * weight);
+      std::copy(values, values + std::min(simd::WIDTH, dst.width - i), out + i);
+    }
+  });
+}
+}  // namespace
+
+void generate_pattern(const Pattern& pattern, const TextureView& dst, const PatternOptions& options /*= {}*/) {
+  if (!ensure(dst.is_valid() && dst.channels == 1)) {
+    return;
+  }
+
+  std::visit(
+      [&](const auto& parameters) {
+        using Parameters = std::decay_t<decltype(parameters)>;
+        if constexpr (std::is_same_v<Parameters, LinearGradientPattern>) {
+          render(LinearGradient(parameters), dst, options);
+        } else if constexpr (std::is_same_v<Parameters, StripesPattern>) {
+          render(Stripes(parameters), dst, options);
+        } else if constexpr (std::is_same_v<Parameters, BricksPattern>) {
+          render(Bricks(parameters), dst, options);
+        } else {
+          render(Shape(parameters), dst, options);
+        }
+      },
+      pattern);
+}
+}  // namespace kn
@@ -0,0 +1,119 @@
+/**************************************************************************/
+/* patterns.hpp                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <variant>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/**
+ * Ramp along a direction: the value rises from 0 to 1 over every period of repeat_x * u + repeat_y * v. Integer
+ * repetitions keep the pattern tileable in every direction.
+ */
+struct LinearGradientPattern {
+  int32_t repeat_x = 1;
+  int32_t repeat_y = 0;
+  /** Goes back down to 0 within every period instead of restarting from 0. */
+  bool mirror = false;
+};
+
+/** Parallel stripes, one per period of repeat_x * u + repeat_y * v. */
+struct StripesPattern {
+  int32_t repeat_x = 8;
+  int32_t repeat_y = 0;
+  /** Fraction of a period covered by a stripe. */
+  float width = 0.5f;
+  /** Width of the ramp from the stripe edges to its inside, in UV units. */
+  float bevel = 0.0f;
+};
+
+/** Bricks, or tiles without offset, laid on a grid of columns x rows, separated by gaps. */
+struct BricksPattern {
+  uint32_t columns = 4;
+  uint32_t rows = 8;
+  /** Horizontal shift of every other row, in bricks; rows must be even for the pattern to tile when it is set. */
+  float offset = 0.5f;
+  /** Width of the gaps, in UV units. */
+  float gap = 0.01f;
+  /** Radius of the corners, as a fraction of the smaller half extent of a brick. */
+  float roundness = 0.0f;
+  /** Width of the ramp from the brick edges to their inside, in UV units. */
+  float bevel = 0.02f;
+};
+
+enum class ShapeKind : uint8_t {
+  Disk,
+  /** Regular polygon. */
+  Polygon,
+};
+
+/** A shape centered in every cell of a tiles_x x tiles_y grid. */
+struct ShapePattern {
+  ShapeKind kind = ShapeKind::Disk;
+  uint32_t tiles_x = 1;
+  uint32_t tiles_y = 1;
+  /** Sides of the polygon, 3 to 32. */
+  uint32_t sides = 6;
+  /** Radius of the circumscribed circle, as a fraction of half the smaller side of a cell. */
+  float size = 0.8f;
+  /** Rotation of the polygon, in radians; without rotation, a vertex points along u. */
+  float rotation = 0.0f;
+  /** Width of the ramp from the shape edges to its inside, in UV units. */
+  float bevel = 0.0f;
+};
+
+using Pattern = std::variant<LinearGradientPattern, StripesPattern, BricksPattern, ShapePattern>;
+
+struct PatternOptions {
+  /** Subsamples per pixel along each axis, averaged to anti-alias edges. */
+  uint32_t supersampling = 2;
+  /** Size of the whole texture the pattern covers once over [0, 1) UV; 0 for the size of dst. */
+  uint32_t width = 0;
+  uint32_t height = 0;
+  /** Position of dst in the whole texture; regions crossing its border wrap around. */
+  uint32_t x = 0;
+  uint32_t y = 0;
+};
+
+/**
+ * Renders an analytic pattern, evaluating the signed distance or ramp of four pixels per SIMD instruction at
+ * every subsample. Patterns repeat over the unit square, so the output is tileable. Since every pixel is evaluated
+ * independently, dst may be any region of the whole texture, such as a tile requested by lazy evaluation; its
+ * pixels are the same as those of a render of the whole texture.
+ * @param[in] pattern The pattern and its parameters.
+ * @param[out] dst The single channel region to render.
+ * @param[in] options The supersampling rate and the position of dst in the whole texture.
+ */
+KN_TEXTURE_API void generate_pattern(const Pattern& pattern,
+                                     const TextureView& dst,
+                                     const PatternOptions& options = {});
+}  // namespace kn
@@ -0,0 +1,392 @@
+/**************************************************************************/
+/* resample.cpp                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "resample.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "color.hpp"
+#include "math/simd.hpp"
+#include "texture_format.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+using simd::vfloat4;
+
+/** Weights of a 1D resampling, every output pixel having the same number of taps. */
+struct FilterWeights {
+  uint32_t taps = 0;
+  /** First source pixel of every output pixel, before wrapping. */
+  std::vector<int64_t> first;
+  std::vector<float> weights;
+
+  [[nodiscard]] inline const float* get(size_t i) const { return weights.data() + i * taps; }
+};
+
+double mitchell(double x) {
+  // B = C = 1/3, both polynomials being premultiplied by 6.
+  x = std::abs(x);
+  if (x < 1.0) {
+    return (7.0 * x * x * x - 12.0 * x * x + 16.0 / 3.0) / 6.0;
+  }
+  if (x < 2.0) {
+    return (-7.0 / 3.0 * x * x * x + 12.0 * x * x - 20.0 * x + 32.0 / 3.0) / 6.0;
+  }
+  return 0.0;
+}
+
+double sinc(double x) {
+  if (x == 0.0) {
+    return 1.0;
+  }
+  const double px = std::numbers::pi * x;
+  return std::sin(px) / px;
+}
+
+double lanczos3(double x) {
+  return std::abs(x) < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+FilterWeights compute_weights(uint32_t src_size, uint32_t dst_size, ResampleFilter filter) {
+  const double scale = static_cast<double>(src_size) / static_cast<double>(dst_size);
+
+  FilterWeights result;
+  result.first.resize(dst_size);
+
+  if (filter == ResampleFilter::Area) {
+    // Output pixel i covers [i * scale, (i + 1) * scale) of the source.
+    result.taps = static_cast<uint32_t>(std::ceil(scale)) + 1;
+    result.weights.resize(static_cast<size_t>(dst_size) * result.taps);
+    for (uint32_t i = 0; i < dst_size; ++i) {
+      const double low = i * scale;
+      const double high = low + scale;
+      const auto first = static_cast<int64_t>(std::floor(low));
+      result.first[i] = first;
+      for (uint32_t k = 0; k < result.taps; ++k) {
+        const auto j = static_cast<double>(first + k);
+        const double coverage = std::min(high, j + 1.0) - std::max(low, j);
+        result.weights[static_cast<size_t>(i) * result.taps + k] = static_cast<float>(std::max(coverage, 0.0) / scale);
+      }
+    }
+    return result;
+  }
+
+  const double radius = filter == ResampleFilter::Mitchell ? 2.0 : 3.0;
+  const double filter_scale = std::max(scale, 1.0);
+  const double support = radius * filter_scale;
+  result.taps = static_cast<uint32_t>(std::ceil(2.0 * support)) + 1;
+  result.weights.resize(static_cast<size_t>(dst_size) * result.taps);
+
+  for (uint32_t i = 0; i < dst_size; ++i) {
+    // Source pixel j is centered on j + 0.5, and contributes when that center lies within the support.
+    const double center = (i + 0.5) * scale;
+    const auto first = static_cast<int64_t>(std::ceil(center - support - 0.5));
+    result.first[i] = first;
+
+    float* weights = result.weights.data() + static_cast<size_t>(i) * result.taps;
+    double sum = 0.0;
+    for (uint32_t k = 0; k < result.taps; ++k) {
+      const double x = (static_cast<double>(first + k) + 0.5 - center) / filter_scale;
+      const double w = filter == ResampleFilter::Mitchell ? mitchell(x) : lanczos3(x);
+      weights[k] = static_cast<float>(w);
+      sum += w;
+    }
+    for (uint32_t k = 0; k < result.taps; ++k) {
+      weights[k] = static_cast<float>(weights[k] / sum);
+    }
+  }
+  return result;
+}
+
+/** Output rows resampled by one task. */
+constexpr uint32_t BAND_ROWS = 64;
+
+/**
+ * Horizontal pass over one row of src_width pixels, compiled per channel count. Taps are read in place, except for
+ * the few output pixels whose taps wrap around the row, which are gathered into scratch first.
+ */
+template <uint32_t Channels>
+void filter_row(const float* src,
+                uint32_t src_width,
+                const FilterWeights& weights,
+                std::vector<float>& scratch,
+                float* out) {
+  scratch.resize(static_cast<size_t>(weights.taps) * Channels);
+
+  const uint32_t taps = weights.taps;
+  for (size_t x = 0; x < weights.first.size(); ++x) {
+    const int64_t first = weights.first[x];
+    const float* values = scratch.data();
+    if (first < 0 || first + taps > src_width) {
+      for (uint32_t t = 0; t < taps; ++t) {
+        const uint32_t sx = wrap_coord(first + t, src_width);
+        std::copy_n(src + static_cast<size_t>(sx) * Channels, Channels, scratch.data() + t * Channels);
+      }
+    } else {
+      values = src + first * Channels;
+    }
+    const float* w = weights.get(x);
+    uint32_t k = 0;
+
+    if constexpr (Channels == simd::WIDTH) {
+      // Independent accumulators hide the latency of the multiply-add chain.
+      vfloat4 accum[4] = {simd::broadcast(0.0f), simd::broadcast(0.0f), simd::broadcast(0.0f), simd::broadcast(0.0f)};
+      for (; k + 4 <= taps; k += 4) {
+        for (uint32_t i = 0; i < 4; ++i) {
+          accum[i] = simd::madd(simd::load(values + (k + i) * simd::WIDTH), simd::broadcast(w[k + i]), accum[i]);
+        }
+      }
+      for (; k < taps; ++k) {
+        accum[0] = simd::madd(simd::load(values + k * simd::WIDTH), simd::broadcast(w[k]), accum[0]);
+      }
+      simd::store(out + x * simd::WIDTH, (accum[0] + accum[1]) + (accum[2] + accum[3]));
+    } else if constexpr (Channels == 1) {
+      // Single channel taps are contiguous, four of them fit in a register.
+      vfloat4 accum = simd::broadcast(0.0f);
+      for (; k + simd::WIDTH <= taps; k += simd::WIDTH) {
+        accum = simd::madd(simd::load(values + k), simd::load(w + k), accum);
+      }
+      alignas(16) float lanes[simd::WIDTH];
+      simd::store(lanes, accum);
+      float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+      for (; k < taps; ++k) {
+        sum += values[k] * w[k];
+      }
+      out[x] = sum;
+    } else {
+      // The sums of all the channels stay in registers over the taps.
+      float sums[Channels] = {};
+      for (; k < taps; ++k) {
+        for (uint32_t c = 0; c < Channels; ++c) {
+          sums[c] += values[k * Channels + c] * w[k];
+        }
+      }
+      std::copy_n(sums, Channels, out + x * Channels);
+    }
+  }
+}
+
+/** Vertical pass for one output row: out = sum of w[k] * rows[k] over row_size floats. */
+void filter_column(const float* const* rows, const float* w, uint32_t taps, size_t row_size, float* out) {
+  constexpr size_t BLOCK = 4 * simd::WIDTH;
+  size_t i = 0;
+  for (; i + BLOCK <= row_size; i += BLOCK) {
+    vfloat4 accum[4] = {simd::broadcast(0.0f), simd::broadcast(0.0f), simd::broadcast(0.0f), simd::broadcast(0.0f)};
+    for (uint32_t k = 0; k < taps; ++k) {
+      const vfloat4 weight = simd::broadcast(w[k]);
+      for (uint32_t j = 0; j < 4; ++j) {
+        accum[j] = simd::madd(simd::load(rows[k] + i + j * simd::WIDTH), weight, accum[j]);
+      }
+    }
+    for (uint32_t j = 0; j < 4; ++j) {
+      simd::store(out + i + j * simd::WIDTH, accum[j]);
+    }
+  }
+  for (; i < row_size; ++i) {
+    float sum = 0.0f;
+    for (uint32_t k = 0; k < taps; ++k) {
+      sum += rows[k][i] * w[k];
+    }
+    out[i] = sum;
+  }
+}
+
+/**
+ * sRGB transfer functions through linearly interpolated tables, as pow would cost more than the filtering itself.
+ * Encoding is tabulated against the fourth root of the value, where it is smooth enough to interpolate.
+ * Values outside of [0, 1] go through the exact functions.
+ */
+class SrgbTables {
+ public:
+  static const SrgbTables& get() {
+    static const SrgbTables tables;
+    return tables;
+  }
+
+  [[nodiscard]] float decode(float value) const {
+    return value >= 0.0f && value <= 1.0f ? lookup(_decode, value) : srgb_to_linear(value);
+  }
+
+  [[nodiscard]] float encode(float value) const {
+    return value >= 0.0f && value <= 1.0f ? lookup(_encode, std::sqrt(std::sqrt(value))) : linear_to_srgb(value);
+  }
+
+ private:
+  static constexpr uint32_t SIZE = 4096;
+  using Table = std::array<float, SIZE + 1>;
+
+  SrgbTables() {
+    for (uint32_t i = 0; i <= SIZE; ++i) {
+      const double x = static_cast<double>(i) / SIZE;
+      _decode[i] = srgb_to_linear(static_cast<float>(x));
+      _encode[i] = linear_to_srgb(static_cast<float>(x * x * x * x));
+    }
+  }
+
+  static float lookup(const Table& table, float x) {
+    const float position = x * static_cast<float>(SIZE);
+    const uint32_t i = std::min(static_cast<uint32_t>(position), SIZE - 1);
+    const float t = position - static_cast<float>(i);
+    return table[i] + (table[i + 1] - table[i]) * t;
+  }
+
+  Table _decode;
+  Table _encode;
+};
+
+/** Applies a transfer function to the color channels of a row of pixels, leaving alpha untouched. */
+template <typename Transfer>
+void transform_colors(const float* src, float* dst, uint32_t width, uint32_t channels, Transfer&& transfer) {
+  const uint32_t color_channels = std::min(channels, 3u);
+  for (size_t x = 0; x < width; ++x) {
+    for (uint32_t c = 0; c < channels; ++c) {
+      const float value = src[x * channels + c];
+      dst[x * channels + c] = c < color_channels ? transfer(value) : value;
+    }
+  }
+}
+
+void decode_srgb(const float* src, float* dst, uint32_t width, uint32_t channels) {
+  const SrgbTables& tables = SrgbTables::get();
+  transform_colors(src, dst, width, channels, [&](float value) { return tables.decode(value); });
+}
+
+void encode_srgb(float* row, uint32_t width, uint32_t channels) {
+  const SrgbTables& tables = SrgbTables::get();
+  transform_colors(row, row, width, channels, [&](float value) { return tables.encode(value); });
+}
+
+/**
+ * Resamples bands of output rows in parallel. With rows_first, a band filters the source rows it reads
+ * horizontally into a local buffer, then combines them vertically; bands overlap by the vertical filter taps.
+ * Otherwise, every output row is combined vertically from the source rows, then filtered horizontally.
+ * sRGB source rows are decoded as they are read, which is only possible when rows are filtered first.
+ */
+void resample_bands(const TextureView& src,
+                    const TextureView& dst,
+                    const FilterWeights& columns,
+                    const FilterWeights& rows,
+                    bool rows_first,
+                    bool decode_source,
+                    bool encode_output) {
+  const uint32_t channels = src.channels;
+  const size_t src_row_size = static_cast<size_t>(src.width) * channels;
+  const size_t dst_row_size = static_cast<size_t>(dst.width) * channels;
+  const auto filter = dispatch_channels(channels, [](auto count) { return &filter_row<count()>; });
+
+  parallel_for(0, (dst.height + BAND_ROWS - 1) / BAND_ROWS, [&](size_t band) {
+    thread_local std::vector<float> scratch;
+    thread_local std::vector<float> buffer;
+    thread_local std::vector<float> linear;
+    thread_local std::vector<const float*> taps;
+    taps.resize(rows.taps);
+
+    const uint32_t y0 = static_cast<uint32_t>(band) * BAND_ROWS;
+    const uint32_t y1 = std::min(y0 + BAND_ROWS, dst.height);
+
+    if (rows_first) {
+      const int64_t first_row = rows.first[y0];
+      const auto row_count = static_cast<size_t>(rows.first[y1 - 1] + rows.taps - first_row);
+      buffer.resize(row_count * dst_row_size);
+      for (size_t r = 0; r < row_count; ++r) {
+        const float* row = src.row(wrap_coord(first_row + static_cast<int64_t>(r), src.height));
+        if (decode_source) {
+          linear.resize(src_row_size);
+          decode_srgb(row, linear.data(), src.width, channels);
+          row = linear.data();
+        }
+        filter(row, src.width, columns, scratch, buffer.data() + r * dst_row_size);
+      }
+
+      for (uint32_t y = y0; y < y1; ++y) {
+        for (uint32_t k = 0; k < rows.taps; ++k) {
+          taps[k] = buffer.data() + static_cast<size_t>(rows.first[y] - first_row + k) * dst_row_size;
+        }
+        filter_column(taps.data(), rows.get(y), rows.taps, dst_row_size, dst.row(y));
+        if (encode_output) {
+          encode_srgb(dst.row(y), dst.width, channels);
+        }
+      }
+      return;
+    }
+
+    buffer.resize(src_row_size);
+    for (uint32_t y = y0; y < y1; ++y) {
+      for (uint32_t k = 0; k < rows.taps; ++k) {
+        taps[k] = src.row(wrap_coord(rows.first[y] + k, src.height));
+      }
+      filter_column(taps.data(), rows.get(y), rows.taps, src_row_size, buffer.data());
+      filter(buffer.data(), src.width, columns, scratch, dst.row(y));
+      if (encode_output) {
+        encode_srgb(dst.row(y), dst.width, channels);
+      }
+    }
+  });
+}
+
+}  // namespace
+
+void resample(const TextureView& src, const TextureView& dst, const ResampleOptions& options /*= {}*/) {
+  if (!ensure(src.is_valid() && dst.is_valid() && src.channels <= 4 && dst.channels == src.channels)) {
+    return;
+  }
+
+  const FilterWeights columns = compute_weights(src.width, dst.width, options.filter);
+  const FilterWeights rows = compute_weights(src.height, dst.height, options.filter);
+
+  // Filtering rows first costs a horizontal pass over src.height rows, filtering columns first a horizontal pass
+  // over src.width columns; pick the order with the fewest multiply-adds.
+  const double dst_pixels = static_cast<double>(dst.width) * dst.height;
+  const double rows_cost = static_cast<double>(dst.width) * src.height * columns.taps + dst_pixels * rows.taps;
+  const double columns_cost = static_cast<double>(src.width) * dst.height * rows.taps + dst_pixels * columns.taps;
+  const bool rows_first = rows_cost <= columns_cost;
+
+  if (!options.srgb || rows_first) {
+    resample_bands(src, dst, columns, rows, rows_first, options.srgb, options.srgb);
+    return;
+  }
+
+  // Source rows are read by several output rows, decode them once.
+  Texture linear(src.width, src.height, src.channels);
+  const TextureView input = linear.view();
+  parallel_for(0, src.height, [&](size_t y) {
+    decode_srgb(src.row(static_cast<uint32_t>(y)), input.row(static_cast<uint32_t>(y)), src.width, src.channels);
+  });
+  resample_bands(input, dst, columns, rows, false, false, true);
+}
+
+Texture resample(const Texture& src, uint32_t width, uint32_t height, const ResampleOptions& options /*= {}*/) {
+  return filter_texture(src, width, height, src.get_channels(), [&](const TextureView& from, const TextureView& to) {
+    resample(from, to, options);
+  });
+}
+}  // namespace kn
@@ -0,0 +1,69 @@
+/**************************************************************************/
+/* resample.hpp                                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+enum class ResampleFilter : uint8_t {
+  /** Averages the source pixels covered by each output pixel, weighted by coverage. */
+  Area,
+  /** Mitchell-Netravali cubic with B = C = 1/3, soft with little ringing. */
+  Mitchell,
+  /** Windowed sinc with 3 lobes, sharp with some ringing. */
+  Lanczos3,
+};
+
+struct ResampleOptions {
+  ResampleFilter filter = ResampleFilter::Lanczos3;
+  /** Filters the color channels in linear light; they are sRGB encoded in source and destination. */
+  bool srgb = false;
+};
+
+/**
+ * Resamples a texture to the size of dst, scaling up or down independently along each axis.
+ * The filter is separable: weights are computed once per output row and column, then applied by a horizontal
+ * and a vertical pass, in the order doing the least work. The filter is widened by the scale factor when
+ * downscaling, so every source pixel contributes. The texture is tileable, so filters wrap around borders.
+ * @param[in] src The texture to resample, with 1 to 4 channels.
+ * @param[out] dst The resampled texture, with the channel count of src.
+ * @param[in] options The filter, and whether the first three channels are sRGB encoded; the fourth one, alpha,
+ * is always filtered as is.
+ */
+KN_TEXTURE_API void resample(const TextureView& src, const TextureView& dst, const ResampleOptions& options = {});
+
+/** Resamples a texture to a new one of the given size; a uniform src gives a uniform texture, see filter_texture. */
+KN_TEXTURE_API Texture resample(const Texture& src,
+                                uint32_t width,
+                                uint32_t height,
+                                const ResampleOptions& options = {});
+}  // namespace kn
@@ -0,0 +1,314 @@
+/**************************************************************************/
+/* sampler.cpp                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "sampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include "math/simd.hpp"
+
+namespace kn {
+namespace {
+using simd::vfloat4;
+
+constexpr uint32_t LANES = simd::WIDTH;
+
+/** Magnitude texel coordinates are clamped to, below which floats still hold every integer. */
+constexpr float COORD_LIMIT = 16777216.0f;
+
+/** Address mode of one axis, with its constants hoisted out of the sample loop. */
+class Axis {
+ public:
+  Axis(AddressMode mode, uint32_t size)
+      : _mode(mode),
+        _size(static_cast<int32_t>(size)),
+        _period(static_cast<int32_t>(mode == AddressMode::Mirror ? 2 * size : size)),
+        _last(simd::broadcast(static_cast<float>(size) - 1.0f)) {}
+
+  /** Resolves integral texel coordinates, stored as floats, into texel indices; NaN resolves as 0. */
+  void resolve(vfloat4 coord, int32_t* out) const {
+    if (_mode == AddressMode::Clamp) {
+      // NaN lanes take the second operand of min and max.
+      simd::store(out, simd::to_int(simd::min(simd::max(coord, simd::broadcast(0.0f)), _last)));
+      return;
+    }
+
+    // Wrapping in floats leaves rounding errors of a texel or more for large coordinates, so it is done on integers.
+    alignas(16) float lanes[LANES];
+    simd::store(lanes, coord);
+    for (uint32_t l = 0; l < LANES; ++l) {
+      const float clamped = std::isnan(lanes[l]) ? 0.0f : std::clamp(lanes[l], -COORD_LIMIT, COORD_LIMIT);
+      int32_t r = static_cast<int32_t>(clamped) % _period;
+      r = r < 0 ? r + _period : r;
+      out[l] = _mode == AddressMode::Mirror && r >= _size ? _period - 1 - r : r;
+    }
+  }
+
+ private:
+  AddressMode _mode;
+  int32_t _size;
+  int32_t _period;
+  vfloat4 _last;
+};
+
+/** Gathers and accumulates weighted texels for four samples at once. */
+template <uint32_t Channels>
+class Gatherer {
+ public:
+  Gatherer(const TextureView& texture, const SamplerState& state)
+      : _data(texture.data),
+        _row_stride(texture.row_stride),
+        _max_anisotropy(static_cast<float>(std::max(state.max_anisotropy, 1u))),
+        _u(state.address_u, texture.width),
+        _v(state.address_v, texture.height),
+        _width(simd::broadcast(static_cast<float>(texture.width))),
+        _height(simd::broadcast(static_cast<float>(texture.height))) {}
+
+  void clear() { std::fill(&_accum[0][0], &_accum[0][0] + LANES * Channels, 0.0f); }
+
+  void nearest(vfloat4 u, vfloat4 v) {
+    alignas(16) int32_t xs[LANES];
+    alignas(16) int32_t ys[LANES];
+    _u.resolve(simd::floor(u * _width), xs);
+    _v.resolve(simd::floor(v * _height), ys);
+    add(xs, ys, simd::broadcast(1.0f));
+  }
+
+  void bilinear(vfloat4 u, vfloat4 v, vfloat4 weight) {
+    const vfloat4 half = simd::broadcast(0.5f);
+    const vfloat4 one = simd::broadcast(1.0f);
+    const vfloat4 x = u * _width - half;
+    const vfloat4 y = v * _height - half;
+    const vfloat4 x0 = simd::floor(x);
+    const vfloat4 y0 = simd::floor(y);
+    const vfloat4 fx = x - x0;
+    const vfloat4 fy = y - y0;
+
+    alignas(16) int32_t xs[2][LANES];
+    alignas(16) int32_t ys[2][LANES];
+    _u.resolve(x0, xs[0]);
+    _u.resolve(x0 + one, xs[1]);
+    _v.resolve(y0, ys[0]);
+    _v.resolve(y0 + one, ys[1]);
+
+    const vfloat4 top = (one - fy) * weight;
+    const vfloat4 bottom = fy * weight;
+    add(xs[0], ys[0], (one - fx) * top);
+    add(xs[1], ys[0], fx * top);
+    add(xs[0], ys[1], (one - fx) * bottom);
+    add(xs[1], ys[1], fx * bottom);
+  }
+
+  void bicubic(vfloat4 u, vfloat4 v) {
+    const vfloat4 half = simd::broadcast(0.5f);
+    const vfloat4 x = u * _width - half;
+    const vfloat4 y = v * _height - half;
+    const vfloat4 x1 = simd::floor(x);
+    const vfloat4 y1 = simd::floor(y);
+
+    vfloat4 wx[4];
+    vfloat4 wy[4];
+    catmull_rom(x - x1, wx);
+    catmull_rom(y - y1, wy);
+
+    alignas(16) int32_t xs[4][LANES];
+    alignas(16) int32_t ys[4][LANES];
+    for (int32_t i = 0; i < 4; ++i) {
+      const vfloat4 offset = simd::broadcast(static_cast<float>(i - 1));
+      _u.resolve(x1 + offset, xs[i]);
+      _v.resolve(y1 + offset, ys[i]);
+    }
+
+    for (uint32_t j = 0; j < 4; ++j) {
+      for (uint32_t i = 0; i < 4; ++i) {
+        add(xs[i], ys[j], wx[i] * wy[j]);
+      }
+    }
+  }
+
+  /**
+   * Spreads up to max_anisotropy bilinear taps along the longest axis of the footprint, the number of taps of
+   * each lane being the ratio between the axes.
+   */
+  void anisotropic(vfloat4 u, vfloat4 v, vfloat4 dudx, vfloat4 dvdx, vfloat4 dudy, vfloat4 dvdy) {
+    const vfloat4 x_length = (dudx * _width) * (dudx * _width) + (dvdx * _height) * (dvdx * _height);
+    const vfloat4 y_length = (dudy * _width) * (dudy * _width) + (dvdy * _height) * (dvdy * _height);
+
+    const auto x_major = y_length < x_length;
+    const vfloat4 major_u = simd::select(x_major, dudx, dudy);
+    const vfloat4 major_v = simd::select(x_major, dvdx, dvdy);
+    alignas(16) float major[LANES];
+    alignas(16) float minor[LANES];
+    simd::store(major, simd::max(x_length, y_length));
+    simd::store(minor, simd::min(x_length, y_length));
+
+    alignas(16) float tap_counts[LANES];
+    uint32_t max_taps = 1;
+    for (uint32_t l = 0; l < LANES; ++l) {
+      const float ratio = minor[l] > 0.0f ? std::sqrt(major[l] / minor[l]) : (major[l] > 0.0f ? 1e30f : 1.0f);
+      const auto taps = static_cast<uint32_t>(std::ceil(std::clamp(ratio, 1.0f, _max_anisotropy)));
+      tap_counts[l] = static_cast<float>(taps);
+      max_taps = std::max(max_taps, taps);
+    }
+
+    const vfloat4 taps = simd::load(tap_counts);
+    const vfloat4 weight = simd::broadcast(1.0f) / taps;
+    const vfloat4 zero = simd::broadcast(0.0f);
+    for (uint32_t k = 0; k < max_taps; ++k) {
+      const vfloat4 index = simd::broadcast(static_cast<float>(k));
+      const vfloat4 offset = (index + simd::broadcast(0.5f)) / taps - simd::broadcast(0.5f);
+      bilinear(simd::madd(major_u, offset, u), simd::madd(major_v, offset, v),
+               simd::select(index < taps, weight, zero));
+    }
+  }
+
+  /** Writes the first lanes results, interleaved like the texture. */
+  void write(float* out, size_t lanes) const {
+    std::copy(&_accum[0][0], &_accum[0][0] + lanes * Channels, out);
+  }
+
+ private:
+  /**
+   * Adds weight * texel(xs, ys) to the accumulators of the four lanes. Texels are accumulated lane by lane, as
+   * transposing them into channel vectors would cost more than the arithmetic it saves.
+   */
+  void add(const int32_t* xs, const int32_t* ys, vfloat4 weight) {
+    alignas(16) float weights[LANES];
+    simd::store(weights, weight);
+
+    for (uint32_t l = 0; l < LANES; ++l) {
+      const float* texel = _data + static_cast<size_t>(ys[l]) * _row_stride + static_cast<size_t>(xs[l]) * Channels;
+      for (uint32_t c = 0; c < Channels; ++c) {
+        _accum[l][c] += texel[c] * weights[l];
+      }
+    }
+  }
+
+  static void catmull_rom(vfloat4 t, vfloat4 (&w)[4]) {
+    const vfloat4 t2 = t * t;
+    const vfloat4 t3 = t2 * t;
+    const auto k = [](float value) { return simd::broadcast(value); };
+    w[0] = k(-0.5f) * t3 + t2 - k(0.5f) * t;
+    w[1] = k(1.5f) * t3 - k(2.5f) * t2 + k(1.0f);
+    w[2] = k(-1.5f) * t3 + k(2.0f) * t2 + k(0.5f) * t;
+    w[3] = k(0.5f) * t3 - k(0.5f) * t2;
+  }
+
+  const float* _data;
+  size_t _row_stride;
+  float _max_anisotropy;
+  Axis _u;
+  Axis _v;
+  vfloat4 _width;
+  vfloat4 _height;
+  float _accum[LANES][Channels];
+};
+
+/** Loads four values starting at index, repeating the last valid one past count. */
+vfloat4 load_lanes(const float* values, size_t index, size_t count) {
+  if (index + LANES <= count) {
+    return simd::load(values + index);
+  }
+  alignas(16) float lanes[LANES];
+  for (uint32_t l = 0; l < LANES; ++l) {
+    lanes[l] = values[std::min(index + l, count - 1)];
+  }
+  return simd::load(lanes);
+}
+
+template <uint32_t Channels>
+void sample_batches(const TextureView& texture,
+                    const SamplerState& state,
+                    const float* u,
+                    const float* v,
+                    size_t count,
+                    float* out,
+                    const SampleGradients* gradients) {
+  Gatherer<Channels> gatherer(texture, state);
+
+  FilterMode filter = state.filter;
+  if (filter == FilterMode::Anisotropic &&
+      !(gradients && gradients->dudx && gradients->dvdx && gradients->dudy && gradients->dvdy)) {
+    filter = FilterMode::Bilinear;
+  }
+
+  for (size_t first = 0; first < count; first += LANES) {
+    gatherer.clear();
+
+    const vfloat4 lane_u = load_lanes(u, first, count);
+    const vfloat4 lane_v = load_lanes(v, first, count);
+
+    switch (filter) {
+      case FilterMode::Nearest:
+        gatherer.nearest(lane_u, lane_v);
+        break;
+      case FilterMode::Bilinear:
+        gatherer.bilinear(lane_u, lane_v, simd::broadcast(1.0f));
+        break;
+      case FilterMode::Bicubic:
+        gatherer.bicubic(lane_u, lane_v);
+        break;
+      case FilterMode::Anisotropic:
+        gatherer.anisotropic(lane_u, lane_v, load_lanes(gradients->dudx, first, count),
+                             load_lanes(gradients->dvdx, first, count), load_lanes(gradients->dudy, first, count),
+                             load_lanes(gradients->dvdy, first, count));
+        break;
+    }
+
+    gatherer.write(out + first * Channels, std::min<size_t>(LANES, count - first));
+  }
+}
+}  // namespace
+
+void sample(const TextureView& texture,
+            const SamplerState& state,
+            const float* u,
+            const float* v,
+            size_t count,
+            float* out,
+            const SampleGradients* gradients /*= nullptr*/) {
+  if (!ensure(texture.is_valid() && texture.channels <= 4) || count == 0) {
+    return;
+  }
+
+  switch (texture.channels) {
+    case 1:
+      sample_batches<1>(texture, state, u, v, count, out, gradients);
+      break;
+    case 2:
+      sample_batches<2>(texture, state, u, v, count, out, gradients);
+      break;
+    case 3:
+      sample_batches<3>(texture, state, u, v, count, out, gradients);
+      break;
+    default:
+      sample_batches<4>(texture, state, u, v, count, out, gradients);
+      break;
+  }
+}
+}  // namespace kn
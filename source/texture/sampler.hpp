@@ -0,0 +1,93 @@
+/**************************************************************************/
+/* sampler.hpp                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/** How texel coordinates outside of the texture are resolved, as D3D12_TEXTURE_ADDRESS_MODE. */
+enum class AddressMode : uint8_t {
+  Wrap,
+  Clamp,
+  Mirror,
+};
+
+enum class FilterMode : uint8_t {
+  /** Closest texel. */
+  Nearest,
+  /** Linear interpolation of the 2x2 closest texels. */
+  Bilinear,
+  /** Catmull-Rom interpolation of the 4x4 closest texels, it goes through the texel values. */
+  Bicubic,
+  /** Bilinear taps spread along the major axis of the pixel footprint, requires gradients. */
+  Anisotropic,
+};
+
+/** CPU counterpart of a shader SamplerState. */
+struct SamplerState {
+  FilterMode filter = FilterMode::Bilinear;
+  AddressMode address_u = AddressMode::Wrap;
+  AddressMode address_v = AddressMode::Wrap;
+  /** Maximum number of taps of the anisotropic filter. */
+  uint32_t max_anisotropy = 8;
+};
+
+/** Derivatives of the coordinates across the output, one value per sample, as passed to SampleGrad. */
+struct SampleGradients {
+  const float* dudx = nullptr;
+  const float* dvdx = nullptr;
+  const float* dudy = nullptr;
+  const float* dvdy = nullptr;
+};
+
+/**
+ * Samples a texture at normalized coordinates, matching Texture2D.Sample on the GPU: texel centers lie at
+ * (i + 0.5) / size and address modes apply to texel indices. Coordinates are processed four at a time, with
+ * address, weight and blend arithmetic in SIMD registers.
+ * @param[in] texture The texture to sample, with at most 4 channels.
+ * @param[in] state The filter and address modes.
+ * @param[in] u The horizontal coordinates.
+ * @param[in] v The vertical coordinates.
+ * @param[in] count The number of coordinates.
+ * @param[out] out count * texture.channels floats, interleaved like the texture.
+ * @param[in] gradients The coordinate derivatives, only read by the anisotropic filter, which falls back to
+ * bilinear without them.
+ */
+KN_TEXTURE_API void sample(const TextureView& texture,
+                           const SamplerState& state,
+                           const float* u,
+                           const float* v,
+                           size_t count,
+                           float* out,
+                           const SampleGradients* gradients = nullptr);
+}  // namespace kn
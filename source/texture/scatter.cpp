@@ -0,0 +1,381 @@
+/**************************************************************************/
+/* scatter.cpp                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "scatter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "math/simd.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+/** Side of the canvas tiles stamps are binned into, in pixels. */
+constexpr uint32_t TILE_SIZE = 64;
+
+/** Minimum number of stamps binned by one task. */
+constexpr size_t CHUNK_SIZE = 4096;
+
+/** Maximum number of binning tasks, each one holding a counter per tile. */
+constexpr size_t MAX_CHUNKS = 64;
+
+/** A stamp in pixel units of the canvas. */
+struct Placement {
+  float center_x;
+  float center_y;
+  /** Rotation, pre-divided by the size of the stamp along each of its axes. */
+  float cos_u;
+  float sin_u;
+  float cos_v;
+  float sin_v;
+  /** Bounds of the stamp, before wrapping. */
+  double min_x;
+  double max_x;
+  double min_y;
+  double max_y;
+  bool visible;
+
+  /** Coordinates of the pattern at a pixel of the canvas, for the copy of the stamp centered on (cx, cy). */
+  inline void locate(float cx, float cy, uint32_t x, uint32_t y, float& u, float& v) const {
+    const float dx = static_cast<float>(x) + 0.5f - cx;
+    const float dy = static_cast<float>(y) + 0.5f - cy;
+    u = dx * cos_u + dy * sin_u + 0.5f;
+    v = dy * cos_v - dx * sin_v + 0.5f;
+  }
+
+  [[nodiscard]] inline bool covers(float cx, float cy, uint32_t x, uint32_t y) const {
+    float u, v;
+    locate(cx, cy, x, y, u, v);
+    return u >= 0.0f && u < 1.0f && v >= 0.0f && v < 1.0f;
+  }
+};
+
+/** A stamp overlapping a tile; the shift selects which of its wrapped copies does. */
+struct BinEntry {
+  uint32_t stamp;
+  int32_t shift_x;
+  int32_t shift_y;
+};
+
+Placement place(const Stamp& stamp, uint32_t width, uint32_t height) {
+  Placement p{};
+  const double size_x = static_cast<double>(stamp.width) * width;
+  const double size_y = static_cast<double>(stamp.height) * height;
+  p.visible = size_x > 0.0 && size_y > 0.0 && stamp.opacity != 0.0f && std::isfinite(stamp.x) &&
+              std::isfinite(stamp.y) && std::isfinite(stamp.rotation) && std::isfinite(size_x * size_y);
+  if (!p.visible) {
+    return p;
+  }
+
+  const double c = std::cos(static_cast<double>(stamp.rotation));
+  const double s = std::sin(static_cast<double>(stamp.rotation));
+  const double cx = static_cast<double>(stamp.x) * width;
+  const double cy = static_cast<double>(stamp.y) * height;
+  p.center_x = static_cast<float>(cx);
+  p.center_y = static_cast<float>(cy);
+  p.cos_u = static_cast<float>(c / size_x);
+  p.sin_u = static_cast<float>(s / size_x);
+  p.cos_v = static_cast<float>(c / size_y);
+  p.sin_v = static_cast<float>(s / size_y);
+
+  const double extent_x = 0.5 * (std::abs(c) * size_x + std::abs(s) * size_y);
+  const double extent_y = 0.5 * (std::abs(s) * size_x + std::abs(c) * size_y);
+  p.min_x = cx - extent_x;
+  p.max_x = cx + extent_x;
+  p.min_y = cy - extent_y;
+  p.max_y = cy + extent_y;
+  return p;
+}
+
+/** Pixels of a canvas axis overlapped by the bounds of a stamp, once shifted by a whole number of canvas sizes. */
+bool overlap(double min, double max, int64_t shift, uint32_t size, uint32_t& first, uint32_t& last) {
+  const double lo = std::floor(min - static_cast<double>(shift));
+  const double hi = std::floor(max - static_cast<double>(shift));
+  if (hi < 0.0 || lo >= size) {
+    return false;
+  }
+  first = static_cast<uint32_t>(std::max(lo, 0.0));
+  last = static_cast<uint32_t>(std::min(hi, static_cast<double>(size - 1)));
+  return true;
+}
+
+/** Invokes func(tile, shift_x, shift_y) for every tile overlapped by every wrapped copy of a stamp. */
+template <typename Func>
+void for_each_tile(const Placement& p, uint32_t width, uint32_t height, uint32_t tiles_x, Func&& func) {
+  const auto copies_y0 = static_cast<int64_t>(std::floor(p.min_y / height));
+  const auto copies_y1 = static_cast<int64_t>(std::floor(p.max_y / height));
+  const auto copies_x0 = static_cast<int64_t>(std::floor(p.min_x / width));
+  const auto copies_x1 = static_cast<int64_t>(std::floor(p.max_x / width));
+
+  for (int64_t ky = copies_y0; ky <= copies_y1; ++ky) {
+    const int64_t shift_y = ky * height;
+    uint32_t y0, y1;
+    if (!overlap(p.min_y, p.max_y, shift_y, height, y0, y1)) {
+      continue;
+    }
+    for (int64_t kx = copies_x0; kx <= copies_x1; ++kx) {
+      const int64_t shift_x = kx * width;
+      uint32_t x0, x1;
+      if (!overlap(p.min_x, p.max_x, shift_x, width, x0, x1)) {
+        continue;
+      }
+      for (uint32_t ty = y0 / TILE_SIZE; ty <= y1 / TILE_SIZE; ++ty) {
+        for (uint32_t tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; ++tx) {
+          func(ty * tiles_x + tx, static_cast<int32_t>(shift_x), static_cast<int32_t>(shift_y));
+        }
+      }
+    }
+  }
+}
+
+/** Range of t where 0 <= a * t + b < 1, t being unbounded when a is 0 and b is in range. */
+void clip(double a, double b, double& lo, double& hi) {
+  if (a == 0.0) {
+    if (b < 0.0 || b >= 1.0) {
+      lo = std::numeric_limits<double>::infinity();
+    }
+    return;
+  }
+  const double t0 = -b / a;
+  const double t1 = (1.0 - b) / a;
+  lo = std::max(lo, std::min(t0, t1));
+  hi = std::min(hi, std::max(t0, t1));
+}
+
+/** Applies f to a stamp span: d = lerp(d, f(d, intensity * s), opacity). */
+template <ScatterBlend Blend>
+void blend_span(float* d, const float* s, size_t count, float intensity, float opacity) {
+  using namespace simd;
+  const auto combine = [](auto dst, auto src) {
+    if constexpr (Blend == ScatterBlend::Normal) {
+      return src;
+    } else if constexpr (Blend == ScatterBlend::Add) {
+      return dst + src;
+    } else if constexpr (Blend == ScatterBlend::Multiply) {
+      return dst * src;
+    } else if constexpr (Blend == ScatterBlend::Max) {
+      return max(dst, src);
+    } else {
+      return min(dst, src);
+    }
+  };
+
+  size_t i = 0;
+  const vfloat4 scale = broadcast(intensity);
+  const vfloat4 fade = broadcast(opacity);
+  for (; i + WIDTH <= count; i += WIDTH) {
+    const vfloat4 dst = load(d + i);
+    store(d + i, lerp(dst, combine(dst, load(s + i) * scale), fade));
+  }
+  for (; i < count; ++i) {
+    const vfloat4 dst = broadcast(d[i]);
+    float out[WIDTH];
+    store(out, lerp(dst, combine(dst, broadcast(s[i]) * scale), fade));
+    d[i] = out[0];
+  }
+}
+
+void blend_span(ScatterBlend blend, float* d, const float* s, size_t count, float intensity, float opacity) {
+  switch (blend) {
+    case ScatterBlend::Normal:
+      blend_span<ScatterBlend::Normal>(d, s, count, intensity, opacity);
+      break;
+    case ScatterBlend::Add:
+      blend_span<ScatterBlend::Add>(d, s, count, intensity, opacity);
+      break;
+    case ScatterBlend::Multiply:
+      blend_span<ScatterBlend::Multiply>(d, s, count, intensity, opacity);
+      break;
+    case ScatterBlend::Max:
+      blend_span<ScatterBlend::Max>(d, s, count, intensity, opacity);
+      break;
+    case ScatterBlend::Min:
+      blend_span<ScatterBlend::Min>(d, s, count, intensity, opacity);
+      break;
+  }
+}
+
+/** Per-thread coordinates and samples of one span. */
+struct SpanBuffers {
+  float u[TILE_SIZE];
+  float v[TILE_SIZE];
+  float samples[TILE_SIZE * 4];
+};
+
+/** Composites one wrapped copy of a stamp over the pixels of a tile. */
+void stamp_tile(const Placement& p,
+                const Stamp& stamp,
+                const BinEntry& entry,
+                const TextureView& pattern,
+                const SamplerState& state,
+                ScatterBlend blend,
+                const TextureView& dst,
+                uint32_t tile_x0,
+                uint32_t tile_y0,
+                SpanBuffers& buffers) {
+  const uint32_t tile_x1 = std::min(tile_x0 + TILE_SIZE, dst.width);
+  const uint32_t tile_y1 = std::min(tile_y0 + TILE_SIZE, dst.height);
+  const float cx = p.center_x - static_cast<float>(entry.shift_x);
+  const float cy = p.center_y - static_cast<float>(entry.shift_y);
+
+  uint32_t y0, y1;
+  if (!overlap(p.min_y, p.max_y, entry.shift_y, dst.height, y0, y1)) {
+    return;
+  }
+  y0 = std::max(y0, tile_y0);
+  y1 = std::min(y1 + 1, tile_y1);
+
+  for (uint32_t y = y0; y < y1; ++y) {
+    // Solve for the covered run of the row, then settle its ends with the exact per-pixel test.
+    const double dy = static_cast<double>(y) + 0.5 - cy;
+    double lo = -std::numeric_limits<double>::infinity();
+    double hi = std::numeric_limits<double>::infinity();
+    clip(p.cos_u, dy * p.sin_u + 0.5, lo, hi);
+    clip(-static_cast<double>(p.sin_v), dy * p.cos_v + 0.5, lo, hi);
+    if (!(lo <= hi)) {
+      continue;
+    }
+    const double first = std::max(std::ceil(lo + cx - 0.5), static_cast<double>(tile_x0));
+    const double last = std::min(std::floor(hi + cx - 0.5), static_cast<double>(tile_x1) - 1.0);
+    if (first > last + 1.0) {
+      continue;
+    }
+
+    auto x0 = static_cast<uint32_t>(first);
+    auto x1 = static_cast<uint32_t>(last + 1.0);
+    while (x0 < x1 && !p.covers(cx, cy, x0, y)) {
+      ++x0;
+    }
+    while (x1 > x0 && !p.covers(cx, cy, x1 - 1, y)) {
+      --x1;
+    }
+    if (x0 == x1) {
+      continue;
+    }
+    while (x0 > tile_x0 && p.covers(cx, cy, x0 - 1, y)) {
+      --x0;
+    }
+    while (x1 < tile_x1 && p.covers(cx, cy, x1, y)) {
+      ++x1;
+    }
+
+    const uint32_t count = x1 - x0;
+    for (uint32_t i = 0; i < count; ++i) {
+      p.locate(cx, cy, x0 + i, y, buffers.u[i], buffers.v[i]);
+    }
+    sample(pattern, state, buffers.u, buffers.v, count, buffers.samples);
+    blend_span(blend, &dst.at(x0, y), buffers.samples, static_cast<size_t>(count) * dst.channels, stamp.intensity,
+               stamp.opacity);
+  }
+}
+}  // namespace
+
+void scatter(const std::vector<TextureView>& patterns,
+             const std::vector<Stamp>& stamps,
+             const TextureView& dst,
+             const ScatterOptions& options /*= {}*/) {
+  if (!ensure(dst.is_valid() && dst.channels <= 4)) {
+    return;
+  }
+  for (const TextureView& pattern : patterns) {
+    if (!ensure(pattern.is_valid() && pattern.channels == dst.channels)) {
+      return;
+    }
+  }
+  for (const Stamp& stamp : stamps) {
+    if (!ensure(stamp.pattern < patterns.size())) {
+      return;
+    }
+  }
+  if (stamps.empty()) {
+    return;
+  }
+
+  const uint32_t tiles_x = (dst.width + TILE_SIZE - 1) / TILE_SIZE;
+  const uint32_t tiles_y = (dst.height + TILE_SIZE - 1) / TILE_SIZE;
+  const size_t tile_count = static_cast<size_t>(tiles_x) * tiles_y;
+  const size_t chunk_size = std::max(CHUNK_SIZE, (stamps.size() + MAX_CHUNKS - 1) / MAX_CHUNKS);
+  const size_t chunk_count = (stamps.size() + chunk_size - 1) / chunk_size;
+
+  // Binning is a counting sort of (stamp, tile) pairs: chunks count their pairs per tile, the counts become the
+  // offset of every chunk within every bin, then chunks fill their slots. Bins end up in stamp order.
+  std::vector<Placement> placements(stamps.size());
+  std::vector<size_t> cursors(chunk_count * tile_count, 0);
+  parallel_for(0, chunk_count, [&](size_t chunk) {
+    size_t* counts = cursors.data() + chunk * tile_count;
+    const size_t end = std::min(stamps.size(), (chunk + 1) * chunk_size);
+    for (size_t i = chunk * chunk_size; i < end; ++i) {
+      placements[i] = place(stamps[i], dst.width, dst.height);
+      if (placements[i].visible) {
+        for_each_tile(placements[i], dst.width, dst.height, tiles_x,
+                      [&](size_t tile, int32_t, int32_t) { ++counts[tile]; });
+      }
+    }
+  });
+
+  std::vector<size_t> bins(tile_count + 1);
+  size_t total = 0;
+  for (size_t tile = 0; tile < tile_count; ++tile) {
+    bins[tile] = total;
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+      const size_t count = cursors[chunk * tile_count + tile];
+      cursors[chunk * tile_count + tile] = total;
+      total += count;
+    }
+  }
+  bins[tile_count] = total;
+
+  std::vector<BinEntry> entries(total);
+  parallel_for(0, chunk_count, [&](size_t chunk) {
+    size_t* slots = cursors.data() + chunk * tile_count;
+    const size_t end = std::min(stamps.size(), (chunk + 1) * chunk_size);
+    for (size_t i = chunk * chunk_size; i < end; ++i) {
+      if (placements[i].visible) {
+        for_each_tile(placements[i], dst.width, dst.height, tiles_x,
+                      [&](size_t tile, int32_t shift_x, int32_t shift_y) {
+                        entries[slots[tile]++] = {static_cast<uint32_t>(i), shift_x, shift_y};
+                      });
+      }
+    }
+  });
+
+  const SamplerState state{options.filter, AddressMode::Clamp, AddressMode::Clamp};
+  parallel_for(0, tile_count, [&](size_t tile) {
+    thread_local SpanBuffers buffers;
+    const uint32_t tile_x0 = static_cast<uint32_t>(tile % tiles_x) * TILE_SIZE;
+    const uint32_t tile_y0 = static_cast<uint32_t>(tile / tiles_x) * TILE_SIZE;
+    for (size_t e = bins[tile]; e < bins[tile + 1]; ++e) {
+      const BinEntry& entry = entries[e];
+      const Stamp& stamp = stamps[entry.stamp];
+      stamp_tile(placements[entry.stamp], stamp, entry, patterns[stamp.pattern], state, options.blend, dst, tile_x0,
+                 tile_y0, buffers);
+    }
+  });
+}
+}  // namespace kn
@@ -0,0 +1,91 @@
+/**************************************************************************/
+/* scatter.hpp                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "sampler.hpp"
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/** How a stamp s is composited over the canvas d, the result being faded by the stamp opacity: lerp(d, f(d, s), o). */
+enum class ScatterBlend : uint8_t {
+  /** f = s. */
+  Normal,
+  /** f = d + s. */
+  Add,
+  /** f = d * s. */
+  Multiply,
+  /** f = max(d, s). */
+  Max,
+  /** f = min(d, s). */
+  Min,
+};
+
+/** A pattern placed on the canvas as a rotated rectangle. */
+struct Stamp {
+  /** Center, in UV units of the canvas. */
+  float x = 0.5f;
+  float y = 0.5f;
+  /** Size along the axes of the stamp, in UV units of the canvas along x and y. */
+  float width = 0.1f;
+  float height = 0.1f;
+  /** Rotation from the x axis of the canvas toward its y axis, in radians. */
+  float rotation = 0.0f;
+  /** Factor applied to the pattern values. */
+  float intensity = 1.0f;
+  float opacity = 1.0f;
+  /** Index of the pattern in the list passed to scatter. */
+  uint32_t pattern = 0;
+};
+
+struct ScatterOptions {
+  ScatterBlend blend = ScatterBlend::Normal;
+  /** Filter used to read the patterns, which are clamped at their borders. */
+  FilterMode filter = FilterMode::Bilinear;
+};
+
+/**
+ * Composites stamps over a canvas, in their order, as tile sampler nodes do. Stamps are first binned by the 64x64
+ * tiles of the canvas their bounds overlap, then tiles are composited in parallel, each one only visiting its own
+ * stamps, so the cost follows the covered area rather than pixels times stamps. A stamp crossing a border wraps
+ * around to keep the canvas tileable, and the order of the stamps within every tile is kept, so the result does
+ * not depend on the number of threads.
+ * @param[in] patterns The textures stamped, with the channel count of dst, at most 4.
+ * @param[in] stamps The placements of the patterns.
+ * @param[in,out] dst The canvas, holding the background on input.
+ * @param[in] options The blend mode and pattern filter.
+ */
+KN_TEXTURE_API void scatter(const std::vector<TextureView>& patterns,
+                            const std::vector<Stamp>& stamps,
+                            const TextureView& dst,
+                            const ScatterOptions& options = {});
+}  // namespace kn
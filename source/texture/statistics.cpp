@@ -0,0 +1,457 @@
+/**************************************************************************/
+/* statistics.cpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "statistics.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include "math/simd.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+/** Maximum number of row bands reduced independently. */
+constexpr size_t MAX_BANDS = 64;
+
+/** Memory budget of the per-band histograms, in bytes. */
+constexpr size_t HISTOGRAM_BUDGET = size_t{32} << 20;
+
+/** Floats summed in single precision before flushing to the double precision totals. */
+constexpr size_t FLUSH_INTERVAL = 1024;
+
+/** Moments of a set of values, merged with Chan's parallel formula. */
+struct Moments {
+  uint64_t count = 0;
+  double mean = 0.0;
+  /** Sum of the squared deviations from the mean. */
+  double m2 = 0.0;
+  float min = std::numeric_limits<float>::infinity();
+  float max = -std::numeric_limits<float>::infinity();
+
+  void merge(const Moments& other) {
+    if (other.count == 0) {
+      return;
+    }
+    const auto n = static_cast<double>(count);
+    const auto m = static_cast<double>(other.count);
+    const double delta = other.mean - mean;
+    count += other.count;
+    mean += delta * m / (n + m);
+    m2 += other.m2 + delta * delta * n * m / (n + m);
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+};
+
+/** Statistics of a band of rows. */
+struct Partial {
+  std::vector<Moments> moments;
+  /** bins counters per channel. */
+  std::vector<uint64_t> histogram;
+
+  void merge(const Partial& other) {
+    for (size_t c = 0; c < moments.size(); ++c) {
+      moments[c].merge(other.moments[c]);
+    }
+    for (size_t i = 0; i < histogram.size(); ++i) {
+      histogram[i] += other.histogram[i];
+    }
+  }
+};
+
+/**
+ * Channel of every lane. Interleaved values cycle through the channels with a period of lcm(channels, 4) floats,
+ * so consecutive vectors go through at most 3 phases.
+ */
+struct LaneLayout {
+  uint32_t phases;
+  uint32_t channel[3][simd::WIDTH];
+
+  explicit LaneLayout(uint32_t channels) : phases(channels == 3 ? 3 : 1) {
+    for (uint32_t p = 0; p < 3; ++p) {
+      for (uint32_t i = 0; i < simd::WIDTH; ++i) {
+        channel[p][i] = (p * simd::WIDTH + i) % channels;
+      }
+    }
+  }
+};
+
+/** Reduces one row into a band: moments from two passes over the row, which stays in cache, and the histogram. */
+class RowReducer {
+ public:
+  RowReducer(uint32_t width, uint32_t channels, const StatisticsOptions& options)
+      : _width(width), _channels(channels), _layout(channels), _bins(options.bins), _range_min(options.range_min) {
+    const float range = options.range_max - options.range_min;
+    _scale = range > 0.0f ? static_cast<float>(_bins) / range : 0.0f;
+    for (uint32_t p = 0; p < _layout.phases; ++p) {
+      int32_t offsets[simd::WIDTH];
+      for (uint32_t i = 0; i < simd::WIDTH; ++i) {
+        offsets[i] = static_cast<int32_t>(_layout.channel[p][i] * _bins);
+      }
+      _bin_offsets[p] = simd::load(offsets);
+    }
+  }
+
+  void reduce(const float* row, Partial& partial) const {
+    using namespace simd;
+    const size_t count = static_cast<size_t>(_width) * _channels;
+    const uint32_t phases = _layout.phases;
+
+    vfloat4 lo[3];
+    vfloat4 hi[3];
+    vfloat4 sums[3];
+    double totals[3][WIDTH] = {};
+    for (uint32_t p = 0; p < phases; ++p) {
+      lo[p] = broadcast(std::numeric_limits<float>::infinity());
+      hi[p] = broadcast(-std::numeric_limits<float>::infinity());
+      sums[p] = broadcast(0.0f);
+    }
+
+    const vfloat4 range_min = broadcast(_range_min);
+    const vfloat4 scale = broadcast(_scale);
+    const vfloat4 last_bin = broadcast(static_cast<float>(_bins > 0 ? _bins - 1 : 0));
+    uint64_t* histogram = partial.histogram.data();
+
+    size_t i = 0;
+    uint32_t p = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      const vfloat4 value = load(row + i);
+      lo[p] = min(lo[p], value);
+      hi[p] = max(hi[p], value);
+      sums[p] = sums[p] + value;
+      if (_bins > 0) {
+        const vfloat4 bin = min(max((value - range_min) * scale, broadcast(0.0f)), last_bin);
+        int32_t indices[WIDTH];
+        store(indices, to_int(bin) + _bin_offsets[p]);
+        for (uint32_t l = 0; l < WIDTH; ++l) {
+          ++histogram[indices[l]];
+        }
+      }
+      if ((i / WIDTH + 1) % (FLUSH_INTERVAL / WIDTH) == 0) {
+        flush(sums, totals);
+      }
+      p = p + 1 == phases ? 0 : p + 1;
+    }
+    flush(sums, totals);
+
+    Moments row_moments[4];
+    double row_sums[4] = {};
+    for (uint32_t q = 0; q < phases; ++q) {
+      float lanes_lo[WIDTH];
+      float lanes_hi[WIDTH];
+      store(lanes_lo, lo[q]);
+      store(lanes_hi, hi[q]);
+      for (uint32_t l = 0; l < WIDTH; ++l) {
+        Moments& m = row_moments[_layout.channel[q][l]];
+        m.min = std::min(m.min, lanes_lo[l]);
+        m.max = std::max(m.max, lanes_hi[l]);
+        row_sums[_layout.channel[q][l]] += totals[q][l];
+      }
+    }
+    for (size_t t = i; t < count; ++t) {
+      const float value = row[t];
+      Moments& m = row_moments[t % _channels];
+      m.min = std::min(m.min, value);
+      m.max = std::max(m.max, value);
+      row_sums[t % _channels] += value;
+      if (_bins > 0) {
+        const float bin = std::min(std::max(0.0f, (value - _range_min) * _scale), static_cast<float>(_bins - 1));
+        ++histogram[(t % _channels) * _bins + static_cast<uint32_t>(bin)];
+      }
+    }
+
+    // Second pass, from cache: squared deviations from the row means.
+    float means[4];
+    for (uint32_t c = 0; c < _channels; ++c) {
+      row_moments[c].count = _width;
+      row_moments[c].mean = row_sums[c] / _width;
+      means[c] = static_cast<float>(row_moments[c].mean);
+    }
+    vfloat4 centers[3];
+    double deviations[3][WIDTH] = {};
+    for (uint32_t q = 0; q < phases; ++q) {
+      float lanes[WIDTH];
+      for (uint32_t l = 0; l < WIDTH; ++l) {
+        lanes[l] = means[_layout.channel[q][l]];
+      }
+      centers[q] = load(lanes);
+      sums[q] = broadcast(0.0f);
+    }
+    i = 0;
+    p = 0;
+    for (; i + WIDTH <= count; i += WIDTH) {
+      const vfloat4 deviation = load(row + i) - centers[p];
+      sums[p] = madd(deviation, deviation, sums[p]);
+      if ((i / WIDTH + 1) % (FLUSH_INTERVAL / WIDTH) == 0) {
+        flush(sums, deviations);
+      }
+      p = p + 1 == phases ? 0 : p + 1;
+    }
+    flush(sums, deviations);
+
+    for (uint32_t q = 0; q < phases; ++q) {
+      for (uint32_t l = 0; l < WIDTH; ++l) {
+        row_moments[_layout.channel[q][l]].m2 += deviations[q][l];
+      }
+    }
+    for (; i < count; ++i) {
+      const double deviation = static_cast<double>(row[i]) - means[i % _channels];
+      row_moments[i % _channels].m2 += deviation * deviation;
+    }
+
+    // The deviations were measured from the rounded means.
+    for (uint32_t c = 0; c < _channels; ++c) {
+      const double offset = row_moments[c].mean - means[c];
+      row_moments[c].m2 -= offset * offset * _width;
+      partial.moments[c].merge(row_moments[c]);
+    }
+  }
+
+ private:
+  void flush(simd::vfloat4* sums, double (*totals)[simd::WIDTH]) const {
+    for (uint32_t p = 0; p < _layout.phases; ++p) {
+      float lanes[simd::WIDTH];
+      simd::store(lanes, sums[p]);
+      for (uint32_t l = 0; l < simd::WIDTH; ++l) {
+        totals[p][l] += lanes[l];
+      }
+      sums[p] = simd::broadcast(0.0f);
+    }
+  }
+
+  uint32_t _width;
+  uint32_t _channels;
+  LaneLayout _layout;
+  uint32_t _bins;
+  float _range_min;
+  float _scale;
+  simd::vint4 _bin_offsets[3];
+};
+
+/** Mixes one 64-bit word into a hash lane, as the rounds of xxHash64. */
+inline uint64_t mix(uint64_t lane, uint64_t word) {
+  lane += word * 0xC2B2AE3D27D4EB4Full;
+  lane = std::rotl(lane, 31);
+  return lane * 0x9E3779B185EBCA87ull;
+}
+
+uint64_t hash_row(const float* row, size_t count) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(row);
+  const size_t size = count * sizeof(float);
+  // Four independent lanes keep the multiplies of consecutive words in flight together.
+  uint64_t lanes[4] = {1, 2, 3, 4};
+  size_t offset = 0;
+  for (; offset + 32 <= size; offset += 32) {
+    for (uint32_t l = 0; l < 4; ++l) {
+      uint64_t word;
+      std::memcpy(&word, bytes + offset + l * 8, 8);
+      lanes[l] = mix(lanes[l], word);
+    }
+  }
+  uint64_t hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+  for (; offset < size; offset += 4) {
+    uint32_t word;
+    std::memcpy(&word, bytes + offset, 4);
+    hash = mix(hash, word);
+  }
+  return hash;
+}
+}  // namespace
+
+float TextureStatistics::percentile(uint32_t channel, float fraction) const {
+  if (!ensure(channel < channels.size() && !channels[channel].histogram.empty())) {
+    return 0.0f;
+  }
+  const std::vector<uint64_t>& histogram = channels[channel].histogram;
+  const double target = std::clamp(static_cast<double>(fraction), 0.0, 1.0) * static_cast<double>(pixel_count);
+  const double bin_width = (static_cast<double>(options.range_max) - options.range_min) / histogram.size();
+
+  double below = 0.0;
+  for (size_t b = 0; b < histogram.size(); ++b) {
+    const auto count = static_cast<double>(histogram[b]);
+    if (count > 0.0 && below + count >= target) {
+      const double value = options.range_min + (static_cast<double>(b) + (target - below) / count) * bin_width;
+      return std::clamp(static_cast<float>(value), channels[channel].min, channels[channel].max);
+    }
+    below += count;
+  }
+  return channels[channel].max;
+}
+
+TextureStatistics compute_statistics(const TextureView& texture, const StatisticsOptions& options /*= {}*/) {
+  TextureStatistics result;
+  result.options = options;
+  if (!ensure(texture.is_valid() && texture.channels <= 4)) {
+    return result;
+  }
+  const uint32_t channels = texture.channels;
+  const size_t histogram_size = static_cast<size_t>(options.bins) * channels;
+
+  // Bands only depend on the texture, which keeps the summation order, and so the result, fixed.
+  size_t bands = std::min<size_t>(MAX_BANDS, texture.height);
+  if (histogram_size > 0) {
+    bands = std::clamp<size_t>(HISTOGRAM_BUDGET / (histogram_size * sizeof(uint64_t)), 1, bands);
+  }
+  const size_t rows_per_band = (texture.height + bands - 1) / bands;
+  bands = (texture.height + rows_per_band - 1) / rows_per_band;
+
+  std::vector<Partial> partials(bands);
+  const RowReducer reducer(texture.width, channels, options);
+  parallel_for(0, bands, [&](size_t band) {
+    Partial& partial = partials[band];
+    partial.moments.resize(channels);
+    partial.histogram.assign(histogram_size, 0);
+    const size_t end = std::min<size_t>(texture.height, (band + 1) * rows_per_band);
+    for (size_t y = band * rows_per_band; y < end; ++y) {
+      reducer.reduce(texture.row(static_cast<uint32_t>(y)), partial);
+    }
+  });
+
+  for (size_t stride = 1; stride < bands; stride *= 2) {
+    parallel_for(0, (bands + 2 * stride - 1) / (2 * stride), [&](size_t pair) {
+      const size_t target = pair * 2 * stride;
+      if (target + stride < bands) {
+        partials[target].merge(partials[target + stride]);
+      }
+    });
+  }
+
+  const Partial& total = partials.front();
+  result.pixel_count = texture.get_pixel_count();
+  result.channels.resize(channels);
+  for (uint32_t c = 0; c < channels; ++c) {
+    ChannelStatistics& statistics = result.channels[c];
+    statistics.min = total.moments[c].min;
+    statistics.max = total.moments[c].max;
+    statistics.mean = total.moments[c].mean;
+    statistics.variance = total.moments[c].m2 / static_cast<double>(total.moments[c].count);
+    if (options.bins > 0) {
+      statistics.histogram.assign(total.histogram.begin() + static_cast<ptrdiff_t>(c) * options.bins,
+                                  total.histogram.begin() + static_cast<ptrdiff_t>(c + 1) * options.bins);
+    }
+  }
+  return result;
+}
+
+TextureStatistics compute_statistics(const Texture& texture, const StatisticsOptions& options /*= {}*/) {
+  if (!texture.is_uniform()) {
+    return compute_statistics(texture.view(), options);
+  }
+  // Statistics of the single pixel, counted as many times as the texture has pixels.
+  Texture pixel(1, 1, texture.get_channels());
+  std::copy_n(texture.get_data(), texture.get_channels(), pixel.get_data());
+  TextureStatistics result = compute_statistics(pixel.view(), options);
+  result.pixel_count = static_cast<uint64_t>(texture.get_width()) * texture.get_height();
+  for (ChannelStatistics& channel : result.channels) {
+    for (uint64_t& count : channel.histogram) {
+      count *= result.pixel_count;
+    }
+  }
+  return result;
+}
+
+uint64_t hash_texture(const TextureView& texture) {
+  if (!texture.is_valid()) {
+    return 0;
+  }
+  std::vector<uint64_t> rows(texture.height);
+  const size_t count = static_cast<size_t>(texture.width) * texture.channels;
+  parallel_for(
+      0, texture.height, [&](size_t y) { rows[y] = hash_row(texture.row(static_cast<uint32_t>(y)), count); }, 16);
+
+  uint64_t hash = mix(mix(mix(0, texture.width), texture.height), texture.channels);
+  for (const uint64_t row : rows) {
+    hash = mix(hash, row);
+  }
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDull;
+  return hash ^ (hash >> 33);
+}
+
+StatisticsCache* StatisticsCache::get_instance() {
+  static StatisticsCache instance;
+  return &instance;
+}
+
+std::shared_ptr<const TextureStatistics> StatisticsCache::get(const TextureView& texture,
+                                                              const StatisticsOptions& options /*= {}*/) {
+  return get(hash_texture(texture), texture, options);
+}
+
+std::shared_ptr<const TextureStatistics> StatisticsCache::get(uint64_t content_key,
+                                                              const TextureView& texture,
+                                                              const StatisticsOptions& options /*= {}*/) {
+  const auto matches = [&](const Entry& entry) {
+    return entry.key == content_key && entry.width == texture.width && entry.height == texture.height &&
+           entry.channels == texture.channels && entry.options.bins == options.bins &&
+           entry.options.range_min == options.range_min && entry.options.range_max == options.range_max;
+  };
+
+  {
+    std::lock_guard lock(_mutex);
+    const auto it = std::find_if(_entries.begin(), _entries.end(), matches);
+    if (it != _entries.end()) {
+      // Moves the entry to the most recently used end.
+      std::rotate(it, it + 1, _entries.end());
+      return _entries.back().statistics;
+    }
+  }
+
+  // Computed outside of the lock, so that lookups of other textures are not blocked meanwhile.
+  auto statistics = std::make_shared<const TextureStatistics>(compute_statistics(texture, options));
+
+  std::lock_guard lock(_mutex);
+  if (std::find_if(_entries.begin(), _entries.end(), matches) == _entries.end()) {
+    _entries.push_back({content_key, texture.width, texture.height, texture.channels, options, statistics});
+    if (_entries.size() > _capacity) {
+      _entries.erase(_entries.begin(), _entries.begin() + static_cast<ptrdiff_t>(_entries.size() - _capacity));
+    }
+  }
+  return statistics;
+}
+
+void StatisticsCache::clear() {
+  std::lock_guard lock(_mutex);
+  _entries.clear();
+}
+
+void StatisticsCache::set_capacity(size_t entries) {
+  std::lock_guard lock(_mutex);
+  _capacity = entries;
+  if (_entries.size() > _capacity) {
+    _entries.erase(_entries.begin(), _entries.begin() + static_cast<ptrdiff_t>(_entries.size() - _capacity));
+  }
+}
+
+size_t StatisticsCache::get_size() const {
+  std::lock_guard lock(_mutex);
+  return _entries.size();
+}
+}  // namespace kn
@@ -0,0 +1,134 @@
+/**************************************************************************/
+/* statistics.hpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+struct StatisticsOptions {
+  /** Histogram bins per channel, 0 to skip the histogram. */
+  uint32_t bins = 256;
+  /** Range covered by the histogram; values outside of it are counted in the first or last bin. */
+  float range_min = 0.0f;
+  float range_max = 1.0f;
+};
+
+struct ChannelStatistics {
+  float min = 0.0f;
+  float max = 0.0f;
+  double mean = 0.0;
+  /** Population variance. */
+  double variance = 0.0;
+  /** Pixel count per bin, empty when no bin was requested. */
+  std::vector<uint64_t> histogram;
+};
+
+struct KN_TEXTURE_API TextureStatistics {
+  uint64_t pixel_count = 0;
+  StatisticsOptions options;
+  std::vector<ChannelStatistics> channels;
+
+  /**
+   * Returns the value below which the given fraction of the pixels of a channel lie, interpolated within the
+   * histogram bin holding it; auto-levels read their black and white points from it.
+   */
+  [[nodiscard]] float percentile(uint32_t channel, float fraction) const;
+};
+
+/**
+ * Computes the minimum, maximum, mean, variance and histogram of every channel in a single read of the texture.
+ * Fixed bands of rows are reduced in parallel, each one into its own statistics, which are then merged pairwise
+ * in a tree, so the result does not depend on the number of threads. Moments are merged with Chan's formula and
+ * kept in double precision.
+ */
+KN_TEXTURE_API TextureStatistics compute_statistics(const TextureView& texture, const StatisticsOptions& options = {});
+
+/** Computes the statistics of a texture; those of a uniform texture come from its single pixel. */
+KN_TEXTURE_API TextureStatistics compute_statistics(const Texture& texture, const StatisticsOptions& options = {});
+
+/** Hashes the layout and pixel values of a texture, reading rows in parallel. */
+KN_TEXTURE_API uint64_t hash_texture(const TextureView& texture);
+
+/**
+ * Keeps the statistics of recently seen textures, keyed by their content, so that editing a parameter unrelated
+ * to the input of a statistics node does not reduce the texture again. Thread-safe.
+ */
+class KN_TEXTURE_API StatisticsCache {
+ public:
+  StatisticsCache(const StatisticsCache&) = delete;
+  StatisticsCache& operator=(const StatisticsCache&) = delete;
+
+  StatisticsCache() = default;
+  ~StatisticsCache() = default;
+
+  static StatisticsCache* get_instance();
+
+  /** Returns the statistics of a texture, hashing its pixels to look them up. */
+  [[nodiscard]] std::shared_ptr<const TextureStatistics> get(const TextureView& texture,
+                                                             const StatisticsOptions& options = {});
+
+  /**
+   * Returns the statistics of a texture identified by a key, which must change whenever its content does, such as
+   * the hash of the inputs and parameters that produced it; the pixels are only read on a miss.
+   */
+  [[nodiscard]] std::shared_ptr<const TextureStatistics> get(uint64_t content_key,
+                                                             const TextureView& texture,
+                                                             const StatisticsOptions& options = {});
+
+  /** Drops every entry. */
+  void clear();
+
+  /** Sets the maximum number of entries, dropping the least recently used ones beyond it. */
+  void set_capacity(size_t entries);
+
+  [[nodiscard]] size_t get_size() const;
+
+ private:
+  struct Entry {
+    uint64_t key;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    StatisticsOptions options;
+    std::shared_ptr<const TextureStatistics> statistics;
+  };
+
+  mutable std::mutex _mutex;
+  /** Entries, least recently used first. */
+  std::vector<Entry> _entries;
+  size_t _capacity = 64;
+};
+}  // namespace kn
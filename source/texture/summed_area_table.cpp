@@ -0,0 +1,178 @@
+/**************************************************************************/
+/* summed_area_table.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "summed_area_table.hpp"
+#include <algorithm>
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+/** Columns accumulated together by a worker in the vertical pass. */
+constexpr uint32_t COLUMN_BLOCK = 256;
+
+struct BoxSpans {
+  std::vector<SummedAreaTable::Coord> x0;
+  std::vector<SummedAreaTable::Coord> x1;
+};
+
+BoxSpans make_spans(uint32_t size, uint32_t radius) {
+  BoxSpans spans;
+  spans.x0.resize(size);
+  spans.x1.resize(size);
+  for (uint32_t x = 0; x < size; ++x) {
+    spans.x0[x] = SummedAreaTable::split(static_cast<int64_t>(x) - radius, size);
+    spans.x1[x] = SummedAreaTable::split(static_cast<int64_t>(x) + radius + 1, size);
+  }
+  return spans;
+}
+
+/** Calls func(x, y, c, sum, squares) with the box sums of every pixel and channel. */
+template <typename Func>
+void for_each_box(const SummedAreaTable& sat, uint32_t radius_x, uint32_t radius_y, bool squares, Func&& func) {
+  const BoxSpans columns = make_spans(sat.get_width(), radius_x);
+  const BoxSpans rows = make_spans(sat.get_height(), radius_y);
+
+  parallel_for(0, sat.get_height(), [&](size_t y) {
+    const auto y0 = rows.x0[y];
+    const auto y1 = rows.x1[y];
+    for (uint32_t x = 0; x < sat.get_width(); ++x) {
+      const auto x0 = columns.x0[x];
+      const auto x1 = columns.x1[x];
+      for (uint32_t c = 0; c < sat.get_channels(); ++c) {
+        const auto box = [&](const std::vector<double>& table) {
+          return sat.prefix(table, x1, y1, c) - sat.prefix(table, x0, y1, c) - sat.prefix(table, x1, y0, c) +
+                 sat.prefix(table, x0, y0, c);
+        };
+        func(x, static_cast<uint32_t>(y), c, box(sat.get_sums()), squares ? box(sat.get_squares()) : 0.0);
+      }
+    }
+  });
+}
+}  // namespace
+
+SummedAreaTable::SummedAreaTable(const TextureView& src, bool with_squares)
+    : _width(src.width), _height(src.height), _channels(src.channels) {
+  ensure(src.is_valid());
+
+  build(src, _sums, false);
+  if (with_squares) {
+    build(src, _squares, true);
+  }
+}
+
+SummedAreaTable::Coord SummedAreaTable::split(int64_t coord, uint32_t size) {
+  const int64_t periods = coord >= 0 ? coord / size : -((-coord + size - 1) / size);
+  return {periods, static_cast<uint32_t>(coord - periods * size)};
+}
+
+double SummedAreaTable::box(const std::vector<double>& table,
+                            int64_t x0,
+                            int64_t y0,
+                            int64_t x1,
+                            int64_t y1,
+                            uint32_t c) const {
+  const Coord sx0 = split(x0, _width);
+  const Coord sy0 = split(y0, _height);
+  const Coord sx1 = split(x1, _width);
+  const Coord sy1 = split(y1, _height);
+  return prefix(table, sx1, sy1, c) - prefix(table, sx0, sy1, c) - prefix(table, sx1, sy0, c) +
+         prefix(table, sx0, sy0, c);
+}
+
+void SummedAreaTable::build(const TextureView& src, std::vector<double>& table, bool squared) {
+  const size_t row_size = static_cast<size_t>(_width + 1) * _channels;
+  table.assign(row_size * (_height + 1), 0.0);
+
+  // Horizontal prefix sums, one row per task.
+  parallel_for(0, _height, [&](size_t y) {
+    const float* src_row = src.row(static_cast<uint32_t>(y));
+    double* row = table.data() + (y + 1) * row_size;
+    for (uint32_t x = 0; x < _width; ++x) {
+      for (uint32_t c = 0; c < _channels; ++c) {
+        const double value = src_row[static_cast<size_t>(x) * _channels + c];
+        row[(x + 1) * _channels + c] = row[x * _channels + c] + (squared ? value * value : value);
+      }
+    }
+  });
+
+  // Vertical accumulation over blocks of columns: the inner loop runs over contiguous doubles and vectorizes.
+  const size_t block_count = (row_size + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+  parallel_for(0, block_count, [&](size_t block) {
+    const size_t first = block * COLUMN_BLOCK;
+    const size_t last = std::min(first + COLUMN_BLOCK, row_size);
+    for (uint32_t y = 2; y <= _height; ++y) {
+      const double* previous = table.data() + (y - 1) * row_size;
+      double* row = table.data() + y * row_size;
+      for (size_t i = first; i < last; ++i) {
+        row[i] += previous[i];
+      }
+    }
+  });
+}
+
+void box_filter(const SummedAreaTable& sat, const TextureView& dst, uint32_t radius_x, uint32_t radius_y) {
+  if (!ensure(dst.width == sat.get_width() && dst.height == sat.get_height() && dst.channels == sat.get_channels())) {
+    return;
+  }
+
+  const double scale = 1.0 / (static_cast<double>(2 * radius_x + 1) * (2 * radius_y + 1));
+  for_each_box(sat, radius_x, radius_y, false, [&](uint32_t x, uint32_t y, uint32_t c, double sum, double) {
+    dst.at(x, y, c) = static_cast<float>(sum * scale);
+  });
+}
+
+void local_statistics(const SummedAreaTable& sat,
+                      const TextureView& mean,
+                      const TextureView& variance,
+                      uint32_t radius) {
+  if (!ensure(sat.has_squares())) {
+    return;
+  }
+
+  for (const TextureView* view : {&mean, &variance}) {
+    if (view->data &&
+        !ensure(view->width == sat.get_width() && view->height == sat.get_height() &&
+                view->channels == sat.get_channels())) {
+      return;
+    }
+  }
+
+  const double side = 2.0 * radius + 1.0;
+  const double scale = 1.0 / (side * side);
+  for_each_box(sat, radius, radius, true, [&](uint32_t x, uint32_t y, uint32_t c, double sum, double squares) {
+    const double m = sum * scale;
+    if (mean.data) {
+      mean.at(x, y, c) = static_cast<float>(m);
+    }
+    if (variance.data) {
+      variance.at(x, y, c) = static_cast<float>(std::max(squares * scale - m * m, 0.0));
+    }
+  });
+}
+}  // namespace kn
@@ -0,0 +1,136 @@
+/**************************************************************************/
+/* summed_area_table.hpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/**
+ * Summed-area table over every channel of a texture.
+ * Sums are accumulated in double precision so box sums stay exact to float precision on 16K textures.
+ * The table describes one period of the tiled texture: boxes may cross borders or be larger than the texture,
+ * and one table serves any number of box sizes.
+ */
+class KN_TEXTURE_API SummedAreaTable {
+ public:
+  /**
+   * Builds the table of a texture.
+   * @param src The texture to sum.
+   * @param with_squares Also sums squared values, required for local variance.
+   */
+  explicit SummedAreaTable(const TextureView& src, bool with_squares = false);
+
+  [[nodiscard]] inline uint32_t get_width() const { return _width; }
+  [[nodiscard]] inline uint32_t get_height() const { return _height; }
+  [[nodiscard]] inline uint32_t get_channels() const { return _channels; }
+  [[nodiscard]] inline bool has_squares() const { return !_squares.empty(); }
+
+  /** Returns the sum of channel c over [x0, x1) x [y0, y1) of the tiled texture. */
+  [[nodiscard]] double box_sum(int64_t x0, int64_t y0, int64_t x1, int64_t y1, uint32_t c) const {
+    return box(_sums, x0, y0, x1, y1, c);
+  }
+
+  /** Returns the sum of the squares of channel c over [x0, x1) x [y0, y1) of the tiled texture. */
+  [[nodiscard]] double box_sum_squares(int64_t x0, int64_t y0, int64_t x1, int64_t y1, uint32_t c) const {
+    return box(_squares, x0, y0, x1, y1, c);
+  }
+
+  /**
+   * A coordinate of the tiled texture split into whole periods and a remainder, so lookups along a row or column
+   * can be decomposed once and reused for every pixel.
+   */
+  struct Coord {
+    int64_t periods;
+    uint32_t rest;
+  };
+
+  /** Splits a coordinate along an axis of the given size. */
+  static Coord split(int64_t coord, uint32_t size);
+
+  /** Returns the sum over [0, x) x [0, y) of the tiled texture. */
+  [[nodiscard]] double prefix(const std::vector<double>& table, Coord x, Coord y, uint32_t c) const {
+    return static_cast<double>(x.periods * y.periods) * at(table, _width, _height, c) +
+           static_cast<double>(x.periods) * at(table, _width, y.rest, c) +
+           static_cast<double>(y.periods) * at(table, x.rest, _height, c) + at(table, x.rest, y.rest, c);
+  }
+
+  [[nodiscard]] inline const std::vector<double>& get_sums() const { return _sums; }
+  [[nodiscard]] inline const std::vector<double>& get_squares() const { return _squares; }
+
+ private:
+  [[nodiscard]] inline double at(const std::vector<double>& table, uint32_t x, uint32_t y, uint32_t c) const {
+    return table[(static_cast<size_t>(y) * (_width + 1) + x) * _channels + c];
+  }
+
+  [[nodiscard]] double box(const std::vector<double>& table,
+                           int64_t x0,
+                           int64_t y0,
+                           int64_t x1,
+                           int64_t y1,
+                           uint32_t c) const;
+
+  void build(const TextureView& src, std::vector<double>& table, bool squared);
+
+  uint32_t _width;
+  uint32_t _height;
+  uint32_t _channels;
+  /** (width + 1) x (height + 1) interleaved prefix sums, the first row and column are zero. */
+  std::vector<double> _sums;
+  std::vector<double> _squares;
+};
+
+/**
+ * Box-filters every channel: each pixel becomes the mean of the (2 * radius_x + 1) x (2 * radius_y + 1) box
+ * around it, wrapping around the borders. The cost per pixel does not depend on the radius.
+ * @param sat The table of the texture to filter.
+ * @param dst The destination, with the dimensions and channels of the table.
+ * @param radius_x The horizontal radius of the box.
+ * @param radius_y The vertical radius of the box.
+ */
+KN_TEXTURE_API void box_filter(const SummedAreaTable& sat,
+                               const TextureView& dst,
+                               uint32_t radius_x,
+                               uint32_t radius_y);
+
+/**
+ * Computes the local mean and variance of every channel over a square box.
+ * @param sat The table of the texture, built with squares.
+ * @param mean The destination of the means, or an invalid view to skip them.
+ * @param variance The destination of the variances, or an invalid view to skip them.
+ * @param radius The radius of the box.
+ */
+KN_TEXTURE_API void local_statistics(const SummedAreaTable& sat,
+                                     const TextureView& mean,
+                                     const TextureView& variance,
+                                     uint32_t radius);
+}  // namespace kn
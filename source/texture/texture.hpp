@@ -0,0 +1,216 @@
+/**************************************************************************/
+/* texture.hpp                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+#include "kn_assert.hpp"
+
+namespace kn {
+/**
+ * Wraps a signed coordinate into [0, size).
+ * Textures are tileable, so every neighbourhood lookup crossing a border reads from the opposite side.
+ */
+constexpr uint32_t wrap_coord(int64_t coord, uint32_t size) {
+  const int64_t wrapped = coord % static_cast<int64_t>(size);
+  return static_cast<uint32_t>(wrapped < 0 ? wrapped + size : wrapped);
+}
+
+/**
+ * Non-owning view over interleaved 32-bit float pixels.
+ * Rows may be padded: row_stride is the distance between two rows, in floats.
+ */
+struct TextureView {
+  float* data = nullptr;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t channels = 1;
+  size_t row_stride = 0;
+
+  /** Checks if the view points to pixels. */
+  [[nodiscard]] inline bool is_valid() const { return data != nullptr && width > 0 && height > 0 && channels > 0; }
+
+  /** Returns the number of pixels covered by the view. */
+  [[nodiscard]] inline size_t get_pixel_count() const { return static_cast<size_t>(width) * height; }
+
+  /** Returns the first float of row y. */
+  [[nodiscard]] inline float* row(uint32_t y) const { return data + y * row_stride; }
+
+  /** Returns channel c of the pixel at (x, y). */
+  [[nodiscard]] inline float& at(uint32_t x, uint32_t y, uint32_t c = 0) const {
+    return data[y * row_stride + static_cast<size_t>(x) * channels + c];
+  }
+
+  /** Returns channel c of the pixel at (x, y), wrapping out of range coordinates around the texture. */
+  [[nodiscard]] inline float fetch_wrap(int64_t x, int64_t y, uint32_t c = 0) const {
+    return at(wrap_coord(x, width), wrap_coord(y, height), c);
+  }
+
+  /** Checks if both views have the same dimensions and channel count. */
+  [[nodiscard]] inline bool has_same_layout(const TextureView& other) const {
+    return width == other.width && height == other.height && channels == other.channels;
+  }
+};
+
+/**
+ * CPU texture owning tightly packed interleaved float pixels. A uniform texture, whose pixels all have the same
+ * value, stores that value only: it keeps its size, but has to be materialized before its pixels are viewed.
+ */
+class Texture {
+ public:
+  Texture() = default;
+
+  Texture(uint32_t width, uint32_t height, uint32_t channels = 1, float value = 0.0f)
+      : _width(width),
+        _height(height),
+        _channels(channels),
+        _pixels(static_cast<size_t>(width) * height * channels, value) {
+    ensure(channels > 0);
+  }
+
+  /** Creates a texture reusing the storage of another one, see TexturePool; pixel values are unspecified. */
+  Texture(uint32_t width, uint32_t height, uint32_t channels, std::vector<float>&& storage)
+      : _width(width), _height(height), _channels(channels), _pixels(std::move(storage)) {
+    ensure(channels > 0);
+    _pixels.resize(static_cast<size_t>(width) * height * channels);
+  }
+
+  /**
+   * Creates a uniform texture.
+   * @param value The value of every pixel, whose size gives the channel count.
+   */
+  [[nodiscard]] static inline Texture uniform(uint32_t width, uint32_t height, std::span<const float> value) {
+    ensure(!value.empty());
+    Texture texture;
+    texture._width = width;
+    texture._height = height;
+    texture._channels = static_cast<uint32_t>(value.size());
+    texture._pixels.assign(value.begin(), value.end());
+    texture._uniform = true;
+    return texture;
+  }
+
+  [[nodiscard]] inline uint32_t get_width() const { return _width; }
+  [[nodiscard]] inline uint32_t get_height() const { return _height; }
+  [[nodiscard]] inline uint32_t get_channels() const { return _channels; }
+
+  /** Checks if the texture stores a single pixel for all of them, which get_data then points to. */
+  [[nodiscard]] inline bool is_uniform() const { return _uniform; }
+
+  /** Returns the number of floats the texture stores. */
+  [[nodiscard]] inline size_t get_stored_size() const { return _pixels.size(); }
+
+  /** Returns the raw pixel storage. */
+  [[nodiscard]] inline float* get_data() { return _pixels.data(); }
+  [[nodiscard]] inline const float* get_data() const { return _pixels.data(); }
+
+  /** Returns a view over the whole texture. */
+  [[nodiscard]] inline TextureView view() {
+    if (!ensure(!_uniform)) {
+      return {};
+    }
+    return {_pixels.data(), _width, _height, _channels, static_cast<size_t>(_width) * _channels};
+  }
+
+  /** Returns a read-only view over the whole texture; kernels never write through their source view. */
+  [[nodiscard]] inline TextureView view() const { return const_cast<Texture*>(this)->view(); }
+
+  /**
+   * Checks if every pixel has the same value, so that the texture could be uniform. Textures that are not usually
+   * differ within their first pixels, which ends the check early.
+   */
+  [[nodiscard]] inline bool has_single_value() const {
+    if (_uniform || _pixels.size() <= _channels) {
+      return true;
+    }
+    // Every pixel equals the previous one.
+    return std::equal(_pixels.begin() + _channels, _pixels.end(), _pixels.begin());
+  }
+
+  /** Stores every pixel of a uniform texture, so that it can be viewed; other textures are left as they are. */
+  inline void materialize() {
+    if (!_uniform) {
+      return;
+    }
+    std::vector<float> pixels(static_cast<size_t>(_width) * _height * _channels);
+    for (size_t i = 0; i < pixels.size(); i += _channels) {
+      std::copy_n(_pixels.data(), _channels, pixels.data() + i);
+    }
+    _pixels = std::move(pixels);
+    _uniform = false;
+  }
+
+  /** Gives up the pixel storage, leaving an empty texture. */
+  [[nodiscard]] inline std::vector<float> take_storage() {
+    _width = 0;
+    _height = 0;
+    _channels = 0;
+    _uniform = false;
+    return std::move(_pixels);
+  }
+
+ private:
+  uint32_t _width = 0;
+  uint32_t _height = 0;
+  uint32_t _channels = 0;
+  std::vector<float> _pixels;
+  bool _uniform = false;
+};
+
+/**
+ * Runs a filter into a new texture. Filters invariant by translation over wrapping textures, like convolutions,
+ * morphology, resampling or grading, turn a uniform texture into a uniform one whatever its size, so a uniform src
+ * is filtered as a single pixel and gives a uniform texture.
+ * @param src The texture to filter.
+ * @param width, height, channels The layout of the filtered texture.
+ * @param filter Called with the views of the source and of the filtered texture.
+ */
+template <typename Filter>
+[[nodiscard]] Texture filter_texture(const Texture& src,
+                                     uint32_t width,
+                                     uint32_t height,
+                                     uint32_t channels,
+                                     Filter&& filter) {
+  if (src.is_uniform()) {
+    Texture pixel(1, 1, src.get_channels());
+    std::copy_n(src.get_data(), src.get_channels(), pixel.get_data());
+    Texture result(1, 1, channels);
+    filter(pixel.view(), result.view());
+    return Texture::uniform(width, height, {result.get_data(), channels});
+  }
+  Texture dst(width, height, channels);
+  filter(src.view(), dst.view());
+  return dst;
+}
+}  // namespace kn
@@ -0,0 +1,101 @@
+/**************************************************************************/
+/* texture_format.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "texture_format.hpp"
+#include <algorithm>
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+template <uint32_t Src, uint32_t Dst>
+void convert_row(const float* src, float* dst, size_t count) {
+  for (size_t x = 0; x < count; ++x, src += Src, dst += Dst) {
+    // Gray and alpha of the source pixel.
+    float gray;
+    if constexpr (Src >= 3) {
+      gray = 0.2126f * src[0] + 0.7152f * src[1] + 0.0722f * src[2];
+    } else {
+      gray = src[0];
+    }
+    const float alpha = Src == 2 ? src[1] : (Src == 4 ? src[3] : 1.0f);
+
+    if constexpr (Dst >= 3) {
+      for (uint32_t c = 0; c < 3; ++c) {
+        dst[c] = Src >= 3 ? src[c] : gray;
+      }
+    } else {
+      dst[0] = gray;
+    }
+    if constexpr (Dst == 2) {
+      dst[1] = alpha;
+    } else if constexpr (Dst == 4) {
+      dst[3] = alpha;
+    }
+  }
+}
+}  // namespace
+
+void convert_pixels(const float* src, uint32_t src_channels, float* dst, uint32_t dst_channels, size_t count) {
+  dispatch_channels(src_channels, [&](auto from) {
+    dispatch_channels(dst_channels, [&](auto to) {
+      if constexpr (from() == to()) {
+        std::copy_n(src, count * from(), dst);
+      } else {
+        convert_row<from(), to()>(src, dst, count);
+      }
+    });
+  });
+}
+
+void convert_channels(const TextureView& src, const TextureView& dst) {
+  if (!ensure(src.is_valid() && dst.is_valid() && src.width == dst.width && src.height == dst.height &&
+              src.channels <= 4 && dst.channels <= 4)) {
+    return;
+  }
+
+  parallel_for(0, src.height, [&](size_t y) {
+    convert_pixels(src.row(static_cast<uint32_t>(y)), src.channels, dst.row(static_cast<uint32_t>(y)), dst.channels,
+                   src.width);
+  });
+}
+
+Texture convert_channels(const Texture& src, uint32_t channels) {
+  if (!ensure(channels > 0 && channels <= 4 && src.get_channels() <= 4)) {
+    return {};
+  }
+  if (src.is_uniform()) {
+    float value[4] = {};
+    convert_pixels(src.get_data(), src.get_channels(), value, channels, 1);
+    return Texture::uniform(src.get_width(), src.get_height(), {value, channels});
+  }
+  Texture dst(src.get_width(), src.get_height(), channels);
+  convert_channels(src.view(), dst.view());
+  return dst;
+}
+}  // namespace kn
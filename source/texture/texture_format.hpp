@@ -0,0 +1,86 @@
+/**************************************************************************/
+/* texture_format.hpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "kn_assert.hpp"
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/**
+ * Calls a function with a channel count of 1 to 4 as a compile-time constant, so that a kernel is compiled once per
+ * format, float to float4, with its loops over channels unrolled.
+ * @param channels The channel count, clamped to 4.
+ * @param func The function, taking a std::integral_constant<uint32_t, Channels>.
+ */
+template <typename Func>
+decltype(auto) dispatch_channels(uint32_t channels, Func&& func) {
+  ensure(channels > 0 && channels <= 4);
+  switch (channels) {
+    case 1:
+      return func(std::integral_constant<uint32_t, 1>());
+    case 2:
+      return func(std::integral_constant<uint32_t, 2>());
+    case 3:
+      return func(std::integral_constant<uint32_t, 3>());
+    default:
+      return func(std::integral_constant<uint32_t, 4>());
+  }
+}
+
+/**
+ * Converts a run of consecutive pixels from one channel count to another, as convert_channels does, on the calling
+ * thread. The conversion is chosen once for the run, which suits kernels converting their inputs piece by piece.
+ * @param[in] src The pixels to convert.
+ * @param src_channels The channels of src, 1 to 4.
+ * @param[out] dst The converted pixels, which must not overlap src.
+ * @param dst_channels The channels of dst, 1 to 4.
+ * @param count The number of pixels.
+ */
+KN_TEXTURE_API void convert_pixels(const float* src,
+                                   uint32_t src_channels,
+                                   float* dst,
+                                   uint32_t dst_channels,
+                                   size_t count);
+
+/**
+ * Converts pixels to the channel count of dst. Channels are read as gray, gray and alpha, RGB or RGBA: gray is
+ * repeated into color, color is reduced to its Rec. 709 luminance, and a missing alpha is 1.
+ * @param[in] src The pixels to convert, with 1 to 4 channels.
+ * @param[out] dst The converted pixels, with the size of src and 1 to 4 channels.
+ */
+KN_TEXTURE_API void convert_channels(const TextureView& src, const TextureView& dst);
+
+/** Returns a texture with the pixels of another one converted to a channel count, uniform if the other one is. */
+KN_TEXTURE_API Texture convert_channels(const Texture& src, uint32_t channels);
+}  // namespace kn
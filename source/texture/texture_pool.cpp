@@ -0,0 +1,104 @@
+/**************************************************************************/
+/* texture_pool.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "texture_pool.hpp"
+#include <utility>
+
+namespace kn {
+TexturePool* TexturePool::get_instance() {
+  static TexturePool instance;
+  return &instance;
+}
+
+Texture TexturePool::acquire(uint32_t width, uint32_t height, uint32_t channels /*= 1*/) {
+  const size_t size = static_cast<size_t>(width) * height * channels;
+
+  std::vector<float> storage;
+  {
+    std::lock_guard lock(_mutex);
+    size_t best = _storage.size();
+    for (size_t i = 0; i < _storage.size(); ++i) {
+      const size_t capacity = _storage[i].capacity();
+      if (capacity >= size && (best == _storage.size() || capacity < _storage[best].capacity())) {
+        best = i;
+      }
+    }
+    if (best < _storage.size()) {
+      storage = std::move(_storage[best]);
+      _storage.erase(_storage.begin() + static_cast<ptrdiff_t>(best));
+      _pooled_size -= storage.capacity() * sizeof(float);
+    }
+  }
+
+  return Texture(width, height, channels, std::move(storage));
+}
+
+void TexturePool::release(Texture&& texture) {
+  std::vector<float> storage = texture.take_storage();
+  if (storage.capacity() == 0) {
+    return;
+  }
+
+  std::lock_guard lock(_mutex);
+  _pooled_size += storage.capacity() * sizeof(float);
+  _storage.push_back(std::move(storage));
+  trim();
+}
+
+void TexturePool::clear() {
+  std::lock_guard lock(_mutex);
+  _storage.clear();
+  _pooled_size = 0;
+}
+
+void TexturePool::set_capacity(size_t bytes) {
+  std::lock_guard lock(_mutex);
+  _capacity = bytes;
+  trim();
+}
+
+size_t TexturePool::get_capacity() const {
+  std::lock_guard lock(_mutex);
+  return _capacity;
+}
+
+size_t TexturePool::get_pooled_size() const {
+  std::lock_guard lock(_mutex);
+  return _pooled_size;
+}
+
+void TexturePool::trim() {
+  size_t dropped = 0;
+  while (dropped < _storage.size() && _pooled_size > _capacity) {
+    _pooled_size -= _storage[dropped].capacity() * sizeof(float);
+    ++dropped;
+  }
+  _storage.erase(_storage.begin(), _storage.begin() + static_cast<ptrdiff_t>(dropped));
+}
+}  // namespace kn
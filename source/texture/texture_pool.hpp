@@ -0,0 +1,82 @@
+/**************************************************************************/
+/* texture_pool.hpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/**
+ * Recycles the pixel storage of intermediate textures between kernel invocations, so that large temporary
+ * buffers are not allocated and page-faulted in again by every evaluation. Thread-safe.
+ */
+class KN_TEXTURE_API TexturePool {
+ public:
+  TexturePool(const TexturePool&) = delete;
+  TexturePool& operator=(const TexturePool&) = delete;
+
+  TexturePool() = default;
+  ~TexturePool() = default;
+
+  static TexturePool* get_instance();
+
+  /**
+   * Returns a texture of the given layout, backed by the smallest pooled storage large enough, or by a new
+   * allocation. Pixel values are unspecified.
+   */
+  [[nodiscard]] Texture acquire(uint32_t width, uint32_t height, uint32_t channels = 1);
+
+  /** Returns the storage of a texture to the pool, dropping the oldest storage beyond the capacity. */
+  void release(Texture&& texture);
+
+  /** Frees every pooled storage. */
+  void clear();
+
+  /** Sets the maximum number of bytes kept in the pool. */
+  void set_capacity(size_t bytes);
+
+  [[nodiscard]] size_t get_capacity() const;
+  [[nodiscard]] size_t get_pooled_size() const;
+
+ private:
+  /** Drops the oldest storage until the pool fits its capacity. */
+  void trim();
+
+  mutable std::mutex _mutex;
+  /** Pooled storage, oldest first. */
+  std::vector<std::vector<float>> _storage;
+  size_t _pooled_size = 0;
+  size_t _capacity = size_t{1} << 30;
+};
+}  // namespace kn
@@ -0,0 +1,76 @@
+/**************************************************************************/
+/* tiled_texture.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tiled_texture.hpp"
+#include <algorithm>
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+TiledTexture::TiledTexture(uint32_t width, uint32_t height, uint32_t channels /*= 1*/, float value /*= 0.0f*/)
+    : _width(width),
+      _height(height),
+      _channels(channels),
+      _tiles_x((width + TILE_SIZE - 1) >> TILE_SHIFT),
+      _tiles_y((height + TILE_SIZE - 1) >> TILE_SHIFT),
+      _pixels(static_cast<size_t>(_tiles_x) * _tiles_y * TILE_PIXELS * channels, value) {
+  ensure(channels > 0);
+}
+
+TiledTexture::TiledTexture(const TextureView& src) : TiledTexture(src.width, src.height, src.channels) {
+  if (!ensure(src.is_valid())) {
+    return;
+  }
+
+  parallel_for(0, _height, [&](size_t y) {
+    const float* row = src.row(static_cast<uint32_t>(y));
+    const size_t row_offset = get_row_offset(static_cast<uint32_t>(y));
+    for (uint32_t x = 0; x < _width; x += TILE_SIZE) {
+      const uint32_t count = std::min(TILE_SIZE, _width - x);
+      std::copy_n(row + static_cast<size_t>(x) * _channels, count * _channels,
+                  _pixels.data() + row_offset + get_column_offset(x));
+    }
+  });
+}
+
+void TiledTexture::copy_to(const TextureView& dst) const {
+  if (!ensure(dst.width == _width && dst.height == _height && dst.channels == _channels)) {
+    return;
+  }
+
+  parallel_for(0, _height, [&](size_t y) {
+    float* row = dst.row(static_cast<uint32_t>(y));
+    const size_t row_offset = get_row_offset(static_cast<uint32_t>(y));
+    for (uint32_t x = 0; x < _width; x += TILE_SIZE) {
+      const uint32_t count = std::min(TILE_SIZE, _width - x);
+      std::copy_n(_pixels.data() + row_offset + get_column_offset(x), count * _channels,
+                  row + static_cast<size_t>(x) * _channels);
+    }
+  });
+}
+}  // namespace kn
@@ -0,0 +1,107 @@
+/**************************************************************************/
+/* tiled_texture.hpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "texture.hpp"
+#include "texture_api.hpp"
+
+namespace kn {
+/**
+ * CPU texture stored as square tiles of TILE_SIZE x TILE_SIZE interleaved pixels, tiles being laid out row by row.
+ * A 2D neighbourhood spans a few tiles instead of many rows, which keeps data-dependent reads such as warps within
+ * a small set of cache lines and pages. Border tiles are padded up to the full tile size.
+ */
+class KN_TEXTURE_API TiledTexture {
+ public:
+  static constexpr uint32_t TILE_SHIFT = 5;
+  static constexpr uint32_t TILE_SIZE = 1u << TILE_SHIFT;
+  static constexpr uint32_t TILE_PIXELS = TILE_SIZE * TILE_SIZE;
+
+  TiledTexture() = default;
+  TiledTexture(uint32_t width, uint32_t height, uint32_t channels = 1, float value = 0.0f);
+
+  /** Copies a linear texture into tiles. */
+  explicit TiledTexture(const TextureView& src);
+
+  /** Copies the pixels back to a linear texture of the same layout. */
+  void copy_to(const TextureView& dst) const;
+
+  [[nodiscard]] inline uint32_t get_width() const { return _width; }
+  [[nodiscard]] inline uint32_t get_height() const { return _height; }
+  [[nodiscard]] inline uint32_t get_channels() const { return _channels; }
+  [[nodiscard]] inline uint32_t get_tiles_x() const { return _tiles_x; }
+  [[nodiscard]] inline uint32_t get_tiles_y() const { return _tiles_y; }
+
+  /** Returns the index of the first float of the pixel at (x, y), as the sum of a column and a row part. */
+  [[nodiscard]] inline size_t get_offset(uint32_t x, uint32_t y) const {
+    return get_column_offset(x) + get_row_offset(y);
+  }
+
+  /** Returns the part of get_offset depending on x. */
+  [[nodiscard]] inline size_t get_column_offset(uint32_t x) const {
+    return ((static_cast<size_t>(x >> TILE_SHIFT) << (2 * TILE_SHIFT)) + (x & (TILE_SIZE - 1))) * _channels;
+  }
+
+  /** Returns the part of get_offset depending on y. */
+  [[nodiscard]] inline size_t get_row_offset(uint32_t y) const {
+    return ((static_cast<size_t>(y >> TILE_SHIFT) * _tiles_x << (2 * TILE_SHIFT)) +
+            ((y & (TILE_SIZE - 1)) << TILE_SHIFT)) *
+           _channels;
+  }
+
+  [[nodiscard]] inline float& at(uint32_t x, uint32_t y, uint32_t c = 0) { return _pixels[get_offset(x, y) + c]; }
+  [[nodiscard]] inline float at(uint32_t x, uint32_t y, uint32_t c = 0) const {
+    return _pixels[get_offset(x, y) + c];
+  }
+
+  /** Returns the first pixel of tile (tx, ty), followed by its rows of TILE_SIZE pixels. */
+  [[nodiscard]] inline float* get_tile(uint32_t tx, uint32_t ty) {
+    return _pixels.data() + (static_cast<size_t>(ty) * _tiles_x + tx) * TILE_PIXELS * _channels;
+  }
+  [[nodiscard]] inline const float* get_tile(uint32_t tx, uint32_t ty) const {
+    return const_cast<TiledTexture*>(this)->get_tile(tx, ty);
+  }
+
+  /** Returns the raw tile storage. */
+  [[nodiscard]] inline float* get_data() { return _pixels.data(); }
+  [[nodiscard]] inline const float* get_data() const { return _pixels.data(); }
+
+ private:
+  uint32_t _width = 0;
+  uint32_t _height = 0;
+  uint32_t _channels = 0;
+  uint32_t _tiles_x = 0;
+  uint32_t _tiles_y = 0;
+  std::vector<float> _pixels;
+};
+}  // namespace kn
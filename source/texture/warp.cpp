@@ -0,0 +1,284 @@
+/**************************************************************************/
+/* warp.cpp                                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "warp.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "math/simd.hpp"
+#include "threading/parallel_for.hpp"
+
+namespace kn {
+namespace {
+constexpr uint32_t TILE_SIZE = TiledTexture::TILE_SIZE;
+constexpr uint32_t TILE_PIXELS = TiledTexture::TILE_PIXELS;
+
+/**
+ * Lookups are binned by source tile coordinates modulo BIN_TILES. Warps rarely reach further than a few tiles, so
+ * a bin almost always holds a single source tile, for the price of one counting sort pass.
+ */
+constexpr uint32_t BIN_SHIFT = 3;
+constexpr uint32_t BIN_TILES = 1u << BIN_SHIFT;
+constexpr uint32_t BIN_COUNT = BIN_TILES * BIN_TILES;
+
+/** Number of lookups between the prefetch of a texel and its use. */
+constexpr uint32_t PREFETCH_DISTANCE = 8;
+
+/** Bilinear lookups of one destination tile, indexed like its pixels. */
+struct Lookups {
+  /** Source position, in texels: integer coordinates are texel centers. */
+  alignas(16) float x[TILE_PIXELS];
+  alignas(16) float y[TILE_PIXELS];
+
+  alignas(16) int32_t x0[TILE_PIXELS];
+  alignas(16) int32_t x1[TILE_PIXELS];
+  alignas(16) int32_t y0[TILE_PIXELS];
+  alignas(16) int32_t y1[TILE_PIXELS];
+  alignas(16) float fx[TILE_PIXELS];
+  alignas(16) float fy[TILE_PIXELS];
+
+  /** Lookup indices sorted by bin. */
+  uint16_t order[TILE_PIXELS];
+};
+
+/** Magnitude source positions are clamped to, below which floats still hold every integer. */
+constexpr float COORD_LIMIT = 16777216.0f;
+
+/**
+ * Wraps the texel coordinates of the lookups of a tile and splits them into the two texels and the blend weight.
+ * NaN positions read texel 0; wrapping is done on integers, since rounding errors of a float modulo grow past a
+ * texel for large positions.
+ */
+void address(const float* coords, uint32_t size, int32_t* i0, int32_t* i1, float* weights) {
+  for (uint32_t i = 0; i < TILE_PIXELS; ++i) {
+    const float coord = std::isnan(coords[i]) ? 0.0f : std::clamp(coords[i], -COORD_LIMIT, COORD_LIMIT);
+    const float floored = std::floor(coord);
+    weights[i] = coord - floored;
+    const uint32_t wrapped = wrap_coord(static_cast<int64_t>(floored), size);
+    i0[i] = static_cast<int32_t>(wrapped);
+    i1[i] = wrapped + 1 < size ? static_cast<int32_t>(wrapped + 1) : 0;
+  }
+}
+
+template <uint32_t Channels>
+class Warper {
+ public:
+  Warper(const TiledTexture& src, TiledTexture& dst) : _src(src), _dst(dst) {
+    _columns.resize(src.get_width());
+    for (uint32_t x = 0; x < src.get_width(); ++x) {
+      _columns[x] = src.get_column_offset(x);
+    }
+    _rows.resize(src.get_height());
+    for (uint32_t y = 0; y < src.get_height(); ++y) {
+      _rows[y] = src.get_row_offset(y);
+    }
+  }
+
+  /**
+   * Warps every tile of the destination.
+   * @param locate Fills the source positions of the lookups of a destination tile, given its tile coordinates.
+   */
+  template <typename Locate>
+  void run(Locate&& locate) {
+    const uint32_t tiles_x = _dst.get_tiles_x();
+    parallel_for(0, static_cast<size_t>(tiles_x) * _dst.get_tiles_y(), [&](size_t tile) {
+      thread_local Lookups lookups;
+      const auto tx = static_cast<uint32_t>(tile % tiles_x);
+      const auto ty = static_cast<uint32_t>(tile / tiles_x);
+      locate(tx, ty, lookups);
+      prepare(lookups);
+      gather(lookups, _dst.get_tile(tx, ty));
+    });
+  }
+
+ private:
+  /** Addresses the lookups and sorts them by bin. */
+  void prepare(Lookups& lookups) const {
+    address(lookups.x, _src.get_width(), lookups.x0, lookups.x1, lookups.fx);
+    address(lookups.y, _src.get_height(), lookups.y0, lookups.y1, lookups.fy);
+
+    std::array<uint16_t, BIN_COUNT + 1> starts{};
+    const auto bin = [&](uint32_t i) {
+      const uint32_t bx = (static_cast<uint32_t>(lookups.x0[i]) >> TiledTexture::TILE_SHIFT) & (BIN_TILES - 1);
+      const uint32_t by = (static_cast<uint32_t>(lookups.y0[i]) >> TiledTexture::TILE_SHIFT) & (BIN_TILES - 1);
+      return (by << BIN_SHIFT) | bx;
+    };
+    for (uint32_t i = 0; i < TILE_PIXELS; ++i) {
+      ++starts[bin(i) + 1];
+    }
+    for (uint32_t b = 0; b < BIN_COUNT; ++b) {
+      starts[b + 1] = static_cast<uint16_t>(starts[b + 1] + starts[b]);
+    }
+    for (uint32_t i = 0; i < TILE_PIXELS; ++i) {
+      lookups.order[starts[bin(i)]++] = static_cast<uint16_t>(i);
+    }
+  }
+
+  void gather(const Lookups& lookups, float* out) const {
+    const float* texels = _src.get_data();
+
+    for (uint32_t k = 0; k < TILE_PIXELS; ++k) {
+      if (k + PREFETCH_DISTANCE < TILE_PIXELS) {
+        const uint32_t next = lookups.order[k + PREFETCH_DISTANCE];
+        const size_t column = _columns[static_cast<size_t>(lookups.x0[next])];
+        simd::prefetch(texels + _rows[static_cast<size_t>(lookups.y0[next])] + column);
+        simd::prefetch(texels + _rows[static_cast<size_t>(lookups.y1[next])] + column);
+      }
+
+      const uint32_t i = lookups.order[k];
+      const float* row0 = texels + _rows[static_cast<size_t>(lookups.y0[i])];
+      const float* row1 = texels + _rows[static_cast<size_t>(lookups.y1[i])];
+      const size_t x0 = _columns[static_cast<size_t>(lookups.x0[i])];
+      const size_t x1 = _columns[static_cast<size_t>(lookups.x1[i])];
+      const float fx = lookups.fx[i];
+      const float fy = lookups.fy[i];
+
+      for (uint32_t c = 0; c < Channels; ++c) {
+        const float top = row0[x0 + c] + (row0[x1 + c] - row0[x0 + c]) * fx;
+        const float bottom = row1[x0 + c] + (row1[x1 + c] - row1[x0 + c]) * fx;
+        out[i * Channels + c] = top + (bottom - top) * fy;
+      }
+    }
+  }
+
+  const TiledTexture& _src;
+  TiledTexture& _dst;
+  /** Column and row parts of the offsets of the source texels. */
+  std::vector<size_t> _columns;
+  std::vector<size_t> _rows;
+};
+
+template <typename Locate>
+void run_warp(const TiledTexture& src, TiledTexture& dst, Locate&& locate) {
+  switch (src.get_channels()) {
+    case 1:
+      Warper<1>(src, dst).run(locate);
+      break;
+    case 2:
+      Warper<2>(src, dst).run(locate);
+      break;
+    case 3:
+      Warper<3>(src, dst).run(locate);
+      break;
+    default:
+      Warper<4>(src, dst).run(locate);
+      break;
+  }
+}
+
+bool check_textures(const TiledTexture& src, const TiledTexture& map, uint32_t channel, const TiledTexture& dst) {
+  return ensure(src.get_width() > 0 && src.get_height() > 0 && src.get_channels() <= 4) &&
+         ensure(map.get_width() == src.get_width() && map.get_height() == src.get_height() &&
+                channel < map.get_channels()) &&
+         ensure(dst.get_width() == src.get_width() && dst.get_height() == src.get_height() &&
+                dst.get_channels() == src.get_channels());
+}
+
+/**
+ * Calls offset(x, y, map_tile, i) for every pixel of a destination tile, i being its index in the tile, and stores
+ * the source position p + offset.
+ */
+template <typename Offset>
+void locate_tile(const TiledTexture& map, uint32_t tx, uint32_t ty, Lookups& lookups, Offset&& offset) {
+  const float* map_tile = map.get_tile(tx, ty);
+  for (uint32_t j = 0; j < TILE_SIZE; ++j) {
+    const uint32_t y = ty * TILE_SIZE + j;
+    for (uint32_t i = 0; i < TILE_SIZE; ++i) {
+      const uint32_t x = tx * TILE_SIZE + i;
+      const uint32_t index = j * TILE_SIZE + i;
+      const auto [dx, dy] = offset(x, y, map_tile, index);
+      lookups.x[index] = static_cast<float>(x) + dx;
+      lookups.y[index] = static_cast<float>(y) + dy;
+    }
+  }
+}
+}  // namespace
+
+void displace(const TiledTexture& src, const TiledTexture& offsets, float intensity, TiledTexture& dst) {
+  if (!check_textures(src, offsets, 0, dst) || !ensure(offsets.get_channels() >= 2)) {
+    return;
+  }
+
+  const float scale_x = intensity * static_cast<float>(src.get_width());
+  const float scale_y = intensity * static_cast<float>(src.get_height());
+  const uint32_t channels = offsets.get_channels();
+  run_warp(src, dst, [&](uint32_t tx, uint32_t ty, Lookups& lookups) {
+    locate_tile(offsets, tx, ty, lookups, [&](uint32_t, uint32_t, const float* tile, uint32_t index) {
+      const float* offset = tile + static_cast<size_t>(index) * channels;
+      return std::array<float, 2>{offset[0] * scale_x, offset[1] * scale_y};
+    });
+  });
+}
+
+void directional_warp(const TiledTexture& src,
+                      const TiledTexture& map,
+                      uint32_t channel,
+                      float angle,
+                      float intensity,
+                      TiledTexture& dst) {
+  if (!check_textures(src, map, channel, dst)) {
+    return;
+  }
+
+  const float scale_x = intensity * std::cos(angle) * static_cast<float>(src.get_width());
+  const float scale_y = intensity * std::sin(angle) * static_cast<float>(src.get_height());
+  const uint32_t channels = map.get_channels();
+  run_warp(src, dst, [&](uint32_t tx, uint32_t ty, Lookups& lookups) {
+    locate_tile(map, tx, ty, lookups, [&](uint32_t, uint32_t, const float* tile, uint32_t index) {
+      const float distance = tile[static_cast<size_t>(index) * channels + channel];
+      return std::array<float, 2>{distance * scale_x, distance * scale_y};
+    });
+  });
+}
+
+void warp(const TiledTexture& src, const TiledTexture& height, uint32_t channel, float intensity, TiledTexture& dst) {
+  if (!check_textures(src, height, channel, dst)) {
+    return;
+  }
+
+  const uint32_t width = height.get_width();
+  const uint32_t rows = height.get_height();
+  const float scale_x = 0.5f * intensity * static_cast<float>(src.get_width());
+  const float scale_y = 0.5f * intensity * static_cast<float>(src.get_height());
+  run_warp(src, dst, [&](uint32_t tx, uint32_t ty, Lookups& lookups) {
+    locate_tile(height, tx, ty, lookups, [&](uint32_t x, uint32_t y, const float*, uint32_t) {
+      // Padding pixels of border tiles lie outside of the height map, any position inside will do.
+      x = std::min(x, width - 1);
+      y = std::min(y, rows - 1);
+      const uint32_t left = x == 0 ? width - 1 : x - 1;
+      const uint32_t right = x + 1 == width ? 0 : x + 1;
+      const uint32_t up = y == 0 ? rows - 1 : y - 1;
+      const uint32_t down = y + 1 == rows ? 0 : y + 1;
+      return std::array<float, 2>{(height.at(right, y, channel) - height.at(left, y, channel)) * scale_x,
+                                  (height.at(x, down, channel) - height.at(x, up, channel)) * scale_y};
+    });
+  });
+}
+}  // namespace kn
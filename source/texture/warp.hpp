@@ -0,0 +1,78 @@
+/**************************************************************************/
+/* warp.hpp                                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include "texture_api.hpp"
+#include "tiled_texture.hpp"
+
+namespace kn {
+/**
+ * Moves the source by a vector map: dst(p) = src(p + intensity * offsets(p)), offsets being in UV units.
+ * Like every warp, the source is sampled bilinearly with wrap addressing, and maps must have the size of the source.
+ * @param[in] src The texture to warp, with at most 4 channels.
+ * @param[in] offsets The displacement in its first two channels.
+ * @param[in] intensity The scale of the displacement.
+ * @param[out] dst The warped texture, with the layout of src.
+ */
+KN_TEXTURE_API void displace(const TiledTexture& src, const TiledTexture& offsets, float intensity, TiledTexture& dst);
+
+/**
+ * Moves the source along a fixed direction, by a distance read from a map: dst(p) = src(p + intensity * map(p) *
+ * (cos(angle), sin(angle))), in UV units.
+ * @param[in] src The texture to warp, with at most 4 channels.
+ * @param[in] map The displacement distance.
+ * @param[in] channel The channel of map to read.
+ * @param[in] angle The direction, in radians.
+ * @param[in] intensity The scale of the displacement.
+ * @param[out] dst The warped texture, with the layout of src.
+ */
+KN_TEXTURE_API void directional_warp(const TiledTexture& src,
+                                     const TiledTexture& map,
+                                     uint32_t channel,
+                                     float angle,
+                                     float intensity,
+                                     TiledTexture& dst);
+
+/**
+ * Moves the source along the slope of a height map: dst(p) = src(p + intensity * grad(height)(p)), the gradient
+ * being measured with central differences between neighbour pixels, and the offset being in UV units.
+ * @param[in] src The texture to warp, with at most 4 channels.
+ * @param[in] height The height map.
+ * @param[in] channel The channel of height to read.
+ * @param[in] intensity The scale of the displacement.
+ * @param[out] dst The warped texture, with the layout of src.
+ */
+KN_TEXTURE_API void warp(const TiledTexture& src,
+                         const TiledTexture& height,
+                         uint32_t channel,
+                         float intensity,
+                         TiledTexture& dst);
+}  // namespace kn
@@ -0,0 +1,118 @@
+/**************************************************************************/
+/* test_task_scheduler.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <mutex>
+#include <set>
+#include "threading/parallel_for.hpp"
+#include "threading/task_scheduler.hpp"
+
+namespace {
+void count_tree(kn::TaskScheduler& scheduler, kn::TaskGroup& group, std::atomic<uint32_t>& count, uint32_t depth) {
+  count.fetch_add(1);
+  if (depth == 0) {
+    return;
+  }
+  for (uint32_t i = 0; i < 2; ++i) {
+    scheduler.submit(group, [&scheduler, &group, &count, depth]() { count_tree(scheduler, group, count, depth - 1); });
+  }
+}
+}  // namespace
+
+TEST_CASE("Task scheduler") {
+  SUBCASE("Runs every task") {
+    for (uint32_t threads : {0u, 1u, 3u}) {
+      kn::TaskScheduler scheduler(threads);
+      CHECK(scheduler.get_thread_count() == threads);
+      std::atomic<uint32_t> count{0};
+      kn::TaskGroup group;
+      for (uint32_t i = 0; i < 1000; ++i) {
+        scheduler.submit(group, [&count]() { count.fetch_add(1); });
+      }
+      scheduler.wait(group);
+      CHECK(group.is_done());
+      CHECK(count.load() == 1000);
+    }
+  }
+
+  SUBCASE("Tasks submit tasks") {
+    kn::TaskScheduler scheduler(3);
+    std::atomic<uint32_t> count{0};
+    kn::TaskGroup group;
+    scheduler.submit(group, [&]() { count_tree(scheduler, group, count, 10); });
+    scheduler.wait(group);
+    CHECK(count.load() == 2047);
+  }
+
+  SUBCASE("Tasks wait for groups of their own") {
+    kn::TaskScheduler scheduler(2);
+    std::atomic<uint32_t> count{0};
+    kn::TaskGroup outer;
+    for (uint32_t i = 0; i < 8; ++i) {
+      scheduler.submit(outer, [&]() {
+        kn::TaskGroup inner;
+        for (uint32_t j = 0; j < 100; ++j) {
+          scheduler.submit(inner, [&count]() { count.fetch_add(1); });
+        }
+        scheduler.wait(inner);
+      });
+    }
+    scheduler.wait(outer);
+    CHECK(count.load() == 800);
+  }
+
+  SUBCASE("Idle workers steal tasks") {
+    kn::TaskScheduler scheduler(3);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    kn::TaskGroup group;
+    for (uint32_t i = 0; i < 64; ++i) {
+      scheduler.submit(group, [&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard lock(mutex);
+        threads.insert(std::this_thread::get_id());
+      });
+    }
+    scheduler.wait(group);
+    CHECK(threads.size() > 1);
+  }
+}
+
+TEST_CASE("Nested parallel loops") {
+  std::vector<std::atomic<uint32_t>> sums(64);
+  kn::parallel_for(0, sums.size(), [&](size_t i) {
+    kn::parallel_for(0, 1000, [&](size_t j) { sums[i].fetch_add(static_cast<uint32_t>(j)); }, 16);
+  });
+  for (const auto& sum : sums) {
+    CHECK(sum.load() == 499500);
+  }
+}
@@ -0,0 +1,176 @@
+/**************************************************************************/
+/* test_buffer_plan.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <mutex>
+#include <set>
+#include "graph_evaluator.hpp"
+#include "test_definitions.hpp"
+
+namespace {
+struct Fixture : kn::test::TestLibrary {
+  /** A source followed by a chain of filters. */
+  [[nodiscard]] kn::Graph make_chain(uint32_t length) const {
+    kn::GraphBuilder builder(library);
+    kn::test::add_chain(builder, source, filter, length);
+    return *builder.build();
+  }
+
+  /** A source read by four filters, summed. */
+  [[nodiscard]] kn::Graph make_fan() const {
+    kn::GraphBuilder builder(library);
+    const kn::GraphIndex first = builder.add_node(source);
+    const kn::GraphIndex last = builder.add_node(sum);
+    for (kn::GraphIndex i = 0; i < 4; ++i) {
+      const kn::GraphIndex node = builder.add_node(filter);
+      builder.connect(first, 0, node, 0);
+      builder.connect(node, 0, last, i);
+    }
+    return *builder.build();
+  }
+};
+
+kn::GraphIndex last_output(const kn::Graph& graph) {
+  return graph.get_output_count() - 1;
+}
+}  // namespace
+
+TEST_CASE("Buffer plans") {
+  Fixture fixture;
+
+  SUBCASE("Chains alternate between two buffers") {
+    const kn::Graph graph = fixture.make_chain(20);
+    const std::vector<kn::GraphIndex> outputs = {last_output(graph)};
+    const kn::BufferPlan plan = kn::plan_buffers(graph, outputs, {});
+    CHECK(plan.buffer_count == 2);
+    for (kn::GraphIndex output = 1; output < graph.get_output_count(); ++output) {
+      CHECK(plan.buffers[output] != plan.buffers[output - 1]);
+      CHECK(plan.release_levels[output - 1] == output);
+    }
+    CHECK(plan.release_levels[last_output(graph)] == kn::INVALID_INDEX);
+  }
+
+  SUBCASE("Chains working in place use a single buffer") {
+    const kn::Graph graph = fixture.make_chain(20);
+    const std::vector<kn::GraphIndex> outputs = {last_output(graph)};
+    const std::vector<uint8_t> in_place = {0, 1, 0};
+    const kn::BufferPlan plan = kn::plan_buffers(graph, outputs, in_place);
+    CHECK(plan.buffer_count == 1);
+    CHECK(plan.in_place[0] == 0);
+    CHECK(plan.in_place[20] == 1);
+  }
+
+  SUBCASE("Kept outputs are not overwritten") {
+    const kn::Graph graph = fixture.make_chain(3);
+    const std::vector<kn::GraphIndex> outputs = {1, 3};
+    const std::vector<uint8_t> in_place = {0, 1, 0};
+    const kn::BufferPlan plan = kn::plan_buffers(graph, outputs, in_place);
+    CHECK(plan.in_place[2] == 0);
+    CHECK(plan.in_place[3] == 1);
+    CHECK(plan.buffers[1] != plan.buffers[3]);
+    CHECK(plan.release_levels[1] == kn::INVALID_INDEX);
+  }
+
+  SUBCASE("Buffers follow the width of the graph") {
+    const kn::Graph graph = fixture.make_fan();
+    const std::vector<kn::GraphIndex> outputs = {graph.get_outputs(1).front()};
+    const std::vector<uint8_t> in_place = {0, 1, 0};
+    const kn::BufferPlan plan = kn::plan_buffers(graph, outputs, in_place);
+    // The source is read by four nodes, so none works in place.
+    CHECK(plan.buffer_count == 5);
+    CHECK(plan.buffers[graph.get_outputs(1).front()] == plan.buffers[0]);
+  }
+
+  SUBCASE("Only the nodes the outputs depend on run") {
+    const kn::Graph graph = fixture.make_chain(5);
+    const std::vector<kn::GraphIndex> outputs = {2};
+    const kn::BufferPlan plan = kn::plan_buffers(graph, outputs, {});
+    CHECK(plan.active == std::vector<uint8_t>{1, 1, 1, 0, 0, 0});
+    CHECK(plan.buffers[3] == kn::INVALID_INDEX);
+  }
+}
+
+TEST_CASE("Evaluation without intermediate outputs") {
+  Fixture fixture;
+  kn::Graph graph = fixture.make_chain(30);
+  kn::OutputCache cache;
+  kn::GraphEvaluator evaluator(graph, cache);
+  evaluator.set_resolution(64, 32);
+  // The chain computes constant textures, which would otherwise be kept as uniform ones without buffers.
+  evaluator.set_uniform_detection(false);
+
+  std::mutex mutex;
+  std::set<const float*> storage;
+  const auto record = [&](const kn::Texture& texture) {
+    std::lock_guard lock(mutex);
+    storage.insert(texture.get_data());
+  };
+  evaluator.set_kernel(fixture.source, [&](const kn::NodeContext& context) {
+    auto texture = context.allocate(0, context.width, context.height);
+    std::fill_n(texture->get_data(), context.width * context.height, 0.0f);
+    record(*texture);
+    context.outputs[0] = texture;
+  });
+  // Adds one to its input.
+  evaluator.set_kernel(fixture.filter, [&](const kn::NodeContext& context) {
+    auto texture = context.allocate(0, context.width, context.height);
+    const float* input = context.inputs[0]->get_data();
+    for (size_t i = 0; i < context.width * context.height; ++i) {
+      texture->get_data()[i] = input[i] + 1.0f;
+    }
+    record(*texture);
+    context.outputs[0] = texture;
+  });
+
+  const std::vector<kn::GraphIndex> outputs = {10, last_output(graph)};
+
+  SUBCASE("Outputs reuse the buffers of released outputs") {
+    const std::vector<kn::TexturePtr> results = evaluator.evaluate_once(outputs);
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0] != nullptr);
+    REQUIRE(results[1] != nullptr);
+    CHECK(results[0]->get_data()[0] == 10.0f);
+    CHECK(results[1]->get_data()[64 * 32 - 1] == 30.0f);
+    // Two buffers alternate along the chain, a third keeps output 10.
+    CHECK(storage.size() == 3);
+  }
+
+  SUBCASE("Nodes working in place overwrite their input") {
+    evaluator.set_in_place(fixture.filter, true);
+    const std::vector<kn::TexturePtr> results = evaluator.evaluate_once(outputs);
+    CHECK(results[0]->get_data()[0] == 10.0f);
+    CHECK(results[1]->get_data()[64 * 32 - 1] == 30.0f);
+    CHECK(storage.size() == 2);
+  }
+
+  // Previous evaluations are left alone.
+  CHECK(evaluator.get_output(last_output(graph)) == nullptr);
+}
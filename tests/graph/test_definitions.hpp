@@ -0,0 +1,111 @@
+/**************************************************************************/
+/* test_definitions.hpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "graph.hpp"
+#include "node_definition.hpp"
+
+namespace kn::test {
+/** Returns a definition with one output and the given number of inputs, accepting every format. */
+inline NodeDefinition make_definition(const char* id, uint32_t inputs) {
+  NodeDefinition definition;
+  definition.id = id;
+  for (uint32_t i = 0; i < inputs; ++i) {
+    definition.inputs.push_back({"Input", "input" + std::to_string(i), false, FORMAT_ANY});
+  }
+  definition.outputs.push_back({"Output", "output", {}});
+  return definition;
+}
+
+/** Returns a definition with the given input and output ids, named after them, whose inputs accept the formats. */
+inline NodeDefinition make_definition(const std::string& id,
+                                      const std::vector<std::string>& inputs,
+                                      const std::vector<std::string>& outputs,
+                                      PortFormats formats = FORMAT_FLOAT) {
+  NodeDefinition definition;
+  definition.name = id;
+  definition.id = id;
+  for (const std::string& input : inputs) {
+    definition.inputs.push_back({input, input, false, formats});
+  }
+  for (const std::string& output : outputs) {
+    definition.outputs.push_back({output, output, {}});
+  }
+  return definition;
+}
+
+/** Adds a number parameter, named after its id, to a definition. */
+inline void add_number_parameter(NodeDefinition& definition, const std::string& id, double value) {
+  definition.parameters.push_back({id, id, ParameterType::Number, value, {}, {}, {}});
+}
+
+/** Definitions most graph tests build their graphs from. */
+struct TestLibrary {
+  TestLibrary() {
+    NodeDefinition source_definition = make_definition("source", {}, {"output"});
+    add_number_parameter(source_definition, "value", 0.0);
+    source = library.add(source_definition);
+    filter = library.add(make_definition("filter", {"input"}, {"output"}));
+    blend = library.add(make_definition("blend", {"a", "b"}, {"output"}));
+    sum = library.add(make_definition("sum", {"a", "b", "c", "d"}, {"output"}));
+  }
+
+  NodeLibrary library;
+  /** No input, and a number parameter, value. */
+  GraphIndex source = 0;
+  /** One input. */
+  GraphIndex filter = 0;
+  /** Two inputs. */
+  GraphIndex blend = 0;
+  /** Four inputs. */
+  GraphIndex sum = 0;
+};
+
+/**
+ * Adds a source followed by a chain of filters, each reading the first output of the previous node.
+ * @param builder The builder of the graph.
+ * @param source The definition of the first node.
+ * @param filter The definition of the other nodes, whose first input reads the previous node.
+ * @param length The number of filters.
+ * @return The last node of the chain.
+ */
+inline GraphIndex add_chain(GraphBuilder& builder, GraphIndex source, GraphIndex filter, uint32_t length) {
+  GraphIndex previous = builder.add_node(source);
+  for (uint32_t i = 0; i < length; ++i) {
+    const GraphIndex node = builder.add_node(filter);
+    builder.connect(previous, 0, node, 0);
+    previous = node;
+  }
+  return previous;
+}
+}  // namespace kn::test
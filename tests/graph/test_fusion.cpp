@@ -0,0 +1,391 @@
+/**************************************************************************/
+/* test_fusion.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <atomic>
+#include "graph_evaluator.hpp"
+#include "statistics.hpp"
+#include "test_definitions.hpp"
+
+namespace {
+using kn::test::make_definition;
+
+// generator -> invert -> blend -> clamp, with generator -> levels -> blend, and levels also read by blur.
+struct Fixture {
+  Fixture() {
+    generator = library.add(make_definition("generator", 0));
+    invert = library.add(make_definition("invert", 1));
+    blend = library.add(make_definition("blend", 2));
+    clamp = library.add(make_definition("clamp", 1));
+    levels = library.add(make_definition("levels", 1));
+    blur = library.add(make_definition("blur", 1));
+
+    kn::GraphBuilder builder(library);
+    nodes.generator = builder.add_node(generator);
+    nodes.invert = builder.add_node(invert);
+    nodes.levels = builder.add_node(levels);
+    nodes.blend = builder.add_node(blend);
+    nodes.clamp = builder.add_node(clamp);
+    nodes.blur = builder.add_node(blur);
+    builder.connect(nodes.generator, 0, nodes.invert, 0);
+    builder.connect(nodes.generator, 0, nodes.levels, 0);
+    builder.connect(nodes.invert, 0, nodes.blend, 0);
+    builder.connect(nodes.levels, 0, nodes.blend, 1);
+    builder.connect(nodes.blend, 0, nodes.clamp, 0);
+    builder.connect(nodes.levels, 0, nodes.blur, 0);
+    graph = *builder.build();
+
+    evaluator = std::make_unique<kn::GraphEvaluator>(graph, cache);
+    evaluator->set_resolution(300, 200);
+    evaluator->set_kernel(generator, [](const kn::NodeContext& context) {
+      const kn::Region& region = context.region;
+      auto texture = std::make_shared<kn::Texture>(region.width, region.height);
+      for (int32_t y = region.y; y < region.get_bottom(); ++y) {
+        for (int32_t x = region.x; x < region.get_right(); ++x) {
+          const int32_t u = (x % 300 + 300) % 300;
+          const int32_t v = (y % 200 + 200) % 200;
+          const float value = static_cast<float>(u) * 0.004f + static_cast<float>(v) * 0.01f;
+          texture->view().at(x - region.x, y - region.y) = value;
+        }
+      }
+      context.outputs[0] = texture;
+    });
+    evaluator->set_kernel(blur, [](const kn::NodeContext& context) { context.outputs[0] = context.inputs[0]; });
+
+    evaluator->set_pointwise_kernel(invert, {[](const kn::PixelContext& context) {
+                                               for (size_t i = 0; i < context.count; ++i) {
+                                                 context.output[i] = 1.0f - context.inputs[0][i];
+                                               }
+                                             }});
+    evaluator->set_pointwise_kernel(levels, {[](const kn::PixelContext& context) {
+                                               for (size_t i = 0; i < context.count; ++i) {
+                                                 context.output[i] = context.inputs[0][i] * 2.0f - 0.5f;
+                                               }
+                                             }});
+    // Averages its inputs into a color.
+    const auto average = [](const kn::PixelContext& context) {
+      for (size_t i = 0; i < context.count; ++i) {
+        std::fill_n(context.output + i * 3, 3, (context.inputs[0][i] + context.inputs[1][i]) * 0.5f);
+      }
+    };
+    evaluator->set_pointwise_kernel(blend, {average, 3});
+    evaluator->set_pointwise_kernel(clamp, {[](const kn::PixelContext& context) {
+                                              for (size_t i = 0; i < context.count * context.channels; ++i) {
+                                                context.output[i] = std::clamp(context.inputs[0][i], 0.0f, 1.0f);
+                                              }
+                                            }});
+  }
+
+  [[nodiscard]] kn::GraphIndex output(kn::GraphIndex node) const { return *graph.get_outputs(node).begin(); }
+
+  kn::NodeLibrary library;
+  kn::Graph graph;
+  kn::OutputCache cache;
+  std::unique_ptr<kn::GraphEvaluator> evaluator;
+  kn::GraphIndex generator = 0;
+  kn::GraphIndex invert = 0;
+  kn::GraphIndex blend = 0;
+  kn::GraphIndex clamp = 0;
+  kn::GraphIndex levels = 0;
+  kn::GraphIndex blur = 0;
+  struct {
+    kn::GraphIndex generator, invert, levels, blend, clamp, blur;
+  } nodes = {};
+};
+
+float expected(uint32_t x, uint32_t y) {
+  const float value = static_cast<float>(x) * 0.004f + static_cast<float>(y) * 0.01f;
+  return std::clamp(((1.0f - value) + (value * 2.0f - 0.5f)) * 0.5f, 0.0f, 1.0f);
+}
+}  // namespace
+
+TEST_CASE("Fusion groups") {
+  Fixture fixture;
+  const std::vector<uint8_t> pointwise = {0, 1, 1, 1, 1, 0};
+  const std::vector<kn::GraphIndex> groups = kn::find_fusion_groups(fixture.graph, pointwise);
+  CHECK(groups[fixture.nodes.generator] == kn::INVALID_INDEX);
+  CHECK(groups[fixture.nodes.blur] == kn::INVALID_INDEX);
+  CHECK(groups[fixture.nodes.invert] == fixture.nodes.clamp);
+  CHECK(groups[fixture.nodes.blend] == fixture.nodes.clamp);
+  CHECK(groups[fixture.nodes.clamp] == fixture.nodes.clamp);
+  // Blur reads levels too.
+  CHECK(groups[fixture.nodes.levels] == fixture.nodes.levels);
+
+  const kn::GraphIndex kept = fixture.output(fixture.nodes.invert);
+  const std::vector<kn::GraphIndex> kept_groups = kn::find_fusion_groups(fixture.graph, pointwise, {&kept, 1});
+  CHECK(kept_groups[fixture.nodes.invert] == fixture.nodes.invert);
+  CHECK(kept_groups[fixture.nodes.blend] == fixture.nodes.clamp);
+}
+
+TEST_CASE("Fused evaluation") {
+  Fixture fixture;
+  kn::GraphEvaluator& evaluator = *fixture.evaluator;
+
+  const kn::EvaluationStats stats = evaluator.evaluate();
+  CHECK(stats.evaluated == 4);
+  CHECK(stats.fused == 2);
+  CHECK(evaluator.get_output(fixture.output(fixture.nodes.invert)) == nullptr);
+  CHECK(evaluator.get_output(fixture.output(fixture.nodes.blend)) == nullptr);
+  REQUIRE(evaluator.get_output(fixture.output(fixture.nodes.levels)) != nullptr);
+
+  const kn::TexturePtr fused = evaluator.get_output(fixture.output(fixture.nodes.clamp));
+  REQUIRE(fused != nullptr);
+  REQUIRE(fused->get_width() == 300);
+  REQUIRE(fused->get_height() == 200);
+  REQUIRE(fused->get_channels() == 3);
+  uint32_t mismatches = 0;
+  for (uint32_t y = 0; y < 200; ++y) {
+    for (uint32_t x = 0; x < 300; ++x) {
+      for (uint32_t c = 0; c < 3; ++c) {
+        mismatches += fused->view().at(x, y, c) != expected(x, y) ? 1 : 0;
+      }
+    }
+  }
+  CHECK(mismatches == 0);
+
+  SUBCASE("Unfused evaluation gives the same pixels") {
+    evaluator.set_fusion(false);
+    const kn::EvaluationStats unfused_stats = evaluator.evaluate();
+    CHECK(unfused_stats.fused == 0);
+    CHECK(evaluator.get_output(fixture.output(fixture.nodes.blend)) != nullptr);
+    const kn::TexturePtr result = evaluator.get_output(fixture.output(fixture.nodes.clamp));
+    REQUIRE(result != nullptr);
+    CHECK(std::equal(result->get_data(), result->get_data() + 300 * 200 * 3, fused->get_data()));
+  }
+
+  SUBCASE("Regions of fused nodes") {
+    const kn::Region region{250, 150, 100, 80};
+    const kn::TexturePtr texture = evaluator.evaluate_region(fixture.output(fixture.nodes.clamp), region);
+    REQUIRE(texture != nullptr);
+    REQUIRE(texture->get_width() == region.width);
+    uint32_t region_mismatches = 0;
+    for (uint32_t y = 0; y < region.height; ++y) {
+      for (uint32_t x = 0; x < region.width; ++x) {
+        region_mismatches += texture->view().at(x, y, 1) != expected((250 + x) % 300, (150 + y) % 200) ? 1 : 0;
+      }
+    }
+    CHECK(region_mismatches == 0);
+  }
+
+  SUBCASE("Requested outputs of fused nodes") {
+    const std::vector<kn::GraphIndex> outputs = {fixture.output(fixture.nodes.invert),
+                                                 fixture.output(fixture.nodes.clamp)};
+    const std::vector<kn::TexturePtr> textures = evaluator.evaluate_once(outputs);
+    REQUIRE(textures.size() == 2);
+    REQUIRE(textures[0] != nullptr);
+    REQUIRE(textures[1] != nullptr);
+    REQUIRE(textures[0]->get_width() == 300);
+    REQUIRE(textures[0]->get_height() == 200);
+    uint32_t once_mismatches = 0;
+    for (uint32_t y = 0; y < 200; ++y) {
+      for (uint32_t x = 0; x < 300; ++x) {
+        const float value = static_cast<float>(x) * 0.004f + static_cast<float>(y) * 0.01f;
+        once_mismatches += textures[0]->view().at(x, y) != 1.0f - value ? 1 : 0;
+        once_mismatches += textures[1]->view().at(x, y, 2) != expected(x, y) ? 1 : 0;
+      }
+    }
+    CHECK(once_mismatches == 0);
+
+    const kn::Region region{10, 20, 30, 40};
+    const kn::TexturePtr texture = evaluator.evaluate_region(fixture.output(fixture.nodes.blend), region);
+    REQUIRE(texture != nullptr);
+    CHECK(texture->get_channels() == 3);
+    CHECK(texture->view().at(5, 6, 0) == doctest::Approx(expected(15, 26)));
+  }
+
+  SUBCASE("Replacing a point-wise kernel splits the group") {
+    evaluator.set_kernel(fixture.blend, [](const kn::NodeContext& context) { context.outputs[0] = context.inputs[1]; });
+    const kn::EvaluationStats split_stats = evaluator.evaluate();
+    CHECK(split_stats.fused == 0);
+    CHECK(evaluator.get_output(fixture.output(fixture.nodes.invert)) != nullptr);
+  }
+}
+
+TEST_CASE("Uniform textures") {
+  Fixture fixture;
+  kn::GraphEvaluator& evaluator = *fixture.evaluator;
+  evaluator.set_kernel(fixture.generator, [](const kn::NodeContext& context) {
+    context.outputs[0] = std::make_shared<kn::Texture>(context.region.width, context.region.height, 1, 0.25f);
+  });
+  bool uniform_input = false;
+  evaluator.set_kernel(fixture.blur, [&](const kn::NodeContext& context) {
+    uniform_input = context.inputs[0]->is_uniform();
+    context.outputs[0] = context.inputs[0];
+  });
+
+  SUBCASE("Texture") {
+    const std::vector<float> value = {0.5f, 1.0f};
+    kn::Texture texture = kn::Texture::uniform(4, 3, value);
+    CHECK(texture.is_uniform());
+    CHECK(texture.get_stored_size() == 2);
+    CHECK(texture.has_single_value());
+    texture.materialize();
+    CHECK_FALSE(texture.is_uniform());
+    CHECK(texture.get_stored_size() == 4 * 3 * 2);
+    CHECK(texture.view().at(3, 2, 1) == 1.0f);
+    CHECK(texture.has_single_value());
+    texture.view().at(3, 2, 1) = 0.0f;
+    CHECK_FALSE(texture.has_single_value());
+  }
+
+  SUBCASE("Constant outputs are kept uniform") {
+    evaluator.evaluate();
+    CHECK(evaluator.is_uniform_output(fixture.output(fixture.nodes.generator)));
+    // Inputs are materialized for kernels reading pixels.
+    CHECK_FALSE(uniform_input);
+
+    // Outputs handed out are materialized, so that every texture function can view them.
+    CHECK(evaluator.is_uniform_output(fixture.output(fixture.nodes.clamp)));
+    const kn::TexturePtr fused = evaluator.get_output(fixture.output(fixture.nodes.clamp));
+    REQUIRE(fused != nullptr);
+    CHECK_FALSE(fused->is_uniform());
+    CHECK(fused->get_height() == 200);
+    REQUIRE(fused->get_channels() == 3);
+    CHECK(fused->view().at(299, 199, 2) == doctest::Approx(0.375f));
+    const kn::TextureStatistics statistics = kn::compute_statistics(fused->view());
+    CHECK(statistics.channels[2].max == doctest::Approx(0.375f));
+
+    evaluator.set_uniform_inputs(fixture.blur, true);
+    evaluator.invalidate(fixture.nodes.blur);
+    evaluator.evaluate();
+    CHECK(uniform_input);
+  }
+
+  SUBCASE("Detection can be disabled") {
+    evaluator.set_uniform_detection(false);
+    evaluator.evaluate();
+    CHECK_FALSE(evaluator.is_uniform_output(fixture.output(fixture.nodes.generator)));
+    CHECK_FALSE(evaluator.is_uniform_output(fixture.output(fixture.nodes.clamp)));
+  }
+
+  SUBCASE("Regions of uniform outputs") {
+    const kn::Region region{250, 150, 300, 80};
+    const kn::TexturePtr texture = evaluator.evaluate_region(fixture.output(fixture.nodes.clamp), region);
+    REQUIRE(texture != nullptr);
+    CHECK_FALSE(texture->is_uniform());
+    CHECK(texture->get_width() == region.width);
+    CHECK(texture->view().at(299, 79, 0) == doctest::Approx(0.375f));
+  }
+
+  SUBCASE("Uniform inputs of fused kernels are repeated") {
+    std::vector<kn::PointwiseKernel> kernels(fixture.library.get_size());
+    kernels[fixture.blend] = {[](const kn::PixelContext& context) {
+      for (size_t i = 0; i < context.count; ++i) {
+        context.output[i] = context.inputs[0][i] + context.inputs[1][i];
+      }
+    }};
+    const kn::Region region{0, 0, 40, 30};
+    const std::vector<float> value = {2.0f};
+    const auto uniform = std::make_shared<kn::Texture>(kn::Texture::uniform(40, 30, value));
+    auto ramp = std::make_shared<kn::Texture>(40, 30);
+    for (size_t i = 0; i < 40 * 30; ++i) {
+      ramp->get_data()[i] = static_cast<float>(i);
+    }
+    const std::vector<kn::GraphIndex> nodes = {fixture.nodes.blend};
+    const kn::IndexRange inputs = fixture.graph.get_inputs(fixture.nodes.blend);
+    const kn::TexturePtr mixed = kn::run_fused(fixture.graph, nodes, kernels, region, [&](kn::GraphIndex input) {
+      return input == *inputs.begin() ? uniform : kn::TexturePtr(ramp);
+    });
+    REQUIRE(mixed != nullptr);
+    CHECK_FALSE(mixed->is_uniform());
+    CHECK(mixed->view().at(39, 29) == doctest::Approx(40.0f * 30.0f + 1.0f));
+
+    const kn::TexturePtr constant =
+        kn::run_fused(fixture.graph, nodes, kernels, region, [&](kn::GraphIndex) { return uniform; });
+    REQUIRE(constant != nullptr);
+    CHECK(constant->is_uniform());
+    CHECK(constant->get_data()[0] == 4.0f);
+  }
+}
+
+TEST_CASE("Format conversions") {
+  // color -> mask -> tint -> sink, mask reading gray, sink reading color.
+  kn::NodeLibrary library;
+  const kn::GraphIndex color = library.add(make_definition("color", 0));
+  kn::NodeDefinition mask_definition = make_definition("mask", 1);
+  mask_definition.inputs[0].formats = kn::FORMAT_FLOAT;
+  const kn::GraphIndex mask = library.add(mask_definition);
+  const kn::GraphIndex tint = library.add(make_definition("tint", 1));
+  kn::NodeDefinition sink_definition = make_definition("sink", 1);
+  sink_definition.inputs[0].formats = kn::FORMAT_FLOAT3 | kn::FORMAT_FLOAT4;
+  const kn::GraphIndex sink = library.add(sink_definition);
+
+  kn::GraphBuilder builder(library);
+  const kn::GraphIndex nodes[] = {builder.add_node(color), builder.add_node(mask), builder.add_node(tint),
+                                  builder.add_node(sink)};
+  for (size_t i = 0; i + 1 < std::size(nodes); ++i) {
+    builder.connect(nodes[i], 0, nodes[i + 1], 0);
+  }
+  kn::Graph graph = *builder.build();
+  CHECK(graph.get_input_formats(*graph.get_inputs(nodes[1]).begin()) == kn::FORMAT_FLOAT);
+
+  kn::OutputCache cache;
+  kn::GraphEvaluator evaluator(graph, cache);
+  evaluator.set_resolution(64, 64);
+  evaluator.set_kernel(color, [](const kn::NodeContext& context) {
+    auto texture = std::make_shared<kn::Texture>(context.region.width, context.region.height, 4);
+    for (size_t i = 0; i < texture->get_stored_size(); i += 4) {
+      const float ramp = static_cast<float>(i / 4 % 64) / 64.0f;
+      texture->get_data()[i] = ramp;
+      texture->get_data()[i + 1] = 1.0f - ramp;
+      texture->get_data()[i + 2] = 0.0f;
+      texture->get_data()[i + 3] = 1.0f;
+    }
+    context.outputs[0] = texture;
+  });
+  std::atomic<uint32_t> mask_channels{0};
+  evaluator.set_pointwise_kernel(mask, {[&](const kn::PixelContext& context) {
+                                          mask_channels.store(context.input_channels[0]);
+                                          std::copy_n(context.inputs[0], context.count, context.output);
+                                        }});
+  // Keeps the channels it reads.
+  evaluator.set_pointwise_kernel(tint, {[](const kn::PixelContext& context) {
+                                          std::copy_n(context.inputs[0], context.count * context.channels,
+                                                      context.output);
+                                        }});
+  uint32_t sink_channels = 0;
+  float sink_value = 0.0f;
+  evaluator.set_kernel(sink, [&](const kn::NodeContext& context) {
+    sink_channels = context.inputs[0]->get_channels();
+    sink_value = context.inputs[0]->view().at(32, 0, 2);
+    context.outputs[0] = context.inputs[0];
+  });
+  evaluator.evaluate();
+
+  // The color is reduced to gray within the fused kernel, and repeated into color for the sink.
+  CHECK(mask_channels == 1);
+  const kn::TexturePtr tinted = evaluator.get_output(*graph.get_outputs(nodes[2]).begin());
+  REQUIRE(tinted != nullptr);
+  CHECK(tinted->get_channels() == 1);
+  CHECK(sink_channels == 3);
+  CHECK(sink_value == doctest::Approx(0.2126f * 0.5f + 0.7152f * 0.5f));
+}
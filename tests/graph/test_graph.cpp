@@ -0,0 +1,202 @@
+/**************************************************************************/
+/* test_graph.cpp                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <random>
+#include "graph.hpp"
+#include "test_definitions.hpp"
+
+namespace {
+using kn::test::make_definition;
+
+kn::NodeLibrary make_library() {
+  kn::NodeLibrary library;
+  kn::NodeDefinition noise = make_definition("noise", {}, {"height"});
+  kn::test::add_number_parameter(noise, "scale", 1.0);
+  library.add(noise);
+  library.add(make_definition("blend", {"a", "b"}, {"output"}));
+  library.add(make_definition("split", {"input"}, {"red", "green"}));
+  return library;
+}
+}  // namespace
+
+TEST_CASE("Graph layout") {
+  const kn::NodeLibrary library = make_library();
+  const kn::GraphIndex noise = library.find("noise");
+  const kn::GraphIndex blend = library.find("blend");
+  const kn::GraphIndex split = library.find("split");
+
+  SUBCASE("Diamond") {
+    kn::GraphBuilder builder(library);
+    const kn::GraphIndex n0 = builder.add_node(noise, "noise");
+    const kn::GraphIndex n1 = builder.add_node(blend, "blend");
+    const kn::GraphIndex n2 = builder.add_node(split, "split");
+    const kn::GraphIndex n3 = builder.add_node(blend, "final");
+    CHECK(builder.set_parameter(n0, "scale", 4.0));
+    CHECK(!builder.set_parameter(n0, "scale", true));
+    CHECK(!builder.set_parameter(n0, "missing", 4.0));
+    CHECK(builder.connect(n2, "red", n3, "a"));
+    CHECK(builder.connect(n1, "output", n2, "input"));
+    CHECK(builder.connect(n0, "height", n1, "a"));
+    CHECK(builder.connect(n0, "height", n1, "b"));
+    CHECK(builder.connect(n0, "height", n3, "b"));
+    CHECK(!builder.connect(n0, "output", n3, "b"));
+    // Replaces the connection of n3.a.
+    CHECK(builder.connect(n2, "green", n3, "a"));
+
+    const std::optional<kn::Graph> graph = builder.build();
+    REQUIRE(graph.has_value());
+    CHECK(graph->get_node_count() == 4);
+    CHECK(graph->get_input_count() == 5);
+    CHECK(graph->get_output_count() == 5);
+    CHECK(graph->get_edge_count() == 5);
+    CHECK(graph->find_node("split") == n2);
+    CHECK(graph->find_node("missing") == kn::INVALID_INDEX);
+    CHECK(graph->get_definition(n3) == blend);
+
+    // Ports.
+    const kn::GraphIndex height = *graph->get_outputs(n0).begin();
+    CHECK(graph->get_outputs(n2).size() == 2);
+    CHECK(graph->get_inputs(n0).empty());
+    CHECK(graph->get_edges(height).size() == 3);
+    for (const kn::GraphIndex edge : graph->get_edges(height)) {
+      CHECK(graph->get_edge_source(edge) == height);
+      CHECK(graph->get_source(graph->get_edge_target(edge)) == height);
+    }
+    const kn::GraphIndex final_a = *graph->get_inputs(n3).begin();
+    CHECK(graph->get_input_node(final_a) == n3);
+    CHECK(graph->get_source(final_a) == *graph->get_outputs(n2).begin() + 1);
+    CHECK(graph->get_output_node(graph->get_source(final_a)) == n2);
+
+    CHECK(std::get<double>(graph->get_parameters(n0)[0]) == 4.0);
+    CHECK(graph->get_parameters(n1).empty());
+
+    // Adjacency lists hold distinct nodes.
+    CHECK(std::vector(graph->get_successors(n0).begin(), graph->get_successors(n0).end()) ==
+          std::vector<kn::GraphIndex>{n1, n3});
+    CHECK(std::vector(graph->get_predecessors(n1).begin(), graph->get_predecessors(n1).end()) ==
+          std::vector<kn::GraphIndex>{n0});
+    CHECK(std::vector(graph->get_predecessors(n3).begin(), graph->get_predecessors(n3).end()) ==
+          std::vector<kn::GraphIndex>{n0, n2});
+
+    CHECK(graph->get_level_count() == 4);
+    CHECK(graph->get_level(n3) == 3);
+    CHECK(std::vector(graph->get_topological_order().begin(), graph->get_topological_order().end()) ==
+          std::vector<kn::GraphIndex>{n0, n1, n2, n3});
+  }
+
+  SUBCASE("Cycles are rejected") {
+    kn::GraphBuilder builder(library);
+    const kn::GraphIndex n0 = builder.add_node(blend);
+    const kn::GraphIndex n1 = builder.add_node(blend);
+    builder.connect(n0, "output", n1, "a");
+    builder.connect(n1, "output", n0, "a");
+    CHECK(!builder.build().has_value());
+  }
+
+  SUBCASE("Duplicate names are rejected") {
+    kn::GraphBuilder builder(library);
+    builder.add_node(noise, "noise");
+    builder.add_node(noise, "noise");
+    CHECK(!builder.build().has_value());
+  }
+
+  SUBCASE("Large graphs") {
+    // Every node reads two random earlier nodes, added in a shuffled order.
+    constexpr kn::GraphIndex NODE_COUNT = 20000;
+    std::mt19937 rng(7);
+    std::vector<kn::GraphIndex> ranks(NODE_COUNT);
+    for (kn::GraphIndex i = 0; i < NODE_COUNT; ++i) {
+      ranks[i] = i;
+    }
+    std::shuffle(ranks.begin(), ranks.end(), rng);
+    std::vector<kn::GraphIndex> nodes(NODE_COUNT);
+
+    kn::GraphBuilder builder(library);
+    for (kn::GraphIndex i = 0; i < NODE_COUNT; ++i) {
+      nodes[ranks[i]] = builder.add_node(ranks[i] < 16 ? noise : blend);
+    }
+    for (kn::GraphIndex rank = 16; rank < NODE_COUNT; ++rank) {
+      for (kn::GraphIndex input = 0; input < 2; ++input) {
+        builder.connect(nodes[std::uniform_int_distribution<kn::GraphIndex>(0, rank - 1)(rng)], 0, nodes[rank], input);
+      }
+    }
+
+    const std::optional<kn::Graph> graph = builder.build();
+    REQUIRE(graph.has_value());
+    CHECK(graph->get_edge_count() == 2 * (NODE_COUNT - 16));
+
+    std::vector<uint32_t> positions(NODE_COUNT);
+    const auto order = graph->get_topological_order();
+    REQUIRE(order.size() == NODE_COUNT);
+    for (kn::GraphIndex i = 0; i < NODE_COUNT; ++i) {
+      positions[order[i]] = i;
+    }
+    bool sorted = true;
+    for (kn::GraphIndex node = 0; node < NODE_COUNT; ++node) {
+      for (const kn::GraphIndex predecessor : graph->get_predecessors(node)) {
+        sorted &= positions[predecessor] < positions[node] && graph->get_level(predecessor) < graph->get_level(node);
+      }
+    }
+    CHECK(sorted);
+  }
+}
+
+TEST_CASE("Graph documents") {
+  kn::NodeLibrary library = make_library();
+
+  const std::optional<kn::Graph> graph = kn::parse_graph(R"({
+    "nodes": [
+      { "id": "base", "type": "noise", "parameters": { "scale": 8 } },
+      { "id": "detail", "type": "noise" },
+      { "id": "mix", "type": "blend" }
+    ],
+    "edges": [
+      { "from": "base", "output": "height", "to": "mix", "input": "a" },
+      { "from": "detail", "output": "height", "to": "mix", "input": "b" }
+    ]
+  })",
+                                                         library);
+  REQUIRE(graph.has_value());
+  CHECK(graph->get_node_count() == 3);
+  CHECK(std::get<double>(graph->get_parameters(graph->find_node("base"))[0]) == 8.0);
+  CHECK(std::get<double>(graph->get_parameters(graph->find_node("detail"))[0]) == 1.0);
+  CHECK(graph->get_predecessors(graph->find_node("mix")).size() == 2);
+  CHECK(graph->get_level_count() == 2);
+
+  CHECK(!kn::parse_graph(R"({ "nodes": [{ "id": "a", "type": "unknown" }] })", library).has_value());
+  CHECK(!kn::parse_graph(R"({ "nodes": [{ "id": "a", "type": "noise", "parameters": { "size": 1 } }] })", library)
+             .has_value());
+  CHECK(!kn::parse_graph(R"({ "nodes": [{ "id": "a", "type": "blend" }],
+    "edges": [{ "from": "a", "output": "output", "to": "a", "input": "a" }] })",
+                         library)
+             .has_value());
+}
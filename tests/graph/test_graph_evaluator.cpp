@@ -0,0 +1,481 @@
+/**************************************************************************/
+/* test_graph_evaluator.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include "graph_evaluator.hpp"
+#include "patterns.hpp"
+#include "test_definitions.hpp"
+
+namespace {
+struct Fixture {
+  Fixture() {
+    // (c0 + c1) + c2, with sources for the constants and blends for the sums.
+    kn::GraphBuilder builder(definitions.library);
+    c0 = builder.add_node(definitions.source);
+    c1 = builder.add_node(definitions.source);
+    c2 = builder.add_node(definitions.source);
+    sum01 = builder.add_node(definitions.blend);
+    sum = builder.add_node(definitions.blend);
+    builder.set_parameter(c0, "value", 1.0);
+    builder.set_parameter(c1, "value", 2.0);
+    builder.set_parameter(c2, "value", 4.0);
+    builder.connect(c0, 0, sum01, 0);
+    builder.connect(c1, 0, sum01, 1);
+    builder.connect(sum01, 0, sum, 0);
+    builder.connect(c2, 0, sum, 1);
+    graph = *builder.build();
+
+    evaluator = std::make_unique<kn::GraphEvaluator>(graph, cache);
+    set_kernels(*evaluator);
+  }
+
+  void set_kernels(kn::GraphEvaluator& evaluator) {
+    evaluator.set_kernel(
+        definitions.source,
+        [this](const kn::NodeContext& context) {
+          runs.fetch_add(1);
+          context.outputs[0] =
+              std::make_shared<kn::Texture>(1, 1, 1, static_cast<float>(std::get<double>(context.parameters[0])));
+        },
+        "constant/1");
+    evaluator.set_kernel(
+        definitions.blend,
+        [this](const kn::NodeContext& context) {
+          runs.fetch_add(1);
+          float value = 0.0f;
+          for (const kn::TexturePtr& input : context.inputs) {
+            value += input ? input->get_data()[0] : 0.0f;
+          }
+          context.outputs[0] = std::make_shared<kn::Texture>(1, 1, 1, value);
+        },
+        "add/1");
+  }
+
+  [[nodiscard]] float result() const { return evaluator->get_output(*graph.get_outputs(sum).begin())->get_data()[0]; }
+
+  kn::test::TestLibrary definitions;
+  kn::Graph graph;
+  kn::OutputCache cache;
+  std::unique_ptr<kn::GraphEvaluator> evaluator;
+  std::atomic<uint32_t> runs{0};
+  kn::GraphIndex c0 = 0;
+  kn::GraphIndex c1 = 0;
+  kn::GraphIndex c2 = 0;
+  kn::GraphIndex sum01 = 0;
+  kn::GraphIndex sum = 0;
+};
+}  // namespace
+
+TEST_CASE("Incremental evaluation") {
+  Fixture fixture;
+  kn::GraphEvaluator& evaluator = *fixture.evaluator;
+
+  kn::EvaluationStats stats = evaluator.evaluate();
+  CHECK(stats.evaluated == 5);
+  CHECK(fixture.result() == 7.0f);
+  CHECK(evaluator.get_version(fixture.sum) == 1);
+
+  SUBCASE("Only the nodes downstream of an edit run") {
+    CHECK(evaluator.set_parameter(fixture.c2, 0, 8.0));
+    CHECK(evaluator.is_dirty(fixture.c2));
+    CHECK(evaluator.is_dirty(fixture.sum));
+    CHECK(!evaluator.is_dirty(fixture.sum01));
+    fixture.runs = 0;
+    stats = evaluator.evaluate();
+    CHECK(stats.evaluated == 2);
+    CHECK(fixture.runs == 2);
+    CHECK(fixture.result() == 11.0f);
+    CHECK(evaluator.get_version(fixture.sum) == 2);
+    CHECK(evaluator.get_version(fixture.sum01) == 1);
+  }
+
+  SUBCASE("Previous states are served from the cache") {
+    evaluator.set_parameter(fixture.c0, 0, 5.0);
+    CHECK(evaluator.evaluate().evaluated == 3);
+    CHECK(fixture.result() == 11.0f);
+
+    evaluator.set_parameter(fixture.c0, 0, 1.0);
+    fixture.runs = 0;
+    stats = evaluator.evaluate();
+    CHECK(stats.evaluated == 0);
+    CHECK(stats.cached == 3);
+    CHECK(fixture.runs == 0);
+    CHECK(fixture.result() == 7.0f);
+  }
+
+  SUBCASE("Unchanged values do not dirty nodes") {
+    CHECK(evaluator.set_parameter(fixture.c1, 0, 2.0));
+    CHECK(!evaluator.is_dirty(fixture.c1));
+    CHECK(!evaluator.set_parameter(fixture.c1, 0, true));
+    stats = evaluator.evaluate();
+    CHECK(stats.evaluated == 0);
+    CHECK(stats.cached == 0);
+  }
+
+  SUBCASE("Invalidated nodes run again") {
+    evaluator.invalidate(fixture.c1);
+    stats = evaluator.evaluate();
+    CHECK(stats.evaluated == 3);
+    CHECK(fixture.result() == 7.0f);
+
+    // The outputs computed before the invalidation are stale for a graph opened again too.
+    fixture.evaluator = std::make_unique<kn::GraphEvaluator>(fixture.graph, fixture.cache);
+    fixture.set_kernels(*fixture.evaluator);
+    stats = fixture.evaluator->evaluate();
+    CHECK(stats.evaluated == 3);
+    CHECK(stats.cached == 2);
+    CHECK(fixture.result() == 7.0f);
+  }
+
+  SUBCASE("Replaced kernels run again") {
+    evaluator.set_kernel(fixture.definitions.source, [](const kn::NodeContext& context) {
+      context.outputs[0] =
+          std::make_shared<kn::Texture>(1, 1, 1, 2.0f * static_cast<float>(std::get<double>(context.parameters[0])));
+    });
+    CHECK(evaluator.is_dirty(fixture.c0));
+    stats = evaluator.evaluate();
+    CHECK(stats.evaluated == 5);
+    CHECK(stats.cached == 0);
+    CHECK(fixture.result() == 14.0f);
+  }
+
+  SUBCASE("A graph opened again is served from the cache") {
+    fixture.evaluator = std::make_unique<kn::GraphEvaluator>(fixture.graph, fixture.cache);
+    fixture.set_kernels(*fixture.evaluator);
+    fixture.runs = 0;
+    stats = fixture.evaluator->evaluate();
+    CHECK(stats.evaluated == 0);
+    CHECK(stats.cached == 5);
+    CHECK(fixture.runs == 0);
+    CHECK(fixture.result() == 7.0f);
+  }
+}
+
+TEST_CASE("Shared output cache") {
+  kn::OutputCache& cache = *kn::OutputCache::get_instance();
+  Fixture fixture;
+  fixture.evaluator = std::make_unique<kn::GraphEvaluator>(fixture.graph, cache);
+  fixture.set_kernels(*fixture.evaluator);
+  // Subcases run the test again, whose first evaluation then reads the shared cache.
+  const kn::EvaluationStats stats = fixture.evaluator->evaluate();
+  CHECK(stats.evaluated + stats.cached == 5);
+  CHECK(fixture.result() == 7.0f);
+
+  SUBCASE("A graph opened again is served from the shared cache") {
+    kn::GraphEvaluator evaluator(fixture.graph, cache);
+    fixture.set_kernels(evaluator);
+    const kn::EvaluationStats reopened_stats = evaluator.evaluate();
+    CHECK(reopened_stats.evaluated == 0);
+    CHECK(reopened_stats.cached == 5);
+  }
+
+  SUBCASE("Kernels of another version run again") {
+    kn::GraphEvaluator evaluator(fixture.graph, cache);
+    fixture.set_kernels(evaluator);
+    evaluator.set_kernel(
+        fixture.definitions.source,
+        [](const kn::NodeContext& context) {
+          const auto value = static_cast<float>(std::get<double>(context.parameters[0]));
+          context.outputs[0] = std::make_shared<kn::Texture>(1, 1, 1, 2.0f * value);
+        },
+        "constant/2");
+    CHECK(evaluator.evaluate().evaluated == 5);
+    CHECK(evaluator.get_output(*fixture.graph.get_outputs(fixture.sum).begin())->get_data()[0] == 14.0f);
+  }
+
+  SUBCASE("Definitions of another library do not collide") {
+    // The definition has the index, parameters and kernel version of the constants of the fixture.
+    kn::NodeLibrary library;
+    kn::NodeDefinition offset = fixture.definitions.library.get(fixture.definitions.source);
+    offset.id = "offset";
+    const kn::GraphIndex definition = library.add(offset);
+    kn::GraphBuilder builder(library);
+    const kn::GraphIndex node = builder.add_node(definition);
+    builder.set_parameter(node, "value", 1.0);
+    kn::Graph graph = *builder.build();
+
+    kn::GraphEvaluator evaluator(graph, cache);
+    evaluator.set_kernel(
+        definition,
+        [](const kn::NodeContext& context) {
+          const auto value = static_cast<float>(std::get<double>(context.parameters[0]));
+          context.outputs[0] = std::make_shared<kn::Texture>(1, 1, 1, value + 10.0f);
+        },
+        "constant/1");
+    CHECK(evaluator.evaluate().evaluated == 1);
+    CHECK(evaluator.get_output(*graph.get_outputs(node).begin())->get_data()[0] == 11.0f);
+  }
+}
+
+TEST_CASE("Multi-resolution export") {
+  Fixture fixture;
+  kn::GraphEvaluator& evaluator = *fixture.evaluator;
+  std::vector<std::pair<uint32_t, uint32_t>> sizes;
+  std::mutex mutex;
+  // Constants and sums of the size of the whole texture.
+  const auto full_size = [&](const kn::NodeContext& context) {
+    {
+      std::lock_guard lock(mutex);
+      sizes.emplace_back(context.width, context.height);
+    }
+    float value = context.inputs.empty() ? static_cast<float>(std::get<double>(context.parameters[0])) : 0.0f;
+    for (const kn::TexturePtr& input : context.inputs) {
+      value += input ? input->get_data()[0] : 0.0f;
+    }
+    context.outputs[0] = std::make_shared<kn::Texture>(context.width, context.height, 1, value);
+  };
+  evaluator.set_kernel(fixture.definitions.source, full_size);
+  evaluator.set_kernel(fixture.definitions.blend, full_size);
+
+  const std::vector<kn::Resolution> resolutions = {{16, 16}, {64, 32}, {32, 16}};
+  const std::vector<kn::GraphIndex> outputs = {*fixture.graph.get_outputs(fixture.sum).begin(),
+                                               *fixture.graph.get_outputs(fixture.sum01).begin()};
+  std::map<std::pair<kn::GraphIndex, size_t>, std::pair<kn::Resolution, float>> encoded;
+  evaluator.evaluate_resolutions(outputs, resolutions, {kn::ResampleFilter::Area},
+                                 [&](kn::GraphIndex output, size_t index, const kn::TextureView& texture) {
+                                   std::lock_guard lock(mutex);
+                                   encoded[{output, index}] = {{texture.width, texture.height}, texture.at(0, 0)};
+                                 });
+
+  // Every node ran once, at the largest resolution.
+  CHECK(sizes.size() == 5);
+  for (const auto& [width, height] : sizes) {
+    CHECK(width == 64);
+    CHECK(height == 32);
+  }
+  REQUIRE(encoded.size() == 6);
+  for (size_t index = 0; index < resolutions.size(); ++index) {
+    const auto& [resolution, value] = encoded[{outputs[0], index}];
+    CHECK(resolution.width == resolutions[index].width);
+    CHECK(resolution.height == resolutions[index].height);
+    CHECK(value == doctest::Approx(7.0f));
+    CHECK(encoded[{outputs[1], index}].second == doctest::Approx(3.0f));
+  }
+
+  // The incremental evaluation keeps its own resolution.
+  sizes.clear();
+  evaluator.evaluate();
+  REQUIRE(!sizes.empty());
+  CHECK(sizes.front().first == 1024);
+}
+
+TEST_CASE("Region evaluation") {
+  // A gradient blurred twice.
+  const kn::test::TestLibrary definitions;
+  const kn::GraphIndex gradient_index = definitions.source;
+  const kn::GraphIndex blur_index = definitions.filter;
+
+  kn::GraphBuilder builder(definitions.library);
+  const kn::GraphIndex source = builder.add_node(gradient_index);
+  const kn::GraphIndex blur0 = builder.add_node(blur_index);
+  const kn::GraphIndex blur1 = builder.add_node(blur_index);
+  builder.connect(source, 0, blur0, 0);
+  builder.connect(blur0, 0, blur1, 0);
+  kn::Graph graph = *builder.build();
+  const kn::GraphIndex output = *graph.get_outputs(blur1).begin();
+
+  kn::OutputCache cache;
+  kn::GraphEvaluator evaluator(graph, cache);
+  evaluator.set_resolution(1024, 512);
+
+  std::atomic<size_t> source_pixels{0};
+  evaluator.set_kernel(gradient_index, [&](const kn::NodeContext& context) {
+    const kn::Region& region = context.region;
+    auto texture = std::make_shared<kn::Texture>(region.width, region.height);
+    kn::PatternOptions options;
+    options.supersampling = 1;
+    options.width = context.width;
+    options.height = context.height;
+    options.x = static_cast<uint32_t>((region.x % static_cast<int32_t>(context.width) + context.width) % context.width);
+    options.y =
+        static_cast<uint32_t>((region.y % static_cast<int32_t>(context.height) + context.height) % context.height);
+    kn::generate_pattern(kn::LinearGradientPattern{1, 1, false}, texture->view(), options);
+    source_pixels.fetch_add(texture->get_width() * texture->get_height());
+    context.outputs[0] = texture;
+  });
+  // 3x3 box filter, reading a pixel around the region.
+  evaluator.set_kernel(blur_index, [](const kn::NodeContext& context) {
+    const kn::Region& region = context.region;
+    const kn::Region& input_region = context.input_regions[0];
+    const kn::TextureView input = context.inputs[0]->view();
+    auto texture = std::make_shared<kn::Texture>(region.width, region.height);
+    for (int32_t y = region.y; y < region.get_bottom(); ++y) {
+      for (int32_t x = region.x; x < region.get_right(); ++x) {
+        float sum = 0.0f;
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+          for (int32_t dx = -1; dx <= 1; ++dx) {
+            sum += input.fetch_wrap(x + dx - input_region.x, y + dy - input_region.y);
+          }
+        }
+        texture->view().at(x - region.x, y - region.y) = sum / 9.0f;
+      }
+    }
+    context.outputs[0] = texture;
+  });
+  evaluator.set_footprint(blur_index,
+                          [](const kn::NodeContext& context, kn::GraphIndex) { return context.region.expanded(1); });
+
+  evaluator.evaluate();
+  const kn::TexturePtr full = evaluator.get_output(output);
+  REQUIRE(full != nullptr);
+  CHECK(source_pixels == 1024 * 512);
+
+  const auto check_region = [&](const kn::Region& region) {
+    const kn::TexturePtr texture = evaluator.evaluate_region(output, region);
+    REQUIRE(texture != nullptr);
+    REQUIRE(texture->get_width() == region.width);
+    REQUIRE(texture->get_height() == region.height);
+    uint32_t mismatches = 0;
+    for (uint32_t y = 0; y < region.height; ++y) {
+      for (uint32_t x = 0; x < region.width; ++x) {
+        mismatches += texture->view().at(x, y) != full->view().fetch_wrap(region.x + x, region.y + y) ? 1 : 0;
+      }
+    }
+    CHECK(mismatches == 0);
+  };
+
+  SUBCASE("Only the footprint of the region is computed") {
+    source_pixels = 0;
+    check_region({300, 200, 100, 50});
+    CHECK(source_pixels == 104 * 54);
+
+    // Tiles of the same region are cached.
+    source_pixels = 0;
+    check_region({300, 200, 100, 50});
+    CHECK(source_pixels == 0);
+  }
+
+  SUBCASE("Regions spanning several tiles") {
+    source_pixels = 0;
+    check_region({200, 100, 400, 300});
+    CHECK(source_pixels == 404 * 304);
+  }
+
+  SUBCASE("Regions crossing the borders wrap around") {
+    check_region({-10, 500, 40, 30});
+  }
+}
+
+TEST_CASE("Output cache") {
+  kn::OutputCache cache;
+  cache.set_disk_budget(0);
+  const auto texture = std::make_shared<const kn::Texture>(1, 1);
+  cache.insert(1, {texture}, 1.0);
+  cache.insert(2, {nullptr}, 1.0);
+
+  std::vector<kn::TexturePtr> outputs;
+  CHECK(cache.find(1, outputs));
+  CHECK(outputs == std::vector<kn::TexturePtr>{texture});
+  CHECK(!cache.find(4, outputs));
+
+  SUBCASE("Entries cheap to compute per byte are evicted first") {
+    cache.set_memory_budget(cache.get_stats().memory_bytes);
+    // 3 takes no time to compute again.
+    cache.insert(3, {}, 0.0);
+    CHECK(cache.get_size() == 2);
+    CHECK(!cache.find(3, outputs));
+    cache.insert(3, {}, 10.0);
+    CHECK(cache.get_size() == 2);
+    CHECK(cache.find(3, outputs));
+    CHECK(cache.find(1, outputs) != cache.find(2, outputs));
+
+    const kn::OutputCacheStats stats = cache.get_stats();
+    CHECK(stats.hits == 3);
+    CHECK(stats.misses == 3);
+    CHECK(stats.evictions == 2);
+    CHECK(stats.discards == 2);
+    CHECK(stats.spills == 0);
+  }
+
+  SUBCASE("Clear drops every entry") {
+    cache.clear();
+    CHECK(cache.get_size() == 0);
+    CHECK(cache.get_stats().memory_bytes == 0);
+    CHECK(!cache.find(1, outputs));
+  }
+}
+
+TEST_CASE("Output cache spill") {
+  const std::filesystem::path directory = std::filesystem::temp_directory_path() / "knoodle_test_output_cache";
+  std::filesystem::remove_all(directory);
+
+  {
+    kn::OutputCache cache;
+    cache.set_scratch_directory(directory);
+    cache.set_memory_budget(0);
+
+    auto texture = std::make_shared<kn::Texture>(4, 2, 3);
+    for (size_t i = 0; i < 4 * 2 * 3; ++i) {
+      texture->get_data()[i] = static_cast<float>(i);
+    }
+    cache.insert(1, {texture, nullptr}, 1.0);
+    CHECK(cache.get_size() == 0);
+    kn::OutputCacheStats stats = cache.get_stats();
+    CHECK(stats.evictions == 1);
+    CHECK(stats.spills == 1);
+    CHECK(stats.disk_bytes == 4 * 2 * 3 * sizeof(float));
+    CHECK(!std::filesystem::is_empty(directory));
+
+    // The entry is read back and kept in memory if the budget allows it.
+    cache.set_memory_budget(1 << 20);
+    std::vector<kn::TexturePtr> outputs;
+    REQUIRE(cache.find(1, outputs));
+    REQUIRE(outputs.size() == 2);
+    CHECK(outputs[1] == nullptr);
+    REQUIRE(outputs[0] != nullptr);
+    CHECK(outputs[0]->get_width() == 4);
+    CHECK(outputs[0]->get_height() == 2);
+    CHECK(outputs[0]->get_channels() == 3);
+    CHECK(std::equal(outputs[0]->get_data(), outputs[0]->get_data() + 4 * 2 * 3, texture->get_data()));
+    CHECK(cache.get_size() == 1);
+    stats = cache.get_stats();
+    CHECK(stats.reloads == 1);
+    CHECK(stats.disk_bytes == 0);
+    CHECK(std::filesystem::is_empty(directory));
+
+    // Spilled entries beyond the disk budget are dropped, oldest first.
+    cache.set_disk_budget(4 * 2 * 3 * sizeof(float));
+    cache.insert(2, {texture}, 1.0);
+    cache.set_memory_budget(0);
+    stats = cache.get_stats();
+    CHECK(stats.spills == 3);
+    CHECK(stats.discards == 1);
+    CHECK(!cache.find(1, outputs));
+    CHECK(cache.find(2, outputs));
+  }
+
+  // Scratch files go away with the cache.
+  CHECK(!std::filesystem::exists(directory));
+}
@@ -0,0 +1,165 @@
+/**************************************************************************/
+/* test_graph_optimizer.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <limits>
+#include "graph_optimizer.hpp"
+#include "test_definitions.hpp"
+
+namespace {
+using kn::test::make_definition;
+
+struct Fixture {
+  Fixture() {
+    kn::NodeDefinition uniform_definition = make_definition("uniform", 0);
+    uniform_definition.parameters.push_back(
+        {"Color", "color", kn::ParameterType::Color, std::array<float, 4>{}, {}, {}, {}});
+    uniform_definition.parameters.push_back({"Channels", "channels", kn::ParameterType::Number, 4.0, {}, {}, {}});
+    kn::NodeDefinition noise_definition = make_definition("noise", 0);
+    noise_definition.parameters.push_back({"Seed", "seed", kn::ParameterType::Number, 0.0, {}, {}, {}});
+    uniform = library.add(uniform_definition);
+    noise = library.add(noise_definition);
+    invert = library.add(make_definition("invert", 1));
+    blend = library.add(make_definition("blend", 2));
+
+    pointwise.resize(library.get_size());
+    pointwise[invert] = {[](const kn::PixelContext& context) {
+      for (size_t i = 0; i < context.count * context.channels; ++i) {
+        context.output[i] = 1.0f - context.inputs[0][i];
+      }
+    }};
+    pointwise[blend] = {[](const kn::PixelContext& context) {
+      for (size_t i = 0; i < context.count * context.channels; ++i) {
+        context.output[i] = (context.inputs[0][i] + context.inputs[1][i]) * 0.5f;
+      }
+    }};
+    options.uniform_definition = uniform;
+    options.pointwise = pointwise;
+  }
+
+  kn::NodeLibrary library;
+  std::vector<kn::PointwiseKernel> pointwise;
+  kn::OptimizerOptions options;
+  kn::GraphIndex uniform = 0;
+  kn::GraphIndex noise = 0;
+  kn::GraphIndex invert = 0;
+  kn::GraphIndex blend = 0;
+};
+}  // namespace
+
+TEST_CASE("Graph optimization") {
+  Fixture fixture;
+
+  // blend(noise 3, invert(uniform)) twice, with a second noise of the same seed, and an unused branch.
+  kn::GraphBuilder builder(fixture.library);
+  const kn::GraphIndex noise0 = builder.add_node(fixture.noise, "noise0");
+  const kn::GraphIndex noise1 = builder.add_node(fixture.noise, "noise1");
+  const kn::GraphIndex noise2 = builder.add_node(fixture.noise, "noise2");
+  const kn::GraphIndex uniform = builder.add_node(fixture.uniform, "uniform");
+  const kn::GraphIndex inverted = builder.add_node(fixture.invert, "inverted");
+  const kn::GraphIndex unused = builder.add_node(fixture.invert, "unused");
+  const kn::GraphIndex blend0 = builder.add_node(fixture.blend, "blend0");
+  const kn::GraphIndex blend1 = builder.add_node(fixture.blend, "blend1");
+  builder.set_parameter(noise0, "seed", 3.0);
+  builder.set_parameter(noise1, "seed", 3.0);
+  builder.set_parameter(noise2, "seed", 4.0);
+  builder.set_parameter(uniform, "color", std::array<float, 4>{0.25f, 0.5f, 0.0f, 0.0f});
+  builder.set_parameter(uniform, "channels", 2.0);
+  builder.connect(uniform, 0, inverted, 0);
+  builder.connect(noise2, 0, unused, 0);
+  builder.connect(noise0, 0, blend0, 0);
+  builder.connect(inverted, 0, blend0, 1);
+  builder.connect(noise1, 0, blend1, 0);
+  builder.connect(inverted, 0, blend1, 1);
+  const kn::Graph graph = *builder.build();
+  const std::vector<kn::GraphIndex> outputs = {*graph.get_outputs(blend0).begin(), *graph.get_outputs(blend1).begin()};
+
+  SUBCASE("Every optimization") {
+    const kn::OptimizedGraph optimized = kn::optimize_graph(graph, fixture.library, outputs, fixture.options);
+    CHECK(optimized.graph.get_node_count() == 3);
+    CHECK(optimized.report.dead_nodes == std::vector<kn::GraphIndex>{noise2, uniform, unused});
+    CHECK(optimized.report.folded_nodes == std::vector<kn::GraphIndex>{inverted});
+    CHECK(optimized.report.merged_nodes ==
+          std::vector<std::pair<kn::GraphIndex, kn::GraphIndex>>{{noise1, noise0}, {blend1, blend0}});
+
+    // Both outputs are the same port, computed from the first noise.
+    CHECK(optimized.outputs[outputs[0]] != kn::INVALID_INDEX);
+    CHECK(optimized.outputs[outputs[0]] == optimized.outputs[outputs[1]]);
+    CHECK(optimized.nodes[noise1] == optimized.nodes[noise0]);
+    CHECK(optimized.nodes[unused] == kn::INVALID_INDEX);
+    CHECK(optimized.graph.find_node("noise0") == optimized.nodes[noise0]);
+
+    // The inversion is now a uniform node.
+    const kn::GraphIndex folded = optimized.nodes[inverted];
+    CHECK(optimized.graph.get_definition(folded) == fixture.uniform);
+    CHECK(optimized.graph.get_inputs(folded).empty());
+    CHECK(optimized.graph.get_parameters(folded)[0] ==
+          kn::ParameterValue(std::array<float, 4>{0.75f, 0.5f, 0.0f, 0.0f}));
+    CHECK(optimized.graph.get_parameters(folded)[1] == kn::ParameterValue(2.0));
+    const kn::GraphIndex blend = optimized.nodes[blend0];
+    CHECK(optimized.graph.get_output_node(optimized.graph.get_source(*optimized.graph.get_inputs(blend).begin() + 1)) ==
+          folded);
+  }
+
+  SUBCASE("Without folding") {
+    const kn::OptimizedGraph optimized = kn::optimize_graph(graph, fixture.library, outputs);
+    CHECK(optimized.graph.get_node_count() == 4);
+    CHECK(optimized.report.dead_nodes == std::vector<kn::GraphIndex>{noise2, unused});
+    CHECK(optimized.report.folded_nodes.empty());
+    CHECK(optimized.report.merged_nodes.size() == 2);
+  }
+
+  SUBCASE("Different parameters are kept apart") {
+    const std::vector<kn::GraphIndex> noise_outputs = {*graph.get_outputs(noise0).begin(),
+                                                       *graph.get_outputs(noise2).begin()};
+    const kn::OptimizedGraph optimized = kn::optimize_graph(graph, fixture.library, noise_outputs);
+    CHECK(optimized.graph.get_node_count() == 2);
+    CHECK(optimized.report.merged_nodes.empty());
+  }
+}
+
+TEST_CASE("NaN parameters are merged") {
+  Fixture fixture;
+  kn::GraphBuilder builder(fixture.library);
+  const kn::GraphIndex noise0 = builder.add_node(fixture.noise);
+  const kn::GraphIndex noise1 = builder.add_node(fixture.noise);
+  const kn::GraphIndex noise2 = builder.add_node(fixture.noise);
+  builder.set_parameter(noise0, "seed", std::numeric_limits<double>::quiet_NaN());
+  builder.set_parameter(noise1, "seed", std::numeric_limits<double>::quiet_NaN());
+  builder.set_parameter(noise2, "seed", 1.0);
+  const kn::Graph graph = *builder.build();
+  const std::vector<kn::GraphIndex> outputs = {*graph.get_outputs(noise0).begin(), *graph.get_outputs(noise1).begin(),
+                                               *graph.get_outputs(noise2).begin()};
+
+  const kn::OptimizedGraph optimized = kn::optimize_graph(graph, fixture.library, outputs);
+  CHECK(optimized.graph.get_node_count() == 2);
+  CHECK(optimized.report.merged_nodes == std::vector<std::pair<kn::GraphIndex, kn::GraphIndex>>{{noise1, noise0}});
+}
@@ -0,0 +1,136 @@
+/**************************************************************************/
+/* test_graph_scheduler.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <random>
+#include "graph_scheduler.hpp"
+#include "test_definitions.hpp"
+#include "threading/parallel_for.hpp"
+
+TEST_CASE("Graph scheduling") {
+  const kn::test::TestLibrary definitions;
+  const kn::NodeLibrary& library = definitions.library;
+
+  SUBCASE("Nodes run after the nodes they read") {
+    constexpr kn::GraphIndex NODE_COUNT = 2000;
+    std::mt19937 rng(3);
+    kn::GraphBuilder builder(library);
+    for (kn::GraphIndex node = 0; node < NODE_COUNT; ++node) {
+      builder.add_node(node < 8 ? definitions.source : definitions.blend);
+    }
+    for (kn::GraphIndex node = 8; node < NODE_COUNT; ++node) {
+      for (kn::GraphIndex input = 0; input < 2; ++input) {
+        builder.connect(std::uniform_int_distribution<kn::GraphIndex>(0, node - 1)(rng), 0, node, input);
+      }
+    }
+    const std::optional<kn::Graph> graph = builder.build();
+    REQUIRE(graph.has_value());
+
+    // Every node also runs tile tasks, which share the workers with the nodes.
+    kn::TaskScheduler scheduler(3);
+    std::vector<std::atomic<uint32_t>> done(NODE_COUNT);
+    std::atomic<uint32_t> misordered{0};
+    kn::run_graph(
+        *graph,
+        [&](kn::GraphIndex node) {
+          for (const kn::GraphIndex predecessor : graph->get_predecessors(node)) {
+            misordered.fetch_add(done[predecessor].load() == 0 ? 1 : 0);
+          }
+          std::atomic<uint32_t> tiles{0};
+          kn::TaskGroup group;
+          for (uint32_t tile = 0; tile < 4; ++tile) {
+            scheduler.submit(group, [&tiles]() { tiles.fetch_add(1); });
+          }
+          scheduler.wait(group);
+          done[node].store(tiles.load());
+        },
+        scheduler);
+
+    CHECK(misordered.load() == 0);
+    bool complete = true;
+    for (const auto& tiles : done) {
+      complete &= tiles.load() == 4;
+    }
+    CHECK(complete);
+  }
+
+  SUBCASE("Independent branches run concurrently") {
+    // Eight chains of four nodes.
+    kn::GraphBuilder builder(library);
+    for (kn::GraphIndex chain = 0; chain < 8; ++chain) {
+      kn::test::add_chain(builder, definitions.source, definitions.filter, 3);
+    }
+    const std::optional<kn::Graph> graph = builder.build();
+    REQUIRE(graph.has_value());
+
+    kn::TaskScheduler scheduler(3);
+    std::atomic<uint32_t> running{0};
+    std::atomic<uint32_t> peak{0};
+    std::atomic<uint32_t> count{0};
+    kn::run_graph(
+        *graph,
+        [&](kn::GraphIndex) {
+          const uint32_t now = running.fetch_add(1) + 1;
+          uint32_t previous = peak.load();
+          while (now > previous && !peak.compare_exchange_weak(previous, now)) {
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+          running.fetch_sub(1);
+          count.fetch_add(1);
+        },
+        scheduler);
+    CHECK(count.load() == 32);
+    CHECK(peak.load() > 1);
+  }
+
+  SUBCASE("Subsets of nodes") {
+    kn::GraphBuilder builder(library);
+    const kn::GraphIndex source = builder.add_node(definitions.source);
+    const kn::GraphIndex middle = builder.add_node(definitions.filter);
+    const kn::GraphIndex sink = builder.add_node(definitions.filter);
+    builder.connect(source, 0, middle, 0);
+    builder.connect(middle, 0, sink, 0);
+    const std::optional<kn::Graph> graph = builder.build();
+    REQUIRE(graph.has_value());
+
+    std::vector<kn::GraphIndex> order;
+    const std::vector<kn::GraphIndex> nodes = {sink, middle};
+    kn::run_graph(*graph, nodes, [&](kn::GraphIndex node) { order.push_back(node); });
+    CHECK(order == std::vector<kn::GraphIndex>{middle, sink});
+  }
+
+  SUBCASE("Empty graphs") {
+    const std::optional<kn::Graph> graph = kn::GraphBuilder(library).build();
+    REQUIRE(graph.has_value());
+    kn::run_graph(*graph, [](kn::GraphIndex) { FAIL("No node to run"); });
+  }
+}
@@ -0,0 +1,161 @@
+/**************************************************************************/
+/* test_node_definition.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <fstream>
+#include "node_definition.hpp"
+#include "node_library.hpp"
+
+namespace {
+constexpr const char* BLEND_NODE = R"({
+  "name": "Blend",
+  "id": "blend",
+  "description": "Blends two textures.",
+  "category": "Filters",
+  "parameters": [
+    { "name": "Mode", "id": "mode", "type": "Enum", "values": ["Normal", "Multiply"] },
+    { "name": "Opacity", "id": "opacity", "type": "Slider", "default": 0.5, "min": 0, "max": 1 },
+    { "name": "Tint", "id": "tint", "type": "Color", "default": [1, 0.5, 0.25] },
+    { "name": "Clamp", "id": "clamp", "type": "Boolean", "default": true }
+  ],
+  "inputs": [
+    { "name": "Foreground", "id": "foreground", "required": true, "formats": ["float", "float4"] },
+    { "name": "Background", "id": "background", "formats": ["float3"] }
+  ],
+  "outputs": [
+    {
+      "name": "Output",
+      "id": "output",
+      "evaluation": {
+        "type": "compute_shader",
+        "filename": "blend.kshader",
+        "binds": [{ "name": "opacity", "slot": 0, "range": [0, 1] }],
+        "permutations": [{ "id": "multiply", "if": "mode == Multiply", "definitions": ["MULTIPLY"] }]
+      }
+    }
+  ]
+})";
+}  // namespace
+
+TEST_CASE("Node definitions") {
+  SUBCASE("Parses every field of the schema") {
+    const std::optional<kn::NodeDefinition> definition = kn::parse_node_definition(BLEND_NODE);
+    REQUIRE(definition.has_value());
+    CHECK(definition->name == "Blend");
+    CHECK(definition->id == "blend");
+    CHECK(definition->category == "Filters");
+    CHECK(definition->author.empty());
+
+    REQUIRE(definition->parameters.size() == 4);
+    CHECK(definition->parameters[0].type == kn::ParameterType::Enum);
+    CHECK(std::get<std::string>(definition->parameters[0].default_value) == "Normal");
+    CHECK(definition->parameters[1].type == kn::ParameterType::Slider);
+    CHECK(std::get<double>(definition->parameters[1].default_value) == 0.5);
+    CHECK(definition->parameters[1].max == 1.0);
+    CHECK(std::get<std::array<float, 4>>(definition->parameters[2].default_value) ==
+          std::array<float, 4>{1.0f, 0.5f, 0.25f, 1.0f});
+    CHECK(std::get<bool>(definition->parameters[3].default_value));
+
+    REQUIRE(definition->inputs.size() == 2);
+    CHECK(definition->inputs[0].required);
+    CHECK(definition->inputs[0].formats == (kn::FORMAT_FLOAT | kn::FORMAT_FLOAT4));
+    CHECK(!definition->inputs[1].required);
+    CHECK(definition->inputs[1].formats == kn::FORMAT_FLOAT3);
+
+    REQUIRE(definition->outputs.size() == 1);
+    const kn::EvaluationDefinition& evaluation = definition->outputs[0].evaluation;
+    CHECK(evaluation.type == kn::EvaluationType::ComputeShader);
+    CHECK(evaluation.filename == "blend.kshader");
+    REQUIRE(evaluation.binds.size() == 1);
+    CHECK(evaluation.binds[0].at("slot") == "0");
+    REQUIRE(evaluation.permutations.size() == 1);
+    CHECK(evaluation.permutations[0].condition == "mode == Multiply");
+    CHECK(evaluation.permutations[0].definitions == std::vector<std::string>{"MULTIPLY"});
+
+    CHECK(definition->find_parameter("opacity") == 1);
+    CHECK(definition->find_input("background") == 1);
+    CHECK(definition->find_output("output") == 0);
+    CHECK(definition->find_output("missing") == kn::INVALID_INDEX);
+  }
+
+  SUBCASE("Rejects documents that do not follow the schema") {
+    CHECK(!kn::parse_node_definition(R"({ "name": "Empty", "id": "empty" })").has_value());
+    CHECK(!kn::parse_node_definition(R"({ "name": "Bad", "id": "bad", "outputs": [
+      { "name": "Output", "id": "output", "evaluation": { "type": "glsl" } }
+    ] })")
+               .has_value());
+    CHECK(!kn::parse_node_definition("[1, 2").has_value());
+  }
+}
+
+TEST_CASE("Node library") {
+  const std::filesystem::path directory = std::filesystem::temp_directory_path() / "knoodle_test_node_library";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  std::ofstream(directory / "blend.json") << BLEND_NODE;
+  std::ofstream(directory / "constant.json")
+      << R"({ "name": "Constant", "id": "constant", "outputs": [
+        { "name": "Output", "id": "output", "evaluation": { "type": "pixel_shader" } }
+      ] })";
+  std::ofstream(directory / "notes.txt") << "not a node";
+
+  kn::NodeLibrary library;
+  CHECK(library.load_directory(directory));
+  CHECK(library.get_size() == 2);
+  CHECK(library.find("blend") == 0);
+  CHECK(library.find("constant") == 1);
+  CHECK(library.find("missing") == kn::INVALID_INDEX);
+
+  // Adding a definition with a known id replaces it in place.
+  kn::NodeDefinition constant = library.get(1);
+  constant.name = "Renamed";
+  CHECK(library.add(constant) == 1);
+  CHECK(library.get(1).name == "Renamed");
+  CHECK(library.get_size() == 2);
+
+  std::ofstream(directory / "broken.json") << R"({ "name": "Broken" })";
+  CHECK(!library.load_directory(directory));
+  CHECK(library.get_size() == 2);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("Port formats") {
+  // Accepted formats, or any.
+  CHECK(kn::fit_channels(3, kn::FORMAT_FLOAT | kn::FORMAT_FLOAT3) == 3);
+  CHECK(kn::fit_channels(2, 0) == 2);
+  // The narrowest wider format, then the widest narrower one.
+  CHECK(kn::fit_channels(1, kn::FORMAT_FLOAT3 | kn::FORMAT_FLOAT4) == 3);
+  CHECK(kn::fit_channels(2, kn::FORMAT_FLOAT4) == 4);
+  CHECK(kn::fit_channels(4, kn::FORMAT_FLOAT | kn::FORMAT_FLOAT2) == 2);
+  CHECK(kn::fit_channels(3, kn::FORMAT_FLOAT) == 1);
+}
@@ -0,0 +1,72 @@
+/**************************************************************************/
+/* test_region.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "region.hpp"
+
+TEST_CASE("Region operations") {
+  const kn::Region region{-10, 20, 30, 40};
+  CHECK(region.get_right() == 20);
+  CHECK(region.get_bottom() == 60);
+  CHECK(!region.is_empty());
+  CHECK(kn::Region{}.is_empty());
+
+  CHECK(region.united({}) == region);
+  CHECK(kn::Region{}.united(region) == region);
+  CHECK(region.united({0, 0, 5, 5}) == kn::Region{-10, 0, 30, 60});
+  CHECK(region.intersected({0, 0, 100, 30}) == kn::Region{0, 20, 20, 10});
+  CHECK(region.intersected({100, 100, 5, 5}).is_empty());
+  CHECK(region.expanded(2) == kn::Region{-12, 18, 34, 44});
+
+  CHECK(region.contains({0, 30, 10, 10}));
+  CHECK(!region.contains({0, 30, 30, 10}));
+  CHECK(region.contains({}));
+
+  // Tiles extend below zero as they do above.
+  CHECK(region.aligned(16) == kn::Region{-16, 16, 48, 48});
+  CHECK(kn::Region{0, 0, 16, 17}.aligned(16) == kn::Region{0, 0, 16, 32});
+}
+
+TEST_CASE("Transformed bounds") {
+  // Identity: bilinear filtering reads one more pixel past the last center.
+  CHECK(kn::map_bounds({4, 8, 10, 10}, {1, 0, 0, 0, 1, 0}) == kn::Region{4, 8, 11, 11});
+
+  // Scaling by 2 reads twice the pixels.
+  CHECK(kn::map_bounds({0, 0, 4, 4}, {2, 0, 0, 0, 2, 0}) == kn::Region{0, 0, 8, 8});
+
+  // Translation moves the bounds, rotation by a quarter turn swaps the axes.
+  CHECK(kn::map_bounds({0, 0, 4, 2}, {1, 0, 10, 0, 1, -5}) == kn::Region{10, -5, 5, 3});
+  const kn::Region rotated = kn::map_bounds({0, 0, 4, 2}, {0, -1, 0, 1, 0, 0});
+  CHECK(rotated.width == 3);
+  CHECK(rotated.height == 5);
+
+  CHECK(kn::map_bounds({}, {1, 0, 0, 0, 1, 0}).is_empty());
+}
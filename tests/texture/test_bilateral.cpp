@@ -0,0 +1,157 @@
+/**************************************************************************/
+/* test_bilateral.cpp                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include "bilateral.hpp"
+#include "texture_pool.hpp"
+
+namespace {
+/** Two flat halves at 0.2 and 0.8, with noise of the given amplitude. */
+kn::Texture make_noisy_step(uint32_t size, uint32_t channels, float noise) {
+  kn::Texture texture(size, size, channels);
+  std::mt19937 rng(31);
+  std::uniform_real_distribution<float> dist(-noise, noise);
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      for (uint32_t c = 0; c < channels; ++c) {
+        texture.view().at(x, y, c) = (x < size / 2 ? 0.2f : 0.8f) + dist(rng);
+      }
+    }
+  }
+  return texture;
+}
+}  // namespace
+
+TEST_CASE("Bilateral filter") {
+  SUBCASE("Constant textures are unchanged") {
+    const kn::Texture src(40, 24, 2, 0.6f);
+    kn::Texture dst(40, 24, 2);
+    kn::bilateral_filter(src.view(), src.view(), 0, dst.view(), {8.0f, 0.1f});
+    for (size_t i = 0; i < 40 * 24 * 2; ++i) {
+      CHECK(dst.get_data()[i] == doctest::Approx(0.6f).epsilon(1e-4));
+    }
+  }
+
+  SUBCASE("Noise is smoothed and edges are kept") {
+    const uint32_t size = 128;
+    const kn::Texture src = make_noisy_step(size, 3, 0.03f);
+    kn::Texture dst(size, size, 3);
+    kn::bilateral_filter(src.view(), src.view(), 0, dst.view(), {16.0f, 0.1f});
+
+    double src_error = 0.0;
+    double dst_error = 0.0;
+    for (uint32_t y = 0; y < size; ++y) {
+      for (uint32_t x = 0; x < size; ++x) {
+        const float expected = x < size / 2 ? 0.2f : 0.8f;
+        for (uint32_t c = 0; c < 3; ++c) {
+          src_error += std::abs(src.view().at(x, y, c) - expected);
+          dst_error += std::abs(dst.view().at(x, y, c) - expected);
+          // A plain blur of this sigma would spread the step over dozens of pixels.
+          CHECK(std::abs(dst.view().at(x, y, c) - expected) < 0.06f);
+        }
+      }
+    }
+    CHECK(dst_error < 0.5 * src_error);
+  }
+
+  SUBCASE("Wide guide ranges keep a bounded grid") {
+    kn::TexturePool* pool = kn::TexturePool::get_instance();
+    pool->clear();
+    kn::Texture guide(32, 32, 1, 0.0f);
+    guide.view().at(5, 7) = 1e30f;
+    guide.view().at(9, 2) = -1e30f;
+    const kn::Texture src(32, 32, 1, 0.5f);
+    kn::Texture dst(32, 32, 1);
+    kn::bilateral_filter(src.view(), guide.view(), 0, dst.view(), {8.0f, 1e-3f});
+    // Two grids of 4 x 4 cells, 256 deep, with a value and a weight.
+    CHECK(pool->get_pooled_size() <= 2 * 4 * 4 * 256 * 2 * sizeof(float));
+    for (size_t i = 0; i < 32 * 32; ++i) {
+      CHECK(dst.get_data()[i] == doctest::Approx(0.5f).epsilon(1e-4));
+    }
+  }
+
+  SUBCASE("Non-finite guides leave the source unfiltered") {
+    const kn::Texture src = make_noisy_step(32, 2, 0.05f);
+    for (const float invalid : {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity()}) {
+      kn::Texture guide(32, 32, 1, 0.5f);
+      guide.view().at(3, 4) = invalid;
+      kn::Texture dst(32, 32, 2, -1.0f);
+      kn::bilateral_filter(src.view(), guide.view(), 0, dst.view());
+      for (size_t i = 0; i < 32 * 32 * 2; ++i) {
+        CHECK(dst.get_data()[i] == src.get_data()[i]);
+      }
+    }
+  }
+
+  SUBCASE("Uniform textures are returned as they are") {
+    const std::vector<float> value = {0.4f, 0.6f};
+    const kn::Texture src = kn::Texture::uniform(32, 16, value);
+    const kn::Texture guide = make_noisy_step(32, 1, 0.1f);
+    const kn::Texture dst = kn::bilateral_filter(src, guide, 0);
+    REQUIRE(dst.is_uniform());
+    CHECK(dst.get_data()[1] == 0.6f);
+  }
+
+  SUBCASE("Intermediate grids go back to the pool") {
+    kn::TexturePool* pool = kn::TexturePool::get_instance();
+    pool->clear();
+    const kn::Texture src(64, 64, 1, 0.5f);
+    kn::Texture dst(64, 64, 1);
+    kn::bilateral_filter(src.view(), src.view(), 0, dst.view());
+    const size_t pooled = pool->get_pooled_size();
+    CHECK(pooled > 0);
+    kn::bilateral_filter(src.view(), src.view(), 0, dst.view());
+    CHECK(pool->get_pooled_size() == pooled);
+  }
+}
+
+TEST_CASE("Texture pool") {
+  kn::TexturePool pool;
+  kn::Texture texture = pool.acquire(16, 16, 4);
+  CHECK(texture.get_width() == 16);
+  CHECK(texture.get_channels() == 4);
+  const float* storage = texture.get_data();
+
+  pool.release(std::move(texture));
+  CHECK(pool.get_pooled_size() >= 16 * 16 * 4 * sizeof(float));
+
+  // Smaller textures reuse larger storage.
+  kn::Texture reused = pool.acquire(8, 8, 2);
+  CHECK(reused.get_data() == storage);
+  CHECK(pool.get_pooled_size() == 0);
+
+  pool.release(std::move(reused));
+  pool.set_capacity(0);
+  CHECK(pool.get_pooled_size() == 0);
+}
@@ -0,0 +1,207 @@
+/**************************************************************************/
+/* test_color_grading.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+#include "color.hpp"
+#include "color_grading.hpp"
+
+namespace {
+kn::Texture make_noise(uint32_t width, uint32_t height, uint32_t channels, uint32_t seed) {
+  kn::Texture texture(width, height, channels);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+    texture.get_data()[i] = dist(rng);
+  }
+  return texture;
+}
+
+/** Largest and mean differences between the tables applied to src and the exact chain. */
+std::pair<float, float> measure_error(kn::ColorGrading& grading, const kn::Texture& src) {
+  kn::Texture dst(src.get_width(), src.get_height(), src.get_channels());
+  grading.apply(src.view(), dst.view());
+
+  const uint32_t channels = src.get_channels();
+  float error = 0.0f;
+  double sum = 0.0;
+  for (size_t p = 0; p < src.view().get_pixel_count(); ++p) {
+    float values[4];
+    std::copy(src.get_data() + p * channels, src.get_data() + (p + 1) * channels, values);
+    grading.evaluate(values, channels);
+    for (uint32_t c = 0; c < channels; ++c) {
+      const float difference = std::abs(values[c] - dst.get_data()[p * channels + c]);
+      error = std::max(error, difference);
+      sum += difference;
+    }
+  }
+  return {error, static_cast<float>(sum / static_cast<double>(src.view().get_pixel_count() * channels))};
+}
+}  // namespace
+
+TEST_CASE("HSL conversion") {
+  const auto red = kn::rgb_to_hsl(1.0f, 0.0f, 0.0f);
+  CHECK(red[0] == doctest::Approx(0.0f));
+  CHECK(red[1] == doctest::Approx(1.0f));
+  CHECK(red[2] == doctest::Approx(0.5f));
+
+  const auto blue = kn::rgb_to_hsl(0.25f, 0.25f, 0.75f);
+  CHECK(blue[0] == doctest::Approx(2.0f / 3.0f));
+  CHECK(blue[1] == doctest::Approx(0.5f));
+  CHECK(blue[2] == doctest::Approx(0.5f));
+
+  const auto gray = kn::rgb_to_hsl(0.3f, 0.3f, 0.3f);
+  CHECK(gray[1] == doctest::Approx(0.0f));
+  CHECK(gray[2] == doctest::Approx(0.3f));
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (int i = 0; i < 1000; ++i) {
+    const float r = dist(rng);
+    const float g = dist(rng);
+    const float b = dist(rng);
+    const auto hsl = kn::rgb_to_hsl(r, g, b);
+    const auto rgb = kn::hsl_to_rgb(hsl[0], hsl[1], hsl[2]);
+    CHECK(rgb[0] == doctest::Approx(r).epsilon(1e-4));
+    CHECK(rgb[1] == doctest::Approx(g).epsilon(1e-4));
+    CHECK(rgb[2] == doctest::Approx(b).epsilon(1e-4));
+  }
+}
+
+TEST_CASE("Levels and curves") {
+  const kn::Levels levels{0.2f, 0.8f, 2.0f, 0.1f, 0.9f};
+  CHECK(levels.evaluate(0.1f) == doctest::Approx(0.1f));
+  CHECK(levels.evaluate(0.9f) == doctest::Approx(0.9f));
+  CHECK(levels.evaluate(0.5f) == doctest::Approx(0.1f + 0.8f * std::sqrt(0.5f)));
+
+  const kn::ToneCurve curve({{1.0f, 1.0f}, {0.0f, 0.0f}, {0.5f, 0.8f}, {0.25f, 0.7f}});
+  CHECK(curve.evaluate(0.25f) == doctest::Approx(0.7f));
+  CHECK(curve.evaluate(0.5f) == doctest::Approx(0.8f));
+  float previous = curve.evaluate(0.0f);
+  for (int i = 1; i <= 100; ++i) {
+    const float value = curve.evaluate(static_cast<float>(i) / 100.0f);
+    CHECK(value >= previous);
+    previous = value;
+  }
+  CHECK(kn::ToneCurve().evaluate(0.3f) == 0.3f);
+}
+
+TEST_CASE("Color grading") {
+  SUBCASE("Per-channel chains match the exact adjustments") {
+    kn::ColorGrading grading;
+    grading.add_levels({0.1f, 0.9f, 1.5f, 0.0f, 1.0f});
+    grading.add_curve(kn::ToneCurve({{0.0f, 0.1f}, {0.5f, 0.4f}, {1.0f, 0.9f}}), 0b0001);
+    grading.add_levels({0.0f, 1.0f, 0.7f, 0.2f, 1.0f}, 0b1000);
+    for (uint32_t channels = 1; channels <= 4; ++channels) {
+      CHECK(measure_error(grading, make_noise(37, 11, channels, channels)).first < 2e-3f);
+    }
+  }
+
+  SUBCASE("Untouched channels are copied") {
+    kn::ColorGrading grading;
+    grading.add_levels({0.0f, 0.5f, 1.0f, 0.0f, 1.0f}, 0b0010);
+    const kn::Texture src = make_noise(9, 7, 3, 5);
+    kn::Texture dst(9, 7, 3);
+    grading.apply(src.view(), dst.view());
+    CHECK(dst.view().at(4, 3, 0) == src.view().at(4, 3, 0));
+    CHECK(dst.view().at(4, 3, 2) == src.view().at(4, 3, 2));
+    CHECK(dst.view().at(4, 3, 1) == doctest::Approx(std::min(1.0f, 2.0f * src.view().at(4, 3, 1))).epsilon(1e-3));
+  }
+
+  SUBCASE("HSL chains are baked into an RGB table") {
+    kn::ColorGrading grading;
+    grading.add_levels({0.05f, 0.95f, 1.2f, 0.0f, 1.0f});
+    grading.add_hsl({0.1f, 0.3f, -0.1f});
+    grading.add_curve(kn::ToneCurve({{0.0f, 0.0f}, {0.5f, 0.6f}, {1.0f, 1.0f}}));
+    // HSL is steep near black and white, where the table is least accurate.
+    const auto [error, mean] = measure_error(grading, make_noise(64, 64, 4, 7));
+    CHECK(error < 0.1f);
+    CHECK(mean < 1e-3f);
+
+    // The table follows changes of the chain.
+    grading.clear();
+    grading.add_hsl({0.5f, 0.0f, 0.0f});
+    const kn::Texture src(4, 4, 3, 0.5f);
+    kn::Texture dst(4, 4, 3);
+    grading.apply(src.view(), dst.view());
+    CHECK(dst.view().at(1, 1, 0) == doctest::Approx(0.5f));
+  }
+
+  SUBCASE("Grading in place") {
+    kn::ColorGrading grading;
+    grading.add_hsl({0.0f, -1.0f, 0.0f});
+    kn::Texture texture = make_noise(16, 16, 3, 9);
+    grading.apply(texture.view(), texture.view());
+    CHECK(texture.view().at(5, 5, 0) == doctest::Approx(texture.view().at(5, 5, 1)).epsilon(1e-3));
+    CHECK(texture.view().at(5, 5, 1) == doctest::Approx(texture.view().at(5, 5, 2)).epsilon(1e-3));
+  }
+}
+
+TEST_CASE("Gradient map") {
+  const kn::GradientMap gradient({{1.0f, {1.0f, 1.0f, 0.0f, 1.0f}}, {0.0f, {0.0f, 0.0f, 1.0f, 0.5f}}});
+  kn::Texture src(3, 1, 2);
+  src.view().at(0, 0, 1) = 0.0f;
+  src.view().at(1, 0, 1) = 0.5f;
+  src.view().at(2, 0, 1) = 2.0f;
+
+  kn::Texture dst(3, 1, 4);
+  gradient.apply(src.view(), 1, dst.view());
+  CHECK(dst.view().at(0, 0, 2) == doctest::Approx(1.0f));
+  CHECK(dst.view().at(0, 0, 3) == doctest::Approx(0.5f));
+  CHECK(dst.view().at(1, 0, 0) == doctest::Approx(0.5f).epsilon(1e-3));
+  CHECK(dst.view().at(1, 0, 2) == doctest::Approx(0.5f).epsilon(1e-3));
+  CHECK(dst.view().at(2, 0, 0) == doctest::Approx(1.0f));
+  CHECK(dst.view().at(2, 0, 2) == doctest::Approx(0.0f));
+
+  kn::Texture gray(3, 1, 1);
+  gradient.apply(src.view(), 1, gray.view());
+  CHECK(gray.view().at(2, 0) == doctest::Approx(1.0f));
+}
+
+TEST_CASE("Grade uniform textures") {
+  kn::ColorGrading grading;
+  grading.add_levels({0.1f, 0.9f, 1.5f, 0.0f, 1.0f});
+  grading.add_hsl({0.1f, 0.2f, 0.0f});
+  const std::vector<float> value = {0.2f, 0.5f, 0.8f, 1.0f};
+  const kn::Texture src = kn::Texture::uniform(40, 30, value);
+  kn::Texture materialized = src;
+  materialized.materialize();
+
+  const kn::Texture dst = grading.apply(src);
+  const kn::Texture expected = grading.apply(materialized);
+  REQUIRE(dst.is_uniform());
+  for (uint32_t c = 0; c < 4; ++c) {
+    CHECK(dst.get_data()[c] == doctest::Approx(expected.view().at(39, 29, c)));
+  }
+}
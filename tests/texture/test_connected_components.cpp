@@ -0,0 +1,151 @@
+/**************************************************************************/
+/* test_connected_components.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <queue>
+#include <random>
+#include "connected_components.hpp"
+
+namespace {
+/** Flood fill reference labeling components in raster order. */
+std::vector<uint32_t> reference_labels(const kn::TextureView& mask, bool eight) {
+  std::vector<uint32_t> labels(mask.get_pixel_count(), 0);
+  uint32_t next = 0;
+  for (uint32_t y = 0; y < mask.height; ++y) {
+    for (uint32_t x = 0; x < mask.width; ++x) {
+      if (mask.at(x, y) < 0.5f || labels[y * mask.width + x] != 0) {
+        continue;
+      }
+      ++next;
+      std::queue<std::pair<uint32_t, uint32_t>> queue;
+      queue.emplace(x, y);
+      labels[y * mask.width + x] = next;
+      while (!queue.empty()) {
+        const auto [px, py] = queue.front();
+        queue.pop();
+        for (int64_t j = -1; j <= 1; ++j) {
+          for (int64_t i = -1; i <= 1; ++i) {
+            if ((i == 0 && j == 0) || (!eight && i != 0 && j != 0)) {
+              continue;
+            }
+            const uint32_t nx = kn::wrap_coord(px + i, mask.width);
+            const uint32_t ny = kn::wrap_coord(py + j, mask.height);
+            if (mask.at(nx, ny) >= 0.5f && labels[ny * mask.width + nx] == 0) {
+              labels[ny * mask.width + nx] = next;
+              queue.emplace(nx, ny);
+            }
+          }
+        }
+      }
+    }
+  }
+  return labels;
+}
+}  // namespace
+
+TEST_CASE("ConnectedComponents") {
+  SUBCASE("labels match a wrapping flood fill") {
+    kn::Texture mask(150, 90);
+    std::mt19937 rng(5);
+    for (size_t i = 0; i < mask.view().get_pixel_count(); ++i) {
+      mask.get_data()[i] = rng() % 100 < 45 ? 1.0f : 0.0f;
+    }
+
+    for (auto connectivity : {kn::Connectivity::Four, kn::Connectivity::Eight}) {
+      kn::ComponentLabels result;
+      kn::label_components(mask.view(), 0, 0.5f, connectivity, result);
+      const auto expected = reference_labels(mask.view(), connectivity == kn::Connectivity::Eight);
+      REQUIRE(result.labels == expected);
+
+      uint32_t max_label = 0;
+      for (uint32_t label : expected) {
+        max_label = std::max(max_label, label);
+      }
+      CHECK(result.components.size() == max_label);
+
+      std::vector<uint32_t> counts(max_label, 0);
+      for (uint32_t label : expected) {
+        if (label) {
+          counts[label - 1]++;
+        }
+      }
+      CHECK(result.components.pixel_count == counts);
+    }
+  }
+
+  SUBCASE("components crossing borders keep contiguous bounds") {
+    kn::Texture mask(100, 80);
+    // A 6x4 rectangle straddling the top-left corner.
+    for (int64_t y = -2; y < 2; ++y) {
+      for (int64_t x = -3; x < 3; ++x) {
+        mask.view().at(kn::wrap_coord(x, 100), kn::wrap_coord(y, 80)) = 1.0f;
+      }
+    }
+    mask.view().at(50, 40) = 1.0f;
+
+    kn::ComponentLabels result;
+    kn::label_components(mask.view(), 0, 0.5f, kn::Connectivity::Four, result);
+    REQUIRE(result.components.size() == 2);
+    CHECK(result.at(0, 0) == 1);
+    CHECK(result.at(99, 79) == 1);
+    CHECK(result.at(50, 40) == 2);
+
+    const auto& table = result.components;
+    CHECK(table.pixel_count[0] == 24);
+    CHECK(table.min_x[0] == 97);
+    CHECK(table.max_x[0] == 102);
+    CHECK(table.min_y[0] == 78);
+    CHECK(table.max_y[0] == 81);
+    CHECK(table.centroid_x[0] == doctest::Approx(99.5f));
+    CHECK(table.centroid_y[0] == doctest::Approx(79.5f));
+    CHECK(table.wraps[0] == 0);
+    CHECK(table.mean_value[0] == doctest::Approx(1.0f));
+
+    CHECK(table.min_x[1] == 50);
+    CHECK(table.max_x[1] == 50);
+  }
+
+  SUBCASE("bands around the texture wrap") {
+    kn::Texture mask(130, 70);
+    for (uint32_t x = 0; x < 130; ++x) {
+      mask.view().at(x, 10) = 1.0f;
+    }
+
+    kn::ComponentLabels result;
+    kn::label_components(mask.view(), 0, 0.5f, kn::Connectivity::Four, result);
+    REQUIRE(result.components.size() == 1);
+    CHECK(result.components.wraps[0] == kn::ComponentTable::WRAPS_X);
+    CHECK(result.components.min_x[0] == 0);
+    CHECK(result.components.max_x[0] == 129);
+    CHECK(result.components.min_y[0] == 10);
+    CHECK(result.components.max_y[0] == 10);
+  }
+}
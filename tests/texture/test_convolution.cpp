@@ -0,0 +1,175 @@
+/**************************************************************************/
+/* test_convolution.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <random>
+#include "convolution.hpp"
+#include "fft.hpp"
+
+namespace {
+kn::Texture make_noise(uint32_t width, uint32_t height, uint32_t channels, uint32_t seed) {
+  kn::Texture texture(width, height, channels);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+    texture.get_data()[i] = dist(rng);
+  }
+  return texture;
+}
+
+float reference_convolution(const kn::TextureView& src, const kn::ConvolutionKernel& kernel, uint32_t x, uint32_t y) {
+  float sum = 0.0f;
+  for (uint32_t j = 0; j < kernel.height; ++j) {
+    for (uint32_t i = 0; i < kernel.width; ++i) {
+      const int64_t sx = static_cast<int64_t>(x) + i - kernel.origin_x;
+      const int64_t sy = static_cast<int64_t>(y) + j - kernel.origin_y;
+      sum += kernel.weight(i, j) * src.fetch_wrap(sx, sy);
+    }
+  }
+  return sum;
+}
+}  // namespace
+
+TEST_CASE("FFT") {
+  SUBCASE("1D matches the DFT definition") {
+    for (uint32_t size : {1u, 2u, 8u, 12u, 17u}) {
+      kn::FFTPlan plan(size);
+      std::vector<kn::complex_t> data(size);
+      for (uint32_t i = 0; i < size; ++i) {
+        data[i] = {static_cast<float>(i % 5) - 2.0f, static_cast<float>(i % 3)};
+      }
+      auto result = data;
+      plan.forward(result.data());
+
+      for (uint32_t k = 0; k < size; ++k) {
+        std::complex<double> expected;
+        for (uint32_t n = 0; n < size; ++n) {
+          const double angle = -2.0 * 3.14159265358979323846 * k * n / size;
+          expected += std::complex<double>(data[n]) * std::polar(1.0, angle);
+        }
+        CHECK(result[k].real() == doctest::Approx(expected.real()).epsilon(1e-4));
+        CHECK(result[k].imag() == doctest::Approx(expected.imag()).epsilon(1e-4));
+      }
+    }
+  }
+
+  SUBCASE("2D round trip") {
+    for (auto [width, height] : {std::pair{16u, 16u}, std::pair{12u, 10u}, std::pair{7u, 9u}}) {
+      const kn::Texture src = make_noise(width, height, 2, width * height);
+      kn::Texture dst(width, height, 2);
+
+      kn::RealFFT2D fft(width, height);
+      kn::Spectrum spectrum;
+      for (uint32_t c = 0; c < 2; ++c) {
+        fft.forward(src.view(), c, spectrum);
+        fft.inverse(spectrum, dst.view(), c);
+      }
+
+      for (size_t i = 0; i < static_cast<size_t>(width) * height * 2; ++i) {
+        CHECK(dst.get_data()[i] == doctest::Approx(src.get_data()[i]).epsilon(1e-4));
+      }
+    }
+  }
+
+  SUBCASE("DC bin holds the sum of the image") {
+    kn::Texture src(8, 4, 1, 0.5f);
+    kn::RealFFT2D fft(8, 4);
+    kn::Spectrum spectrum;
+    fft.forward(src.view(), 0, spectrum);
+    CHECK(spectrum.bins[0].real() == doctest::Approx(16.0f));
+    CHECK(std::abs(spectrum.bins[1]) == doctest::Approx(0.0f));
+  }
+}
+
+TEST_CASE("Convolution") {
+  SUBCASE("Direct and FFT agree with wrapping") {
+    const kn::Texture src = make_noise(20, 14, 3, 7);
+    std::vector<float> weights(7 * 5);
+    for (size_t i = 0; i < weights.size(); ++i) {
+      weights[i] = static_cast<float>((i * 37) % 11) / 11.0f - 0.3f;
+    }
+    kn::ConvolutionKernel kernel{7, 5, 1, 3, weights};
+
+    kn::Texture direct(20, 14, 3);
+    kn::Texture fft(20, 14, 3);
+    kn::convolve(src.view(), direct.view(), kernel, kn::ConvolutionMethod::Direct);
+    kn::convolve(src.view(), fft.view(), kernel, kn::ConvolutionMethod::FFT);
+
+    for (uint32_t y = 0; y < 14; ++y) {
+      for (uint32_t x = 0; x < 20; ++x) {
+        CHECK(direct.view().at(x, y, 0) == doctest::Approx(reference_convolution(src.view(), kernel, x, y)));
+        for (uint32_t c = 0; c < 3; ++c) {
+          CHECK(fft.view().at(x, y, c) == doctest::Approx(direct.view().at(x, y, c)).epsilon(1e-3));
+        }
+      }
+    }
+  }
+
+  SUBCASE("Kernels larger than the texture fold around it") {
+    const kn::Texture src = make_noise(8, 8, 1, 3);
+    kn::ConvolutionKernel kernel = kn::ConvolutionKernel::centered(11, 11, std::vector<float>(121, 1.0f / 121.0f));
+
+    kn::Texture direct(8, 8);
+    kn::Texture fft(8, 8);
+    kn::convolve(src.view(), direct.view(), kernel, kn::ConvolutionMethod::Direct);
+    kn::convolve(src.view(), fft.view(), kernel, kn::ConvolutionMethod::FFT);
+
+    for (size_t i = 0; i < 64; ++i) {
+      CHECK(fft.get_data()[i] == doctest::Approx(direct.get_data()[i]).epsilon(1e-3));
+    }
+  }
+
+  SUBCASE("Auto picks FFT for large kernels only") {
+    kn::Texture src(1024, 1024);
+    CHECK(kn::select_convolution_method(src.view(), kn::ConvolutionKernel::centered(3, 3, std::vector<float>(9))) ==
+          kn::ConvolutionMethod::Direct);
+    CHECK(kn::select_convolution_method(src.view(), kn::ConvolutionKernel::centered(
+                                                        65, 65, std::vector<float>(65 * 65))) ==
+          kn::ConvolutionMethod::FFT);
+  }
+}
+
+TEST_CASE("Convolve uniform textures") {
+  const std::vector<float> value = {0.5f, -1.0f};
+  const kn::Texture src = kn::Texture::uniform(16, 12, value);
+  kn::Texture materialized = src;
+  materialized.materialize();
+  const std::vector<float> weights = {0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f};
+  const kn::ConvolutionKernel kernel{3, 2, 1, 0, weights};
+
+  const kn::Texture dst = kn::convolve(src, kernel);
+  const kn::Texture expected = kn::convolve(materialized, kernel);
+  REQUIRE(dst.is_uniform());
+  REQUIRE_FALSE(expected.is_uniform());
+  for (uint32_t c = 0; c < 2; ++c) {
+    CHECK(dst.get_data()[c] == doctest::Approx(expected.view().at(7, 5, c)));
+  }
+}
@@ -0,0 +1,132 @@
+/**************************************************************************/
+/* test_distance_field.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include "distance_field.hpp"
+
+namespace {
+float reference_distance(const kn::TextureView& mask, uint32_t x, uint32_t y) {
+  float best = std::numeric_limits<float>::infinity();
+  for (uint32_t sy = 0; sy < mask.height; ++sy) {
+    for (uint32_t sx = 0; sx < mask.width; ++sx) {
+      if (mask.at(sx, sy) < 0.5f) {
+        continue;
+      }
+      int64_t dx = std::abs(static_cast<int64_t>(x) - sx);
+      int64_t dy = std::abs(static_cast<int64_t>(y) - sy);
+      dx = std::min<int64_t>(dx, mask.width - dx);
+      dy = std::min<int64_t>(dy, mask.height - dy);
+      best = std::min(best, std::sqrt(static_cast<float>(dx * dx + dy * dy)));
+    }
+  }
+  return best;
+}
+
+kn::Texture make_seeds(uint32_t width, uint32_t height, uint32_t count) {
+  kn::Texture mask(width, height);
+  std::mt19937 rng(99);
+  for (uint32_t i = 0; i < count; ++i) {
+    mask.view().at(rng() % width, rng() % height) = 1.0f;
+  }
+  return mask;
+}
+}  // namespace
+
+TEST_CASE("DistanceField") {
+  SUBCASE("exact transform matches brute force on the torus") {
+    const kn::Texture mask = make_seeds(37, 26, 6);
+    kn::Texture field(37, 26);
+    kn::distance_field(mask.view(), 0, 0.5f, field.view());
+
+    for (uint32_t y = 0; y < 26; ++y) {
+      for (uint32_t x = 0; x < 37; ++x) {
+        REQUIRE(field.view().at(x, y) == doctest::Approx(reference_distance(mask.view(), x, y)));
+      }
+    }
+  }
+
+  SUBCASE("jump flooding stays close to the exact field") {
+    const kn::Texture mask = make_seeds(64, 48, 20);
+    kn::Texture exact(64, 48);
+    kn::Texture approximate(64, 48);
+    kn::distance_field(mask.view(), 0, 0.5f, exact.view());
+    kn::distance_field(mask.view(), 0, 0.5f, approximate.view(), kn::DistanceFieldMethod::JumpFlooding);
+
+    size_t mismatches = 0;
+    for (uint32_t y = 0; y < 48; ++y) {
+      for (uint32_t x = 0; x < 64; ++x) {
+        const float e = exact.view().at(x, y);
+        const float a = approximate.view().at(x, y);
+        REQUIRE(a >= e - 1e-4f);
+        REQUIRE(a <= e + 1.5f);
+        mismatches += a > e + 1e-4f ? 1 : 0;
+      }
+    }
+    CHECK(mismatches < 64 * 48 / 100);
+  }
+
+  SUBCASE("fields wrap across borders") {
+    kn::Texture mask(16, 16);
+    mask.view().at(0, 0) = 1.0f;
+    kn::Texture field(16, 16);
+    kn::distance_field(mask.view(), 0, 0.5f, field.view());
+    CHECK(field.view().at(15, 0) == doctest::Approx(1.0f));
+    CHECK(field.view().at(15, 15) == doctest::Approx(std::sqrt(2.0f)));
+    CHECK(field.view().at(8, 8) == doctest::Approx(std::sqrt(128.0f)));
+  }
+
+  SUBCASE("empty masks are infinitely far") {
+    kn::Texture mask(8, 8);
+    kn::Texture field(8, 8);
+    kn::distance_field(mask.view(), 0, 0.5f, field.view());
+    CHECK(std::isinf(field.view().at(3, 3)));
+  }
+
+  SUBCASE("signed field is negative inside") {
+    kn::Texture mask(32, 32);
+    for (uint32_t y = 10; y < 20; ++y) {
+      for (uint32_t x = 10; x < 20; ++x) {
+        mask.view().at(x, y) = 1.0f;
+      }
+    }
+    for (auto method : {kn::DistanceFieldMethod::Exact, kn::DistanceFieldMethod::JumpFlooding}) {
+      kn::Texture field(32, 32);
+      kn::signed_distance_field(mask.view(), 0, 0.5f, field.view(), method);
+      CHECK(field.view().at(14, 14) == doctest::Approx(-4.5f));
+      CHECK(field.view().at(10, 15) == doctest::Approx(-0.5f));
+      CHECK(field.view().at(9, 15) == doctest::Approx(0.5f));
+      CHECK(field.view().at(5, 15) == doctest::Approx(4.5f));
+    }
+  }
+}
@@ -0,0 +1,162 @@
+/**************************************************************************/
+/* test_height_filters.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <numbers>
+#include "height_filters.hpp"
+
+namespace {
+/** Periodic bump, highest at the center of the texture. */
+kn::Texture make_bump(uint32_t size, uint32_t channels, uint32_t channel) {
+  kn::Texture texture(size, size, channels);
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      const float u = 2.0f * std::numbers::pi_v<float> * (x + 0.5f) / size;
+      const float v = 2.0f * std::numbers::pi_v<float> * (y + 0.5f) / size;
+      texture.view().at(x, y, channel) = 0.25f * (2.0f - std::cos(u) - std::cos(v));
+    }
+  }
+  return texture;
+}
+}  // namespace
+
+TEST_CASE("Height to normal") {
+  SUBCASE("A flat height map points straight up") {
+    const kn::Texture height(13, 9, 1, 0.3f);
+    kn::Texture normal(13, 9, 4);
+    kn::height_to_normal(height.view(), 0, normal.view());
+    for (uint32_t y = 0; y < 9; ++y) {
+      for (uint32_t x = 0; x < 13; ++x) {
+        CHECK(normal.view().at(x, y, 0) == doctest::Approx(0.5f));
+        CHECK(normal.view().at(x, y, 1) == doctest::Approx(0.5f));
+        CHECK(normal.view().at(x, y, 2) == doctest::Approx(1.0f));
+        CHECK(normal.view().at(x, y, 3) == 1.0f);
+      }
+    }
+  }
+
+  SUBCASE("A ramp tilts the normal against its slope") {
+    // Height grows by 0.5 per pixel along +X; the ramp wraps at the border, which is skipped.
+    kn::Texture height(11, 6);
+    for (uint32_t y = 0; y < 6; ++y) {
+      for (uint32_t x = 0; x < 11; ++x) {
+        height.view().at(x, y) = 0.5f * x;
+      }
+    }
+
+    for (const auto filter : {kn::NormalFilter::Sobel, kn::NormalFilter::Scharr}) {
+      kn::Texture normal(11, 6, 3);
+      kn::height_to_normal(height.view(), 0, normal.view(), {filter, kn::NormalFormat::OpenGL, 2.0f});
+      const float expected = -1.0f / std::sqrt(2.0f);
+      for (uint32_t y = 0; y < 6; ++y) {
+        for (uint32_t x = 1; x + 1 < 11; ++x) {
+          CHECK(normal.view().at(x, y, 0) == doctest::Approx(expected * 0.5f + 0.5f));
+          CHECK(normal.view().at(x, y, 1) == doctest::Approx(0.5f));
+          CHECK(normal.view().at(x, y, 2) == doctest::Approx(-expected * 0.5f + 0.5f));
+        }
+      }
+    }
+  }
+
+  SUBCASE("DirectX flips the green channel") {
+    const kn::Texture height = make_bump(16, 2, 1);
+    kn::Texture opengl(16, 16, 3);
+    kn::Texture directx(16, 16, 3);
+    kn::height_to_normal(height.view(), 1, opengl.view(), {kn::NormalFilter::Sobel, kn::NormalFormat::OpenGL});
+    kn::height_to_normal(height.view(), 1, directx.view(), {kn::NormalFilter::Sobel, kn::NormalFormat::DirectX});
+    for (uint32_t y = 0; y < 16; ++y) {
+      for (uint32_t x = 0; x < 16; ++x) {
+        CHECK(opengl.view().at(x, y, 0) == doctest::Approx(directx.view().at(x, y, 0)));
+        CHECK(opengl.view().at(x, y, 1) == doctest::Approx(1.0f - directx.view().at(x, y, 1)));
+      }
+    }
+    // Below the top of the bump, in image space, the surface faces down the image: OpenGL green goes below 0.5.
+    CHECK(opengl.view().at(8, 12, 1) < 0.5f);
+  }
+}
+
+TEST_CASE("Height to curvature") {
+  const kn::Texture height = make_bump(32, 1, 0);
+  kn::Texture curvature(32, 32);
+  kn::height_to_curvature(height.view(), 0, curvature.view(), {3, 4.0f});
+
+  // The top of the bump is convex, its bottom concave, and the saddles in between flat.
+  CHECK(curvature.view().at(16, 16) > 0.5f);
+  CHECK(curvature.view().at(0, 0) < 0.5f);
+  CHECK(curvature.view().at(16, 0) == doctest::Approx(0.5f).epsilon(1e-3));
+
+  const kn::Texture flat(8, 8, 1, 0.7f);
+  kn::Texture flat_curvature(8, 8);
+  kn::height_to_curvature(flat.view(), 0, flat_curvature.view());
+  CHECK(flat_curvature.view().at(3, 5) == doctest::Approx(0.5f));
+
+  // Scales past the texture size are dropped rather than shifting the radius out of range.
+  kn::Texture all_scales(32, 32);
+  kn::Texture many_scales(32, 32);
+  kn::height_to_curvature(height.view(), 0, all_scales.view(), {6, 4.0f});
+  kn::height_to_curvature(height.view(), 0, many_scales.view(), {40, 4.0f});
+  for (uint32_t y = 0; y < 32; ++y) {
+    for (uint32_t x = 0; x < 32; ++x) {
+      CHECK(many_scales.view().at(x, y) == all_scales.view().at(x, y));
+    }
+  }
+}
+
+TEST_CASE("Height to ambient occlusion") {
+  const kn::Texture height = make_bump(64, 1, 0);
+
+  SUBCASE("Flat maps are unoccluded") {
+    const kn::Texture flat(16, 16, 1, 0.4f);
+    kn::Texture ao(16, 16);
+    kn::height_to_ambient_occlusion(flat.view(), 0, ao.view());
+    for (uint32_t y = 0; y < 16; ++y) {
+      for (uint32_t x = 0; x < 16; ++x) {
+        CHECK(ao.view().at(x, y) == doctest::Approx(1.0f));
+      }
+    }
+  }
+
+  SUBCASE("Valleys are occluded and peaks are not") {
+    for (const uint32_t budget : {1u, 16u, 64u}) {
+      kn::Texture ao(64, 64);
+      kn::height_to_ambient_occlusion(height.view(), 0, ao.view(), {12.0f, 64.0f, budget});
+      CHECK(ao.view().at(32, 32) == doctest::Approx(1.0f));
+      CHECK(ao.view().at(0, 0) < 0.9f);
+      for (uint32_t y = 0; y < 64; ++y) {
+        for (uint32_t x = 0; x < 64; ++x) {
+          CHECK(ao.view().at(x, y) >= 0.0f);
+          CHECK(ao.view().at(x, y) <= 1.0f);
+        }
+      }
+    }
+  }
+}
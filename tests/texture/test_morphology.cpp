@@ -0,0 +1,144 @@
+/**************************************************************************/
+/* test_morphology.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <random>
+#include "morphology.hpp"
+
+namespace {
+kn::Texture make_noise(uint32_t width, uint32_t height, uint32_t channels) {
+  kn::Texture texture(width, height, channels);
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+    texture.get_data()[i] = dist(rng);
+  }
+  return texture;
+}
+
+float reference_square(const kn::TextureView& src, uint32_t x, uint32_t y, uint32_t c, int64_t radius, bool dilate) {
+  float result = src.at(x, y, c);
+  for (int64_t j = -radius; j <= radius; ++j) {
+    for (int64_t i = -radius; i <= radius; ++i) {
+      const float v = src.fetch_wrap(x + i, y + j, c);
+      result = dilate ? std::max(result, v) : std::min(result, v);
+    }
+  }
+  return result;
+}
+}  // namespace
+
+TEST_CASE("Morphology") {
+  SUBCASE("square erosion and dilation match brute force") {
+    const kn::Texture src = make_noise(70, 23, 2);
+    for (uint32_t radius : {1u, 2u, 5u, 12u, 40u}) {
+      kn::Texture eroded(70, 23, 2);
+      kn::Texture dilated(70, 23, 2);
+      kn::morphology(src.view(), eroded.view(), kn::MorphologyOp::Erode, kn::StructuringElement::Square, radius);
+      kn::morphology(src.view(), dilated.view(), kn::MorphologyOp::Dilate, kn::StructuringElement::Square, radius);
+
+      for (uint32_t y = 0; y < 23; ++y) {
+        for (uint32_t x = 0; x < 70; ++x) {
+          for (uint32_t c = 0; c < 2; ++c) {
+            REQUIRE(eroded.view().at(x, y, c) == reference_square(src.view(), x, y, c, radius, false));
+            REQUIRE(dilated.view().at(x, y, c) == reference_square(src.view(), x, y, c, radius, true));
+          }
+        }
+      }
+    }
+  }
+
+  SUBCASE("disc is a symmetric octagon and wraps around") {
+    for (uint32_t radius : {3u, 7u, 16u}) {
+      const uint32_t size = 4 * radius + 3;
+      kn::Texture impulse(size, size);
+      impulse.view().at(0, 0) = 1.0f;
+
+      kn::Texture footprint(size, size);
+      kn::morphology(impulse.view(), footprint.view(), kn::MorphologyOp::Dilate, kn::StructuringElement::Disc, radius);
+
+      const auto at = [&](int64_t x, int64_t y) { return footprint.view().fetch_wrap(x, y); };
+      const auto r = static_cast<int64_t>(radius);
+      CHECK(at(r, 0) == 1.0f);
+      CHECK(at(-r, 0) == 1.0f);
+      CHECK(at(0, r) == 1.0f);
+      CHECK(at(0, -r) == 1.0f);
+      CHECK(at(r + 1, 0) == 0.0f);
+      CHECK(at(r, r) == 0.0f);
+      CHECK(at(-r, -r) == 0.0f);
+
+      size_t area = 0;
+      for (int64_t y = -r; y <= r; ++y) {
+        for (int64_t x = -r; x <= r; ++x) {
+          REQUIRE(at(x, y) == at(-x, y));
+          REQUIRE(at(x, y) == at(y, x));
+          area += at(x, y) == 1.0f ? 1 : 0;
+          if (x * x + y * y <= r * r * 7 / 10) {
+            REQUIRE(at(x, y) == 1.0f);
+          }
+        }
+      }
+      const double disc_area = 3.14159265358979 * r * r;
+      CHECK(static_cast<double>(area) == doctest::Approx(disc_area).epsilon(0.35));
+    }
+  }
+
+  SUBCASE("opening removes specks, closing fills holes") {
+    kn::Texture mask(32, 32);
+    for (uint32_t y = 8; y < 24; ++y) {
+      for (uint32_t x = 8; x < 24; ++x) {
+        mask.view().at(x, y) = 1.0f;
+      }
+    }
+    mask.view().at(2, 2) = 1.0f;
+    mask.view().at(15, 15) = 0.0f;
+
+    kn::Texture opened(32, 32);
+    kn::morphology(mask.view(), opened.view(), kn::MorphologyOp::Open, kn::StructuringElement::Square, 1);
+    CHECK(opened.view().at(2, 2) == 0.0f);
+    CHECK(opened.view().at(8, 8) == 1.0f);
+
+    kn::Texture closed = mask;
+    kn::morphology(closed.view(), closed.view(), kn::MorphologyOp::Close, kn::StructuringElement::Disc, 3);
+    CHECK(closed.view().at(15, 15) == 1.0f);
+    CHECK(closed.view().at(8, 8) == 1.0f);
+    CHECK(closed.view().at(30, 30) == 0.0f);
+  }
+}
+
+TEST_CASE("Morphology of uniform textures") {
+  const std::vector<float> value = {0.25f};
+  const kn::Texture src = kn::Texture::uniform(32, 32, value);
+  const kn::Texture dst = kn::morphology(src, kn::MorphologyOp::Close, kn::StructuringElement::Disc, 40);
+  REQUIRE(dst.is_uniform());
+  CHECK(dst.get_data()[0] == 0.25f);
+}
@@ -0,0 +1,74 @@
+/**************************************************************************/
+/* test_multi_resolution.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <mutex>
+#include <random>
+#include "multi_resolution.hpp"
+
+TEST_CASE("Multi-resolution export") {
+  kn::Texture source(64, 64, 3);
+  std::mt19937 rng(29);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (size_t i = 0; i < 64 * 64 * 3; ++i) {
+    source.get_data()[i] = dist(rng);
+  }
+
+  const std::vector<kn::Resolution> resolutions = {{16, 16}, {64, 64}, {8, 8}, {32, 32}, {32, 16}};
+
+  std::mutex mutex;
+  std::vector<kn::Texture> outputs(resolutions.size());
+  std::vector<uint32_t> calls(resolutions.size());
+  kn::derive_resolutions(source.view(), resolutions, {kn::ResampleFilter::Area},
+                         [&](size_t index, const kn::TextureView& texture) {
+                           kn::Texture copy(texture.width, texture.height, texture.channels);
+                           for (uint32_t y = 0; y < texture.height; ++y) {
+                             std::copy_n(texture.row(y), texture.width * texture.channels, copy.view().row(y));
+                           }
+                           std::lock_guard lock(mutex);
+                           outputs[index] = std::move(copy);
+                           ++calls[index];
+                         });
+
+  for (size_t i = 0; i < resolutions.size(); ++i) {
+    CHECK(calls[i] == 1);
+    REQUIRE(outputs[i].get_width() == resolutions[i].width);
+    REQUIRE(outputs[i].get_height() == resolutions[i].height);
+
+    // Halving area filters compose, so the mip chain matches a direct resampling of the source.
+    kn::Texture expected(resolutions[i].width, resolutions[i].height, 3);
+    kn::resample(source.view(), expected.view(), {kn::ResampleFilter::Area});
+    const size_t size = static_cast<size_t>(resolutions[i].width) * resolutions[i].height * 3;
+    for (size_t j = 0; j < size; ++j) {
+      CHECK(outputs[i].get_data()[j] == doctest::Approx(expected.get_data()[j]).epsilon(1e-5));
+    }
+  }
+}
@@ -0,0 +1,143 @@
+/**************************************************************************/
+/* test_patterns.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include "patterns.hpp"
+
+namespace {
+kn::Texture render(const kn::Pattern& pattern, uint32_t size, uint32_t supersampling = 1) {
+  kn::Texture texture(size, size, 1);
+  kn::generate_pattern(pattern, texture.view(), {supersampling});
+  return texture;
+}
+}  // namespace
+
+TEST_CASE("Pattern generators") {
+  SUBCASE("Linear gradient") {
+    const kn::Texture ramp = render(kn::LinearGradientPattern{}, 16);
+    for (uint32_t x = 0; x < 16; ++x) {
+      CHECK(ramp.view().at(x, 5) == doctest::Approx((x + 0.5f) / 16.0f));
+    }
+
+    const kn::Texture mirrored = render(kn::LinearGradientPattern{0, 2, true}, 16);
+    CHECK(mirrored.view().at(3, 0) == doctest::Approx(0.125f));
+    CHECK(mirrored.view().at(3, 3) == doctest::Approx(0.875f));
+    CHECK(mirrored.view().at(3, 4) == doctest::Approx(0.875f));
+    CHECK(mirrored.view().at(3, 8) == doctest::Approx(0.125f));
+  }
+
+  SUBCASE("Stripes") {
+    const kn::Texture stripes = render(kn::StripesPattern{4, 0, 0.5f, 0.0f}, 32);
+    for (uint32_t x = 0; x < 32; ++x) {
+      // Stripes are centered in their period of 8 pixels.
+      const bool inside = x % 8 >= 2 && x % 8 < 6;
+      CHECK(stripes.view().at(x, 7) == (inside ? 1.0f : 0.0f));
+    }
+  }
+
+  SUBCASE("Bricks") {
+    const kn::BricksPattern bricks{2, 2, 0.5f, 0.1f, 0.0f, 0.0f};
+    const kn::Texture texture = render(bricks, 40);
+    CHECK(texture.view().at(10, 10) == 1.0f);
+    CHECK(texture.view().at(0, 10) == 0.0f);
+    CHECK(texture.view().at(20, 10) == 0.0f);
+    CHECK(texture.view().at(10, 20) == 0.0f);
+    // The second row is shifted by half a brick.
+    CHECK(texture.view().at(20, 30) == 1.0f);
+    CHECK(texture.view().at(10, 30) == 0.0f);
+  }
+
+  SUBCASE("Shapes") {
+    kn::ShapePattern disk;
+    disk.tiles_x = 2;
+    disk.tiles_y = 2;
+    disk.size = 0.5f;
+    const kn::Texture disks = render(disk, 64);
+    CHECK(disks.view().at(16, 16) == 1.0f);
+    CHECK(disks.view().at(48, 16) == 1.0f);
+    CHECK(disks.view().at(0, 0) == 0.0f);
+    CHECK(disks.view().at(26, 16) == 0.0f);
+
+    kn::ShapePattern diamond = disk;
+    diamond.kind = kn::ShapeKind::Polygon;
+    diamond.sides = 4;
+    diamond.size = 1.0f;
+    const kn::Texture diamonds = render(diamond, 64);
+    // Without rotation, vertices point along the axes and reach the middle of the cell sides.
+    CHECK(diamonds.view().at(16, 16) == 1.0f);
+    CHECK(diamonds.view().at(10, 10) == 1.0f);
+    CHECK(diamonds.view().at(1, 16) == 1.0f);
+    CHECK(diamonds.view().at(16, 30) == 1.0f);
+    CHECK(diamonds.view().at(4, 4) == 0.0f);
+  }
+
+  SUBCASE("Supersampling anti-aliases edges") {
+    const kn::StripesPattern stripes{1, 0, 0.5f, 0.0f};
+    kn::Texture texture(9, 1, 1);
+    kn::generate_pattern(stripes, texture.view(), {4});
+    // The stripe covers [0.25, 0.75), whose edges cross the third and seventh pixels.
+    CHECK(texture.view().at(0, 0) == 0.0f);
+    CHECK(texture.view().at(2, 0) > 0.0f);
+    CHECK(texture.view().at(2, 0) < 1.0f);
+    CHECK(texture.view().at(4, 0) == 1.0f);
+    CHECK(texture.view().at(6, 0) > 0.0f);
+    CHECK(texture.view().at(6, 0) < 1.0f);
+  }
+
+  SUBCASE("Regions match the whole texture") {
+    kn::ShapePattern hexagons;
+    hexagons.kind = kn::ShapeKind::Polygon;
+    hexagons.tiles_x = 3;
+    hexagons.tiles_y = 5;
+    hexagons.rotation = 0.3f;
+    hexagons.bevel = 0.02f;
+    const kn::Texture whole = render(hexagons, 57, 3);
+
+    // A region crossing the right and bottom borders wraps around.
+    kn::Texture region(21, 13, 1);
+    kn::generate_pattern(hexagons, region.view(), {3, 57, 57, 45, 50});
+    for (uint32_t y = 0; y < 13; ++y) {
+      for (uint32_t x = 0; x < 21; ++x) {
+        CHECK(region.view().at(x, y) == whole.view().fetch_wrap(45 + x, 50 + y));
+      }
+    }
+  }
+
+  SUBCASE("Patterns tile") {
+    const kn::BricksPattern bricks{3, 4, 0.5f, 0.02f, 0.5f, 0.03f};
+    const kn::Texture texture = render(bricks, 48, 2);
+    // Subsamples are symmetric around pixel centers, so a pattern symmetric about the texture border is too.
+    for (uint32_t y = 0; y < 48; ++y) {
+      CHECK(texture.view().at(0, y) == doctest::Approx(texture.view().at(47, y)).epsilon(1e-4));
+    }
+  }
+}
@@ -0,0 +1,156 @@
+/**************************************************************************/
+/* test_resample.cpp                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include "color.hpp"
+#include "resample.hpp"
+
+namespace {
+kn::Texture make_noise(uint32_t width, uint32_t height, uint32_t channels) {
+  kn::Texture texture(width, height, channels);
+  std::mt19937 rng(23);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+    texture.get_data()[i] = dist(rng);
+  }
+  return texture;
+}
+
+/** Periodic wave of one cycle per texture width, sampled at pixel centers. */
+kn::Texture make_wave(uint32_t width, uint32_t height) {
+  kn::Texture texture(width, height);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      texture.view().at(x, y) = std::sin(2.0f * std::numbers::pi_v<float> * (x + 0.5f) / width);
+    }
+  }
+  return texture;
+}
+
+constexpr kn::ResampleFilter FILTERS[] = {kn::ResampleFilter::Area, kn::ResampleFilter::Mitchell,
+                                          kn::ResampleFilter::Lanczos3};
+}  // namespace
+
+TEST_CASE("Resample") {
+  SUBCASE("Constant textures stay constant") {
+    for (const auto filter : FILTERS) {
+      for (const uint32_t channels : {1u, 3u, 4u}) {
+        const kn::Texture src(37, 29, channels, 0.25f);
+        for (const auto& [width, height] : {std::pair{11u, 64u}, std::pair{80u, 7u}, std::pair{1u, 1u}}) {
+          kn::Texture dst(width, height, channels);
+          kn::resample(src.view(), dst.view(), {filter});
+          for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+            CHECK(dst.get_data()[i] == doctest::Approx(0.25f).epsilon(1e-5));
+          }
+        }
+      }
+    }
+  }
+
+  SUBCASE("Lanczos at the same size is the identity") {
+    const kn::Texture src = make_noise(19, 23, 4);
+    for (const bool srgb : {false, true}) {
+      kn::Texture dst(19, 23, 4);
+      kn::resample(src.view(), dst.view(), {kn::ResampleFilter::Lanczos3, srgb});
+      for (size_t i = 0; i < 19 * 23 * 4; ++i) {
+        CHECK(dst.get_data()[i] == doctest::Approx(src.get_data()[i]).epsilon(1e-4));
+      }
+    }
+  }
+
+  SUBCASE("Area halving averages 2x2 blocks") {
+    const kn::Texture src = make_noise(24, 18, 2);
+    kn::Texture dst(12, 9, 2);
+    kn::resample(src.view(), dst.view(), {kn::ResampleFilter::Area});
+    for (uint32_t y = 0; y < 9; ++y) {
+      for (uint32_t x = 0; x < 12; ++x) {
+        for (uint32_t c = 0; c < 2; ++c) {
+          const float expected = (src.view().at(2 * x, 2 * y, c) + src.view().at(2 * x + 1, 2 * y, c) +
+                                  src.view().at(2 * x, 2 * y + 1, c) + src.view().at(2 * x + 1, 2 * y + 1, c)) /
+                                 4.0f;
+          CHECK(dst.view().at(x, y, c) == doctest::Approx(expected).epsilon(1e-5));
+        }
+      }
+    }
+  }
+
+  SUBCASE("Smooth periodic signals survive up and down scaling") {
+    for (const auto filter : {kn::ResampleFilter::Mitchell, kn::ResampleFilter::Lanczos3}) {
+      for (const uint32_t width : {23u, 64u, 300u}) {
+        const kn::Texture src = make_wave(128, 4);
+        const kn::Texture expected = make_wave(width, 3);
+        kn::Texture dst(width, 3);
+        kn::resample(src.view(), dst.view(), {filter});
+        // Mitchell slightly blurs even a slow wave.
+        const double tolerance = filter == kn::ResampleFilter::Mitchell ? 0.02 : 0.002;
+        for (uint32_t x = 0; x < width; ++x) {
+          CHECK(std::abs(dst.view().at(x, 1) - expected.view().at(x, 1)) < tolerance);
+        }
+      }
+    }
+  }
+
+  SUBCASE("sRGB textures are averaged in linear light") {
+    // Both shapes filter their longest axis first.
+    for (const auto& [width, height] : {std::pair{2u, 64u}, std::pair{64u, 2u}}) {
+      kn::Texture src(width, height, 4);
+      for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+          for (uint32_t c = 0; c < 4; ++c) {
+            src.view().at(x, y, c) = (x + y) % 2 == 0 ? 1.0f : 0.0f;
+          }
+        }
+      }
+
+      kn::Texture dst(1, 1, 4);
+      kn::resample(src.view(), dst.view(), {kn::ResampleFilter::Area, true});
+      CHECK(dst.view().at(0, 0, 0) == doctest::Approx(kn::linear_to_srgb(0.5f)));
+      CHECK(dst.view().at(0, 0, 2) == doctest::Approx(kn::linear_to_srgb(0.5f)));
+      CHECK(dst.view().at(0, 0, 3) == doctest::Approx(0.5f));
+    }
+  }
+}
+
+TEST_CASE("Resample uniform textures") {
+  const std::vector<float> value = {0.3f, 0.7f};
+  const kn::Texture src = kn::Texture::uniform(64, 48, value);
+  for (const kn::ResampleFilter filter : {kn::ResampleFilter::Area, kn::ResampleFilter::Lanczos3}) {
+    const kn::Texture dst = kn::resample(src, 20, 10, {filter, false});
+    REQUIRE(dst.is_uniform());
+    CHECK(dst.get_width() == 20);
+    CHECK(dst.get_height() == 10);
+    CHECK(dst.get_data()[0] == doctest::Approx(0.3f));
+    CHECK(dst.get_data()[1] == doctest::Approx(0.7f));
+  }
+}
@@ -0,0 +1,212 @@
+/**************************************************************************/
+/* test_sampler.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include "sampler.hpp"
+
+namespace {
+kn::Texture make_noise(uint32_t width, uint32_t height, uint32_t channels) {
+  kn::Texture texture(width, height, channels);
+  std::mt19937 rng(17);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+    texture.get_data()[i] = dist(rng);
+  }
+  return texture;
+}
+
+int64_t reference_address(int64_t i, kn::AddressMode mode, int64_t size) {
+  switch (mode) {
+    case kn::AddressMode::Clamp:
+      return std::clamp<int64_t>(i, 0, size - 1);
+    case kn::AddressMode::Mirror: {
+      const int64_t m = ((i % (2 * size)) + 2 * size) % (2 * size);
+      return m < size ? m : 2 * size - 1 - m;
+    }
+    default:
+      return ((i % size) + size) % size;
+  }
+}
+
+float reference_bilinear(const kn::TextureView& t, kn::AddressMode mode, float u, float v, uint32_t c) {
+  const double x = static_cast<double>(u) * t.width - 0.5;
+  const double y = static_cast<double>(v) * t.height - 0.5;
+  const auto x0 = static_cast<int64_t>(std::floor(x));
+  const auto y0 = static_cast<int64_t>(std::floor(y));
+  const double fx = x - x0;
+  const double fy = y - y0;
+  const auto texel = [&](int64_t i, int64_t j) {
+    return static_cast<double>(t.at(static_cast<uint32_t>(reference_address(i, mode, t.width)),
+                                    static_cast<uint32_t>(reference_address(j, mode, t.height)), c));
+  };
+  return static_cast<float>((1 - fx) * (1 - fy) * texel(x0, y0) + fx * (1 - fy) * texel(x0 + 1, y0) +
+                            (1 - fx) * fy * texel(x0, y0 + 1) + fx * fy * texel(x0 + 1, y0 + 1));
+}
+}  // namespace
+
+TEST_CASE("Sampler") {
+  const kn::Texture texture = make_noise(13, 7, 3);
+  const kn::TextureView view = texture.view();
+
+  std::vector<float> us;
+  std::vector<float> vs;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> dist(-1.5f, 2.5f);
+  for (uint32_t i = 0; i < 103; ++i) {
+    us.push_back(dist(rng));
+    vs.push_back(dist(rng));
+  }
+  std::vector<float> out(us.size() * 3);
+
+  SUBCASE("bilinear matches the GPU convention for every address mode") {
+    for (auto mode : {kn::AddressMode::Wrap, kn::AddressMode::Clamp, kn::AddressMode::Mirror}) {
+      kn::SamplerState state{kn::FilterMode::Bilinear, mode, mode};
+      kn::sample(view, state, us.data(), vs.data(), us.size(), out.data());
+      for (size_t i = 0; i < us.size(); ++i) {
+        for (uint32_t c = 0; c < 3; ++c) {
+          REQUIRE(out[i * 3 + c] == doctest::Approx(reference_bilinear(view, mode, us[i], vs[i], c)).epsilon(1e-4));
+        }
+      }
+    }
+  }
+
+  SUBCASE("nearest picks the texel containing the coordinate") {
+    kn::SamplerState state{kn::FilterMode::Nearest, kn::AddressMode::Mirror, kn::AddressMode::Wrap};
+    kn::sample(view, state, us.data(), vs.data(), us.size(), out.data());
+    for (size_t i = 0; i < us.size(); ++i) {
+      const auto x = reference_address(static_cast<int64_t>(std::floor(us[i] * 13.0f)), kn::AddressMode::Mirror, 13);
+      const auto y = reference_address(static_cast<int64_t>(std::floor(vs[i] * 7.0f)), kn::AddressMode::Wrap, 7);
+      REQUIRE(out[i * 3 + 1] == view.at(static_cast<uint32_t>(x), static_cast<uint32_t>(y), 1));
+    }
+  }
+
+  SUBCASE("interpolating filters hit texel centers exactly") {
+    for (auto filter : {kn::FilterMode::Bilinear, kn::FilterMode::Bicubic}) {
+      kn::SamplerState state{filter, kn::AddressMode::Wrap, kn::AddressMode::Wrap};
+      const float u[] = {0.5f / 13.0f, 6.5f / 13.0f, 12.5f / 13.0f, 3.5f / 13.0f, 9.5f / 13.0f};
+      const float v[] = {0.5f / 7.0f, 3.5f / 7.0f, 6.5f / 7.0f, 1.5f / 7.0f, 5.5f / 7.0f};
+      float result[5 * 3];
+      kn::sample(view, state, u, v, 5, result);
+      CHECK(result[0] == doctest::Approx(view.at(0, 0, 0)));
+      CHECK(result[1 * 3 + 2] == doctest::Approx(view.at(6, 3, 2)));
+      CHECK(result[2 * 3 + 1] == doctest::Approx(view.at(12, 6, 1)));
+      CHECK(result[4 * 3 + 0] == doctest::Approx(view.at(9, 5, 0)));
+    }
+  }
+
+  SUBCASE("bicubic reproduces linear ramps") {
+    kn::Texture ramp(16, 4);
+    for (uint32_t y = 0; y < 4; ++y) {
+      for (uint32_t x = 0; x < 16; ++x) {
+        ramp.view().at(x, y) = static_cast<float>(x);
+      }
+    }
+    kn::SamplerState state{kn::FilterMode::Bicubic, kn::AddressMode::Clamp, kn::AddressMode::Clamp};
+    const float u[] = {4.25f / 16.0f, 7.8f / 16.0f};
+    const float v[] = {0.3f, 0.6f};
+    float result[2];
+    kn::sample(ramp.view(), state, u, v, 2, result);
+    CHECK(result[0] == doctest::Approx(3.75f));
+    CHECK(result[1] == doctest::Approx(7.3f));
+  }
+
+  SUBCASE("anisotropic filtering averages along the major axis") {
+    kn::SamplerState state{kn::FilterMode::Anisotropic, kn::AddressMode::Wrap, kn::AddressMode::Wrap, 16};
+
+    const std::vector<float> zeros(us.size(), 0.0f);
+    kn::SampleGradients flat{zeros.data(), zeros.data(), zeros.data(), zeros.data()};
+    std::vector<float> bilinear(out.size());
+    kn::sample(view, state, us.data(), vs.data(), us.size(), out.data(), &flat);
+    kn::sample(view, {}, us.data(), vs.data(), us.size(), bilinear.data());
+    for (size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == doctest::Approx(bilinear[i]));
+    }
+
+    // A footprint spanning a whole period horizontally averages every column of the row.
+    kn::Texture stripes(8, 8);
+    for (uint32_t y = 0; y < 8; ++y) {
+      for (uint32_t x = 0; x < 8; ++x) {
+        stripes.view().at(x, y) = static_cast<float>(x % 2);
+      }
+    }
+    const float u[] = {0.5f / 8.0f};
+    const float v[] = {0.5f / 8.0f};
+    const float dudx[] = {1.0f};
+    const float dvdx[] = {0.0f};
+    const float dudy[] = {0.0f};
+    const float dvdy[] = {1.0f / 16.0f};
+    kn::SampleGradients gradients{dudx, dvdx, dudy, dvdy};
+    float result = 0.0f;
+    kn::sample(stripes.view(), state, u, v, 1, &result, &gradients);
+    CHECK(result == doctest::Approx(0.5f));
+  }
+}
+
+TEST_CASE("Sampler with extreme coordinates") {
+  constexpr float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const std::vector<float> us = {nan, inf, -inf, 1.43e7f, -1.43e7f, 1e6f + 0.3f, 0.05f, -1.1e6f};
+  const std::vector<float> vs = {0.05f, nan, 0.05f, 0.05f, inf, -1e6f - 0.7f, -inf, 2.1e6f};
+
+  for (const auto& [width, height] : {std::pair{7u, 7u}, std::pair{13u, 5u}}) {
+    const kn::Texture texture = make_noise(width, height, 2);
+    std::vector<float> out(us.size() * 2);
+    for (auto filter : {kn::FilterMode::Nearest, kn::FilterMode::Bilinear, kn::FilterMode::Bicubic}) {
+      for (auto mode : {kn::AddressMode::Wrap, kn::AddressMode::Clamp, kn::AddressMode::Mirror}) {
+        kn::SamplerState state{filter, mode, mode};
+        kn::sample(texture.view(), state, us.data(), vs.data(), us.size(), out.data());
+        // Texels beyond float precision are still in the texture; noise stays in [0, 1] through bilinear filtering.
+        if (filter != kn::FilterMode::Bicubic) {
+          for (size_t i = 3; i < us.size(); ++i) {
+            if (std::isfinite(us[i]) && std::isfinite(vs[i])) {
+              REQUIRE(out[i * 2] >= 0.0f);
+              REQUIRE(out[i * 2] <= 1.0f);
+            }
+          }
+        }
+      }
+    }
+
+    // Below 2^24 texels, large coordinates address the same texel as exact integer arithmetic.
+    kn::SamplerState state{kn::FilterMode::Nearest, kn::AddressMode::Mirror, kn::AddressMode::Wrap};
+    kn::sample(texture.view(), state, us.data(), vs.data(), us.size(), out.data());
+    for (const size_t i : {size_t{5}, size_t{7}}) {
+      const auto x = reference_address(static_cast<int64_t>(std::floor(us[i] * static_cast<float>(width))),
+                                       kn::AddressMode::Mirror, width);
+      const auto y = reference_address(static_cast<int64_t>(std::floor(vs[i] * static_cast<float>(height))),
+                                       kn::AddressMode::Wrap, height);
+      CHECK(out[i * 2] == texture.view().at(static_cast<uint32_t>(x), static_cast<uint32_t>(y)));
+    }
+  }
+}
@@ -0,0 +1,205 @@
+/**************************************************************************/
+/* test_scatter.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "scatter.hpp"
+
+namespace {
+kn::Texture make_noise(uint32_t width, uint32_t height, uint32_t channels, uint32_t seed) {
+  kn::Texture texture(width, height, channels);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+    texture.get_data()[i] = dist(rng);
+  }
+  return texture;
+}
+
+std::vector<kn::Stamp> make_stamps(size_t count, float max_size, uint32_t pattern_count, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  std::vector<kn::Stamp> stamps(count);
+  for (size_t i = 0; i < count; ++i) {
+    kn::Stamp& stamp = stamps[i];
+    stamp.x = unit(rng) * 1.2f - 0.1f;
+    stamp.y = unit(rng) * 1.2f - 0.1f;
+    stamp.width = 0.01f + unit(rng) * max_size;
+    stamp.height = 0.01f + unit(rng) * max_size;
+    stamp.rotation = unit(rng) * 7.0f;
+    stamp.intensity = 0.5f + unit(rng);
+    stamp.opacity = unit(rng);
+    stamp.pattern = static_cast<uint32_t>(i % pattern_count);
+  }
+  return stamps;
+}
+
+/** Composites every stamp at every pixel, trying all the wrapped copies of the stamps. */
+void reference_scatter(const std::vector<kn::TextureView>& patterns,
+                       const std::vector<kn::Stamp>& stamps,
+                       const kn::TextureView& dst,
+                       kn::ScatterBlend blend) {
+  const kn::SamplerState state{kn::FilterMode::Bilinear, kn::AddressMode::Clamp, kn::AddressMode::Clamp};
+  for (uint32_t y = 0; y < dst.height; ++y) {
+    for (uint32_t x = 0; x < dst.width; ++x) {
+      for (const kn::Stamp& stamp : stamps) {
+        const double size_x = static_cast<double>(stamp.width) * dst.width;
+        const double size_y = static_cast<double>(stamp.height) * dst.height;
+        const double c = std::cos(static_cast<double>(stamp.rotation));
+        const double s = std::sin(static_cast<double>(stamp.rotation));
+        const auto cos_u = static_cast<float>(c / size_x);
+        const auto sin_u = static_cast<float>(s / size_x);
+        const auto cos_v = static_cast<float>(c / size_y);
+        const auto sin_v = static_cast<float>(s / size_y);
+        const auto center_x = static_cast<float>(static_cast<double>(stamp.x) * dst.width);
+        const auto center_y = static_cast<float>(static_cast<double>(stamp.y) * dst.height);
+
+        for (int32_t ky = -1; ky <= 1; ++ky) {
+          for (int32_t kx = -1; kx <= 1; ++kx) {
+            const float cx = center_x - static_cast<float>(kx * static_cast<int32_t>(dst.width));
+            const float cy = center_y - static_cast<float>(ky * static_cast<int32_t>(dst.height));
+            const float dx = static_cast<float>(x) + 0.5f - cx;
+            const float dy = static_cast<float>(y) + 0.5f - cy;
+            const float u = dx * cos_u + dy * sin_u + 0.5f;
+            const float v = dy * cos_v - dx * sin_v + 0.5f;
+            if (u < 0.0f || u >= 1.0f || v < 0.0f || v >= 1.0f) {
+              continue;
+            }
+
+            float values[4];
+            kn::sample(patterns[stamp.pattern], state, &u, &v, 1, values);
+            for (uint32_t ch = 0; ch < dst.channels; ++ch) {
+              const float d = dst.at(x, y, ch);
+              const float src = values[ch] * stamp.intensity;
+              float f = src;
+              switch (blend) {
+                case kn::ScatterBlend::Normal:
+                  break;
+                case kn::ScatterBlend::Add:
+                  f = d + src;
+                  break;
+                case kn::ScatterBlend::Multiply:
+                  f = d * src;
+                  break;
+                case kn::ScatterBlend::Max:
+                  f = std::max(d, src);
+                  break;
+                case kn::ScatterBlend::Min:
+                  f = std::min(d, src);
+                  break;
+              }
+              dst.at(x, y, ch) = stamp.opacity * (f - d) + d;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST_CASE("Scatter") {
+  SUBCASE("Matches compositing every stamp at every pixel") {
+    const kn::Texture pattern_a = make_noise(16, 16, 2, 1);
+    const kn::Texture pattern_b = make_noise(9, 30, 2, 2);
+    const std::vector<kn::TextureView> patterns = {pattern_a.view(), pattern_b.view()};
+    const std::vector<kn::Stamp> stamps = make_stamps(300, 0.4f, 2, 3);
+
+    for (const kn::ScatterBlend blend : {kn::ScatterBlend::Normal, kn::ScatterBlend::Add, kn::ScatterBlend::Multiply,
+                                         kn::ScatterBlend::Max, kn::ScatterBlend::Min}) {
+      kn::Texture expected = make_noise(150, 100, 2, 4);
+      kn::Texture result = make_noise(150, 100, 2, 4);
+      reference_scatter(patterns, stamps, expected.view(), blend);
+      kn::scatter(patterns, stamps, result.view(), {blend});
+
+      float error = 0.0f;
+      for (size_t i = 0; i < 150 * 100 * 2; ++i) {
+        error = std::max(error, std::abs(result.get_data()[i] - expected.get_data()[i]));
+      }
+      CHECK(error < 1e-4f);
+    }
+  }
+
+  SUBCASE("Stamps crossing a border wrap around") {
+    const kn::Texture pattern(4, 4, 1, 1.0f);
+    kn::Texture canvas(128, 128);
+    kn::Stamp stamp;
+    stamp.x = 0.0f;
+    stamp.y = 0.0f;
+    stamp.width = 0.25f;
+    stamp.height = 0.25f;
+    kn::scatter({pattern.view()}, {stamp}, canvas.view());
+
+    const kn::TextureView view = canvas.view();
+    CHECK(view.at(0, 0) == 1.0f);
+    CHECK(view.at(127, 0) == 1.0f);
+    CHECK(view.at(0, 127) == 1.0f);
+    CHECK(view.at(127, 127) == 1.0f);
+    CHECK(view.at(15, 15) == 1.0f);
+    CHECK(view.at(112, 112) == 1.0f);
+    CHECK(view.at(16, 0) == 0.0f);
+    CHECK(view.at(111, 0) == 0.0f);
+    CHECK(view.at(64, 64) == 0.0f);
+  }
+
+  SUBCASE("Later stamps are composited over earlier ones") {
+    const kn::Texture low(4, 4, 1, 0.25f);
+    const kn::Texture high(4, 4, 1, 0.75f);
+    std::vector<kn::Stamp> stamps(2000);
+    for (size_t i = 0; i < stamps.size(); ++i) {
+      stamps[i].x = static_cast<float>(i % 40) / 40.0f;
+      stamps[i].y = static_cast<float>(i / 40) / 50.0f;
+      stamps[i].width = 0.2f;
+      stamps[i].height = 0.2f;
+      stamps[i].pattern = static_cast<uint32_t>(i % 2);
+    }
+    stamps.back().pattern = 1;
+    stamps.back().x = 0.5f;
+    stamps.back().y = 0.5f;
+
+    kn::Texture canvas(256, 256);
+    kn::scatter({low.view(), high.view()}, stamps, canvas.view());
+    CHECK(canvas.view().at(128, 128) == 0.75f);
+  }
+
+  SUBCASE("Invisible stamps are skipped") {
+    const kn::Texture pattern(4, 4, 1, 1.0f);
+    kn::Texture canvas(32, 32);
+    kn::Stamp transparent;
+    transparent.opacity = 0.0f;
+    kn::Stamp empty;
+    empty.width = 0.0f;
+    kn::scatter({pattern.view()}, {transparent, empty}, canvas.view());
+    CHECK(*std::max_element(canvas.get_data(), canvas.get_data() + 32 * 32) == 0.0f);
+  }
+}
@@ -0,0 +1,162 @@
+/**************************************************************************/
+/* test_statistics.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "statistics.hpp"
+
+namespace {
+kn::Texture make_noise(uint32_t width, uint32_t height, uint32_t channels, uint32_t seed) {
+  kn::Texture texture(width, height, channels);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-0.25f, 1.25f);
+  for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+    texture.get_data()[i] = dist(rng);
+  }
+  return texture;
+}
+}  // namespace
+
+TEST_CASE("Texture statistics") {
+  SUBCASE("Matches a serial reduction") {
+    for (uint32_t channels = 1; channels <= 4; ++channels) {
+      const kn::Texture texture = make_noise(97, 131, channels, channels);
+      const kn::StatisticsOptions options{16, 0.0f, 1.0f};
+      const kn::TextureStatistics statistics = kn::compute_statistics(texture.view(), options);
+      REQUIRE(statistics.channels.size() == channels);
+      CHECK(statistics.pixel_count == 97 * 131);
+
+      for (uint32_t c = 0; c < channels; ++c) {
+        float min = texture.view().at(0, 0, c);
+        float max = min;
+        double sum = 0.0;
+        std::vector<uint64_t> histogram(16, 0);
+        for (uint32_t y = 0; y < 131; ++y) {
+          for (uint32_t x = 0; x < 97; ++x) {
+            const float value = texture.view().at(x, y, c);
+            min = std::min(min, value);
+            max = std::max(max, value);
+            sum += value;
+            ++histogram[static_cast<size_t>(std::clamp(std::floor(value * 16.0f), 0.0f, 15.0f))];
+          }
+        }
+        const double mean = sum / (97 * 131);
+        double squares = 0.0;
+        for (uint32_t y = 0; y < 131; ++y) {
+          for (uint32_t x = 0; x < 97; ++x) {
+            const double deviation = texture.view().at(x, y, c) - mean;
+            squares += deviation * deviation;
+          }
+        }
+
+        const kn::ChannelStatistics& channel = statistics.channels[c];
+        CHECK(channel.min == min);
+        CHECK(channel.max == max);
+        CHECK(channel.mean == doctest::Approx(mean).epsilon(1e-6));
+        CHECK(channel.variance == doctest::Approx(squares / (97 * 131)).epsilon(1e-6));
+        CHECK(channel.histogram == histogram);
+      }
+    }
+  }
+
+  SUBCASE("Moments stay accurate far from zero") {
+    kn::Texture texture(512, 512, 1);
+    for (size_t i = 0; i < 512 * 512; ++i) {
+      texture.get_data()[i] = 1000.0f + static_cast<float>(i % 2);
+    }
+    const kn::TextureStatistics statistics = kn::compute_statistics(texture.view(), {0});
+    CHECK(statistics.channels[0].histogram.empty());
+    CHECK(statistics.channels[0].mean == doctest::Approx(1000.5));
+    CHECK(statistics.channels[0].variance == doctest::Approx(0.25).epsilon(1e-6));
+  }
+
+  SUBCASE("Percentiles") {
+    kn::Texture texture(100, 100, 1);
+    for (uint32_t i = 0; i < 100 * 100; ++i) {
+      texture.get_data()[i] = static_cast<float>(i) / (100 * 100);
+    }
+    const kn::TextureStatistics statistics = kn::compute_statistics(texture.view(), {1000, 0.0f, 1.0f});
+    CHECK(statistics.percentile(0, 0.0f) == doctest::Approx(0.0f));
+    CHECK(statistics.percentile(0, 0.25f) == doctest::Approx(0.25f).epsilon(1e-3));
+    CHECK(statistics.percentile(0, 0.9f) == doctest::Approx(0.9f).epsilon(1e-3));
+    CHECK(statistics.percentile(0, 1.0f) == doctest::Approx(statistics.channels[0].max));
+  }
+}
+
+TEST_CASE("Statistics cache") {
+  kn::StatisticsCache cache;
+  kn::Texture texture = make_noise(64, 48, 2, 7);
+
+  const auto first = cache.get(texture.view());
+  CHECK(cache.get(texture.view()) == first);
+  CHECK(cache.get(texture.view(), {32, 0.0f, 1.0f}) != first);
+  CHECK(cache.get_size() == 2);
+
+  // Editing a pixel changes the content hash.
+  const uint64_t hash = kn::hash_texture(texture.view());
+  texture.view().at(10, 20, 1) += 1.0f;
+  CHECK(kn::hash_texture(texture.view()) != hash);
+  const auto edited = cache.get(texture.view());
+  CHECK(edited != first);
+  CHECK(edited->channels[1].mean != first->channels[1].mean);
+
+  // Keyed lookups do not read the pixels when the key is known.
+  const auto keyed = cache.get(42, texture.view());
+  texture.view().at(0, 0, 0) = 100.0f;
+  CHECK(cache.get(42, texture.view()) == keyed);
+
+  cache.set_capacity(1);
+  CHECK(cache.get_size() == 1);
+  CHECK(cache.get(42, texture.view()) == keyed);
+  cache.clear();
+  CHECK(cache.get_size() == 0);
+}
+
+TEST_CASE("Statistics of uniform textures") {
+  const std::vector<float> value = {0.25f, 0.75f};
+  const kn::Texture src = kn::Texture::uniform(50, 20, value);
+  kn::Texture materialized = src;
+  materialized.materialize();
+
+  const kn::TextureStatistics statistics = kn::compute_statistics(src);
+  const kn::TextureStatistics expected = kn::compute_statistics(materialized);
+  CHECK(statistics.pixel_count == 1000);
+  REQUIRE(statistics.channels.size() == 2);
+  for (uint32_t c = 0; c < 2; ++c) {
+    CHECK(statistics.channels[c].min == expected.channels[c].min);
+    CHECK(statistics.channels[c].max == expected.channels[c].max);
+    CHECK(statistics.channels[c].mean == doctest::Approx(expected.channels[c].mean));
+    CHECK(statistics.channels[c].variance == doctest::Approx(expected.channels[c].variance));
+    CHECK(statistics.channels[c].histogram == expected.channels[c].histogram);
+  }
+}
@@ -0,0 +1,112 @@
+/**************************************************************************/
+/* test_summed_area_table.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <random>
+#include "summed_area_table.hpp"
+
+namespace {
+kn::Texture make_noise(uint32_t width, uint32_t height, uint32_t channels) {
+  kn::Texture texture(width, height, channels);
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+    texture.get_data()[i] = dist(rng);
+  }
+  return texture;
+}
+
+double reference_box_sum(const kn::TextureView& src, int64_t x0, int64_t y0, int64_t x1, int64_t y1, uint32_t c) {
+  double sum = 0.0;
+  for (int64_t y = y0; y < y1; ++y) {
+    for (int64_t x = x0; x < x1; ++x) {
+      sum += src.fetch_wrap(x, y, c);
+    }
+  }
+  return sum;
+}
+}  // namespace
+
+TEST_CASE("SummedAreaTable") {
+  const kn::Texture src = make_noise(13, 9, 2);
+  const kn::SummedAreaTable sat(src.view(), true);
+
+  SUBCASE("box sums wrap around the texture") {
+    CHECK(sat.box_sum(0, 0, 13, 9, 1) == doctest::Approx(reference_box_sum(src.view(), 0, 0, 13, 9, 1)));
+    CHECK(sat.box_sum(-3, -2, 4, 5, 0) == doctest::Approx(reference_box_sum(src.view(), -3, -2, 4, 5, 0)));
+    CHECK(sat.box_sum(10, 7, 16, 12, 1) == doctest::Approx(reference_box_sum(src.view(), 10, 7, 16, 12, 1)));
+    CHECK(sat.box_sum(-20, -11, 31, 25, 0) == doctest::Approx(reference_box_sum(src.view(), -20, -11, 31, 25, 0)));
+  }
+
+  SUBCASE("box filter at several radii from one table") {
+    for (uint32_t radius : {0u, 1u, 4u, 15u}) {
+      kn::Texture dst(13, 9, 2);
+      kn::box_filter(sat, dst.view(), radius, radius / 2);
+
+      const double area = static_cast<double>(2 * radius + 1) * (2 * (radius / 2) + 1);
+      for (uint32_t y = 0; y < 9; ++y) {
+        for (uint32_t x = 0; x < 13; ++x) {
+          const int64_t rx = radius;
+          const int64_t ry = radius / 2;
+          const double expected = reference_box_sum(src.view(), x - rx, y - ry, x + rx + 1, y + ry + 1, 1) / area;
+          CHECK(dst.view().at(x, y, 1) == doctest::Approx(expected).epsilon(1e-5));
+        }
+      }
+    }
+  }
+
+  SUBCASE("local statistics") {
+    kn::Texture mean(13, 9, 2);
+    kn::Texture variance(13, 9, 2);
+    kn::local_statistics(sat, mean.view(), variance.view(), 2);
+
+    double sum = 0.0;
+    double squares = 0.0;
+    for (int64_t y = 1; y < 6; ++y) {
+      for (int64_t x = -1; x < 4; ++x) {
+        const double v = src.view().fetch_wrap(x, y, 0);
+        sum += v;
+        squares += v * v;
+      }
+    }
+    CHECK(mean.view().at(1, 3, 0) == doctest::Approx(sum / 25.0));
+    CHECK(variance.view().at(1, 3, 0) == doctest::Approx(squares / 25.0 - (sum / 25.0) * (sum / 25.0)));
+  }
+
+  SUBCASE("constant textures keep their value") {
+    const kn::Texture flat(64, 64, 1, 0.25f);
+    const kn::SummedAreaTable flat_sat(flat.view());
+    kn::Texture dst(64, 64);
+    kn::box_filter(flat_sat, dst.view(), 40, 40);
+    CHECK(dst.view().at(0, 0) == doctest::Approx(0.25f));
+    CHECK(dst.view().at(63, 31) == doctest::Approx(0.25f));
+  }
+}
@@ -0,0 +1,97 @@
+/**************************************************************************/
+/* test_texture_format.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include "texture_format.hpp"
+
+namespace {
+kn::Texture make_pixels(uint32_t channels, std::initializer_list<float> values) {
+  kn::Texture texture(static_cast<uint32_t>(values.size()) / channels, 1, channels);
+  std::copy(values.begin(), values.end(), texture.get_data());
+  return texture;
+}
+}  // namespace
+
+TEST_CASE("Channel dispatch") {
+  for (uint32_t channels = 1; channels <= 4; ++channels) {
+    CHECK(kn::dispatch_channels(channels, [](auto count) { return count(); }) == channels);
+  }
+}
+
+TEST_CASE("Channel conversion") {
+  SUBCASE("Gray is repeated into color, with an opaque alpha") {
+    const kn::Texture gray = make_pixels(1, {0.25f, 0.5f});
+    const kn::Texture rgba = kn::convert_channels(gray, 4);
+    REQUIRE(rgba.get_channels() == 4);
+    CHECK(rgba.view().at(1, 0, 0) == 0.5f);
+    CHECK(rgba.view().at(1, 0, 2) == 0.5f);
+    CHECK(rgba.view().at(1, 0, 3) == 1.0f);
+  }
+
+  SUBCASE("Color is reduced to its luminance, keeping alpha") {
+    const kn::Texture rgba = make_pixels(4, {1.0f, 0.0f, 0.0f, 0.5f, 0.0f, 1.0f, 0.0f, 1.0f});
+    const kn::Texture gray_alpha = kn::convert_channels(rgba, 2);
+    REQUIRE(gray_alpha.get_channels() == 2);
+    CHECK(gray_alpha.view().at(0, 0, 0) == doctest::Approx(0.2126f));
+    CHECK(gray_alpha.view().at(0, 0, 1) == 0.5f);
+    CHECK(gray_alpha.view().at(1, 0, 0) == doctest::Approx(0.7152f));
+    const kn::Texture gray = kn::convert_channels(rgba, 1);
+    CHECK(gray.view().at(0, 0) == doctest::Approx(0.2126f));
+  }
+
+  SUBCASE("Color keeps its channels") {
+    const kn::Texture rgb = make_pixels(3, {0.1f, 0.2f, 0.3f});
+    const kn::Texture rgba = kn::convert_channels(rgb, 4);
+    CHECK(rgba.view().at(0, 0, 1) == 0.2f);
+    CHECK(rgba.view().at(0, 0, 3) == 1.0f);
+    const kn::Texture back = kn::convert_channels(rgba, 3);
+    CHECK(std::equal(back.get_data(), back.get_data() + 3, rgb.get_data()));
+  }
+
+  SUBCASE("Runs of pixels") {
+    const float rgb[6] = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+    float gray_alpha[4] = {};
+    kn::convert_pixels(rgb, 3, gray_alpha, 2, 2);
+    CHECK(gray_alpha[0] == doctest::Approx(0.2126f));
+    CHECK(gray_alpha[1] == 1.0f);
+    CHECK(gray_alpha[2] == doctest::Approx(0.0722f));
+    CHECK(gray_alpha[3] == 1.0f);
+  }
+
+  SUBCASE("Uniform textures stay uniform") {
+    const std::vector<float> value = {0.5f, 0.25f};
+    const kn::Texture texture = kn::convert_channels(kn::Texture::uniform(64, 32, value), 3);
+    REQUIRE(texture.is_uniform());
+    CHECK(texture.get_width() == 64);
+    CHECK(texture.get_stored_size() == 3);
+    CHECK(texture.get_data()[2] == 0.5f);
+  }
+}
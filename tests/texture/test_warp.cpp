@@ -0,0 +1,201 @@
+/**************************************************************************/
+/* test_warp.cpp                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                                Knoodle                                 */
+/*                        https://knoodlegraph.org                        */
+/**************************************************************************/
+/* Copyright (c) 2025 Knoodle contributors (vide AUTHORS.md)              */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include "warp.hpp"
+
+namespace {
+kn::Texture make_noise(uint32_t width, uint32_t height, uint32_t channels, uint32_t seed) {
+  kn::Texture texture(width, height, channels);
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (size_t i = 0; i < static_cast<size_t>(width) * height * channels; ++i) {
+    texture.get_data()[i] = dist(rng);
+  }
+  return texture;
+}
+
+/** Bilinear wrapped sample of a linear texture, at a position where integer coordinates are texel centers. */
+float reference_sample(const kn::TextureView& t, double x, double y, uint32_t c) {
+  const double x0 = std::floor(x);
+  const double y0 = std::floor(y);
+  const double fx = x - x0;
+  const double fy = y - y0;
+  const auto texel = [&](double i, double j) {
+    return static_cast<double>(t.fetch_wrap(static_cast<int64_t>(i), static_cast<int64_t>(j), c));
+  };
+  return static_cast<float>((1 - fx) * (1 - fy) * texel(x0, y0) + fx * (1 - fy) * texel(x0 + 1, y0) +
+                            (1 - fx) * fy * texel(x0, y0 + 1) + fx * fy * texel(x0 + 1, y0 + 1));
+}
+
+kn::Texture to_linear(const kn::TiledTexture& tiled) {
+  kn::Texture texture(tiled.get_width(), tiled.get_height(), tiled.get_channels());
+  tiled.copy_to(texture.view());
+  return texture;
+}
+}  // namespace
+
+TEST_CASE("Tiled texture") {
+  const kn::Texture texture = make_noise(45, 70, 3, 1);
+  const kn::TiledTexture tiled(texture.view());
+  CHECK(tiled.get_tiles_x() == 2);
+  CHECK(tiled.get_tiles_y() == 3);
+  CHECK(tiled.at(44, 69, 2) == texture.view().at(44, 69, 2));
+  CHECK(tiled.at(33, 5, 1) == texture.view().at(33, 5, 1));
+
+  const kn::Texture copy = to_linear(tiled);
+  CHECK(std::equal(copy.get_data(), copy.get_data() + 45 * 70 * 3, texture.get_data()));
+}
+
+TEST_CASE("Displace") {
+  const uint32_t width = 77;
+  const uint32_t height = 50;
+
+  SUBCASE("Whole pixel offsets roll the texture") {
+    const kn::Texture texture = make_noise(width, height, 4, 2);
+    kn::Texture offsets(width, height, 2);
+    for (uint32_t y = 0; y < height; ++y) {
+      for (uint32_t x = 0; x < width; ++x) {
+        offsets.view().at(x, y, 0) = 3.0f / width;
+        offsets.view().at(x, y, 1) = -60.0f / height;
+      }
+    }
+
+    kn::TiledTexture dst(width, height, 4);
+    kn::displace(kn::TiledTexture(texture.view()), kn::TiledTexture(offsets.view()), 1.0f, dst);
+    const kn::Texture result = to_linear(dst);
+    for (uint32_t y = 0; y < height; ++y) {
+      for (uint32_t x = 0; x < width; ++x) {
+        for (uint32_t c = 0; c < 4; ++c) {
+          CHECK(result.view().at(x, y, c) ==
+                doctest::Approx(texture.view().fetch_wrap(x + 3, static_cast<int64_t>(y) - 60, c)).epsilon(1e-5));
+        }
+      }
+    }
+  }
+
+  SUBCASE("Invalid and huge offsets read texels of the texture") {
+    const kn::Texture texture = make_noise(width, height, 1, 5);
+    const float values[] = {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+                            -std::numeric_limits<float>::infinity(), 1.43e7f, -3.1e6f, 0.25f};
+    kn::Texture offsets(width, height, 2);
+    for (size_t i = 0; i < static_cast<size_t>(width) * height * 2; ++i) {
+      offsets.get_data()[i] = values[i % std::size(values)];
+    }
+
+    kn::TiledTexture dst(width, height, 1);
+    kn::displace(kn::TiledTexture(texture.view()), kn::TiledTexture(offsets.view()), 1.0f, dst);
+    const kn::Texture result = to_linear(dst);
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i) {
+      REQUIRE(result.get_data()[i] >= 0.0f);
+      REQUIRE(result.get_data()[i] <= 1.0f);
+    }
+  }
+
+  SUBCASE("Random offsets match the bilinear reference") {
+    for (uint32_t channels = 1; channels <= 4; ++channels) {
+      const kn::Texture texture = make_noise(width, height, channels, 3);
+      const kn::Texture offsets = make_noise(width, height, 2, 4);
+      const float intensity = 2.5f;
+
+      kn::TiledTexture dst(width, height, channels);
+      kn::displace(kn::TiledTexture(texture.view()), kn::TiledTexture(offsets.view()), intensity, dst);
+      const kn::Texture result = to_linear(dst);
+
+      for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+          const double sx = x + static_cast<double>(intensity * offsets.view().at(x, y, 0) * width);
+          const double sy = y + static_cast<double>(intensity * offsets.view().at(x, y, 1) * height);
+          for (uint32_t c = 0; c < channels; ++c) {
+            const float expected = reference_sample(texture.view(), sx, sy, c);
+            CHECK(result.view().at(x, y, c) == doctest::Approx(expected).epsilon(1e-3));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Directional warp") {
+  const uint32_t size = 64;
+  const kn::Texture texture = make_noise(size, size, 1, 5);
+  const kn::Texture map = make_noise(size, size, 2, 6);
+  const float angle = 0.7f;
+  const float intensity = 0.1f;
+
+  kn::TiledTexture dst(size, size, 1);
+  kn::directional_warp(kn::TiledTexture(texture.view()), kn::TiledTexture(map.view()), 1, angle, intensity, dst);
+  const kn::Texture result = to_linear(dst);
+
+  for (uint32_t y = 0; y < size; ++y) {
+    for (uint32_t x = 0; x < size; ++x) {
+      const double distance = intensity * map.view().at(x, y, 1) * size;
+      const double sx = x + distance * std::cos(angle);
+      const double sy = y + distance * std::sin(angle);
+      CHECK(result.view().at(x, y) == doctest::Approx(reference_sample(texture.view(), sx, sy, 0)).epsilon(1e-3));
+    }
+  }
+}
+
+TEST_CASE("Warp") {
+  const uint32_t width = 40;
+  const uint32_t height = 33;
+  const kn::Texture texture = make_noise(width, height, 2, 7);
+
+  SUBCASE("A flat height map leaves the texture unchanged") {
+    kn::TiledTexture dst(width, height, 2);
+    kn::warp(kn::TiledTexture(texture.view()), kn::TiledTexture(width, height, 1, 0.5f), 0, 10.0f, dst);
+    const kn::Texture result = to_linear(dst);
+    CHECK(std::equal(result.get_data(), result.get_data() + width * height * 2, texture.get_data()));
+  }
+
+  SUBCASE("A ramp moves the texture along its slope") {
+    kn::Texture ramp(width, height);
+    for (uint32_t y = 0; y < height; ++y) {
+      for (uint32_t x = 0; x < width; ++x) {
+        ramp.view().at(x, y) = static_cast<float>(y);
+      }
+    }
+
+    // The slope is 1 per pixel except across the wrapped border, where the ramp falls back to 0.
+    kn::TiledTexture dst(width, height, 2);
+    kn::warp(kn::TiledTexture(texture.view()), kn::TiledTexture(ramp.view()), 0, 2.0f / height, dst);
+    const kn::Texture result = to_linear(dst);
+    for (uint32_t y = 1; y + 1 < height; ++y) {
+      for (uint32_t x = 0; x < width; ++x) {
+        CHECK(result.view().at(x, y, 1) == doctest::Approx(texture.view().fetch_wrap(x, y + 2, 1)).epsilon(1e-5));
+      }
+    }
+  }
+}